@@ -117,6 +117,28 @@ macro(integration_benchmark name)
   set_property(GLOBAL APPEND PROPERTY COUCHBASE_BENCHMARKS "benchmark_integration_${name}")
 endmacro()
 
+macro(unit_benchmark name)
+  add_executable(benchmark_unit_${name} "${PROJECT_SOURCE_DIR}/test/benchmark_unit_${name}.cxx")
+  target_include_directories(benchmark_unit_${name} PRIVATE ${PROJECT_BINARY_DIR}/generated)
+  target_link_libraries(
+    benchmark_unit_${name}
+    project_options
+    project_warnings
+    Catch2::Catch2WithMain
+    Threads::Threads
+    snappy
+    couchbase_cxx_client
+    test_utils)
+  catch_discover_tests(
+    benchmark_unit_${name}
+    PROPERTIES
+    SKIP_REGULAR_EXPRESSION
+    "SKIP"
+    LABELS
+    "benchmark")
+  set_property(GLOBAL APPEND PROPERTY COUCHBASE_BENCHMARKS "benchmark_unit_${name}")
+endmacro()
+
 add_subdirectory(${PROJECT_SOURCE_DIR}/test)
 
 get_property(integration_targets GLOBAL PROPERTY COUCHBASE_INTEGRATION_TESTS)
@@ -15,6 +15,7 @@
 
 #include "agent.hxx"
 
+#include "cluster.hxx"
 #include "collections_component.hxx"
 #include "core/logger/logger.hxx"
 #include "core/meta/version.hxx"
@@ -38,7 +39,7 @@ class agent_impl
       , config_{ std::move(config) }
       , bucket_name_{ config_.bucket_name }
       , collections_{ io_, { bucket_name_, config_.shim }, { config_.key_value.max_queue_size, config_.default_retry_strategy } }
-      , crud_{ io_, collections_, config_.default_retry_strategy }
+      , crud_{ io_, bucket_name_, collections_, config_.default_retry_strategy, config_.shim.cluster->tracer() }
     {
         CB_LOG_DEBUG("SDK version: {}", meta::sdk_id());
         CB_LOG_DEBUG("creating new agent: {}", config_.to_string());
@@ -49,123 +50,115 @@ class agent_impl
         return bucket_name_;
     }
 
-    auto get(get_options /* options */, get_callback && /* callback */) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    auto get(get_options options, get_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        return tl::unexpected(errc::common::unsupported_operation);
+        return crud_.get(std::move(options), std::move(callback));
     }
 
-    auto get_and_touch(get_and_touch_options /* options */, get_and_touch_callback && /* callback */)
+    auto get_and_touch(get_and_touch_options options, get_and_touch_callback&& callback)
       -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        return tl::unexpected(errc::common::unsupported_operation);
+        return crud_.get_and_touch(std::move(options), std::move(callback));
     }
 
-    auto get_and_lock(get_and_lock_options /* options */, get_and_touch_callback && /* callback */)
+    auto get_and_lock(get_and_lock_options options, get_and_lock_callback&& callback)
       -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        return tl::unexpected(errc::common::unsupported_operation);
+        return crud_.get_and_lock(std::move(options), std::move(callback));
     }
 
-    auto get_one_replica(get_one_replica_options /* options */, get_one_replica_callback && /* callback */)
+    auto get_one_replica(get_one_replica_options options, get_one_replica_callback&& callback)
       -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        return tl::unexpected(errc::common::unsupported_operation);
+        return crud_.get_one_replica(std::move(options), std::move(callback));
     }
 
-    auto touch(touch_options /* options */, touch_callback && /* callback */)
-      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    auto touch(touch_options options, touch_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        return tl::unexpected(errc::common::unsupported_operation);
+        return crud_.touch(std::move(options), std::move(callback));
     }
 
-    auto unlock(unlock_options /* options */, unlock_callback && /* callback */)
-      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    auto unlock(unlock_options options, unlock_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        return tl::unexpected(errc::common::unsupported_operation);
+        return crud_.unlock(std::move(options), std::move(callback));
     }
 
-    auto remove(remove_options /* options */, remove_callback && /* callback */)
-      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    auto remove(remove_options options, remove_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        return tl::unexpected(errc::common::unsupported_operation);
+        return crud_.remove(std::move(options), std::move(callback));
     }
 
-    auto insert(insert_options /* options */, insert_callback && /* callback */)
-      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    auto insert(insert_options options, insert_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        return tl::unexpected(errc::common::unsupported_operation);
+        return crud_.insert(std::move(options), std::move(callback));
     }
 
-    auto upsert(upsert_options /* options */, upsert_callback && /* callback */)
-      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    auto upsert(upsert_options options, upsert_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        return tl::unexpected(errc::common::unsupported_operation);
+        return crud_.upsert(std::move(options), std::move(callback));
     }
 
-    auto replace(replace_options /* options */, replace_callback && /* callback */)
-      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    auto replace(replace_options options, replace_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        return tl::unexpected(errc::common::unsupported_operation);
+        return crud_.replace(std::move(options), std::move(callback));
     }
 
-    auto append(adjoin_options /* options */, adjoin_callback && /* callback */)
-      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    auto append(adjoin_options options, adjoin_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        return tl::unexpected(errc::common::unsupported_operation);
+        return crud_.append(std::move(options), std::move(callback));
     }
 
-    auto prepend(adjoin_options /* options */, adjoin_callback && /* callback */)
-      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    auto prepend(adjoin_options options, adjoin_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        return tl::unexpected(errc::common::unsupported_operation);
+        return crud_.prepend(std::move(options), std::move(callback));
     }
 
-    auto increment(counter_options /* options */, counter_callback && /* callback */)
+    auto increment(counter_options options, counter_callback&& callback)
       -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        return tl::unexpected(errc::common::unsupported_operation);
+        return crud_.increment(std::move(options), std::move(callback));
     }
 
-    auto decrement(counter_options /* options */, counter_callback && /* callback */)
+    auto decrement(counter_options options, counter_callback&& callback)
       -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        return tl::unexpected(errc::common::unsupported_operation);
+        return crud_.decrement(std::move(options), std::move(callback));
     }
 
-    auto lookup_in(lookup_in_options /* options */, lookup_in_callback && /* callback */)
+    auto lookup_in(lookup_in_options options, lookup_in_callback&& callback)
       -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        return tl::unexpected(errc::common::unsupported_operation);
+        return crud_.lookup_in(std::move(options), std::move(callback));
     }
 
-    auto mutate_in(mutate_in_options /* options */, mutate_in_callback && /* callback */)
+    auto mutate_in(mutate_in_options options, mutate_in_callback&& callback)
       -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        return tl::unexpected(errc::common::unsupported_operation);
+        return crud_.mutate_in(std::move(options), std::move(callback));
     }
 
-    auto get_random(get_random_options /* options */, get_random_callback && /* callback */)
+    auto get_random(get_random_options options, get_random_callback&& callback)
       -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        return tl::unexpected(errc::common::unsupported_operation);
+        return crud_.get_random(std::move(options), std::move(callback));
     }
 
-    auto get_with_meta(get_with_meta_options /* options */, get_with_meta_callback && /* callback */)
+    auto get_with_meta(get_with_meta_options options, get_with_meta_callback&& callback)
       -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        return tl::unexpected(errc::common::unsupported_operation);
+        return crud_.get_with_meta(std::move(options), std::move(callback));
     }
 
-    auto upsert_with_meta(upsert_with_meta_options /* options */, upsert_with_meta_callback && /* callback */)
+    auto upsert_with_meta(upsert_with_meta_options options, upsert_with_meta_callback&& callback)
       -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        return tl::unexpected(errc::common::unsupported_operation);
+        return crud_.upsert_with_meta(std::move(options), std::move(callback));
     }
 
-    auto remove_with_meta(remove_with_meta_options /* options */, remove_with_meta_callback && /* callback */)
+    auto remove_with_meta(remove_with_meta_options options, remove_with_meta_callback&& callback)
       -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        return tl::unexpected(errc::common::unsupported_operation);
+        return crud_.remove_with_meta(std::move(options), std::move(callback));
     }
 
     auto n1ql_query(n1ql_query_options /* options */, n1ql_query_callback && /* callback */)
@@ -238,13 +231,15 @@ class agent_impl
     auto observe(observe_options /* options */, observe_callback && /* callback */)
       -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
+        // legacy observe carries the key in the value, so it cannot be used with collections (see mcbp::codec::encode_packet),
+        // observe_seqno should be used instead
         return tl::unexpected(errc::common::unsupported_operation);
     }
 
-    auto observe_seqno(observe_seqno_options /* options */, observe_seqno_callback && /* callback */)
+    auto observe_seqno(observe_seqno_options options, observe_seqno_callback&& callback)
       -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        return tl::unexpected(errc::common::unsupported_operation);
+        return crud_.observe_seqno(std::move(options), std::move(callback));
     }
 
     auto range_scan_create(std::uint16_t vbucket_id, range_scan_create_options options, range_scan_create_callback&& callback)
@@ -256,7 +251,7 @@ class agent_impl
     auto range_scan_continue(std::vector<std::byte> scan_uuid,
                              std::uint16_t vbucket_id,
                              range_scan_continue_options options,
-                             range_scan_item_callback&& item_callback,
+                             range_scan_item_view_callback&& item_callback,
                              range_scan_continue_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
         return crud_.range_scan_continue(
@@ -306,7 +301,7 @@ agent::get_and_touch(get_and_touch_options options, get_and_touch_callback&& cal
 }
 
 auto
-agent::get_and_lock(get_and_lock_options options, get_and_touch_callback&& callback)
+agent::get_and_lock(get_and_lock_options options, get_and_lock_callback&& callback)
   -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
 {
     return impl_->get_and_lock(std::move(options), std::move(callback));
@@ -521,7 +516,7 @@ auto
 agent::range_scan_continue(std::vector<std::byte> scan_uuid,
                            std::uint16_t vbucket_id,
                            range_scan_continue_options options,
-                           range_scan_item_callback&& item_callback,
+                           range_scan_item_view_callback&& item_callback,
                            range_scan_continue_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
 {
     return impl_->range_scan_continue(std::move(scan_uuid), vbucket_id, std::move(options), std::move(item_callback), std::move(callback));
@@ -58,7 +58,7 @@ class agent
     auto get_and_touch(get_and_touch_options options, get_and_touch_callback&& callback)
       -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
 
-    auto get_and_lock(get_and_lock_options options, get_and_touch_callback&& callback)
+    auto get_and_lock(get_and_lock_options options, get_and_lock_callback&& callback)
       -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
 
     auto get_one_replica(get_one_replica_options options, get_one_replica_callback&& callback)
@@ -147,7 +147,7 @@ class agent
     auto range_scan_continue(std::vector<std::byte> scan_uuid,
                              std::uint16_t vbucket_id,
                              range_scan_continue_options options,
-                             range_scan_item_callback&& item_callback,
+                             range_scan_item_view_callback&& item_callback,
                              range_scan_continue_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
 
     auto range_scan_cancel(std::vector<std::byte> scan_uuid,
@@ -22,6 +22,8 @@
 #include "core/mcbp/codec.hxx"
 #include "dispatcher.hxx"
 #include "impl/bootstrap_state_listener.hxx"
+#include "io/io_context_pool.hxx"
+#include "metrics/noop_meter.hxx"
 #include "mcbp/completion_token.hxx"
 #include "mcbp/operation_queue.hxx"
 #include "mcbp/queue_request.hxx"
@@ -35,6 +37,7 @@
 
 #include <fmt/chrono.h>
 
+#include <map>
 #include <mutex>
 #include <queue>
 #include <spdlog/fmt/bin_to_hex.h>
@@ -63,6 +66,33 @@ diff_nodes(const std::vector<topology::configuration::node>& lhs,
     }
 }
 
+/**
+ * looks up the compression recorders of every command, that might send Snappy-compressed value (see client_request::data())
+ */
+static auto
+make_compression_recorders(const std::shared_ptr<couchbase::metrics::meter>& meter)
+  -> std::map<protocol::client_opcode, compression_value_recorders>
+{
+    std::map<protocol::client_opcode, compression_value_recorders> recorders{};
+    for (auto opcode : {
+           protocol::client_opcode::insert,
+           protocol::client_opcode::upsert,
+           protocol::client_opcode::replace,
+           protocol::client_opcode::append,
+           protocol::client_opcode::prepend,
+         }) {
+        const std::map<std::string, std::string> tags = {
+            { "db.couchbase.service", "kv" },
+            { "db.operation", fmt::format("{}", opcode) },
+        };
+        recorders[opcode] = {
+            meter->get_value_recorder("db.couchbase.compression.saved_bytes", tags),
+            meter->get_value_recorder("db.couchbase.compression.duration_ns", tags),
+        };
+    }
+    return recorders;
+}
+
 class bucket_impl
   : public std::enable_shared_from_this<bucket_impl>
   , public config_listener
@@ -77,18 +107,21 @@ class bucket_impl
                 std::vector<protocol::hello_feature> known_features,
                 std::shared_ptr<impl::bootstrap_state_listener> state_listener,
                 asio::io_context& ctx,
-                asio::ssl::context& tls)
+                asio::ssl::context& tls,
+                std::shared_ptr<io::io_context_pool> shards)
       : client_id_{ std::move(client_id) }
       , name_{ std::move(name) }
       , log_prefix_{ fmt::format("[{}/{}]", client_id_, name_) }
       , origin_{ std::move(origin) }
       , tracer_{ std::move(tracer) }
       , meter_{ std::move(meter) }
+      , compression_recorders_{ make_compression_recorders(meter_) }
       , known_features_{ std::move(known_features) }
       , state_listener_{ std::move(state_listener) }
       , codec_{ { known_features_.begin(), known_features_.end() } }
       , ctx_{ ctx }
       , tls_{ tls }
+      , shards_{ std::move(shards) }
     {
     }
 
@@ -328,9 +361,10 @@ class bucket_impl
         }
         couchbase::core::origin origin(origin_.credentials(), hostname, port, origin_.options());
 
+        auto& shard = session_context();
         io::mcbp_session session = origin_.options().enable_tls
-                                     ? io::mcbp_session(client_id_, ctx_, tls_, origin, state_listener_, name_, known_features_)
-                                     : io::mcbp_session(client_id_, ctx_, origin, state_listener_, name_, known_features_);
+                                     ? io::mcbp_session(client_id_, shard, tls_, origin, state_listener_, name_, known_features_)
+                                     : io::mcbp_session(client_id_, shard, origin, state_listener_, name_, known_features_);
 
         std::scoped_lock lock(sessions_mutex_);
         if (auto ptr = sessions_.find(index); ptr == sessions_.end()) {
@@ -386,9 +420,10 @@ class bucket_impl
         if (state_listener_) {
             state_listener_->register_config_listener(shared_from_this());
         }
+        auto& shard = session_context();
         io::mcbp_session new_session = origin_.options().enable_tls
-                                         ? io::mcbp_session(client_id_, ctx_, tls_, origin_, state_listener_, name_, known_features_)
-                                         : io::mcbp_session(client_id_, ctx_, origin_, state_listener_, name_, known_features_);
+                                         ? io::mcbp_session(client_id_, shard, tls_, origin_, state_listener_, name_, known_features_)
+                                         : io::mcbp_session(client_id_, shard, origin_, state_listener_, name_, known_features_);
         new_session.bootstrap([self = shared_from_this(), new_session, h = std::move(handler)](std::error_code ec,
                                                                                                topology::configuration cfg) mutable {
             if (ec) {
@@ -578,9 +613,10 @@ class bucket_impl
                     continue;
                 }
                 couchbase::core::origin origin(origin_.credentials(), hostname, port, origin_.options());
+                auto& shard = session_context();
                 io::mcbp_session session = origin_.options().enable_tls
-                                             ? io::mcbp_session(client_id_, ctx_, tls_, origin, state_listener_, name_, known_features_)
-                                             : io::mcbp_session(client_id_, ctx_, origin, state_listener_, name_, known_features_);
+                                             ? io::mcbp_session(client_id_, shard, tls_, origin, state_listener_, name_, known_features_)
+                                             : io::mcbp_session(client_id_, shard, origin, state_listener_, name_, known_features_);
                 CB_LOG_DEBUG(
                   R"({} rev={}, add session="{}", address="{}:{}")", log_prefix_, config.rev_str(), session.id(), hostname, port);
                 session.bootstrap(
@@ -663,6 +699,19 @@ class bucket_impl
         return meter_;
     }
 
+    [[nodiscard]] auto compression_recorders(protocol::client_opcode opcode) const -> const compression_value_recorders&
+    {
+        if (auto it = compression_recorders_.find(opcode); it != compression_recorders_.end()) {
+            return it->second;
+        }
+        // the command never compresses its value, so nothing will be recorded
+        static const compression_value_recorders noop{
+            std::make_shared<metrics::noop_value_recorder>(),
+            std::make_shared<metrics::noop_value_recorder>(),
+        };
+        return noop;
+    }
+
     void export_diag_info(diag::diagnostics_result& res) const
     {
         std::map<size_t, io::mcbp_session> sessions;
@@ -706,18 +755,25 @@ class bucket_impl
     }
 
   private:
+    [[nodiscard]] asio::io_context& session_context()
+    {
+        return shards_ ? shards_->next() : ctx_;
+    }
+
     const std::string client_id_;
     const std::string name_;
     const std::string log_prefix_;
     const origin origin_;
     const std::shared_ptr<couchbase::tracing::request_tracer> tracer_;
     const std::shared_ptr<couchbase::metrics::meter> meter_;
+    const std::map<protocol::client_opcode, compression_value_recorders> compression_recorders_;
     const std::vector<protocol::hello_feature> known_features_;
     const std::shared_ptr<impl::bootstrap_state_listener> state_listener_;
     mcbp::codec codec_;
 
     asio::io_context& ctx_;
     asio::ssl::context& tls_;
+    const std::shared_ptr<io::io_context_pool> shards_;
 
     std::atomic_bool closed_{ false };
     std::atomic_bool configured_{ false };
@@ -744,7 +800,8 @@ bucket::bucket(std::string client_id,
                std::string name,
                couchbase::core::origin origin,
                std::vector<protocol::hello_feature> known_features,
-               std::shared_ptr<impl::bootstrap_state_listener> state_listener)
+               std::shared_ptr<impl::bootstrap_state_listener> state_listener,
+               std::shared_ptr<io::io_context_pool> shards)
 
   : ctx_(ctx)
   , impl_{ std::make_shared<bucket_impl>(std::move(client_id),
@@ -755,7 +812,8 @@ bucket::bucket(std::string client_id,
                                          std::move(known_features),
                                          std::move(state_listener),
                                          ctx,
-                                         tls) }
+                                         tls,
+                                         std::move(shards)) }
 {
 }
 
@@ -812,6 +870,12 @@ bucket::meter() const -> std::shared_ptr<couchbase::metrics::meter>
     return impl_->meter();
 }
 
+auto
+bucket::compression_recorders(protocol::client_opcode opcode) const -> const compression_value_recorders&
+{
+    return impl_->compression_recorders(opcode);
+}
+
 auto
 bucket::default_retry_strategy() const -> std::shared_ptr<couchbase::retry_strategy>
 {
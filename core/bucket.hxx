@@ -34,6 +34,7 @@ namespace couchbase
 namespace metrics
 {
 class meter;
+class value_recorder;
 } // namespace metrics
 namespace tracing
 {
@@ -54,10 +55,22 @@ namespace impl
 {
 class bootstrap_state_listener;
 } // namespace impl
+namespace io
+{
+class io_context_pool;
+} // namespace io
 
 class bucket_impl;
 struct origin;
 
+/**
+ * Recorders of the compression metrics for one command.
+ */
+struct compression_value_recorders {
+    std::shared_ptr<couchbase::metrics::value_recorder> saved_bytes{};
+    std::shared_ptr<couchbase::metrics::value_recorder> duration{};
+};
+
 class bucket
   : public std::enable_shared_from_this<bucket>
   , public config_listener
@@ -71,7 +84,8 @@ class bucket
            std::string name,
            couchbase::core::origin origin,
            std::vector<protocol::hello_feature> known_features,
-           std::shared_ptr<impl::bootstrap_state_listener> state_listener);
+           std::shared_ptr<impl::bootstrap_state_listener> state_listener,
+           std::shared_ptr<io::io_context_pool> shards);
     ~bucket() override;
 
     template<typename Request, typename Handler>
@@ -161,6 +175,10 @@ class bucket
     [[nodiscard]] auto log_prefix() const -> const std::string&;
     [[nodiscard]] auto tracer() const -> std::shared_ptr<couchbase::tracing::request_tracer>;
     [[nodiscard]] auto meter() const -> std::shared_ptr<couchbase::metrics::meter>;
+    /**
+     * @return recorders of the compression metrics, that are looked up in the meter once, when the bucket is created
+     */
+    [[nodiscard]] auto compression_recorders(protocol::client_opcode opcode) const -> const compression_value_recorders&;
     [[nodiscard]] auto default_retry_strategy() const -> std::shared_ptr<couchbase::retry_strategy>;
     [[nodiscard]] auto is_closed() const -> bool;
     [[nodiscard]] auto is_configured() const -> bool;
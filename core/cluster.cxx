@@ -17,6 +17,8 @@
 
 #include "cluster.hxx"
 
+#include "core/impl/active_read_latency.hxx"
+#include "core/impl/observe_probe_coalescer.hxx"
 #include "core/mcbp/completion_token.hxx"
 #include "core/mcbp/queue_request.hxx"
 #include "ping_collector.hxx"
@@ -125,7 +127,7 @@ cluster::do_ping(std::optional<std::string> report_id,
 std::shared_ptr<bucket>
 cluster::find_bucket_by_name(const std::string& name)
 {
-    std::scoped_lock lock(buckets_mutex_);
+    std::shared_lock lock(buckets_mutex_);
 
     auto bucket = buckets_.find(name);
     if (bucket == buckets_.end()) {
@@ -134,6 +136,27 @@ cluster::find_bucket_by_name(const std::string& name)
     return bucket->second;
 }
 
+auto
+cluster::read_latency_tracker(const std::string& bucket_name) -> std::shared_ptr<impl::active_read_latency>
+{
+    std::scoped_lock lock(read_latency_mutex_);
+    auto& tracker = read_latency_[bucket_name];
+    if (!tracker) {
+        tracker = std::make_shared<impl::active_read_latency>();
+    }
+    return tracker;
+}
+
+auto
+cluster::observe_probes() -> std::shared_ptr<impl::observe_probe_coalescer>
+{
+    std::scoped_lock lock(observe_probes_mutex_);
+    if (!observe_probes_) {
+        observe_probes_ = std::make_shared<impl::observe_probe_coalescer>();
+    }
+    return observe_probes_;
+}
+
 auto
 cluster::direct_dispatch(const std::string& bucket_name, std::shared_ptr<couchbase::core::mcbp::queue_request> req) -> std::error_code
 {
@@ -21,8 +21,10 @@
 #include "capella_ca.hxx"
 #include "core/io/http_command.hxx"
 #include "core/io/http_session_manager.hxx"
+#include "core/io/io_context_pool.hxx"
 #include "core/io/mcbp_command.hxx"
 #include "core/io/mcbp_session.hxx"
+#include "core/io/tls_session_cache.hxx"
 #include "core/metrics/logging_meter.hxx"
 #include "core/metrics/noop_meter.hxx"
 #include "core/operations/management/bucket_create.hxx"
@@ -39,6 +41,7 @@
 
 #include <asio/ssl.hpp>
 #include <fstream>
+#include <shared_mutex>
 #include <thread>
 #include <utility>
 
@@ -46,6 +49,12 @@ namespace couchbase::core
 {
 class crud_component;
 
+namespace impl
+{
+class active_read_latency;
+class observe_probe_coalescer;
+} // namespace impl
+
 class cluster : public std::enable_shared_from_this<cluster>
 {
   public:
@@ -102,6 +111,10 @@ class cluster : public std::enable_shared_from_this<cluster>
         }
         meter_->start();
         session_manager_->set_tracer(tracer_);
+        if (origin_.options().io_shards > 0) {
+            shards_ = std::make_shared<io::io_context_pool>(origin_.options().io_shards, origin_.options().pin_io_shards);
+            session_manager_->set_io_context_pool(shards_);
+        }
         if (origin_.options().enable_dns_srv) {
             auto [hostname, _] = origin_.next_address();
             dns_srv_tracker_ =
@@ -142,6 +155,9 @@ class cluster : public std::enable_shared_from_this<cluster>
             self->for_each_bucket([](auto& bucket) { bucket->close(); });
             self->session_manager_->close();
             handler();
+            if (self->shards_) {
+                self->shards_->stop();
+            }
             self->work_.reset();
             if (self->tracer_) {
                 self->tracer_->stop();
@@ -169,7 +185,8 @@ class cluster : public std::enable_shared_from_this<cluster>
                 if (session_ && session_->has_config()) {
                     known_features = session_->supported_features();
                 }
-                b = std::make_shared<bucket>(id_, ctx_, tls_, tracer_, meter_, bucket_name, origin_, known_features, dns_srv_tracker_);
+                b = std::make_shared<bucket>(
+                  id_, ctx_, tls_, tracer_, meter_, bucket_name, origin_, known_features, dns_srv_tracker_, shards_);
                 buckets_.try_emplace(bucket_name, b);
             }
         }
@@ -205,6 +222,10 @@ class cluster : public std::enable_shared_from_this<cluster>
                 buckets_.erase(ptr);
             }
         }
+        {
+            std::scoped_lock lock(read_latency_mutex_);
+            read_latency_.erase(bucket_name);
+        }
         if (b != nullptr) {
             b->close();
         }
@@ -287,6 +308,7 @@ class cluster : public std::enable_shared_from_this<cluster>
             }
             self->for_each_bucket([&res](const auto& bucket) { bucket->export_diag_info(res); });
             self->session_manager_->export_diag_info(res);
+            res.tls_sessions = self->tls_sessions_->stats();
             handler(std::move(res));
         }));
     }
@@ -300,10 +322,39 @@ class cluster : public std::enable_shared_from_this<cluster>
         do_ping(report_id, bucket_name, services, std::forward<Handler>(handler));
     }
 
+    [[nodiscard]] auto tracer() const -> const std::shared_ptr<couchbase::tracing::request_tracer>&
+    {
+        return tracer_;
+    }
+
+    /**
+     * @return true if the cluster has been closed, and does not accept requests anymore
+     */
+    [[nodiscard]] auto is_stopped() const -> bool
+    {
+        return stopped_;
+    }
+
     auto direct_dispatch(const std::string& bucket_name, std::shared_ptr<couchbase::core::mcbp::queue_request> req) -> std::error_code;
 
     auto direct_re_queue(const std::string& bucket_name, std::shared_ptr<mcbp::queue_request> req, bool is_retry) -> std::error_code;
 
+    /**
+     * @return the bucket if it has been opened. Callers that dispatch to the same bucket repeatedly might keep a weak reference to it, to
+     * avoid the lookup on every request.
+     */
+    std::shared_ptr<bucket> find_bucket_by_name(const std::string& name);
+
+    /**
+     * @return latency of the recent reads from the active nodes of the bucket, that is used to derive the delay of the hedged reads
+     */
+    auto read_latency_tracker(const std::string& bucket_name) -> std::shared_ptr<impl::active_read_latency>;
+
+    /**
+     * @return coalescer of the observe_seqno probes, that are sent by the legacy durability polling
+     */
+    auto observe_probes() -> std::shared_ptr<impl::observe_probe_coalescer>;
+
   private:
     explicit cluster(asio::io_context& ctx)
       : ctx_(ctx)
@@ -312,8 +363,6 @@ class cluster : public std::enable_shared_from_this<cluster>
     {
     }
 
-    std::shared_ptr<bucket> find_bucket_by_name(const std::string& name);
-
     void do_ping(std::optional<std::string> report_id,
                  std::optional<std::string> bucket_name,
                  std::set<service_type> services,
@@ -324,7 +373,7 @@ class cluster : public std::enable_shared_from_this<cluster>
     {
         std::vector<std::shared_ptr<bucket>> buckets{};
         {
-            std::scoped_lock lock(buckets_mutex_);
+            std::shared_lock lock(buckets_mutex_);
             buckets.reserve(buckets_.size());
             for (const auto& [name, bucket] : buckets_) {
                 buckets.push_back(bucket);
@@ -335,6 +384,11 @@ class cluster : public std::enable_shared_from_this<cluster>
         }
     }
 
+    [[nodiscard]] asio::io_context& session_context()
+    {
+        return shards_ ? shards_->next() : ctx_;
+    }
+
     template<typename Handler>
     void do_open(Handler&& handler)
     {
@@ -369,6 +423,7 @@ class cluster : public std::enable_shared_from_this<cluster>
 
         if (origin_.options().enable_tls) {
             tls_.set_options(asio::ssl::context::default_workarounds | asio::ssl::context::no_sslv2 | asio::ssl::context::no_sslv3);
+            io::tls_session_cache::attach(tls_sessions_, tls_);
             switch (origin_.options().tls_verify) {
                 case tls_verify_mode::none:
                     tls_.set_verify_mode(asio::ssl::verify_none);
@@ -447,9 +502,9 @@ class cluster : public std::enable_shared_from_this<cluster>
                 }
             }
 
-            session_ = io::mcbp_session(id_, ctx_, tls_, origin_, dns_srv_tracker_);
+            session_ = io::mcbp_session(id_, session_context(), tls_, origin_, dns_srv_tracker_);
         } else {
-            session_ = io::mcbp_session(id_, ctx_, origin_, dns_srv_tracker_);
+            session_ = io::mcbp_session(id_, session_context(), origin_, dns_srv_tracker_);
         }
         session_->bootstrap([self = shared_from_this(),
                              handler = std::forward<Handler>(handler)](std::error_code ec, const topology::configuration& config) mutable {
@@ -499,12 +554,21 @@ class cluster : public std::enable_shared_from_this<cluster>
     std::string id_{ uuid::to_string(uuid::random()) };
     asio::io_context& ctx_;
     asio::executor_work_guard<asio::io_context::executor_type> work_;
+    // declared before tls_, because the context refers to the cache
+    std::shared_ptr<io::tls_session_cache> tls_sessions_{ std::make_shared<io::tls_session_cache>() };
     asio::ssl::context tls_{ asio::ssl::context::tls_client };
     std::shared_ptr<io::http_session_manager> session_manager_;
+    // sessions are spread over the shards, while the timers of the commands and the internal handlers stay on ctx_
+    std::shared_ptr<io::io_context_pool> shards_{};
     std::optional<io::mcbp_session> session_{};
     std::shared_ptr<impl::dns_srv_tracker> dns_srv_tracker_{};
-    std::mutex buckets_mutex_{};
+    // lookups are much more frequent than opening or closing the buckets, so the readers should not block each other
+    std::shared_mutex buckets_mutex_{};
     std::map<std::string, std::shared_ptr<bucket>> buckets_{};
+    std::mutex read_latency_mutex_{};
+    std::map<std::string, std::shared_ptr<impl::active_read_latency>> read_latency_{};
+    std::mutex observe_probes_mutex_{};
+    std::shared_ptr<impl::observe_probe_coalescer> observe_probes_{};
     couchbase::core::origin origin_{};
     std::shared_ptr<couchbase::tracing::request_tracer> tracer_{ nullptr };
     std::shared_ptr<couchbase::metrics::meter> meter_{ nullptr };
@@ -19,6 +19,7 @@
 
 #include "core/io/dns_config.hxx"
 #include "core/io/ip_protocol.hxx"
+#include "core/io/mcbp_capture_options.hxx"
 #include "core/metrics/logging_meter_options.hxx"
 #include "core/tracing/threshold_logging_options.hxx"
 #include "core/transactions/attempt_context_testing_hooks.hxx"
@@ -60,6 +61,8 @@ struct cluster_options {
     bool enable_unordered_execution{ true };
     bool enable_clustermap_notification{ false };
     bool enable_compression{ true };
+    std::size_t compression_min_size{ 32 };
+    double compression_min_ratio{ 0.83 };
     bool enable_tracing{ true };
     bool enable_metrics{ true };
     std::string network{ "auto" };
@@ -75,14 +78,33 @@ struct cluster_options {
     std::chrono::milliseconds config_poll_floor = timeout_defaults::config_poll_floor;
     std::chrono::milliseconds config_idle_redial_timeout = timeout_defaults::config_idle_redial_timeout;
 
+    /**
+     * How long the resolved addresses (and the resolution failures) are reused by all sessions of the process. Zero disables caching.
+     */
+    std::chrono::milliseconds dns_cache_ttl = timeout_defaults::dns_cache_ttl;
+    std::chrono::milliseconds dns_negative_cache_ttl = timeout_defaults::dns_negative_cache_ttl;
+
+    /**
+     * Delay before the connection attempt to the next address of the node is started, while the previous attempt is still pending.
+     */
+    std::chrono::milliseconds connection_attempt_delay = timeout_defaults::connection_attempt_delay;
+
     std::size_t max_http_connections{ 0 };
     std::chrono::milliseconds idle_http_connection_timeout = timeout_defaults::idle_http_connection_timeout;
     std::string user_agent_extra{};
+
+    /**
+     * Number of IO contexts (each with its own thread) owned by the cluster. KV and HTTP sessions are spread over them, instead of
+     * sharing the IO context passed to the cluster. Zero disables sharding.
+     */
+    std::size_t io_shards{ 0 };
+    bool pin_io_shards{ false };
     couchbase::transactions::transactions_config::built transactions{};
 
     [[nodiscard]] std::chrono::milliseconds default_timeout_for(service_type type) const;
 
     bool dump_configuration{ false };
+    io::mcbp_capture_options mcbp_capture{};
     bool disable_mozilla_ca_certificates{ false };
     void apply_profile(std::string profile_name);
 };
@@ -30,19 +30,50 @@
 #include "protocol/client_opcode_fmt.hxx"
 #include "retry_orchestrator.hxx"
 #include "utils/binary.hxx"
-#include "utils/json.hxx"
 
 #include <fmt/core.h>
 
 #include <asio/io_context.hpp>
 #include <asio/steady_timer.hpp>
 
+#include <atomic>
+#include <functional>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+
 namespace couchbase::core
 {
 static auto
-build_key(std::string_view scope_name, std::string_view collection_name) -> std::string
+hash_key(std::string_view scope_name, std::string_view collection_name) -> std::size_t
+{
+    auto hash = std::hash<std::string_view>{}(scope_name);
+    hash ^= std::hash<std::string_view>{}(collection_name) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+static constexpr auto
+is_resolved(std::uint32_t id) -> bool
+{
+    return id != unknown_collection_id && id != pending_collection_id;
+}
+
+/**
+ * The body of range_scan_create is a JSON object generated by crud_component, so the collection could be spliced in as the first member,
+ * instead of parsing and generating the whole document again.
+ */
+static auto
+splice_range_scan_collection_id(std::vector<std::byte>& body, std::uint32_t collection_id) -> std::error_code
 {
-    return fmt::format("%s.%s", scope_name, collection_name);
+    if (body.size() < 2 || body.front() != std::byte{ '{' } || body.back() != std::byte{ '}' }) {
+        return errc::common::parsing_failure;
+    }
+    bool empty_object = body.size() == 2;
+    auto member = fmt::format(R"("collection":"{:x}"{})", collection_id, empty_object ? "" : ",");
+    body.insert(body.begin() + 1,
+                reinterpret_cast<const std::byte*>(member.data()),
+                reinterpret_cast<const std::byte*>(member.data() + member.size()));
+    return {};
 }
 
 class collection_id_cache_entry_impl
@@ -65,76 +96,81 @@ class collection_id_cache_entry_impl
     {
     }
 
+    [[nodiscard]] auto matches(std::string_view scope_name, std::string_view collection_name) const -> bool
+    {
+        return scope_name_ == scope_name && collection_name_ == collection_name;
+    }
+
     [[nodiscard]] auto dispatch(std::shared_ptr<mcbp::queue_request> req) -> std::error_code override
     {
+        // the collection id is known most of the time, and the requests could be sent without synchronizing with the refresh
+        if (auto id = get_id(); is_resolved(id)) {
+            return send_with_collection_id(std::move(req), id);
+        }
+
         /*
          * if the collection id is unknown then mark the request pending and refresh collection id first
          * if it is pending then queue request
          * otherwise send the request
          */
-        switch (std::scoped_lock lock(mutex_); id_) {
-            case unknown_collection_id:
-                CB_LOG_DEBUG("collection {}.{} unknown. refreshing id", req->scope_name_, req->collection_id_);
-                id_ = pending_collection_id;
-
-                if (auto ec = refresh_collection_id(req); ec) {
-                    id_ = unknown_collection_id;
-                    return ec;
-                }
-                return {};
-
-            case pending_collection_id:
-                CB_LOG_DEBUG("collection {}.{} pending. queueing request OP={}", req->scope_name_, req->collection_id_, req->command_);
-                return queue_->push(req, max_queue_size_);
-
-            default:
-                break;
+        std::uint32_t id{};
+        {
+            std::scoped_lock lock(mutex_);
+            switch (id = id_.load(std::memory_order_relaxed); id) {
+                case unknown_collection_id:
+                    CB_LOG_DEBUG("collection {}.{} unknown. refreshing id", req->scope_name_, req->collection_name_);
+                    id_.store(pending_collection_id, std::memory_order_release);
+
+                    if (auto ec = refresh_collection_id(req); ec) {
+                        id_.store(unknown_collection_id, std::memory_order_release);
+                        return ec;
+                    }
+                    return {};
+
+                case pending_collection_id:
+                    CB_LOG_DEBUG(
+                      "collection {}.{} pending. queueing request OP={}", req->scope_name_, req->collection_name_, req->command_);
+                    return queue_->push(req, max_queue_size_);
+
+                default:
+                    break;
+            }
         }
 
-        return send_with_collection_id(std::move(req));
+        return send_with_collection_id(std::move(req), id);
     }
 
     void reset_id() override
     {
         std::scoped_lock lock(mutex_);
-        if (id_ != unknown_collection_id && id_ != pending_collection_id) {
-            id_ = unknown_collection_id;
+        if (is_resolved(id_.load(std::memory_order_relaxed))) {
+            id_.store(unknown_collection_id, std::memory_order_release);
         }
     }
 
     void set_id(std::uint32_t id)
     {
         std::scoped_lock lock(mutex_);
-        id_ = id;
+        id_.store(id, std::memory_order_release);
     }
 
-    [[nodiscard]] auto get_id() -> std::uint32_t
+    [[nodiscard]] auto get_id() const -> std::uint32_t
     {
-        std::scoped_lock lock(mutex_);
-        return id_;
+        return id_.load(std::memory_order_acquire);
     }
 
-    [[nodiscard]] auto assign_collection_id(std::shared_ptr<mcbp::queue_request> req) -> std::error_code
+    [[nodiscard]] static auto assign_collection_id(mcbp::queue_request& req, std::uint32_t collection_id) -> std::error_code
     {
-        auto collection_id = get_id();
-        if (req->command_ == protocol::client_opcode::range_scan_create) {
-            tao::json::value body;
-            try {
-                body = utils::json::parse_binary(req->value_);
-            } catch (const tao::pegtl::parse_error&) {
-                return errc::common::parsing_failure;
-            }
-            body["collection"] = fmt::format("{:x}", collection_id);
-            req->value_ = utils::json::generate_binary(body);
-            return {};
+        if (req.command_ == protocol::client_opcode::range_scan_create) {
+            return splice_range_scan_collection_id(req.value_, collection_id);
         }
-        req->collection_id_ = collection_id;
+        req.collection_id_ = collection_id;
         return {};
     }
 
-    [[nodiscard]] auto send_with_collection_id(std::shared_ptr<mcbp::queue_request> req) -> std::error_code
+    [[nodiscard]] auto send_with_collection_id(std::shared_ptr<mcbp::queue_request> req, std::uint32_t collection_id) -> std::error_code
     {
-        if (auto ec = assign_collection_id(req); ec) {
+        if (auto ec = assign_collection_id(*req, collection_id); ec) {
             CB_LOG_DEBUG("failed to set collection ID \"{}.{}\" on request (OP={}): {}",
                          req->scope_name_,
                          req->collection_name_,
@@ -165,7 +201,7 @@ class collection_id_cache_entry_impl
     const std::string scope_name_;
     const std::string collection_name_;
     const std::size_t max_queue_size_;
-    std::uint32_t id_;
+    std::atomic_uint32_t id_;
     mutable std::recursive_mutex mutex_{};
     std::unique_ptr<mcbp::operation_queue> queue_{ std::make_unique<mcbp::operation_queue>() };
 };
@@ -180,41 +216,50 @@ class collections_component_impl : public std::enable_shared_from_this<collectio
     {
     }
 
-    auto get_and_maybe_insert(std::string scope_name, std::string collection_name, std::uint32_t id)
+    auto get_and_maybe_insert(std::string_view scope_name, std::string_view collection_name, std::uint32_t id)
       -> std::shared_ptr<collection_id_cache_entry>
     {
-        std::scoped_lock lock(cache_mutex_);
-        auto key = build_key(scope_name, collection_name);
+        auto hash = hash_key(scope_name, collection_name);
+        {
+            std::shared_lock lock(cache_mutex_);
+            if (auto entry = find(hash, scope_name, collection_name); entry) {
+                return entry;
+            }
+        }
 
-        if (auto it = cache_.find(key); it != cache_.end()) {
-            return it->second;
+        std::scoped_lock lock(cache_mutex_);
+        if (auto entry = find(hash, scope_name, collection_name); entry) {
+            return entry;
         }
         auto entry = std::make_shared<collection_id_cache_entry_impl>(
-          shared_from_this(), dispatcher_, std::move(scope_name), std::move(collection_name), max_queue_size_, id);
-        cache_.try_emplace(key, entry);
+          shared_from_this(), dispatcher_, std::string{ scope_name }, std::string{ collection_name }, max_queue_size_, id);
+        cache_.emplace(hash, entry);
         return entry;
     }
 
     void remove(std::string_view scope_name, std::string_view collection_name)
     {
         std::scoped_lock lock(cache_mutex_);
-        cache_.erase(build_key(scope_name, collection_name));
+        auto [begin, end] = cache_.equal_range(hash_key(scope_name, collection_name));
+        for (auto it = begin; it != end; ++it) {
+            if (it->second->matches(scope_name, collection_name)) {
+                cache_.erase(it);
+                return;
+            }
+        }
     }
 
-    void upsert(std::string scope_name, std::string collection_name, std::uint32_t id)
+    void upsert(std::string_view scope_name, std::string_view collection_name, std::uint32_t id)
     {
+        auto hash = hash_key(scope_name, collection_name);
         std::scoped_lock lock(cache_mutex_);
-
-        auto key = build_key(scope_name, collection_name);
-
-        if (auto it = cache_.find(key); it != cache_.end()) {
-            it->second->set_id(id);
+        if (auto entry = find(hash, scope_name, collection_name); entry) {
+            entry->set_id(id);
             return;
         }
-
-        cache_.try_emplace(key,
-                           std::make_shared<collection_id_cache_entry_impl>(
-                             shared_from_this(), dispatcher_, std::move(scope_name), std::move(collection_name), max_queue_size_, id));
+        cache_.emplace(hash,
+                       std::make_shared<collection_id_cache_entry_impl>(
+                         shared_from_this(), dispatcher_, std::string{ scope_name }, std::string{ collection_name }, max_queue_size_, id));
     }
 
     auto handle_collection_unknown(std::shared_ptr<mcbp::queue_request> request) -> bool
@@ -321,11 +366,27 @@ class collections_component_impl : public std::enable_shared_from_this<collectio
     }
 
   private:
+    /**
+     * Must be called with cache_mutex_ held.
+     */
+    [[nodiscard]] auto find(std::size_t hash, std::string_view scope_name, std::string_view collection_name) const
+      -> std::shared_ptr<collection_id_cache_entry_impl>
+    {
+        auto [begin, end] = cache_.equal_range(hash);
+        for (auto it = begin; it != end; ++it) {
+            if (it->second->matches(scope_name, collection_name)) {
+                return it->second;
+            }
+        }
+        return nullptr;
+    }
+
     asio::io_context& io_;
     const dispatcher dispatcher_;
     const std::size_t max_queue_size_;
-    std::map<std::string, std::shared_ptr<collection_id_cache_entry_impl>, std::less<>> cache_{};
-    mutable std::mutex cache_mutex_{};
+    // entries are keyed by hash of (scope, collection), so the lookup does not have to build the composite key
+    std::unordered_multimap<std::size_t, std::shared_ptr<collection_id_cache_entry_impl>> cache_{};
+    mutable std::shared_mutex cache_mutex_{};
 };
 
 auto
@@ -380,8 +441,8 @@ collection_id_cache_entry_impl::refresh_collection_id(std::shared_ptr<mcbp::queu
                        res.collection_id);
           auto queue = self->swap_queue();
           queue->close();
-          return queue->drain([self](auto r) {
-              if (auto ec = self->assign_collection_id(r); ec) {
+          return queue->drain([self, collection_id = self->get_id()](auto r) {
+              if (auto ec = assign_collection_id(*r, collection_id); ec) {
                   CB_LOG_DEBUG("failed to set collection ID \"{}.{}\" on request (OP={}): {}",
                                r->scope_name_,
                                r->collection_name_,
@@ -21,14 +21,17 @@
 
 #include "core/logger/logger.hxx"
 #include "core/mcbp/buffer_writer.hxx"
+#include "core/protocol/compression.hxx"
 #include "core/protocol/datatype.hxx"
+#include "core/protocol/status.hxx"
+#include "core/tracing/constants.hxx"
+#include "core/tracing/noop_tracer.hxx"
 #include "core/utils/binary.hxx"
 #include "core/utils/unsigned_leb128.hxx"
 #include "mcbp/big_endian.hxx"
 #include "mcbp/queue_request.hxx"
 #include "mcbp/queue_response.hxx"
 #include "platform/base64.h"
-#include "snappy.h"
 #include "timeout_defaults.hxx"
 #include "utils/json.hxx"
 
@@ -39,6 +42,8 @@
 
 #include <tl/expected.hpp>
 
+#include <limits>
+
 namespace couchbase::core
 {
 static std::pair<std::vector<std::byte>, std::error_code>
@@ -88,7 +93,7 @@ serialize_range_scan_create_options(const range_scan_create_options& options)
 }
 
 auto
-parse_range_scan_keys(gsl::span<std::byte> data, range_scan_item_callback&& item_callback) -> std::error_code
+parse_range_scan_keys(gsl::span<std::byte> data, range_scan_item_view_callback&& item_callback) -> std::error_code
 {
     do {
         if (data.empty()) {
@@ -98,7 +103,7 @@ parse_range_scan_keys(gsl::span<std::byte> data, range_scan_item_callback&& item
         if (remaining.size() < key_length) {
             return errc::network::protocol_error;
         }
-        item_callback(range_scan_item{ { remaining.begin(), remaining.begin() + static_cast<std::ptrdiff_t>(key_length) } });
+        item_callback(range_scan_item_view{ remaining.first(key_length) });
         if (remaining.size() == key_length) {
             return {};
         }
@@ -108,14 +113,17 @@ parse_range_scan_keys(gsl::span<std::byte> data, range_scan_item_callback&& item
 }
 
 auto
-parse_range_scan_documents(gsl::span<std::byte> data, range_scan_item_callback&& item_callback) -> std::error_code
+parse_range_scan_documents(gsl::span<std::byte> data, range_scan_item_view_callback&& item_callback) -> std::error_code
 {
+    // snappy-compressed values are inflated into this buffer, so it is reused for all values of the batch
+    std::vector<std::byte> uncompressed{};
+
     do {
         if (data.empty()) {
             return {};
         }
 
-        range_scan_item_body body{};
+        range_scan_item_body_view body{};
         static constexpr std::size_t header_offset =
           sizeof(body.flags) + sizeof(body.expiry) + sizeof(body.sequence_number) + sizeof(body.cas) + sizeof(body.datatype);
 
@@ -130,13 +138,13 @@ parse_range_scan_documents(gsl::span<std::byte> data, range_scan_item_callback&&
         body.datatype = data[24];
         data = gsl::make_span(data.data() + header_offset, data.size() - header_offset);
 
-        std::vector<std::byte> key{};
+        gsl::span<const std::byte> key{};
         {
             auto [key_length, remaining] = utils::decode_unsigned_leb128<std::size_t>(data, core::utils::leb_128_no_throw{});
             if (remaining.size() < key_length) {
                 return errc::network::protocol_error;
             }
-            key = { remaining.begin(), remaining.begin() + static_cast<std::ptrdiff_t>(key_length) };
+            key = remaining.first(key_length);
             data = gsl::make_span(remaining.data() + key_length, remaining.size() - key_length);
         }
 
@@ -145,24 +153,24 @@ parse_range_scan_documents(gsl::span<std::byte> data, range_scan_item_callback&&
             if (remaining.size() < value_length) {
                 return errc::network::protocol_error;
             }
-            body.value = { remaining.begin(), remaining.begin() + static_cast<std::ptrdiff_t>(value_length) };
+            body.value = remaining.first(value_length);
             if ((body.datatype & static_cast<std::byte>(protocol::datatype::snappy)) != std::byte{ 0 }) {
-                std::string uncompressed;
-                if (snappy::Uncompress(reinterpret_cast<const char*>(body.value.data()), body.value.size(), &uncompressed)) {
-                    body.value = core::utils::to_binary(uncompressed);
+                uncompressed.clear();
+                if (protocol::decompress_value(body.value, uncompressed)) {
+                    body.value = gsl::make_span(uncompressed.data(), uncompressed.size());
                     body.datatype &= ~static_cast<std::byte>(protocol::datatype::snappy);
                 }
             }
             data = gsl::make_span(remaining.data() + value_length, remaining.size() - value_length);
         }
 
-        item_callback(range_scan_item{ std::move(key), std::move(body) });
+        item_callback(range_scan_item_view{ key, body });
     } while (!data.empty());
     return {};
 }
 
 auto
-parse_range_scan_data(gsl::span<std::byte> payload, range_scan_item_callback&& items, bool keys_only) -> std::error_code
+parse_range_scan_data(gsl::span<std::byte> payload, range_scan_item_view_callback&& items, bool keys_only) -> std::error_code
 {
     if (keys_only) {
         return parse_range_scan_keys(payload, std::move(items));
@@ -170,15 +178,569 @@ parse_range_scan_data(gsl::span<std::byte> payload, range_scan_item_callback&& i
     return parse_range_scan_documents(payload, std::move(items));
 }
 
-class crud_component_impl
+static auto
+effective_timeout(std::chrono::milliseconds timeout, couchbase::durability_level level = couchbase::durability_level::none)
+  -> std::chrono::milliseconds
+{
+    if (timeout != std::chrono::milliseconds::zero()) {
+        return timeout;
+    }
+    if (level != couchbase::durability_level::none) {
+        return timeout_defaults::key_value_durable_timeout;
+    }
+    return timeout_defaults::key_value_timeout;
+}
+
+static void
+apply_durability(mcbp::queue_request& req, couchbase::durability_level level, std::chrono::milliseconds timeout)
+{
+    if (level == couchbase::durability_level::none) {
+        return;
+    }
+    req.durability_level_frame_ = mcbp::durability_level_frame{ static_cast<mcbp::durability_level>(level) };
+    if (timeout != std::chrono::milliseconds::zero()) {
+        req.durability_timeout_frame_ = mcbp::durability_timeout_frame{ timeout };
+    }
+}
+
+static auto
+extract_resource_units(const mcbp::queue_response& resp) -> std::optional<resource_unit_result>
+{
+    if (!resp.read_units_frame_ && !resp.write_units_frame_) {
+        return {};
+    }
+    resource_unit_result units{};
+    if (resp.read_units_frame_) {
+        units.read_units = resp.read_units_frame_->read_units;
+    }
+    if (resp.write_units_frame_) {
+        units.write_units = resp.write_units_frame_->write_units;
+    }
+    return units;
+}
+
+static auto
+extract_mutation_token(mcbp::queue_response& resp, const mcbp::queue_request& req, const std::string& bucket_name) -> mutation_token
+{
+    if (resp.extras_.size() < 2 * sizeof(std::uint64_t)) {
+        return {};
+    }
+    return mutation_token{
+        mcbp::big_endian::read_uint64(resp.extras_, 0),
+        mcbp::big_endian::read_uint64(resp.extras_, 8),
+        req.vbucket_,
+        bucket_name,
+    };
+}
+
+static auto
+extract_flags(mcbp::queue_response& resp) -> std::uint32_t
+{
+    if (resp.extras_.size() < sizeof(std::uint32_t)) {
+        return 0;
+    }
+    return mcbp::big_endian::read_uint32(resp.extras_, 0);
+}
+
+static auto
+encode_lookup_in_specs(const std::vector<subdoc_operation>& operations) -> std::vector<std::byte>
+{
+    std::size_t size{ 0 };
+    for (const auto& op : operations) {
+        size += sizeof(std::uint8_t) + sizeof(std::uint8_t) + sizeof(std::uint16_t) + op.path.size();
+    }
+    mcbp::buffer_writer buf{ size };
+    for (const auto& op : operations) {
+        buf.write_byte(static_cast<std::byte>(op.opcode));
+        buf.write_byte(static_cast<std::byte>(op.flags));
+        buf.write_uint16(gsl::narrow_cast<std::uint16_t>(op.path.size()));
+        buf.write(reinterpret_cast<const std::byte*>(op.path.data()), op.path.size());
+    }
+    return std::move(buf.store_);
+}
+
+static auto
+encode_mutate_in_specs(const std::vector<subdoc_operation>& operations) -> std::vector<std::byte>
+{
+    std::size_t size{ 0 };
+    for (const auto& op : operations) {
+        size += sizeof(std::uint8_t) + sizeof(std::uint8_t) + sizeof(std::uint16_t) + sizeof(std::uint32_t) + op.path.size() +
+                op.value.size();
+    }
+    mcbp::buffer_writer buf{ size };
+    for (const auto& op : operations) {
+        buf.write_byte(static_cast<std::byte>(op.opcode));
+        buf.write_byte(static_cast<std::byte>(op.flags));
+        buf.write_uint16(gsl::narrow_cast<std::uint16_t>(op.path.size()));
+        buf.write_uint32(gsl::narrow_cast<std::uint32_t>(op.value.size()));
+        buf.write(reinterpret_cast<const std::byte*>(op.path.data()), op.path.size());
+        buf.write(op.value);
+    }
+    return std::move(buf.store_);
+}
+
+static auto
+parse_lookup_in_results(gsl::span<std::byte> data, std::size_t number_of_operations)
+  -> tl::expected<std::vector<subdoc_result>, std::error_code>
+{
+    std::vector<subdoc_result> results{};
+    results.reserve(number_of_operations);
+    std::size_t offset{ 0 };
+    for (std::size_t i = 0; i < number_of_operations; ++i) {
+        if (data.size() < offset + sizeof(std::uint16_t) + sizeof(std::uint32_t)) {
+            return tl::unexpected(errc::network::protocol_error);
+        }
+        auto status = mcbp::big_endian::read_uint16(data, offset);
+        auto length = mcbp::big_endian::read_uint32(data, offset + sizeof(std::uint16_t));
+        offset += sizeof(std::uint16_t) + sizeof(std::uint32_t);
+        if (data.size() < offset + length) {
+            return tl::unexpected(errc::network::protocol_error);
+        }
+        auto& result = results.emplace_back();
+        result.error = protocol::map_status_code(protocol::client_opcode::subdoc_multi_lookup, status);
+        result.value.assign(data.data() + offset, data.data() + offset + length);
+        offset += length;
+    }
+    return results;
+}
+
+/**
+ * The server sends only the entries, that either carry a value or describe the failure, so the results are indexed by the operation.
+ *
+ * @return the error of the failed operation in case of subdoc_multi_path_failure
+ */
+static auto
+parse_mutate_in_results(gsl::span<std::byte> data, std::vector<subdoc_result>& results) -> std::error_code
+{
+    std::size_t offset{ 0 };
+    while (offset < data.size()) {
+        if (data.size() < offset + sizeof(std::uint8_t) + sizeof(std::uint16_t)) {
+            return errc::network::protocol_error;
+        }
+        auto index = mcbp::big_endian::read_uint8(data, offset);
+        auto status = mcbp::big_endian::read_uint16(data, offset + sizeof(std::uint8_t));
+        offset += sizeof(std::uint8_t) + sizeof(std::uint16_t);
+        if (index >= results.size()) {
+            return errc::network::protocol_error;
+        }
+        auto& result = results[index];
+        result.error = protocol::map_status_code(protocol::client_opcode::subdoc_multi_mutation, status);
+        if (status != static_cast<std::uint16_t>(key_value_status_code::success)) {
+            return result.error;
+        }
+        if (data.size() < offset + sizeof(std::uint32_t)) {
+            return errc::network::protocol_error;
+        }
+        auto length = mcbp::big_endian::read_uint32(data, offset);
+        offset += sizeof(std::uint32_t);
+        if (data.size() < offset + length) {
+            return errc::network::protocol_error;
+        }
+        result.value.assign(data.data() + offset, data.data() + offset + length);
+        offset += length;
+    }
+    return {};
+}
+
+template<typename Result>
+static auto
+make_document_result(mcbp::queue_response& resp) -> Result
+{
+    Result res{};
+    res.value = std::move(resp.value_);
+    res.flags = extract_flags(resp);
+    res.data_type = std::to_integer<std::uint8_t>(resp.datatype_);
+    res.cas = couchbase::cas{ resp.cas_ };
+    res.internal.resource_units = extract_resource_units(resp);
+    return res;
+}
+
+template<typename Result>
+static auto
+make_mutation_result(mcbp::queue_response& resp, const mcbp::queue_request& req, const std::string& bucket_name) -> Result
+{
+    Result res{};
+    res.cas = couchbase::cas{ resp.cas_ };
+    res.token = extract_mutation_token(resp, req, bucket_name);
+    res.internal.resource_units = extract_resource_units(resp);
+    return res;
+}
+
+static auto
+encode_uint32(std::uint32_t value) -> std::vector<std::byte>
+{
+    mcbp::buffer_writer buf{ sizeof(value) };
+    buf.write_uint32(value);
+    return std::move(buf.store_);
+}
+
+static auto
+encode_storage_extras(std::uint32_t flags, std::uint32_t expiry) -> std::vector<std::byte>
+{
+    mcbp::buffer_writer buf{ sizeof(flags) + sizeof(expiry) };
+    buf.write_uint32(flags);
+    buf.write_uint32(expiry);
+    return std::move(buf.store_);
+}
+
+static auto
+encode_counter_extras(const counter_options& options) -> std::vector<std::byte>
+{
+    mcbp::buffer_writer buf{ sizeof(std::uint64_t) * 2 + sizeof(std::uint32_t) };
+    buf.write_uint64(options.delta);
+    if (options.initial_value == std::numeric_limits<std::uint64_t>::max()) {
+        // the document must not be created, when it does not exist
+        buf.write_uint64(0);
+        buf.write_uint32(std::numeric_limits<std::uint32_t>::max());
+    } else {
+        buf.write_uint64(options.initial_value);
+        buf.write_uint32(options.expiry);
+    }
+    return std::move(buf.store_);
+}
+
+template<typename Options>
+static auto
+encode_with_meta_extras(const Options& options) -> std::vector<std::byte>
+{
+    mcbp::buffer_writer buf{ sizeof(std::uint32_t) * 3 + sizeof(std::uint64_t) * 2 + sizeof(std::uint16_t) };
+    buf.write_uint32(options.flags);
+    buf.write_uint32(options.expiry);
+    buf.write_uint64(options.revision_number);
+    buf.write_uint64(options.cas.value());
+    buf.write_uint32(options.options);
+    buf.write_uint16(gsl::narrow_cast<std::uint16_t>(options.extra.size()));
+    return std::move(buf.store_);
+}
+
+static auto
+concat(std::vector<std::byte>&& value, const std::vector<std::byte>& extra) -> std::vector<std::byte>
+{
+    value.insert(value.end(), extra.begin(), extra.end());
+    return std::move(value);
+}
+
+class crud_component_impl : public std::enable_shared_from_this<crud_component_impl>
 {
   public:
-    crud_component_impl(asio::io_context& io, collections_component collections, std::shared_ptr<retry_strategy> default_retry_strategy)
+    crud_component_impl(asio::io_context& io,
+                        std::string bucket_name,
+                        collections_component collections,
+                        std::shared_ptr<retry_strategy> default_retry_strategy,
+                        std::shared_ptr<couchbase::tracing::request_tracer> tracer)
       : io_{ io }
+      , bucket_name_{ std::move(bucket_name) }
       , collections_{ std::move(collections) }
       , default_retry_strategy_{ std::move(default_retry_strategy) }
+      , tracer_{ tracer ? std::move(tracer) : std::make_shared<tracing::noop_tracer>() }
+    {
+    }
+
+    auto get(get_options options, get_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
-        (void)io_;
+        auto req = make_document_request(protocol::client_opcode::get, options, document_handler<get_result>(std::move(callback)));
+        return dispatch(std::move(req), effective_timeout(options.timeout));
+    }
+
+    auto get_and_touch(get_and_touch_options options, get_and_touch_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    {
+        auto req = make_document_request(
+          protocol::client_opcode::get_and_touch, options, document_handler<get_and_touch_result>(std::move(callback)));
+        req->extras_ = encode_uint32(options.expiry);
+        return dispatch(std::move(req), effective_timeout(options.timeout));
+    }
+
+    auto get_and_lock(get_and_lock_options options, get_and_lock_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    {
+        auto req = make_document_request(
+          protocol::client_opcode::get_and_lock, options, document_handler<get_and_lock_result>(std::move(callback)));
+        req->extras_ = encode_uint32(options.lock_time);
+        return dispatch(std::move(req), effective_timeout(options.timeout));
+    }
+
+    auto get_one_replica(get_one_replica_options options, get_one_replica_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    {
+        if (options.replica_index == 0) {
+            return tl::unexpected(errc::common::invalid_argument);
+        }
+        auto req = make_document_request(
+          protocol::client_opcode::get_replica, options, document_handler<get_one_replica_result>(std::move(callback)));
+        req->replica_index_ = options.replica_index;
+        return dispatch(std::move(req), effective_timeout(options.timeout));
+    }
+
+    auto touch(touch_options options, touch_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    {
+        auto req = make_document_request(protocol::client_opcode::touch, options, mutation_handler<touch_result>(std::move(callback)));
+        req->extras_ = encode_uint32(options.expiry);
+        return dispatch(std::move(req), effective_timeout(options.timeout));
+    }
+
+    auto unlock(unlock_options options, unlock_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    {
+        auto req = make_document_request(protocol::client_opcode::unlock, options, mutation_handler<unlock_result>(std::move(callback)));
+        req->cas_ = options.cas.value();
+        return dispatch(std::move(req), effective_timeout(options.timeout));
+    }
+
+    auto remove(remove_options options, remove_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    {
+        auto req = make_document_request(protocol::client_opcode::remove, options, mutation_handler<remove_result>(std::move(callback)));
+        req->cas_ = options.cas.value();
+        apply_durability(*req, options.durability_level, options.durability_level_timeout);
+        return dispatch(std::move(req), effective_timeout(options.timeout, options.durability_level));
+    }
+
+    auto insert(insert_options options, insert_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    {
+        auto req = make_document_request(protocol::client_opcode::insert, options, mutation_handler<insert_result>(std::move(callback)));
+        req->extras_ = encode_storage_extras(options.flags, options.expiry);
+        req->datatype_ = static_cast<std::byte>(options.data_type);
+        req->value_ = std::move(options.value);
+        apply_durability(*req, options.durability_level, options.durability_level_timeout);
+        return dispatch(std::move(req), effective_timeout(options.timeout, options.durability_level));
+    }
+
+    auto upsert(upsert_options options, upsert_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    {
+        auto req = make_document_request(protocol::client_opcode::upsert, options, mutation_handler<upsert_result>(std::move(callback)));
+        req->extras_ = encode_storage_extras(options.flags, options.expiry);
+        req->datatype_ = static_cast<std::byte>(options.data_type);
+        req->value_ = std::move(options.value);
+        if (options.preserve_expiry) {
+            req->preserve_expiry_frame_ = mcbp::preserve_expiry_frame{};
+        }
+        apply_durability(*req, options.durability_level, options.durability_level_timeout);
+        return dispatch(std::move(req), effective_timeout(options.timeout, options.durability_level));
+    }
+
+    auto replace(replace_options options, replace_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    {
+        auto req =
+          make_document_request(protocol::client_opcode::replace, options, mutation_handler<replace_result>(std::move(callback)));
+        req->extras_ = encode_storage_extras(options.flags, options.expiry);
+        req->datatype_ = static_cast<std::byte>(options.data_type);
+        req->value_ = std::move(options.value);
+        req->cas_ = options.cas.value();
+        if (options.preserve_expiry) {
+            req->preserve_expiry_frame_ = mcbp::preserve_expiry_frame{};
+        }
+        apply_durability(*req, options.durability_level, options.durability_level_timeout);
+        return dispatch(std::move(req), effective_timeout(options.timeout, options.durability_level));
+    }
+
+    auto adjoin(protocol::client_opcode opcode, adjoin_options options, adjoin_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    {
+        auto req = make_document_request(opcode, options, mutation_handler<adjoin_result>(std::move(callback)));
+        req->value_ = std::move(options.value);
+        req->cas_ = options.cas.value();
+        apply_durability(*req, options.durability_level, options.durability_level_timeout);
+        return dispatch(std::move(req), effective_timeout(options.timeout, options.durability_level));
+    }
+
+    auto counter(protocol::client_opcode opcode, counter_options options, counter_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    {
+        auto handler = [self = shared_from_this(), cb = std::move(callback)](std::shared_ptr<mcbp::queue_response> resp,
+                                                                             std::shared_ptr<mcbp::queue_request> req,
+                                                                             std::error_code error) mutable {
+            if (error) {
+                return cb({}, error);
+            }
+            if (resp->value_.size() != sizeof(std::uint64_t)) {
+                return cb({}, errc::network::protocol_error);
+            }
+            counter_result res{};
+            res.value = mcbp::big_endian::read_uint64(resp->value_, 0);
+            res.cas = couchbase::cas{ resp->cas_ };
+            res.token = extract_mutation_token(*resp, *req, self->bucket_name_);
+            res.internal.resource_units = extract_resource_units(*resp);
+            return cb(std::move(res), {});
+        };
+        auto req = make_document_request(opcode, options, std::move(handler));
+        req->extras_ = encode_counter_extras(options);
+        apply_durability(*req, options.durability_level, options.durability_level_timeout);
+        return dispatch(std::move(req), effective_timeout(options.timeout, options.durability_level));
+    }
+
+    auto get_random(get_random_options options, get_random_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    {
+        // the key is not known upfront, so the request is routed by the vbucket, and the collection goes into the extras
+        auto req = make_request(protocol::client_opcode::get_random_key, options, document_handler<get_random_result>(std::move(callback)));
+        req->scope_name_ = std::move(options.scope_name);
+        req->collection_name_ = std::move(options.collection_name);
+        req->collection_id_ = options.collection_id;
+        return dispatch(std::move(req), effective_timeout(options.timeout));
+    }
+
+    auto get_with_meta(get_with_meta_options options, get_with_meta_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    {
+        auto handler = [cb = std::move(callback)](std::shared_ptr<mcbp::queue_response> resp,
+                                                  std::shared_ptr<mcbp::queue_request> /* req */,
+                                                  std::error_code error) mutable {
+            if (error) {
+                return cb({}, error);
+            }
+            static constexpr std::size_t meta_size{ sizeof(std::uint32_t) * 3 + sizeof(std::uint64_t) };
+            if (resp->extras_.size() < meta_size) {
+                return cb({}, errc::network::protocol_error);
+            }
+            get_with_meta_result res{};
+            res.deleted = mcbp::big_endian::read_uint32(resp->extras_, 0);
+            res.flags = mcbp::big_endian::read_uint32(resp->extras_, 4);
+            res.expiry = mcbp::big_endian::read_uint32(resp->extras_, 8);
+            res.sequence_number = mcbp::big_endian::read_uint64(resp->extras_, 12);
+            res.data_type = resp->extras_.size() > meta_size ? mcbp::big_endian::read_uint8(resp->extras_, meta_size)
+                                                             : std::to_integer<std::uint8_t>(resp->datatype_);
+            res.value = std::move(resp->value_);
+            res.cas = couchbase::cas{ resp->cas_ };
+            res.internal.resource_units = extract_resource_units(*resp);
+            return cb(std::move(res), {});
+        };
+        auto req = make_document_request(protocol::client_opcode::get_meta, options, std::move(handler));
+        // version 2 of the request asks the server to include datatype into the response
+        req->extras_ = { std::byte{ 0x02 } };
+        return dispatch(std::move(req), effective_timeout(options.timeout));
+    }
+
+    auto upsert_with_meta(upsert_with_meta_options options, upsert_with_meta_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    {
+        auto req = make_document_request(
+          protocol::client_opcode::upsert_with_meta, options, mutation_handler<upsert_with_meta_result>(std::move(callback)));
+        req->extras_ = encode_with_meta_extras(options);
+        req->datatype_ = static_cast<std::byte>(options.data_type);
+        req->value_ = concat(std::move(options.value), options.extra);
+        return dispatch(std::move(req), effective_timeout(options.timeout));
+    }
+
+    auto remove_with_meta(remove_with_meta_options options, remove_with_meta_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    {
+        auto req = make_document_request(
+          protocol::client_opcode::remove_with_meta, options, mutation_handler<remove_with_meta_result>(std::move(callback)));
+        req->extras_ = encode_with_meta_extras(options);
+        req->datatype_ = static_cast<std::byte>(options.data_type);
+        req->value_ = concat(std::move(options.value), options.extra);
+        return dispatch(std::move(req), effective_timeout(options.timeout));
+    }
+
+    auto observe_seqno(observe_seqno_options options, observe_seqno_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    {
+        auto handler = [cb = std::move(callback)](std::shared_ptr<mcbp::queue_response> resp,
+                                                  std::shared_ptr<mcbp::queue_request> /* req */,
+                                                  std::error_code error) mutable {
+            if (error) {
+                return cb({}, error);
+            }
+            static constexpr std::size_t body_size{ sizeof(std::uint8_t) + sizeof(std::uint16_t) + sizeof(std::uint64_t) * 3 };
+            if (resp->value_.size() < body_size) {
+                return cb({}, errc::network::protocol_error);
+            }
+            observe_seqno_result res{};
+            res.did_failover = mcbp::big_endian::read_uint8(resp->value_, 0) != 0;
+            res.vbucket_id = mcbp::big_endian::read_uint16(resp->value_, 1);
+            res.vbucket_uuid = mcbp::big_endian::read_uint64(resp->value_, 3);
+            res.persist_sequence_number = mcbp::big_endian::read_uint64(resp->value_, 11);
+            res.current_sequence_number = mcbp::big_endian::read_uint64(resp->value_, 19);
+            if (res.did_failover) {
+                if (resp->value_.size() < body_size + sizeof(std::uint64_t) * 2) {
+                    return cb({}, errc::network::protocol_error);
+                }
+                res.old_vbucket_uuid = mcbp::big_endian::read_uint64(resp->value_, 27);
+                res.last_sequence_number = mcbp::big_endian::read_uint64(resp->value_, 35);
+            }
+            res.internal.resource_units = extract_resource_units(*resp);
+            return cb(std::move(res), {});
+        };
+        auto req = make_request(protocol::client_opcode::observe_seqno, options, std::move(handler));
+        req->vbucket_ = options.vbucket_id;
+        req->replica_index_ = options.replica_index;
+        mcbp::buffer_writer buf{ sizeof(options.vbucket_uuid) };
+        buf.write_uint64(options.vbucket_uuid);
+        req->value_ = std::move(buf.store_);
+        return dispatch(std::move(req), effective_timeout(options.timeout));
+    }
+
+    auto lookup_in(lookup_in_options options, lookup_in_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    {
+        if (options.operations.empty()) {
+            return tl::unexpected(errc::common::invalid_argument);
+        }
+        auto handler = [cb = std::move(callback), number_of_operations = options.operations.size()](
+                         std::shared_ptr<mcbp::queue_response> resp,
+                         std::shared_ptr<mcbp::queue_request> /* req */,
+                         std::error_code error) mutable {
+            if (error) {
+                return cb({}, error);
+            }
+            auto results = parse_lookup_in_results(resp->value_, number_of_operations);
+            if (!results) {
+                return cb({}, results.error());
+            }
+            lookup_in_result res{};
+            res.results = std::move(results.value());
+            res.cas = couchbase::cas{ resp->cas_ };
+            res.internal.is_deleted = resp->status_code_ == key_value_status_code::subdoc_success_deleted ||
+                                      resp->status_code_ == key_value_status_code::subdoc_multi_path_failure_deleted;
+            res.internal.resource_units = extract_resource_units(*resp);
+            return cb(std::move(res), {});
+        };
+        auto req = make_document_request(protocol::client_opcode::subdoc_multi_lookup, options, std::move(handler));
+        if (options.flags != 0) {
+            req->extras_ = { std::byte{ options.flags } };
+        }
+        req->value_ = encode_lookup_in_specs(options.operations);
+        return dispatch(std::move(req), effective_timeout(options.timeout));
+    }
+
+    auto mutate_in(mutate_in_options options, mutate_in_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    {
+        if (options.operations.empty()) {
+            return tl::unexpected(errc::common::invalid_argument);
+        }
+        auto handler = [self = shared_from_this(), cb = std::move(callback), number_of_operations = options.operations.size()](
+                         std::shared_ptr<mcbp::queue_response> resp,
+                         std::shared_ptr<mcbp::queue_request> req,
+                         std::error_code error) mutable {
+            if (error) {
+                return cb({}, error);
+            }
+            mutate_in_result res{};
+            res.results.resize(number_of_operations);
+            if (auto ec = parse_mutate_in_results(resp->value_, res.results); ec) {
+                return cb(std::move(res), ec);
+            }
+            res.cas = couchbase::cas{ resp->cas_ };
+            res.token = extract_mutation_token(*resp, *req, self->bucket_name_);
+            res.internal.resource_units = extract_resource_units(*resp);
+            return cb(std::move(res), {});
+        };
+        auto req = make_document_request(protocol::client_opcode::subdoc_multi_mutation, options, std::move(handler));
+        if (options.expiry != 0 || options.flags != 0) {
+            mcbp::buffer_writer buf{ (options.expiry != 0 ? sizeof(options.expiry) : 0) +
+                                     (options.flags != 0 ? sizeof(options.flags) : 0) };
+            if (options.expiry != 0) {
+                buf.write_uint32(options.expiry);
+            }
+            if (options.flags != 0) {
+                buf.write_byte(std::byte{ options.flags });
+            }
+            req->extras_ = std::move(buf.store_);
+        }
+        req->value_ = encode_mutate_in_specs(options.operations);
+        req->cas_ = options.cas.value();
+        apply_durability(*req, options.durability_level, options.durability_level_timeout);
+        return dispatch(std::move(req), effective_timeout(options.timeout, options.durability_level));
     }
 
     auto range_scan_create(std::uint16_t vbucket_id, const range_scan_create_options& options, range_scan_create_callback&& callback)
@@ -201,36 +763,21 @@ class crud_component_impl
         req->vbucket_ = vbucket_id;
         req->scope_name_ = options.scope_name;
         req->collection_name_ = options.collection_name;
+        // the body already has the collection, when the id is known, so the request does not need to go through the cache
+        req->collection_id_ = options.collection_id;
         if (auto [value, ec] = serialize_range_scan_create_options(options); !ec) {
             req->value_ = std::move(value);
         } else {
             return tl::unexpected(ec);
         }
 
-        auto op = collections_.dispatch(req);
-        if (!op) {
-            return op;
-        }
-
-        if (options.timeout != std::chrono::milliseconds::zero()) {
-            auto timer = std::make_shared<asio::steady_timer>(io_);
-            timer->expires_after(options.timeout);
-            timer->async_wait([req](auto error) {
-                if (error == asio::error::operation_aborted) {
-                    return;
-                }
-                req->cancel(couchbase::errc::common::unambiguous_timeout);
-            });
-            req->set_deadline(timer);
-        }
-
-        return op;
+        return dispatch(std::move(req), options.timeout);
     }
 
     auto range_scan_continue(std::vector<std::byte> scan_uuid,
                              std::uint16_t vbucket_id,
                              range_scan_continue_options options,
-                             range_scan_item_callback&& item_callback,
+                             range_scan_item_view_callback&& item_callback,
                              range_scan_continue_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
     {
         if (scan_uuid.size() != 16) {
@@ -256,7 +803,9 @@ class crud_component_impl
                       return cb({}, errc::network::protocol_error);
               }
 
-              if (auto ec = parse_range_scan_data(response->value_, std::move(item_cb), ids_only); ec) {
+              // the views refer to the response, so the caller decides which items have to be copied
+              auto items = [&item_cb](const range_scan_item_view& item) { item_cb(item); };
+              if (auto ec = parse_range_scan_data(response->value_, std::move(items), ids_only); ec) {
                   return cb({}, ec);
               }
 
@@ -304,14 +853,102 @@ class crud_component_impl
         req->vbucket_ = vbucket_id;
         req->extras_ = std::move(scan_uuid);
 
+        return dispatch(std::move(req), options.timeout);
+    }
+
+  private:
+    template<typename Options>
+    auto make_request(protocol::client_opcode opcode, const Options& options, mcbp::queue_callback&& handler)
+      -> std::shared_ptr<mcbp::queue_request>
+    {
+        auto span = start_span(opcode, options.parent_span);
+        auto req = std::make_shared<mcbp::queue_request>(protocol::magic::client_request, opcode, traced_handler(span, std::move(handler)));
+        req->span_ = std::move(span);
+        req->retry_strategy_ = options.retry_strategy ? options.retry_strategy : default_retry_strategy_;
+        if (!options.internal.user.empty()) {
+            req->user_impersonation_frame_ = mcbp::user_impersonation_frame{ utils::to_binary(options.internal.user) };
+        }
+        return req;
+    }
+
+    /**
+     * The operation is reported as the child of the parent span, like the operations sent through cluster::execute().
+     */
+    auto start_span(protocol::client_opcode opcode, const std::shared_ptr<couchbase::tracing::request_span>& parent_span)
+      -> std::shared_ptr<couchbase::tracing::request_span>
+    {
+        auto span = tracer_->start_span(tracing::span_name_for_mcbp_command(opcode), parent_span);
+        span->add_tag(tracing::attributes::service, tracing::service::key_value);
+        span->add_tag(tracing::attributes::instance, bucket_name_);
+        return span;
+    }
+
+    static auto traced_handler(std::shared_ptr<couchbase::tracing::request_span> span, mcbp::queue_callback&& handler)
+      -> mcbp::queue_callback
+    {
+        return [span = std::move(span), handler = std::move(handler)](
+                 std::shared_ptr<mcbp::queue_response> resp, std::shared_ptr<mcbp::queue_request> req, std::error_code error) mutable {
+            if (resp && resp->server_duration_frame_) {
+                span->add_tag(tracing::attributes::server_duration,
+                              static_cast<std::uint64_t>(resp->server_duration_frame_->server_duration.count()));
+            }
+            span->end();
+            return handler(std::move(resp), std::move(req), error);
+        };
+    }
+
+    template<typename Options>
+    auto make_document_request(protocol::client_opcode opcode, Options& options, mcbp::queue_callback&& handler)
+      -> std::shared_ptr<mcbp::queue_request>
+    {
+        auto req = make_request(opcode, options, std::move(handler));
+        req->key_ = std::move(options.key);
+        req->scope_name_ = std::move(options.scope_name);
+        req->collection_name_ = std::move(options.collection_name);
+        req->collection_id_ = options.collection_id;
+        return req;
+    }
+
+    template<typename Result, typename Callback>
+    static auto document_handler(Callback&& callback) -> mcbp::queue_callback
+    {
+        return [cb = std::forward<Callback>(callback)](std::shared_ptr<mcbp::queue_response> resp,
+                                                       std::shared_ptr<mcbp::queue_request> /* req */,
+                                                       std::error_code error) mutable {
+            if (error) {
+                return cb({}, error);
+            }
+            return cb(make_document_result<Result>(*resp), {});
+        };
+    }
+
+    template<typename Result, typename Callback>
+    auto mutation_handler(Callback&& callback) -> mcbp::queue_callback
+    {
+        return [self = shared_from_this(), cb = std::forward<Callback>(callback)](
+                 std::shared_ptr<mcbp::queue_response> resp, std::shared_ptr<mcbp::queue_request> req, std::error_code error) mutable {
+            if (error) {
+                return cb({}, error);
+            }
+            return cb(make_mutation_result<Result>(*resp, *req, self->bucket_name_), {});
+        };
+    }
+
+    auto dispatch(std::shared_ptr<mcbp::queue_request> req, std::chrono::milliseconds timeout)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+    {
         auto op = collections_.dispatch(req);
         if (!op) {
+            // the callback will not be invoked, so it cannot end the span
+            if (req->span_) {
+                req->span_->end();
+            }
             return op;
         }
 
-        if (options.timeout != std::chrono::milliseconds::zero()) {
+        if (timeout != std::chrono::milliseconds::zero()) {
             auto timer = std::make_shared<asio::steady_timer>(io_);
-            timer->expires_after(options.timeout);
+            timer->expires_after(timeout);
             timer->async_wait([req](auto error) {
                 if (error == asio::error::operation_aborted) {
                     return;
@@ -324,17 +961,169 @@ class crud_component_impl
         return op;
     }
 
-  private:
     asio::io_context& io_;
+    const std::string bucket_name_;
     collections_component collections_;
     std::shared_ptr<retry_strategy> default_retry_strategy_;
+    std::shared_ptr<couchbase::tracing::request_tracer> tracer_;
 };
 
 crud_component::crud_component(asio::io_context& io,
+                               std::string bucket_name,
                                collections_component collections,
-                               std::shared_ptr<retry_strategy> default_retry_strategy)
-  : impl_{ std::make_shared<crud_component_impl>(io, std::move(collections), std::move(default_retry_strategy)) }
+                               std::shared_ptr<retry_strategy> default_retry_strategy,
+                               std::shared_ptr<couchbase::tracing::request_tracer> tracer)
+  : impl_{ std::make_shared<crud_component_impl>(io,
+                                                 std::move(bucket_name),
+                                                 std::move(collections),
+                                                 std::move(default_retry_strategy),
+                                                 std::move(tracer)) }
+{
+}
+
+auto
+crud_component::get(get_options options, get_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+{
+    return impl_->get(std::move(options), std::move(callback));
+}
+
+auto
+crud_component::get_and_touch(get_and_touch_options options, get_and_touch_callback&& callback)
+  -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+{
+    return impl_->get_and_touch(std::move(options), std::move(callback));
+}
+
+auto
+crud_component::get_and_lock(get_and_lock_options options, get_and_lock_callback&& callback)
+  -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+{
+    return impl_->get_and_lock(std::move(options), std::move(callback));
+}
+
+auto
+crud_component::get_one_replica(get_one_replica_options options, get_one_replica_callback&& callback)
+  -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+{
+    return impl_->get_one_replica(std::move(options), std::move(callback));
+}
+
+auto
+crud_component::touch(touch_options options, touch_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+{
+    return impl_->touch(std::move(options), std::move(callback));
+}
+
+auto
+crud_component::unlock(unlock_options options, unlock_callback&& callback)
+  -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+{
+    return impl_->unlock(std::move(options), std::move(callback));
+}
+
+auto
+crud_component::remove(remove_options options, remove_callback&& callback)
+  -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+{
+    return impl_->remove(std::move(options), std::move(callback));
+}
+
+auto
+crud_component::insert(insert_options options, insert_callback&& callback)
+  -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+{
+    return impl_->insert(std::move(options), std::move(callback));
+}
+
+auto
+crud_component::upsert(upsert_options options, upsert_callback&& callback)
+  -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+{
+    return impl_->upsert(std::move(options), std::move(callback));
+}
+
+auto
+crud_component::replace(replace_options options, replace_callback&& callback)
+  -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+{
+    return impl_->replace(std::move(options), std::move(callback));
+}
+
+auto
+crud_component::append(adjoin_options options, adjoin_callback&& callback)
+  -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+{
+    return impl_->adjoin(protocol::client_opcode::append, std::move(options), std::move(callback));
+}
+
+auto
+crud_component::prepend(adjoin_options options, adjoin_callback&& callback)
+  -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+{
+    return impl_->adjoin(protocol::client_opcode::prepend, std::move(options), std::move(callback));
+}
+
+auto
+crud_component::increment(counter_options options, counter_callback&& callback)
+  -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+{
+    return impl_->counter(protocol::client_opcode::increment, std::move(options), std::move(callback));
+}
+
+auto
+crud_component::decrement(counter_options options, counter_callback&& callback)
+  -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+{
+    return impl_->counter(protocol::client_opcode::decrement, std::move(options), std::move(callback));
+}
+
+auto
+crud_component::get_random(get_random_options options, get_random_callback&& callback)
+  -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+{
+    return impl_->get_random(std::move(options), std::move(callback));
+}
+
+auto
+crud_component::get_with_meta(get_with_meta_options options, get_with_meta_callback&& callback)
+  -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+{
+    return impl_->get_with_meta(std::move(options), std::move(callback));
+}
+
+auto
+crud_component::upsert_with_meta(upsert_with_meta_options options, upsert_with_meta_callback&& callback)
+  -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+{
+    return impl_->upsert_with_meta(std::move(options), std::move(callback));
+}
+
+auto
+crud_component::remove_with_meta(remove_with_meta_options options, remove_with_meta_callback&& callback)
+  -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+{
+    return impl_->remove_with_meta(std::move(options), std::move(callback));
+}
+
+auto
+crud_component::observe_seqno(observe_seqno_options options, observe_seqno_callback&& callback)
+  -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+{
+    return impl_->observe_seqno(std::move(options), std::move(callback));
+}
+
+auto
+crud_component::lookup_in(lookup_in_options options, lookup_in_callback&& callback)
+  -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
+{
+    return impl_->lookup_in(std::move(options), std::move(callback));
+}
+
+auto
+crud_component::mutate_in(mutate_in_options options, mutate_in_callback&& callback)
+  -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
 {
+    return impl_->mutate_in(std::move(options), std::move(callback));
 }
 
 auto
@@ -348,7 +1137,7 @@ auto
 crud_component::range_scan_continue(std::vector<std::byte> scan_uuid,
                                     std::uint16_t vbucket_id,
                                     range_scan_continue_options options,
-                                    range_scan_item_callback&& item_callback,
+                                    range_scan_item_view_callback&& item_callback,
                                     range_scan_continue_callback&& callback)
   -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>
 {
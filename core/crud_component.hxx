@@ -19,11 +19,15 @@
 
 #include "pending_operation.hxx"
 
+#include "crud_options.hxx"
+#include "durability_options.hxx"
 #include "range_scan_options.hxx"
+#include "subdoc_options.hxx"
 
 #include <tl/expected.hpp>
 
 #include <memory>
+#include <string>
 #include <system_error>
 
 namespace asio
@@ -31,14 +35,86 @@ namespace asio
 class io_context;
 } // namespace asio
 
+namespace couchbase::tracing
+{
+class request_tracer;
+} // namespace couchbase::tracing
+
 namespace couchbase::core
 {
 class collections_component;
 class crud_component_impl;
+
+/**
+ * Decodes the items from the payload of range_scan_continue response without copying them. Snappy-compressed values are inflated into
+ * the buffer that is shared by the items of the payload, so the view must be materialized (range_scan_item_view::to_item()) if the item
+ * has to be kept after the callback returns.
+ */
+auto
+parse_range_scan_data(gsl::span<std::byte> payload, range_scan_item_view_callback&& items, bool keys_only) -> std::error_code;
+
 class crud_component
 {
   public:
-    crud_component(asio::io_context& io, collections_component collections, std::shared_ptr<retry_strategy> default_retry_strategy);
+    crud_component(asio::io_context& io,
+                   std::string bucket_name,
+                   collections_component collections,
+                   std::shared_ptr<retry_strategy> default_retry_strategy,
+                   std::shared_ptr<couchbase::tracing::request_tracer> tracer);
+
+    auto get(get_options options, get_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
+
+    auto get_and_touch(get_and_touch_options options, get_and_touch_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
+
+    auto get_and_lock(get_and_lock_options options, get_and_lock_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
+
+    auto get_one_replica(get_one_replica_options options, get_one_replica_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
+
+    auto touch(touch_options options, touch_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
+
+    auto unlock(unlock_options options, unlock_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
+
+    auto remove(remove_options options, remove_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
+
+    auto insert(insert_options options, insert_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
+
+    auto upsert(upsert_options options, upsert_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
+
+    auto replace(replace_options options, replace_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
+
+    auto append(adjoin_options options, adjoin_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
+
+    auto prepend(adjoin_options options, adjoin_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
+
+    auto increment(counter_options options, counter_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
+
+    auto decrement(counter_options options, counter_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
+
+    auto get_random(get_random_options options, get_random_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
+
+    auto get_with_meta(get_with_meta_options options, get_with_meta_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
+
+    auto upsert_with_meta(upsert_with_meta_options options, upsert_with_meta_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
+
+    auto remove_with_meta(remove_with_meta_options options, remove_with_meta_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
+
+    auto observe_seqno(observe_seqno_options options, observe_seqno_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
+
+    auto lookup_in(lookup_in_options options, lookup_in_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
+
+    auto mutate_in(mutate_in_options options, mutate_in_callback&& callback)
+      -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
 
     auto range_scan_create(std::uint16_t vbucket_id, range_scan_create_options options, range_scan_create_callback&& callback)
       -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
@@ -46,7 +122,7 @@ class crud_component
     auto range_scan_continue(std::vector<std::byte> scan_uuid,
                              std::uint16_t vbucket_id,
                              range_scan_continue_options options,
-                             range_scan_item_callback&& item_callback,
+                             range_scan_item_view_callback&& item_callback,
                              range_scan_continue_callback&& callback) -> tl::expected<std::shared_ptr<pending_operation>, std::error_code>;
 
     auto range_scan_cancel(std::vector<std::byte> scan_uuid,
@@ -21,6 +21,7 @@
 
 #include <array>
 #include <chrono>
+#include <cstdint>
 #include <map>
 #include <optional>
 #include <string>
@@ -60,12 +61,23 @@ struct endpoint_diag_info {
     std::optional<std::string> details{};
 };
 
+struct tls_session_info {
+    /** hostname and port of the endpoint */
+    std::string remote;
+    std::uint64_t handshakes{ 0 };
+    /** handshakes, that resumed cached session instead of doing full handshake */
+    std::uint64_t resumed_handshakes{ 0 };
+};
+
 struct diagnostics_result {
     std::string id;
     std::string sdk;
     std::map<service_type, std::vector<endpoint_diag_info>> services{};
 
     int version{ 2 };
+
+    /** empty when TLS is not used */
+    std::vector<tls_session_info> tls_sessions{};
 };
 
 enum class ping_state {
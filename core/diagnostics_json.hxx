@@ -60,6 +60,21 @@ struct traits<couchbase::core::diag::diagnostics_result> {
             { "sdk", r.sdk },
             { "services", services },
         };
+        if (!r.tls_sessions.empty()) {
+            tao::json::value tls_sessions = tao::json::empty_array;
+            for (const auto& info : r.tls_sessions) {
+                tao::json::value e = {
+                    { "remote", info.remote },
+                    { "handshakes", info.handshakes },
+                    { "resumed_handshakes", info.resumed_handshakes },
+                };
+                if (info.handshakes > 0) {
+                    e["resumption_rate"] = static_cast<double>(info.resumed_handshakes) / static_cast<double>(info.handshakes);
+                }
+                tls_sessions.push_back(e);
+            }
+            v["tls_sessions"] = tls_sessions;
+        }
     }
 };
 
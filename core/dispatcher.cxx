@@ -14,24 +14,64 @@
  */
 
 #include "dispatcher.hxx"
-
 #include "cluster.hxx"
 
+#include <shared_mutex>
+
 namespace couchbase::core
 {
+struct dispatcher::bucket_reference {
+    std::shared_mutex mutex{};
+    std::weak_ptr<bucket> bucket{};
+};
+
 dispatcher::dispatcher(std::string bucket_name, core_sdk_shim shim)
   : bucket_name_{ std::move(bucket_name) }
   , shim_{ std::move(shim) }
+  , bucket_{ std::make_shared<bucket_reference>() }
 {
 }
+
+auto
+dispatcher::resolve_bucket() const -> std::shared_ptr<bucket>
+{
+    {
+        std::shared_lock lock(bucket_->mutex);
+        if (auto b = bucket_->bucket.lock(); b && !b->is_closed()) {
+            return b;
+        }
+    }
+    auto b = shim_.cluster->find_bucket_by_name(bucket_name_);
+    if (b) {
+        std::scoped_lock lock(bucket_->mutex);
+        bucket_->bucket = b;
+    }
+    return b;
+}
+
 auto
 dispatcher::direct_dispatch(std::shared_ptr<mcbp::queue_request> req) const -> std::error_code
 {
+    // the cached bucket might still be open, while the cluster is already closing
+    if (shim_.cluster->is_stopped()) {
+        return errc::network::cluster_closed;
+    }
+    if (auto b = resolve_bucket(); b) {
+        return b->direct_dispatch(std::move(req));
+    }
+    // the cluster will open the bucket, or report the error
     return shim_.cluster->direct_dispatch(bucket_name_, std::move(req));
 }
+
 auto
 dispatcher::direct_re_queue(std::shared_ptr<mcbp::queue_request> req, bool is_retry) const -> std::error_code
 {
+    if (shim_.cluster->is_stopped()) {
+        return errc::network::cluster_closed;
+    }
+    if (auto b = resolve_bucket(); b) {
+        return b->direct_re_queue(std::move(req), is_retry);
+    }
     return shim_.cluster->direct_re_queue(bucket_name_, std::move(req), is_retry);
 }
 } // namespace couchbase::core
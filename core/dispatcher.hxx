@@ -26,6 +26,7 @@ namespace mcbp
 {
 class queue_request;
 } // namespace mcbp
+class bucket;
 
 class dispatcher
 {
@@ -36,8 +37,14 @@ class dispatcher
     auto direct_re_queue(std::shared_ptr<mcbp::queue_request> req, bool is_retry) const -> std::error_code;
 
   private:
+    struct bucket_reference;
+
+    [[nodiscard]] auto resolve_bucket() const -> std::shared_ptr<bucket>;
+
     std::string bucket_name_;
     core_sdk_shim shim_;
+    // shared by the copies of the dispatcher, so that the bucket is looked up in the cluster only once
+    std::shared_ptr<bucket_reference> bucket_;
 };
 
 } // namespace couchbase::core
@@ -23,7 +23,13 @@
 #include <fmt/core.h>
 
 #include <algorithm>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <stdexcept>
+#include <tuple>
 
 namespace couchbase::core
 {
@@ -58,32 +64,105 @@ is_valid_collection_element(std::string_view element)
     return std::all_of(element.begin(), element.end(), is_valid_collection_char);
 }
 
-[[nodiscard]] static std::string
-compile_collection_path(const std::string& scope, const std::string& collection)
+namespace impl
 {
-    return fmt::format("{}.{}", scope, collection);
+namespace
+{
+using collection_names_key = std::tuple<std::string, std::string, std::string>;
+
+struct collection_names_registry {
+    std::shared_mutex mutex{};
+    std::map<collection_names_key, std::weak_ptr<const collection_names>, std::less<>> names{};
+    // the released names are swept when the registry grows above this size
+    std::size_t sweep_threshold{ 64 };
+};
+
+auto
+names_match(const collection_names& names, std::string_view bucket, std::string_view scope, std::string_view collection) -> bool
+{
+    return names.bucket == bucket && names.scope == scope && names.collection == collection;
+}
+} // namespace
+
+auto
+empty_collection_names() -> const std::shared_ptr<const collection_names>&
+{
+    static const auto names = std::make_shared<const collection_names>();
+    return names;
+}
+
+auto
+intern_collection_names(std::string_view bucket, std::string_view scope, std::string_view collection)
+  -> std::shared_ptr<const collection_names>
+{
+    // applications usually work with a handful of collections, so most of the lookups are served by the per-thread cache, which also
+    // keeps the last used names alive
+    thread_local std::shared_ptr<const collection_names> last_used{};
+    if (last_used && names_match(*last_used, bucket, scope, collection)) {
+        return last_used;
+    }
+
+    static collection_names_registry registry{};
+    const std::tuple<std::string_view, std::string_view, std::string_view> key{ bucket, scope, collection };
+    {
+        std::shared_lock lock(registry.mutex);
+        if (auto it = registry.names.find(key); it != registry.names.end()) {
+            if (auto names = it->second.lock(); names) {
+                last_used = names;
+                return names;
+            }
+        }
+    }
+
+    std::scoped_lock lock(registry.mutex);
+    auto it = registry.names.find(key);
+    std::shared_ptr<const collection_names> names{};
+    if (it != registry.names.end()) {
+        names = it->second.lock();
+    }
+    if (!names) {
+        auto fresh = std::make_shared<collection_names>();
+        fresh->bucket = bucket;
+        fresh->scope = scope;
+        fresh->collection = collection;
+        if (!scope.empty() || !collection.empty()) {
+            fresh->path = fmt::format("{}.{}", scope, collection);
+        }
+        names = std::move(fresh);
+        if (it != registry.names.end()) {
+            it->second = names;
+        } else {
+            registry.names.emplace(collection_names_key{ bucket, scope, collection }, names);
+        }
+        if (registry.names.size() > registry.sweep_threshold) {
+            for (auto entry = registry.names.begin(); entry != registry.names.end();) {
+                entry = entry->second.expired() ? registry.names.erase(entry) : std::next(entry);
+            }
+            registry.sweep_threshold = std::max<std::size_t>(64, 2 * registry.names.size());
+        }
+    }
+    last_used = names;
+    return names;
 }
+} // namespace impl
 
 document_id::document_id(std::string bucket, std::string key)
-  : bucket_(std::move(bucket))
+  : names_(impl::intern_collection_names(bucket, {}, {}))
   , key_(std::move(key))
   , use_collections_(false)
 {
 }
 
 document_id::document_id(std::string bucket, std::string scope, std::string collection, std::string key)
-  : bucket_(std::move(bucket))
-  , scope_(std::move(scope))
-  , collection_(std::move(collection))
+  : names_(impl::intern_collection_names(bucket, scope, collection))
   , key_(std::move(key))
 {
-    collection_path_ = compile_collection_path(scope_, collection_);
 }
 
 bool
 document_id::has_default_collection() const
 {
-    return !use_collections_ || collection_path_ == "_default._default";
+    return !use_collections_ || names_->path == "_default._default";
 }
 
 std::vector<std::byte>
@@ -17,7 +17,10 @@
 
 #pragma once
 
+#include "core/impl/collection_names.hxx"
+
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -31,22 +34,30 @@ struct document_id {
 
     [[nodiscard]] const std::string& bucket() const
     {
-        return bucket_;
+        return names_->bucket;
     }
 
     [[nodiscard]] const std::string& scope() const
     {
-        return scope_;
+        return names_->scope;
     }
 
     [[nodiscard]] const std::string& collection() const
     {
-        return collection_;
+        return names_->collection;
     }
 
     [[nodiscard]] const std::string& collection_path() const
     {
-        return collection_path_;
+        return names_->path;
+    }
+
+    /**
+     * @return names of the bucket, scope and collection, that could be shared instead of copied
+     */
+    [[nodiscard]] const std::shared_ptr<const impl::collection_names>& names() const
+    {
+        return names_;
     }
 
     [[nodiscard]] const std::string& key() const
@@ -102,11 +113,8 @@ struct document_id {
     }
 
   private:
-    std::string bucket_{};
-    std::string scope_{};
-    std::string collection_{};
+    std::shared_ptr<const impl::collection_names> names_{ impl::empty_collection_names() };
     std::string key_{};
-    std::string collection_path_{};
     std::optional<std::uint32_t> collection_uid_{}; // filled with resolved UID during request lifetime
     bool use_collections_{ true };
     bool use_any_session_{ false };
@@ -24,7 +24,7 @@ key_value_error_context
 make_key_value_error_context(std::error_code ec, const document_id& id)
 {
     return {
-        ec, {}, {}, 0, {}, id.key(), id.bucket(), id.scope(), id.collection(), 0, {}, {}, {}, {},
+        ec, {}, 0, {}, id.key(), id.names(), 0, {}, {}, {}, {},
     };
 }
 
@@ -35,24 +35,6 @@ make_subdocument_error_context(const key_value_error_context& ctx,
                                std::optional<std::uint64_t> first_error_index,
                                bool deleted)
 {
-    return {
-        ec,
-        ctx.last_dispatched_to(),
-        ctx.last_dispatched_from(),
-        ctx.retry_attempts(),
-        ctx.retry_reasons(),
-        ctx.id(),
-        ctx.bucket(),
-        ctx.scope(),
-        ctx.collection(),
-        ctx.opaque(),
-        ctx.status_code(),
-        ctx.cas(),
-        ctx.error_map_info(),
-        ctx.extended_error_info(),
-        std::move(first_error_path),
-        first_error_index,
-        deleted,
-    };
+    return { ctx, ec, std::move(first_error_path), first_error_index, deleted };
 }
 } // namespace couchbase::core
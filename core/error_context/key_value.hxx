@@ -21,6 +21,7 @@
 #include <couchbase/subdocument_error_context.hxx>
 
 #include "core/document_id.hxx"
+#include "core/impl/dispatch_endpoints.hxx"
 
 #include <optional>
 #include <set>
@@ -38,36 +39,24 @@ key_value_error_context
 make_key_value_error_context(std::error_code ec, std::uint16_t status_code, const Command& command, const Response& response)
 {
 
-    const auto& key = command->request.id.key();
-    const auto& collection = command->request.id.collection();
-    const auto& scope = command->request.id.scope();
-    const auto& bucket = command->request.id.bucket();
     std::uint32_t opaque = (ec && response.opaque() == 0) ? command->request.opaque : response.opaque();
-    auto status = response.status();
-    auto retry_attempts = command->request.retries.retry_attempts();
-    auto retry_reasons = command->request.retries.retry_reasons();
-    std::optional<std::string> last_dispatched_from{};
-    std::optional<std::string> last_dispatched_to{};
+    std::shared_ptr<const impl::dispatch_endpoints> endpoints{};
     std::optional<key_value_error_map_info> error_map_info{};
     if (command->session_) {
-        last_dispatched_from = command->session_->local_address();
-        last_dispatched_to = command->session_->remote_address();
+        endpoints = command->session_->dispatch_endpoints();
         if (status_code) {
             error_map_info = command->session_->decode_error_code(status_code);
         }
     }
 
     return { ec,
-             std::move(last_dispatched_from),
-             std::move(last_dispatched_to),
-             retry_attempts,
-             std::move(retry_reasons),
-             key,
-             bucket,
-             scope,
-             collection,
+             std::move(endpoints),
+             command->request.retries.retry_attempts(),
+             command->request.retries.retry_reasons(),
+             command->request.id.key(),
+             command->request.id.names(),
              opaque,
-             status,
+             response.status(),
              response.cas(),
              std::move(error_map_info),
              response.error_info() };
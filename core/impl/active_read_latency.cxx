@@ -0,0 +1,55 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "active_read_latency.hxx"
+
+#include <algorithm>
+#include <cmath>
+
+namespace couchbase::core::impl
+{
+void
+active_read_latency::record(std::chrono::microseconds latency)
+{
+    std::scoped_lock lock(mutex_);
+    samples_[number_of_recorded_samples_ % number_of_samples] = latency;
+    ++number_of_recorded_samples_;
+    ++samples_since_calculation_;
+}
+
+auto
+active_read_latency::delay(double percentile, std::chrono::microseconds default_delay) -> std::chrono::microseconds
+{
+    std::scoped_lock lock(mutex_);
+    if (number_of_recorded_samples_ < minimum_number_of_samples) {
+        return default_delay;
+    }
+    if (cached_percentile_ == percentile && samples_since_calculation_ < recalculate_every) {
+        return cached_delay_;
+    }
+    auto size = std::min(number_of_recorded_samples_, number_of_samples);
+    std::array<std::chrono::microseconds, number_of_samples> sorted{};
+    std::copy_n(samples_.begin(), size, sorted.begin());
+    auto rank = static_cast<std::size_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(size)));
+    auto nth = sorted.begin() + static_cast<std::ptrdiff_t>(std::clamp<std::size_t>(rank, 1, size) - 1);
+    std::nth_element(sorted.begin(), nth, sorted.begin() + static_cast<std::ptrdiff_t>(size));
+    cached_percentile_ = percentile;
+    cached_delay_ = *nth;
+    samples_since_calculation_ = 0;
+    return cached_delay_;
+}
+} // namespace couchbase::core::impl
@@ -0,0 +1,53 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+
+namespace couchbase::core::impl
+{
+/**
+ * Latency of the recent reads from the active nodes of the bucket, used to derive the delay for get_options::hedge_after_percentile().
+ * The tracker is owned by the cluster, one per bucket.
+ */
+class active_read_latency
+{
+  public:
+    static constexpr std::size_t number_of_samples{ 512 };
+    static constexpr std::size_t minimum_number_of_samples{ 32 };
+    static constexpr std::size_t recalculate_every{ 64 };
+
+    void record(std::chrono::microseconds latency);
+
+    /**
+     * @return given percentile of the recorded latencies, or default_delay if there are not enough samples yet
+     */
+    auto delay(double percentile, std::chrono::microseconds default_delay) -> std::chrono::microseconds;
+
+  private:
+    std::mutex mutex_{};
+    std::array<std::chrono::microseconds, number_of_samples> samples_{};
+    std::size_t number_of_recorded_samples_{ 0 };
+    std::size_t samples_since_calculation_{ 0 };
+    double cached_percentile_{ -1 };
+    std::chrono::microseconds cached_delay_{};
+};
+} // namespace couchbase::core::impl
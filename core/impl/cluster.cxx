@@ -111,6 +111,8 @@ options_to_origin(const std::string& connection_string, const couchbase::cluster
     if (opts.network.max_http_connections) {
         user_options.max_http_connections = opts.network.max_http_connections.value();
     }
+    user_options.io_shards = opts.network.io_shards;
+    user_options.pin_io_shards = opts.network.pin_io_shards;
     if (!opts.network.network.empty()) {
         user_options.network = opts.network.network;
     }
@@ -127,6 +129,8 @@ options_to_origin(const std::string& connection_string, const couchbase::cluster
     }
 
     user_options.enable_compression = opts.compression.enabled;
+    user_options.compression_min_size = opts.compression.min_size;
+    user_options.compression_min_ratio = opts.compression.min_ratio;
 
     user_options.enable_metrics = opts.metrics.enabled;
     if (opts.metrics.enabled) {
@@ -0,0 +1,50 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace couchbase::core::impl
+{
+/**
+ * Names of the bucket, scope and collection. Document identifiers and error contexts share them instead of copying the strings for
+ * every operation.
+ */
+struct collection_names {
+    std::string bucket{};
+    std::string scope{};
+    std::string collection{};
+    std::string path{};
+};
+
+/**
+ * @return shared names for default constructed document identifiers
+ */
+auto
+empty_collection_names() -> const std::shared_ptr<const collection_names>&;
+
+/**
+ * Looks up the names, that are still in use, or creates new ones. The registry keeps only weak references, so the names are released
+ * when the last document identifier or error context, that refers to them, is destroyed.
+ */
+auto
+intern_collection_names(std::string_view bucket, std::string_view scope, std::string_view collection)
+  -> std::shared_ptr<const collection_names>;
+} // namespace couchbase::core::impl
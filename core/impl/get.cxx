@@ -15,14 +15,148 @@
  *   limitations under the License.
  */
 
+#include "get_replica.hxx"
+
 #include "core/cluster.hxx"
 #include "core/error_context/key_value.hxx"
+#include "core/impl/active_read_latency.hxx"
 #include "core/operations/document_get.hxx"
+#include "core/topology/configuration.hxx"
 
 #include <couchbase/get_options.hxx>
 
+#include <asio/steady_timer.hpp>
+
+#include <mutex>
+
 namespace couchbase::core::impl
 {
+namespace
+{
+/**
+ * @return true if the replica might still return the document after the active node has failed with the given error. Any other
+ * response of the active node is definitive, and must not be overridden by the replica copy, that might be stale (for example the
+ * document might have been removed already).
+ */
+auto
+is_transient_active_failure(std::error_code ec) -> bool
+{
+    return ec == errc::common::unambiguous_timeout || ec == errc::common::ambiguous_timeout || ec == errc::common::temporary_failure ||
+           ec == errc::common::request_canceled || ec == errc::common::service_not_available;
+}
+
+struct hedged_get_context {
+    hedged_get_context(asio::io_context& io, get_handler&& handler)
+      : hedge_timer_{ io }
+      , handler_{ std::move(handler) }
+    {
+    }
+
+    asio::steady_timer hedge_timer_;
+    std::mutex mutex_{};
+    get_handler handler_;
+    bool replica_requested_{ false };
+    std::size_t pending_responses_{ 1 };
+    std::optional<key_value_error_context> active_error_{};
+};
+
+/**
+ * Sends the request to the active node, and if it does not respond within the hedging delay, to the first replica. Any response of
+ * the active node, that is not a transient failure, completes the operation. The replica wins only if it returns the document before
+ * the active node responds, or after the active node has failed transiently. If both nodes fail, the error of the active node is
+ * reported.
+ */
+void
+initiate_hedged_get_operation(std::shared_ptr<couchbase::core::cluster> core,
+                              document_id id,
+                              get_options::built options,
+                              get_handler&& handler)
+{
+    std::shared_ptr<active_read_latency> latency{};
+    std::chrono::microseconds delay = options.hedge_delay.value();
+    if (options.hedge_percentile) {
+        latency = core->read_latency_tracker(id.bucket());
+        delay = latency->delay(options.hedge_percentile.value(), delay);
+    }
+
+    auto ctx = std::make_shared<hedged_get_context>(core->io_context(), std::move(handler));
+    ctx->hedge_timer_.expires_after(delay);
+    ctx->hedge_timer_.async_wait([core, ctx, id, timeout = options.timeout](std::error_code ec) {
+        if (ec == asio::error::operation_aborted) {
+            return;
+        }
+        core->with_bucket_configuration(
+          id.bucket(), [core, ctx, id, timeout](std::error_code ec, const core::topology::configuration& config) mutable {
+              if (ec || config.num_replicas.value_or(0U) == 0) {
+                  return;
+              }
+              {
+                  std::scoped_lock lock(ctx->mutex_);
+                  if (!ctx->handler_) {
+                      return;
+                  }
+                  ctx->replica_requested_ = true;
+                  ++ctx->pending_responses_;
+              }
+              id.node_index(1);
+              core->execute(get_replica_request{ std::move(id), timeout }, [ctx](get_replica_response&& resp) {
+                  get_handler local_handler{};
+                  std::optional<key_value_error_context> active_error{};
+                  {
+                      std::scoped_lock lock(ctx->mutex_);
+                      --ctx->pending_responses_;
+                      if (!ctx->handler_) {
+                          return;
+                      }
+                      if (resp.ctx.ec() && ctx->pending_responses_ > 0) {
+                          // the active node might still return the document
+                          return;
+                      }
+                      std::swap(local_handler, ctx->handler_);
+                      std::swap(active_error, ctx->active_error_);
+                  }
+                  if (resp.ctx.ec()) {
+                      return local_handler(std::move(active_error).value_or(std::move(resp.ctx)), get_result{});
+                  }
+                  return local_handler(std::move(resp.ctx), get_result{ resp.cas, { std::move(resp.value), resp.flags }, {} });
+              });
+          });
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    core->execute(
+      operations::get_request{
+        std::move(id),
+        {},
+        {},
+        options.timeout,
+        { options.retry_strategy },
+      },
+      [ctx, latency, start](operations::get_response&& resp) mutable {
+          if (latency && !resp.ctx.ec()) {
+              // the response is recorded even if the replica has won, otherwise the slow reads would not be accounted
+              latency->record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start));
+          }
+          get_handler local_handler{};
+          {
+              std::scoped_lock lock(ctx->mutex_);
+              --ctx->pending_responses_;
+              if (!ctx->handler_) {
+                  return;
+              }
+              if (is_transient_active_failure(resp.ctx.ec()) && ctx->replica_requested_ && ctx->pending_responses_ > 0) {
+                  // the replica might still return the document
+                  ctx->active_error_.emplace(std::move(resp.ctx));
+                  return;
+              }
+              std::swap(local_handler, ctx->handler_);
+          }
+          ctx->hedge_timer_.cancel();
+          return local_handler(std::move(resp.ctx), get_result{ resp.cas, { std::move(resp.value), resp.flags }, {} });
+      });
+}
+} // namespace
+
 void
 initiate_get_operation(std::shared_ptr<couchbase::core::cluster> core,
                        std::string bucket_name,
@@ -33,6 +167,13 @@ initiate_get_operation(std::shared_ptr<couchbase::core::cluster> core,
                        get_handler&& handler)
 {
     if (!options.with_expiry && options.projections.empty()) {
+        if (options.hedge_delay) {
+            return initiate_hedged_get_operation(
+              std::move(core),
+              document_id{ std::move(bucket_name), std::move(scope_name), std::move(collection_name), std::move(document_key) },
+              std::move(options),
+              std::move(handler));
+        }
         return core->execute(
           operations::get_request{
             document_id{ std::move(bucket_name), std::move(scope_name), std::move(collection_name), std::move(document_key) },
@@ -0,0 +1,86 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "collection_names.hxx"
+#include "dispatch_endpoints.hxx"
+
+#include <couchbase/key_value_error_context.hxx>
+
+namespace couchbase
+{
+key_value_error_context::key_value_error_context(std::error_code ec,
+                                                 std::optional<std::string> last_dispatched_to,
+                                                 std::optional<std::string> last_dispatched_from,
+                                                 std::size_t retry_attempts,
+                                                 std::set<retry_reason> retry_reasons,
+                                                 std::string id,
+                                                 std::string bucket,
+                                                 std::string scope,
+                                                 std::string collection,
+                                                 std::uint32_t opaque,
+                                                 std::optional<key_value_status_code> status_code,
+                                                 couchbase::cas cas,
+                                                 std::optional<key_value_error_map_info> error_map_info,
+                                                 std::optional<key_value_extended_error_info> extended_error_info)
+  : error_context{ ec, std::move(last_dispatched_to), std::move(last_dispatched_from), retry_attempts, std::move(retry_reasons) }
+  , id_{ std::move(id) }
+  , names_{ std::make_shared<const core::impl::collection_names>(
+      core::impl::collection_names{ std::move(bucket), std::move(scope), std::move(collection), {} }) }
+  , opaque_{ opaque }
+  , status_code_{ status_code }
+  , cas_{ cas }
+  , error_map_info_{ std::move(error_map_info) }
+  , extended_error_info_{ std::move(extended_error_info) }
+{
+}
+
+auto
+key_value_error_context::last_dispatched_to() const -> const std::optional<std::string>&
+{
+    if (endpoints_) {
+        return endpoints_->last_dispatched_to;
+    }
+    return error_context::last_dispatched_to();
+}
+
+auto
+key_value_error_context::last_dispatched_from() const -> const std::optional<std::string>&
+{
+    if (endpoints_) {
+        return endpoints_->last_dispatched_from;
+    }
+    return error_context::last_dispatched_from();
+}
+
+auto
+key_value_error_context::bucket() const -> const std::string&
+{
+    return (names_ ? names_ : core::impl::empty_collection_names())->bucket;
+}
+
+auto
+key_value_error_context::scope() const -> const std::string&
+{
+    return (names_ ? names_ : core::impl::empty_collection_names())->scope;
+}
+
+auto
+key_value_error_context::collection() const -> const std::string&
+{
+    return (names_ ? names_ : core::impl::empty_collection_names())->collection;
+}
+} // namespace couchbase
@@ -18,8 +18,11 @@
 #include "observe_poll.hxx"
 
 #include "core/cluster.hxx"
+#include "core/impl/observe_probe_coalescer.hxx"
 #include "core/impl/observe_seqno.hxx"
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <mutex>
 
@@ -184,7 +187,8 @@ class observe_context : public std::enable_shared_from_this<observe_context>
 
     void start()
     {
-        poll_deadline_.expires_after(poll_deadline_interval_);
+        deadline_ = std::chrono::steady_clock::now() + poll_deadline_interval_;
+        poll_deadline_.expires_at(deadline_);
         poll_deadline_.async_wait([ctx = shared_from_this()](std::error_code ec) {
             if (ec == asio::error::operation_aborted) {
                 return;
@@ -223,19 +227,30 @@ class observe_context : public std::enable_shared_from_this<observe_context>
         return replicate_to_;
     }
 
-    void add_request(observe_seqno_request&& request)
+    void add_request(observe_probe_coalescer::probe_key&& key, observe_seqno_request&& request)
     {
-        requests_.emplace_back(std::move(request));
+        requests_.emplace_back(std::move(key), std::move(request));
     }
 
-    void handle_response(observe_seqno_response&& response)
+    void handle_response(const observe_seqno_response& response)
     {
         --expect_number_of_responses_;
-        auto r = std::move(response);
-        status_.examine(r);
+        status_.examine(response);
         maybe_finish();
     }
 
+    /**
+     * The replication usually completes within few milliseconds, so the first probes are sent almost immediately, and the interval
+     * grows exponentially up to poll_max_backoff_interval_, but never beyond the deadline.
+     */
+    [[nodiscard]] auto next_poll_interval() -> std::chrono::microseconds
+    {
+        auto interval = poll_backoff_interval_;
+        poll_backoff_interval_ = std::min(poll_backoff_interval_ * 2, poll_max_backoff_interval_);
+        auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline_ - std::chrono::steady_clock::now());
+        return std::clamp(remaining, std::chrono::microseconds::zero(), interval);
+    }
+
     void finish(std::error_code ec)
     {
         poll_backoff_.cancel();
@@ -261,7 +276,7 @@ class observe_context : public std::enable_shared_from_this<observe_context>
             if (status_.meets_condition(persist_to_, replicate_to_)) {
                 std::swap(handler_, handler);
             } else if (expect_number_of_responses_ == 0 && on_last_response_) {
-                poll_backoff_.expires_after(poll_backoff_interval_);
+                poll_backoff_.expires_after(next_poll_interval());
                 return poll_backoff_.async_wait(std::move(on_last_response_));
             }
         }
@@ -286,9 +301,11 @@ class observe_context : public std::enable_shared_from_this<observe_context>
             }
             observe_poll(std::move(core), std::move(ctx));
         });
-        for (auto&& request : requests) {
-            core->execute(std::move(request),
-                          [ctx = shared_from_this()](observe_seqno_response&& response) { ctx->handle_response(std::move(response)); });
+        auto probes = core->observe_probes();
+        for (auto&& [key, request] : requests) {
+            probes->execute(core, std::move(key), std::move(request), [ctx = shared_from_this()](const observe_seqno_response& response) {
+                ctx->handle_response(response);
+            });
         }
     }
 
@@ -300,13 +317,15 @@ class observe_context : public std::enable_shared_from_this<observe_context>
     std::optional<std::chrono::milliseconds> timeout_;
     couchbase::persist_to persist_to_;
     couchbase::replicate_to replicate_to_;
-    std::vector<observe_seqno_request> requests_{};
+    std::vector<std::pair<observe_probe_coalescer::probe_key, observe_seqno_request>> requests_{};
     std::atomic_size_t expect_number_of_responses_{};
     std::mutex handler_mutex_{};
     observe_handler handler_{};
     std::function<void(std::error_code)> on_last_response_{};
-    std::chrono::milliseconds poll_backoff_interval_{ 500 };
+    std::chrono::microseconds poll_backoff_interval_{ 100 };
+    std::chrono::microseconds poll_max_backoff_interval_{ 500'000 };
     std::chrono::milliseconds poll_deadline_interval_{ 5'000 };
+    std::chrono::steady_clock::time_point deadline_{};
 };
 
 static void
@@ -323,15 +342,21 @@ observe_poll(std::shared_ptr<couchbase::core::cluster> core, std::shared_ptr<obs
               return ctx->finish(err);
           }
 
+          auto partition = config.map_key(ctx->id().key(), 0).first;
+          auto probe_key = [&ctx, partition](std::size_t node_index) {
+              return observe_probe_coalescer::probe_key{ ctx->bucket_name(), partition, node_index, ctx->partition_uuid() };
+          };
+
           if (ctx->persist_to() != persist_to::none) {
-              ctx->add_request(observe_seqno_request{ ctx->id(), true, ctx->partition_uuid(), ctx->timeout() });
+              ctx->add_request(probe_key(0), observe_seqno_request{ ctx->id(), true, ctx->partition_uuid(), ctx->timeout() });
           }
 
           if (touches_replica(ctx->persist_to(), ctx->replicate_to())) {
               for (std::uint32_t replica_index = 1; replica_index <= number_of_replicas; ++replica_index) {
                   auto replica_id = ctx->id();
                   replica_id.node_index(replica_index);
-                  ctx->add_request(observe_seqno_request{ replica_id, false, ctx->partition_uuid(), ctx->timeout() });
+                  ctx->add_request(probe_key(replica_index),
+                                   observe_seqno_request{ replica_id, false, ctx->partition_uuid(), ctx->timeout() });
               }
           }
           ctx->execute(core);
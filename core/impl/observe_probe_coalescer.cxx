@@ -0,0 +1,82 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "observe_probe_coalescer.hxx"
+
+#include "core/cluster.hxx"
+
+#include <algorithm>
+
+namespace couchbase::core::impl
+{
+void
+observe_probe_coalescer::execute(const std::shared_ptr<couchbase::core::cluster>& core,
+                                 probe_key key,
+                                 observe_seqno_request&& request,
+                                 probe_handler&& handler)
+{
+    // the default timeout is only used to compare the requests with each other, the request itself keeps using the cluster setting
+    auto deadline = std::chrono::steady_clock::now() + request.timeout.value_or(timeout_defaults::key_value_timeout);
+    auto in_flight = std::make_shared<probe>();
+    in_flight->deadline = deadline;
+    {
+        std::scoped_lock lock(mutex_);
+        auto [begin, end] = in_flight_.equal_range(key);
+        if (auto joined = std::find_if(begin, end, [deadline](const auto& entry) { return entry.second->deadline <= deadline; });
+            joined != end) {
+            // the response of the probe, that is already in flight, will be delivered to this handler too
+            joined->second->waiters.push_back({ std::move(handler), std::move(request), deadline });
+            return;
+        }
+        in_flight_.emplace(key, in_flight);
+    }
+    core->execute(std::move(request),
+                  [self = shared_from_this(), core, key = std::move(key), in_flight, handler = std::move(handler)](
+                    observe_seqno_response&& response) {
+                      self->complete(core, key, in_flight, response);
+                      handler(response);
+                  });
+}
+
+void
+observe_probe_coalescer::complete(const std::shared_ptr<couchbase::core::cluster>& core,
+                                  const probe_key& key,
+                                  const std::shared_ptr<probe>& completed,
+                                  const observe_seqno_response& response)
+{
+    std::vector<waiter> waiters{};
+    {
+        std::scoped_lock lock(mutex_);
+        auto [begin, end] = in_flight_.equal_range(key);
+        if (auto it = std::find_if(begin, end, [&completed](const auto& entry) { return entry.second == completed; }); it != end) {
+            in_flight_.erase(it);
+        }
+        std::swap(waiters, completed->waiters);
+    }
+    auto now = std::chrono::steady_clock::now();
+    for (auto& [handler, request, deadline] : waiters) {
+        if (auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+            response.ctx.ec() && remaining > std::chrono::milliseconds::zero()) {
+            // the error of the shared probe (for example its timeout) does not belong to this request, so it is sent on its own
+            request.timeout = remaining;
+            execute(core, key, std::move(request), std::move(handler));
+            continue;
+        }
+        handler(response);
+    }
+}
+} // namespace couchbase::core::impl
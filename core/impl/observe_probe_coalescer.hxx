@@ -0,0 +1,90 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include "observe_seqno.hxx"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace couchbase::core
+{
+class cluster;
+} // namespace couchbase::core
+
+namespace couchbase::core::impl
+{
+/**
+ * observe_seqno reports the state of the whole vBucket, so the probes of the concurrent observe operations, that target the same
+ * vBucket copy, could share single request. The coalescer is owned by the cluster.
+ *
+ * The request joins the probe in flight only if the probe completes before the deadline of the request. If the shared probe fails,
+ * the joined requests, which still have time left, are sent again on their own.
+ */
+class observe_probe_coalescer : public std::enable_shared_from_this<observe_probe_coalescer>
+{
+  public:
+    struct probe_key {
+        std::string bucket_name;
+        std::uint16_t partition;
+        std::size_t node_index;
+        std::uint64_t partition_uuid;
+
+        bool operator<(const probe_key& other) const
+        {
+            return std::tie(bucket_name, partition, node_index, partition_uuid) <
+                   std::tie(other.bucket_name, other.partition, other.node_index, other.partition_uuid);
+        }
+    };
+
+    using probe_handler = std::function<void(const observe_seqno_response&)>;
+
+    void execute(const std::shared_ptr<couchbase::core::cluster>& core,
+                 probe_key key,
+                 observe_seqno_request&& request,
+                 probe_handler&& handler);
+
+  private:
+    struct waiter {
+        probe_handler handler;
+        observe_seqno_request request;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    struct probe {
+        std::chrono::steady_clock::time_point deadline;
+        std::vector<waiter> waiters{};
+    };
+
+    void complete(const std::shared_ptr<couchbase::core::cluster>& core,
+                  const probe_key& key,
+                  const std::shared_ptr<probe>& completed,
+                  const observe_seqno_response& response);
+
+    std::mutex mutex_{};
+    std::multimap<probe_key, std::shared_ptr<probe>> in_flight_{};
+};
+} // namespace couchbase::core::impl
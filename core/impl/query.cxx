@@ -73,14 +73,33 @@ map_status(std::string status)
     return query_status::unknown;
 }
 
-static std::vector<codec::binary>
+struct packed_rows {
+    std::vector<std::byte> data{};
+    std::vector<std::size_t> offsets{};
+};
+
+/**
+ * Packs the rows into the single buffer, releasing the strings as they are copied, so that the large results neither allocate per
+ * row, nor keep two copies of the rows for the whole duration of the conversion.
+ */
+static packed_rows
 map_rows(operations::query_response& resp)
 {
-    std::vector<codec::binary> rows;
-    rows.reserve(resp.rows.size());
+    std::size_t rows_size{ 0 };
     for (const auto& row : resp.rows) {
-        rows.emplace_back(utils::to_binary(row));
+        rows_size += row.size();
+    }
+    packed_rows rows{};
+    rows.data.reserve(rows_size);
+    rows.offsets.reserve(resp.rows.size() + 1);
+    rows.offsets.push_back(0);
+    for (auto& row : resp.rows) {
+        const auto* begin = reinterpret_cast<const std::byte*>(row.data());
+        rows.data.insert(rows.data.end(), begin, begin + row.size());
+        rows.offsets.push_back(rows.data.size());
+        std::string{}.swap(row);
     }
+    resp.rows.clear();
     return rows;
 }
 
@@ -137,6 +156,7 @@ map_profile(operations::query_response& resp)
 static query_result
 build_result(operations::query_response& resp)
 {
+    auto rows = map_rows(resp);
     return {
         query_meta_data{
           std::move(resp.meta.request_id),
@@ -147,7 +167,8 @@ build_result(operations::query_response& resp)
           map_signature(resp),
           map_profile(resp),
         },
-        map_rows(resp),
+        std::move(rows.data),
+        std::move(rows.offsets),
     };
 }
 
@@ -204,6 +225,7 @@ build_transaction_query_result(operations::query_response resp, std::error_code
             txn_ec = errc::transaction_op::not_set;
         }
     }
+    auto rows = map_rows(resp);
     return {
         { txn_ec, build_context(resp) },
         { query_meta_data{
@@ -215,7 +237,8 @@ build_transaction_query_result(operations::query_response resp, std::error_code
             map_signature(resp),
             map_profile(resp),
           },
-          map_rows(resp) },
+          std::move(rows.data),
+          std::move(rows.offsets) },
     };
 }
 
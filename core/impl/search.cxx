@@ -142,13 +142,37 @@ build_search_request(std::string index_name,
     return request;
 }
 
+static std::function<core::utils::json::stream_control(core::operations::search_response::search_row&&)>
+map_row_handler(search_row_handler&& row_handler)
+{
+    return [row_handler = std::move(row_handler)](core::operations::search_response::search_row&& row) {
+        return row_handler(search_row{ internal_search_row{ std::move(row) } }) ? core::utils::json::stream_control::next_row
+                                                                                 : core::utils::json::stream_control::stop;
+    };
+}
+
+void
+cluster::search_query(std::string index_name,
+                      const class search_query& query,
+                      const search_options& options,
+                      search_handler&& handler) const
+{
+    auto request = build_search_request(std::move(index_name), query, options.build(), {}, {});
+
+    core_->execute(std::move(request), [handler = std::move(handler)](core::operations::search_response resp) mutable {
+        handler(search_error_context{ internal_search_error_context{ resp } }, search_result{ internal_search_result{ resp } });
+    });
+}
+
 void
 cluster::search_query(std::string index_name,
                       const class search_query& query,
                       const search_options& options,
+                      search_row_handler&& row_handler,
                       search_handler&& handler) const
 {
     auto request = build_search_request(std::move(index_name), query, options.build(), {}, {});
+    request.hit_callback = map_row_handler(std::move(row_handler));
 
     core_->execute(std::move(request), [handler = std::move(handler)](core::operations::search_response resp) mutable {
         handler(search_error_context{ internal_search_error_context{ resp } }, search_result{ internal_search_result{ resp } });
@@ -176,6 +200,21 @@ scope::search_query(std::string index_name, const class search_query& query, con
     });
 }
 
+void
+scope::search_query(std::string index_name,
+                    const class search_query& query,
+                    const search_options& options,
+                    search_row_handler&& row_handler,
+                    search_handler&& handler) const
+{
+    auto request = build_search_request(std::move(index_name), query, options.build(), bucket_name_, name_);
+    request.hit_callback = map_row_handler(std::move(row_handler));
+
+    core_->execute(std::move(request), [handler = std::move(handler)](core::operations::search_response resp) mutable {
+        return handler(search_error_context{ internal_search_error_context{ resp } }, search_result{ internal_search_result{ resp } });
+    });
+}
+
 auto
 scope::search_query(std::string index_name, const class search_query& query, const search_options& options) const
   -> std::future<std::pair<search_error_context, search_result>>
@@ -0,0 +1,165 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "connect_race.hxx"
+
+#include <asio/dispatch.hpp>
+#include <asio/error.hpp>
+#include <asio/post.hpp>
+
+namespace couchbase::core::io
+{
+connect_race::connect_race(executor_type executor,
+                           std::vector<asio::ip::tcp::endpoint> endpoints,
+                           std::chrono::milliseconds attempt_delay,
+                           handler_type&& handler)
+  : executor_(std::move(executor))
+  , endpoints_(interleave(std::move(endpoints)))
+  , attempt_delay_(attempt_delay)
+  , delay_timer_(executor_)
+  , handler_(std::move(handler))
+  , attempts_(endpoints_.size())
+{
+}
+
+std::shared_ptr<connect_race>
+connect_race::start(executor_type executor,
+                    std::vector<asio::ip::tcp::endpoint> endpoints,
+                    std::chrono::milliseconds attempt_delay,
+                    handler_type&& handler)
+{
+    auto race = std::make_shared<connect_race>(executor, std::move(endpoints), attempt_delay, std::move(handler));
+    asio::dispatch(executor, [race]() { race->start_next_attempt(); });
+    return race;
+}
+
+void
+connect_race::cancel()
+{
+    asio::post(executor_, [self = shared_from_this()]() {
+        self->done_ = true;
+        self->handler_ = nullptr;
+        self->close_attempts();
+    });
+}
+
+std::vector<asio::ip::tcp::endpoint>
+connect_race::interleave(std::vector<asio::ip::tcp::endpoint> endpoints)
+{
+    if (endpoints.size() < 2) {
+        return endpoints;
+    }
+    const bool first_is_v6 = endpoints.front().address().is_v6();
+    std::vector<asio::ip::tcp::endpoint> preferred{};
+    std::vector<asio::ip::tcp::endpoint> other{};
+    for (auto& endpoint : endpoints) {
+        if (endpoint.address().is_v6() == first_is_v6) {
+            preferred.emplace_back(std::move(endpoint));
+        } else {
+            other.emplace_back(std::move(endpoint));
+        }
+    }
+    std::vector<asio::ip::tcp::endpoint> result{};
+    result.reserve(endpoints.size());
+    for (std::size_t i = 0; i < preferred.size() || i < other.size(); ++i) {
+        if (i < preferred.size()) {
+            result.emplace_back(std::move(preferred[i]));
+        }
+        if (i < other.size()) {
+            result.emplace_back(std::move(other[i]));
+        }
+    }
+    return result;
+}
+
+void
+connect_race::start_next_attempt()
+{
+    if (done_) {
+        return;
+    }
+    if (next_attempt_ >= endpoints_.size()) {
+        if (pending_attempts_ == 0) {
+            std::error_code ec = last_error_;
+            if (!ec) {
+                ec = asio::error::host_not_found;
+            }
+            finish(ec, asio::ip::tcp::socket(executor_), {});
+        }
+        return;
+    }
+
+    auto index = next_attempt_++;
+    ++pending_attempts_;
+    attempts_[index] = std::make_unique<asio::ip::tcp::socket>(executor_);
+    attempts_[index]->async_connect(endpoints_[index], [self = shared_from_this(), index](std::error_code ec) {
+        self->on_attempt_completed(index, ec);
+    });
+
+    if (next_attempt_ < endpoints_.size()) {
+        delay_timer_.expires_after(attempt_delay_);
+        delay_timer_.async_wait([self = shared_from_this()](std::error_code ec) {
+            // the timer might have been re-armed by failed attempt after this handler has been queued
+            if (ec == asio::error::operation_aborted || self->delay_timer_.expiry() > std::chrono::steady_clock::now()) {
+                return;
+            }
+            self->start_next_attempt();
+        });
+    }
+}
+
+void
+connect_race::on_attempt_completed(std::size_t index, std::error_code ec)
+{
+    --pending_attempts_;
+    if (done_) {
+        return;
+    }
+    if (!ec) {
+        auto socket = std::move(*attempts_[index]);
+        attempts_[index].reset();
+        return finish(ec, std::move(socket), endpoints_[index]);
+    }
+    last_error_ = ec;
+    attempts_[index].reset();
+    // do not wait for the delay, the failure has been already observed
+    delay_timer_.cancel();
+    start_next_attempt();
+}
+
+void
+connect_race::finish(std::error_code ec, asio::ip::tcp::socket socket, asio::ip::tcp::endpoint endpoint)
+{
+    done_ = true;
+    close_attempts();
+    if (auto handler = std::move(handler_); handler) {
+        handler(ec, std::move(socket), std::move(endpoint));
+    }
+}
+
+void
+connect_race::close_attempts()
+{
+    delay_timer_.cancel();
+    for (auto& attempt : attempts_) {
+        if (attempt) {
+            std::error_code ignored{};
+            attempt->close(ignored);
+        }
+    }
+}
+} // namespace couchbase::core::io
@@ -0,0 +1,92 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include "core/utils/movable_function.hxx"
+
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/steady_timer.hpp>
+#include <asio/strand.hpp>
+
+#include <chrono>
+#include <memory>
+#include <system_error>
+#include <vector>
+
+namespace couchbase::core::io
+{
+/**
+ * Connects to the first reachable address of the node, in the spirit of "Happy Eyeballs" (RFC 8305).
+ *
+ * Instead of trying the addresses one by one, and waiting for the connect timeout on each unreachable address, the next attempt is
+ * started when the previous one fails, or when it has not completed within attempt delay. The addresses are interleaved by family,
+ * so that broken IPv6 connectivity costs one attempt delay rather than the connect timeout. The first established connection wins,
+ * the other attempts are closed.
+ *
+ * All handlers are executed on the strand, that has been passed to start().
+ */
+class connect_race : public std::enable_shared_from_this<connect_race>
+{
+  public:
+    using executor_type = asio::strand<asio::io_context::executor_type>;
+    using handler_type = utils::movable_function<void(std::error_code, asio::ip::tcp::socket, asio::ip::tcp::endpoint)>;
+
+    connect_race(executor_type executor,
+                 std::vector<asio::ip::tcp::endpoint> endpoints,
+                 std::chrono::milliseconds attempt_delay,
+                 handler_type&& handler);
+
+    /**
+     * Starts the race. The handler receives connected socket and its remote endpoint, or the error of the last failed attempt.
+     *
+     * @return handle, that can be used to cancel the race
+     */
+    static std::shared_ptr<connect_race> start(executor_type executor,
+                                               std::vector<asio::ip::tcp::endpoint> endpoints,
+                                               std::chrono::milliseconds attempt_delay,
+                                               handler_type&& handler);
+
+    /**
+     * Closes all pending attempts. The handler will not be invoked after cancellation.
+     */
+    void cancel();
+
+    /**
+     * Reorders the addresses, so that the families alternate, starting from the family of the first address.
+     */
+    [[nodiscard]] static std::vector<asio::ip::tcp::endpoint> interleave(std::vector<asio::ip::tcp::endpoint> endpoints);
+
+  private:
+    void start_next_attempt();
+    void on_attempt_completed(std::size_t index, std::error_code ec);
+    void finish(std::error_code ec, asio::ip::tcp::socket socket, asio::ip::tcp::endpoint endpoint);
+    void close_attempts();
+
+    executor_type executor_;
+    std::vector<asio::ip::tcp::endpoint> endpoints_;
+    std::chrono::milliseconds attempt_delay_;
+    asio::steady_timer delay_timer_;
+    handler_type handler_;
+    std::vector<std::unique_ptr<asio::ip::tcp::socket>> attempts_{};
+    std::size_t next_attempt_{ 0 };
+    std::size_t pending_attempts_{ 0 };
+    std::error_code last_error_{};
+    bool done_{ false };
+};
+} // namespace couchbase::core::io
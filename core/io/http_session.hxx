@@ -24,9 +24,11 @@
 #include "core/platform/base64.h"
 #include "core/platform/uuid.h"
 #include "core/utils/movable_function.hxx"
+#include "connect_race.hxx"
 #include "http_context.hxx"
 #include "http_message.hxx"
 #include "http_parser.hxx"
+#include "resolve_cache.hxx"
 #include "streams.hxx"
 
 #include <couchbase/error_codes.hxx>
@@ -118,7 +120,6 @@ class http_session : public std::enable_shared_from_this<http_session>
       , client_id_(client_id)
       , id_(uuid::to_string(uuid::random()))
       , ctx_(ctx)
-      , resolver_(ctx_)
       , stream_(std::make_unique<plain_stream_impl>(ctx_))
       , deadline_timer_(stream_->get_executor())
       , idle_timer_(stream_->get_executor())
@@ -143,7 +144,6 @@ class http_session : public std::enable_shared_from_this<http_session>
       , client_id_(client_id)
       , id_(uuid::to_string(uuid::random()))
       , ctx_(ctx)
-      , resolver_(ctx_)
       , stream_(std::make_unique<tls_stream_impl>(ctx_, tls))
       , deadline_timer_(ctx_)
       , idle_timer_(ctx_)
@@ -198,11 +198,19 @@ class http_session : public std::enable_shared_from_this<http_session>
     void start()
     {
         state_ = diag::endpoint_state::connecting;
-        async_resolve(http_ctx_.options.use_ip_protocol,
-                      resolver_,
-                      hostname_,
-                      service_,
-                      std::bind(&http_session::on_resolve, shared_from_this(), std::placeholders::_1, std::placeholders::_2));
+        resolve_cache::instance().resolve(
+          http_ctx_.options.use_ip_protocol,
+          hostname_,
+          service_,
+          http_ctx_.options.dns_cache_ttl,
+          http_ctx_.options.dns_negative_cache_ttl,
+          http_ctx_.options.resolve_timeout,
+          [self = shared_from_this()](std::error_code ec, resolve_cache::endpoints_type endpoints) {
+              // the handler is invoked on the thread of the cache
+              asio::post(self->ctx_, [self, ec, endpoints = std::move(endpoints)]() mutable {
+                  self->on_resolve(ec, std::move(endpoints));
+              });
+          });
     }
 
     [[nodiscard]] std::string log_prefix()
@@ -249,6 +257,9 @@ class http_session : public std::enable_shared_from_this<http_session>
         }
         stopped_ = true;
         state_ = diag::endpoint_state::disconnecting;
+        if (auto race = std::move(connect_race_); race) {
+            race->cancel();
+        }
         stream_->close([](std::error_code) {});
         deadline_timer_.cancel();
         idle_timer_.cancel();
@@ -361,7 +372,7 @@ class http_session : public std::enable_shared_from_this<http_session>
         http_parser parser{};
     };
 
-    void on_resolve(std::error_code ec, const asio::ip::tcp::resolver::results_type& endpoints)
+    void on_resolve(std::error_code ec, std::vector<asio::ip::tcp::endpoint> endpoints)
     {
         if (ec == asio::error::operation_aborted || stopped_) {
             return;
@@ -371,31 +382,33 @@ class http_session : public std::enable_shared_from_this<http_session>
             return;
         }
         last_active_ = std::chrono::steady_clock::now();
-        endpoints_ = endpoints;
-        do_connect(endpoints_.begin());
+        CB_LOG_DEBUG("{} connecting to {} address(es), timeout={}ms",
+                     info_.log_prefix(),
+                     endpoints.size(),
+                     http_ctx_.options.connect_timeout.count());
+        deadline_timer_.expires_after(http_ctx_.options.connect_timeout);
+        connect_race_ = connect_race::start(
+          stream_->get_executor(),
+          std::move(endpoints),
+          http_ctx_.options.connection_attempt_delay,
+          [self = shared_from_this()](std::error_code race_ec, asio::ip::tcp::socket socket, asio::ip::tcp::endpoint endpoint) {
+              if (self->stopped_) {
+                  return;
+              }
+              if (race_ec) {
+                  CB_LOG_ERROR("{} unable to connect to any address: {}", self->info_.log_prefix(), race_ec.message());
+                  resolve_cache::instance().invalidate(self->hostname_, self->service_);
+                  return self->stop();
+              }
+              self->stream_->set_server_name(self->hostname_, self->service_);
+              self->stream_->async_attach(std::move(socket), [self, endpoint](std::error_code ec_attach) {
+                  self->on_connect(ec_attach, endpoint);
+              });
+          });
         deadline_timer_.async_wait(std::bind(&http_session::check_deadline, shared_from_this(), std::placeholders::_1));
     }
 
-    void do_connect(asio::ip::tcp::resolver::results_type::iterator it)
-    {
-        if (stopped_) {
-            return;
-        }
-        if (it != endpoints_.end()) {
-            CB_LOG_DEBUG("{} connecting to {}:{}, timeout={}ms",
-                         info_.log_prefix(),
-                         it->endpoint().address().to_string(),
-                         it->endpoint().port(),
-                         http_ctx_.options.connect_timeout.count());
-            deadline_timer_.expires_after(http_ctx_.options.connect_timeout);
-            stream_->async_connect(it->endpoint(), std::bind(&http_session::on_connect, shared_from_this(), std::placeholders::_1, it));
-        } else {
-            CB_LOG_ERROR("{} no more endpoints left to connect", info_.log_prefix());
-            stop();
-        }
-    }
-
-    void on_connect(const std::error_code& ec, asio::ip::tcp::resolver::results_type::iterator it)
+    void on_connect(const std::error_code& ec, const asio::ip::tcp::endpoint& endpoint)
     {
         if (ec == asio::error::operation_aborted || stopped_) {
             return;
@@ -404,26 +417,21 @@ class http_session : public std::enable_shared_from_this<http_session>
         if (!stream_->is_open() || ec) {
             CB_LOG_WARNING("{} unable to connect to {}:{}: {}{}",
                            info_.log_prefix(),
-                           it->endpoint().address().to_string(),
-                           it->endpoint().port(),
+                           endpoint.address().to_string(),
+                           endpoint.port(),
                            ec.message(),
                            (ec == asio::error::connection_refused) ? ", check server ports and cluster encryption setting" : "");
-            if (stream_->is_open()) {
-                stream_->close(std::bind(&http_session::do_connect, shared_from_this(), ++it));
-            } else {
-                do_connect(++it);
-            }
-        } else {
-            state_ = diag::endpoint_state::connected;
-            connected_ = true;
-            CB_LOG_DEBUG("{} connected to {}:{}", info_.log_prefix(), it->endpoint().address().to_string(), it->endpoint().port());
-            {
-                std::scoped_lock lock(info_mutex_);
-                info_ = http_session_info(client_id_, id_, stream_->local_endpoint(), it->endpoint());
-            }
-            deadline_timer_.cancel();
-            flush();
+            return stop();
+        }
+        state_ = diag::endpoint_state::connected;
+        connected_ = true;
+        CB_LOG_DEBUG("{} connected to {}:{}", info_.log_prefix(), endpoint.address().to_string(), endpoint.port());
+        {
+            std::scoped_lock lock(info_mutex_);
+            info_ = http_session_info(client_id_, id_, stream_->local_endpoint(), endpoint);
         }
+        deadline_timer_.cancel();
+        flush();
     }
 
     void check_deadline(std::error_code ec)
@@ -432,6 +440,9 @@ class http_session : public std::enable_shared_from_this<http_session>
             return;
         }
         if (deadline_timer_.expiry() <= asio::steady_timer::clock_type::now()) {
+            if (auto race = std::move(connect_race_); race) {
+                race->cancel();
+            }
             stream_->close([](std::error_code) {});
             deadline_timer_.cancel();
             return;
@@ -526,8 +537,8 @@ class http_session : public std::enable_shared_from_this<http_session>
     std::string client_id_;
     std::string id_;
     asio::io_context& ctx_;
-    asio::ip::tcp::resolver resolver_;
     std::unique_ptr<stream_impl> stream_;
+    std::shared_ptr<connect_race> connect_race_{};
     asio::steady_timer deadline_timer_;
     asio::steady_timer idle_timer_;
 
@@ -551,7 +562,6 @@ class http_session : public std::enable_shared_from_this<http_session>
     std::vector<std::vector<std::uint8_t>> writing_buffer_{};
     std::mutex output_buffer_mutex_{};
     std::mutex writing_buffer_mutex_{};
-    asio::ip::tcp::resolver::results_type endpoints_{};
     http_session_info info_;
     std::mutex info_mutex_{};
     couchbase::core::http_context http_ctx_;
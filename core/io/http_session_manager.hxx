@@ -26,6 +26,7 @@
 #include "http_context.hxx"
 #include "http_session.hxx"
 #include "http_traits.hxx"
+#include "io_context_pool.hxx"
 
 #include <gsl/narrow>
 
@@ -56,6 +57,11 @@ class http_session_manager
         meter_ = std::move(meter);
     }
 
+    void set_io_context_pool(std::shared_ptr<io_context_pool> shards)
+    {
+        shards_ = std::move(shards);
+    }
+
     void update_config(topology::configuration config) override
     {
         std::scoped_lock config_lock(config_mutex_, sessions_mutex_);
@@ -128,7 +134,7 @@ class http_session_manager
                     session = options_.enable_tls
                                 ? std::make_shared<http_session>(type,
                                                                  client_id_,
-                                                                 ctx_,
+                                                                 session_context(),
                                                                  tls_,
                                                                  credentials,
                                                                  hostname,
@@ -136,7 +142,7 @@ class http_session_manager
                                                                  http_context{ config_, options_, query_cache_, hostname, port })
                                 : std::make_shared<http_session>(type,
                                                                  client_id_,
-                                                                 ctx_,
+                                                                 session_context(),
                                                                  credentials,
                                                                  hostname,
                                                                  std::to_string(port),
@@ -297,6 +303,11 @@ class http_session_manager
     }
 
   private:
+    [[nodiscard]] asio::io_context& session_context()
+    {
+        return shards_ ? shards_->next() : ctx_;
+    }
+
     std::shared_ptr<http_session> bootstrap_session(service_type type,
                                                     const couchbase::core::cluster_credentials& credentials,
                                                     const std::string& hostname,
@@ -306,7 +317,7 @@ class http_session_manager
         if (options_.enable_tls) {
             session = std::make_shared<http_session>(type,
                                                      client_id_,
-                                                     ctx_,
+                                                     session_context(),
                                                      tls_,
                                                      credentials,
                                                      hostname,
@@ -315,7 +326,7 @@ class http_session_manager
         } else {
             session = std::make_shared<http_session>(type,
                                                      client_id_,
-                                                     ctx_,
+                                                     session_context(),
                                                      credentials,
                                                      hostname,
                                                      std::to_string(port),
@@ -374,6 +385,7 @@ class http_session_manager
     std::string client_id_;
     asio::io_context& ctx_;
     asio::ssl::context& tls_;
+    std::shared_ptr<io_context_pool> shards_{};
     std::shared_ptr<couchbase::tracing::request_tracer> tracer_{ nullptr };
     std::shared_ptr<couchbase::metrics::meter> meter_{ nullptr };
     cluster_options options_{};
@@ -0,0 +1,117 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "io_context_pool.hxx"
+
+#include "core/logger/logger.hxx"
+
+#include <asio/post.hpp>
+
+#include <algorithm>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace couchbase::core::io
+{
+namespace
+{
+void
+pin_current_thread(std::size_t shard_index)
+{
+#if defined(__linux__)
+    auto number_of_cpus = std::max(1U, std::thread::hardware_concurrency());
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(shard_index % number_of_cpus, &cpus);
+    if (auto rc = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus); rc != 0) {
+        CB_LOG_WARNING("unable to pin IO shard #{} to CPU {}: {}", shard_index, shard_index % number_of_cpus, rc);
+    }
+#else
+    CB_LOG_DEBUG("pinning of IO shard #{} is not supported on this platform", shard_index);
+#endif
+}
+} // namespace
+
+io_context_pool::io_context_pool(std::size_t number_of_shards, bool pin_threads)
+{
+    number_of_shards = std::max<std::size_t>(1, number_of_shards);
+    shards_.reserve(number_of_shards);
+    for (std::size_t i = 0; i < number_of_shards; ++i) {
+        shards_.emplace_back(std::make_unique<io_shard>());
+    }
+    for (std::size_t i = 0; i < number_of_shards; ++i) {
+        shards_[i]->thread = std::thread([shard = shards_[i].get(), i, pin_threads]() {
+            if (pin_threads) {
+                pin_current_thread(i);
+            }
+            shard->ctx.run();
+        });
+    }
+    CB_LOG_DEBUG("started {} IO shards{}", number_of_shards, pin_threads ? " (pinned to CPUs)" : "");
+}
+
+io_context_pool::~io_context_pool()
+{
+    // the pool is owned by the cluster and its buckets, so the operations, that are still pending at this point, belong to the sessions
+    // that nobody can use anymore
+    for (const auto& shard : shards_) {
+        shard->ctx.stop();
+    }
+    for (auto& shard : shards_) {
+        if (!shard->thread.joinable()) {
+            continue;
+        }
+        if (shard->thread.get_id() == std::this_thread::get_id()) {
+            // the last reference to the pool has been released by the handler running on the shard itself, the thread is still inside
+            // of io_context::run(), so neither the thread can be joined nor the context can be destroyed
+            shard->thread.detach();
+            static_cast<void>(shard.release());
+        } else {
+            shard->thread.join();
+        }
+    }
+}
+
+void
+io_context_pool::stop()
+{
+    for (const auto& entry : shards_) {
+        asio::post(entry->ctx, [shard = entry.get()]() { shard->work.reset(); });
+    }
+}
+
+asio::io_context&
+io_context_pool::next()
+{
+    return shards_[next_shard_.fetch_add(1, std::memory_order_relaxed) % shards_.size()]->ctx;
+}
+
+asio::io_context&
+io_context_pool::shard(std::size_t index)
+{
+    return shards_[index % shards_.size()]->ctx;
+}
+
+std::size_t
+io_context_pool::size() const
+{
+    return shards_.size();
+}
+} // namespace couchbase::core::io
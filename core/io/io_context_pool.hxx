@@ -0,0 +1,76 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <asio/executor_work_guard.hpp>
+#include <asio/io_context.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace couchbase::core::io
+{
+/**
+ * Set of IO contexts (shards), each of them run by its own thread.
+ *
+ * Every session is assigned to a single shard when it is created, so that its socket, timers and the handlers of the responses stay on
+ * one thread, instead of migrating between the threads that share single asio::io_context.
+ */
+class io_context_pool
+{
+  public:
+    /**
+     * @param number_of_shards number of IO contexts and threads (at least one)
+     * @param pin_threads bind thread of the shard N to CPU N (modulo number of CPUs). Only supported on Linux, ignored elsewhere.
+     */
+    io_context_pool(std::size_t number_of_shards, bool pin_threads);
+    io_context_pool(const io_context_pool&) = delete;
+    io_context_pool(io_context_pool&&) = delete;
+    io_context_pool& operator=(const io_context_pool&) = delete;
+    io_context_pool& operator=(io_context_pool&&) = delete;
+    ~io_context_pool();
+
+    /**
+     * Lets the threads exit as soon as all started operations have completed. Does not block, because the sessions might still need the
+     * IO context of the caller to shut down. The destructor stops the contexts and joins the threads.
+     */
+    void stop();
+
+    /**
+     * @return IO context of the next shard (round-robin)
+     */
+    [[nodiscard]] asio::io_context& next();
+
+    [[nodiscard]] asio::io_context& shard(std::size_t index);
+
+    [[nodiscard]] std::size_t size() const;
+
+  private:
+    struct io_shard {
+        asio::io_context ctx{ 1 };
+        asio::executor_work_guard<asio::io_context::executor_type> work{ asio::make_work_guard(ctx) };
+        std::thread thread{};
+    };
+
+    std::vector<std::unique_ptr<io_shard>> shards_{};
+    std::atomic_size_t next_shard_{ 0 };
+};
+} // namespace couchbase::core::io
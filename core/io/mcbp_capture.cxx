@@ -0,0 +1,394 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "mcbp_capture.hxx"
+
+#include "core/logger/logger.hxx"
+#include "core/platform/dirutils.h"
+#include "core/protocol/client_opcode.hxx"
+#include "core/protocol/magic.hxx"
+#include "mcbp_message.hxx"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#ifdef _MSC_VER
+#include <io.h>
+#include <share.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace couchbase::core::io
+{
+namespace
+{
+/**
+ * The IO threads wake up the writer only when this much data has been accumulated, otherwise the writer picks the data up periodically.
+ */
+constexpr std::size_t flush_threshold{ 256 * 1024 };
+constexpr std::chrono::milliseconds flush_interval{ 100 };
+
+template<typename T>
+void
+store_le(std::byte* out, T value)
+{
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        out[i] = static_cast<std::byte>(static_cast<std::uint64_t>(value) >> (8 * i));
+    }
+}
+
+template<typename T>
+T
+load_le(const std::byte* in)
+{
+    std::uint64_t value{ 0 };
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+    }
+    return static_cast<T>(value);
+}
+
+std::string
+capture_file_name(const std::string& base_name, std::uint64_t id)
+{
+    return fmt::format("{}.{:06}.mcbp", base_name, id);
+}
+
+std::uint64_t
+find_next_capture_file_id(const std::string& base_name)
+{
+    std::uint64_t next_id{ 0 };
+    for (auto file : platform::find_files_with_prefix(base_name)) {
+        auto index = file.rfind(".mcbp");
+        if (index == std::string::npos) {
+            continue;
+        }
+        file.resize(index);
+        index = file.rfind('.');
+        if (index == std::string::npos) {
+            continue;
+        }
+        try {
+            next_id = std::max<std::uint64_t>(next_id, std::stoull(file.substr(index + 1)) + 1);
+        } catch (const std::invalid_argument&) {
+            continue; /* ignore */
+        } catch (const std::out_of_range&) {
+            continue; /* ignore */
+        }
+    }
+    return next_id;
+}
+
+/**
+ * The value of SASL_AUTH and SASL_STEP requests holds the credentials (or the proofs derived from them), so it is replaced with zeros
+ * before the frame gets into the buffer. The header, extras and key (mechanism name) are kept, so the capture still could be replayed.
+ *
+ * @return offset of the bytes that have to be redacted, or size of the frame if the frame can be stored as is
+ */
+std::size_t
+sasl_value_offset(const std::byte* frame, std::size_t header_size, std::size_t frame_size)
+{
+    if (header_size < protocol::header_size) {
+        return frame_size;
+    }
+    if (auto opcode = static_cast<protocol::client_opcode>(frame[1]);
+        opcode != protocol::client_opcode::sasl_auth && opcode != protocol::client_opcode::sasl_step) {
+        return frame_size;
+    }
+    std::size_t offset{ protocol::header_size + std::to_integer<std::size_t>(frame[4]) };
+    switch (static_cast<protocol::magic>(frame[0])) {
+        case protocol::magic::client_request:
+            offset += (std::to_integer<std::size_t>(frame[2]) << 8U) | std::to_integer<std::size_t>(frame[3]);
+            break;
+        case protocol::magic::alt_client_request:
+            offset += std::to_integer<std::size_t>(frame[2]) + std::to_integer<std::size_t>(frame[3]);
+            break;
+        default:
+            return frame_size;
+    }
+    return std::min(offset, frame_size);
+}
+
+/**
+ * Creates new file, that is readable only by its owner, because the capture exposes the documents and the metadata of the cluster.
+ */
+std::FILE*
+create_private_file(const std::string& file_name)
+{
+#ifdef _MSC_VER
+    int fd{ -1 };
+    if (auto rc = _sopen_s(&fd, file_name.c_str(), _O_WRONLY | _O_CREAT | _O_EXCL | _O_BINARY, _SH_DENYNO, _S_IREAD | _S_IWRITE); rc != 0) {
+        return nullptr;
+    }
+    std::FILE* file = _fdopen(fd, "wb");
+    if (file == nullptr) {
+        _close(fd);
+    }
+#else
+    int fd = ::open(file_name.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd == -1) {
+        return nullptr;
+    }
+    std::FILE* file = ::fdopen(fd, "wb");
+    if (file == nullptr) {
+        auto saved_errno = errno;
+        ::close(fd);
+        errno = saved_errno;
+    }
+#endif
+    return file;
+}
+} // namespace
+
+mcbp_capture_writer::mcbp_capture_writer(mcbp_capture_options options)
+  : options_{ std::move(options) }
+  , next_file_id_{ find_next_capture_file_id(options_.path) }
+{
+    open_next_file();
+    active_.reserve(std::min(options_.max_buffered_size, 2 * flush_threshold));
+    worker_ = std::thread([this]() { run(); });
+}
+
+mcbp_capture_writer::~mcbp_capture_writer()
+{
+    {
+        std::scoped_lock lock(mutex_);
+        stopped_ = true;
+    }
+    wakeup_.notify_one();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    if (file_ != nullptr) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+std::shared_ptr<mcbp_capture_writer>
+mcbp_capture_writer::open(const mcbp_capture_options& options)
+{
+    if (options.path.empty()) {
+        return nullptr;
+    }
+
+    static std::mutex registry_mutex;
+    static std::map<std::string, std::weak_ptr<mcbp_capture_writer>> registry;
+
+    std::scoped_lock lock(registry_mutex);
+    if (auto existing = registry[options.path].lock(); existing) {
+        return existing;
+    }
+    try {
+        auto writer = std::make_shared<mcbp_capture_writer>(options);
+        registry[options.path] = writer;
+        CB_LOG_INFO(R"(capturing MCBP traffic to "{}")", writer->current_file());
+        return writer;
+    } catch (const std::system_error& e) {
+        CB_LOG_WARNING(R"(unable to start MCBP capture to "{}": {})", options.path, e.what());
+    }
+    return nullptr;
+}
+
+void
+mcbp_capture_writer::record(const uuid::uuid_t& session_id,
+                            capture_direction direction,
+                            const std::byte* header,
+                            std::size_t header_size,
+                            const std::byte* body,
+                            std::size_t body_size)
+{
+    std::array<std::byte, capture_format::record_header_size> record_header{};
+    auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    store_le(record_header.data(), static_cast<std::uint64_t>(timestamp));
+    std::memcpy(record_header.data() + 8, session_id.data(), session_id.size());
+    record_header[24] = static_cast<std::byte>(direction);
+    store_le(record_header.data() + 28, static_cast<std::uint32_t>(header_size + body_size));
+    auto redacted_offset = header_size + body_size;
+    if (direction == capture_direction::send) {
+        redacted_offset = sasl_value_offset(header, header_size, header_size + body_size);
+    }
+
+    bool wakeup_writer{ false };
+    {
+        std::scoped_lock lock(mutex_);
+        if (stopped_ || active_.size() + record_header.size() + header_size + body_size > options_.max_buffered_size) {
+            ++dropped_records_;
+            return;
+        }
+        active_.insert(active_.end(), record_header.begin(), record_header.end());
+        auto frame_offset = active_.size();
+        active_.insert(active_.end(), header, header + header_size);
+        if (body_size > 0) {
+            active_.insert(active_.end(), body, body + body_size);
+        }
+        std::fill(active_.begin() + static_cast<std::ptrdiff_t>(frame_offset + redacted_offset), active_.end(), std::byte{ 0 });
+        ++appended_generation_;
+        wakeup_writer = active_.size() >= flush_threshold;
+    }
+    if (wakeup_writer) {
+        wakeup_.notify_one();
+    }
+}
+
+void
+mcbp_capture_writer::flush()
+{
+    std::unique_lock lock(mutex_);
+    auto generation = appended_generation_;
+    flush_requested_ = true;
+    wakeup_.notify_one();
+    flushed_.wait(lock, [this, generation]() { return written_generation_ >= generation; });
+}
+
+std::uint64_t
+mcbp_capture_writer::dropped_records() const
+{
+    std::scoped_lock lock(mutex_);
+    return dropped_records_;
+}
+
+std::string
+mcbp_capture_writer::current_file() const
+{
+    std::scoped_lock lock(mutex_);
+    return current_file_;
+}
+
+void
+mcbp_capture_writer::run()
+{
+    std::unique_lock lock(mutex_);
+    while (true) {
+        wakeup_.wait_for(lock, flush_interval, [this]() { return stopped_ || flush_requested_ || active_.size() >= flush_threshold; });
+        flush_requested_ = false;
+        if (active_.empty()) {
+            written_generation_ = appended_generation_;
+            flushed_.notify_all();
+            if (stopped_) {
+                return;
+            }
+            continue;
+        }
+        std::swap(active_, writing_);
+        auto generation = appended_generation_;
+        lock.unlock();
+        write_to_file(writing_);
+        writing_.clear();
+        lock.lock();
+        written_generation_ = generation;
+        flushed_.notify_all();
+    }
+}
+
+void
+mcbp_capture_writer::write_to_file(const std::vector<std::byte>& data)
+{
+    if (file_ == nullptr) {
+        return;
+    }
+    if (std::fwrite(data.data(), 1, data.size(), file_) != data.size()) {
+        CB_LOG_WARNING(R"(unable to write {} bytes of MCBP capture to "{}")", data.size(), current_file());
+    }
+    std::fflush(file_);
+    current_file_size_ += data.size();
+    if (current_file_size_ >= options_.max_file_size) {
+        try {
+            open_next_file();
+        } catch (const std::system_error& e) {
+            CB_LOG_WARNING(R"(unable to rotate MCBP capture "{}": {})", current_file(), e.what());
+        }
+    }
+}
+
+void
+mcbp_capture_writer::open_next_file()
+{
+    auto id = next_file_id_;
+    auto file_name = capture_file_name(options_.path, id);
+    std::FILE* file = create_private_file(file_name);
+    if (file == nullptr) {
+        throw std::system_error(errno, std::generic_category(), file_name);
+    }
+
+    std::array<std::byte, capture_format::file_header_size> file_header{};
+    std::memcpy(file_header.data(), capture_format::magic, sizeof(capture_format::magic));
+    store_le(file_header.data() + sizeof(capture_format::magic), capture_format::version);
+    std::fwrite(file_header.data(), 1, file_header.size(), file);
+
+    if (file_ != nullptr) {
+        std::fclose(file_);
+    }
+    file_ = file;
+    current_file_size_ = file_header.size();
+    ++next_file_id_;
+    {
+        std::scoped_lock lock(mutex_);
+        current_file_ = std::move(file_name);
+    }
+
+    if (options_.max_files > 0 && id >= options_.max_files) {
+        std::remove(capture_file_name(options_.path, id - options_.max_files).c_str());
+    }
+}
+
+mcbp_capture_reader::mcbp_capture_reader(const std::string& path)
+  : file_{ std::fopen(path.c_str(), "rb") }
+{
+    if (file_ == nullptr) {
+        throw std::system_error(errno, std::generic_category(), path);
+    }
+    std::array<std::byte, capture_format::file_header_size> file_header{};
+    if (std::fread(file_header.data(), 1, file_header.size(), file_) != file_header.size() ||
+        std::memcmp(file_header.data(), capture_format::magic, sizeof(capture_format::magic)) != 0) {
+        std::fclose(file_);
+        throw std::runtime_error(fmt::format(R"("{}" is not an MCBP capture file)", path));
+    }
+    if (auto version = load_le<std::uint16_t>(file_header.data() + sizeof(capture_format::magic)); version != capture_format::version) {
+        std::fclose(file_);
+        throw std::runtime_error(fmt::format(R"("{}" has unsupported MCBP capture version {})", path, version));
+    }
+}
+
+mcbp_capture_reader::~mcbp_capture_reader()
+{
+    std::fclose(file_);
+}
+
+bool
+mcbp_capture_reader::next(mcbp_capture_record& record)
+{
+    std::array<std::byte, capture_format::record_header_size> record_header{};
+    if (std::fread(record_header.data(), 1, record_header.size(), file_) != record_header.size()) {
+        return false;
+    }
+    record.timestamp = std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+      std::chrono::nanoseconds(load_le<std::uint64_t>(record_header.data()))));
+    std::memcpy(record.session_id.data(), record_header.data() + 8, record.session_id.size());
+    record.direction = static_cast<capture_direction>(record_header[24]);
+    record.data.resize(load_le<std::uint32_t>(record_header.data() + 28));
+    return std::fread(record.data.data(), 1, record.data.size(), file_) == record.data.size();
+}
+} // namespace couchbase::core::io
@@ -0,0 +1,161 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include "mcbp_capture_options.hxx"
+
+#include "core/platform/uuid.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace couchbase::core::io
+{
+/**
+ * Binary capture of the MCBP traffic.
+ *
+ * The file starts with 16 bytes header: "CBMCBPCP" magic, 16-bit format version, and six reserved bytes. It is followed by the records,
+ * each of them has 32 bytes header (all integers are little-endian):
+ *
+ *   uint64  timestamp, nanoseconds since UNIX epoch
+ *   uint8   session id (UUID of the MCBP session) [16]
+ *   uint8   direction (0 - sent to the server, 1 - received from the server)
+ *   uint8   reserved [3]
+ *   uint32  size of the data
+ *
+ * and the data as it appears on the wire. Sent records always contain single MCBP frame (header with body), while received records
+ * contain the bytes as they have been read from the socket, so they might hold partial frames, or several frames at once. Feeding
+ * them into mcbp_parser reproduces the read path of the session.
+ *
+ * The value of sent SASL_AUTH and SASL_STEP frames is replaced with zeros, so that the credentials never reach the disk. The files are
+ * created with permissions for the owner only.
+ */
+enum class capture_direction : std::uint8_t {
+    send = 0,
+    receive = 1,
+};
+
+namespace capture_format
+{
+static constexpr std::uint16_t version{ 1 };
+static constexpr std::size_t file_header_size{ 16 };
+static constexpr std::size_t record_header_size{ 32 };
+static constexpr char magic[8] = { 'C', 'B', 'M', 'C', 'B', 'P', 'C', 'P' };
+} // namespace capture_format
+
+struct mcbp_capture_record {
+    std::chrono::system_clock::time_point timestamp{};
+    uuid::uuid_t session_id{};
+    capture_direction direction{ capture_direction::send };
+    std::vector<std::byte> data{};
+};
+
+/**
+ * Appends frames into the in-memory buffer, and writes them to the disk from the background thread, so that the IO threads only pay for
+ * the copy of the frame.
+ *
+ * All sessions, that use the same capture path, share single writer.
+ */
+class mcbp_capture_writer
+{
+  public:
+    explicit mcbp_capture_writer(mcbp_capture_options options);
+    mcbp_capture_writer(const mcbp_capture_writer&) = delete;
+    mcbp_capture_writer(mcbp_capture_writer&&) = delete;
+    mcbp_capture_writer& operator=(const mcbp_capture_writer&) = delete;
+    mcbp_capture_writer& operator=(mcbp_capture_writer&&) = delete;
+    ~mcbp_capture_writer();
+
+    /**
+     * @return writer for the given options, or nullptr if the capture is disabled or the file cannot be created
+     */
+    [[nodiscard]] static std::shared_ptr<mcbp_capture_writer> open(const mcbp_capture_options& options);
+
+    void record(const uuid::uuid_t& session_id,
+                capture_direction direction,
+                const std::byte* header,
+                std::size_t header_size,
+                const std::byte* body = nullptr,
+                std::size_t body_size = 0);
+
+    /**
+     * Blocks until all recorded frames are written to the disk.
+     */
+    void flush();
+
+    [[nodiscard]] std::uint64_t dropped_records() const;
+
+    [[nodiscard]] std::string current_file() const;
+
+  private:
+    void run();
+    void write_to_file(const std::vector<std::byte>& data);
+    void open_next_file();
+
+    const mcbp_capture_options options_;
+    std::FILE* file_{ nullptr };
+    std::string current_file_{};
+    std::size_t current_file_size_{ 0 };
+    std::uint64_t next_file_id_{ 0 };
+
+    mutable std::mutex mutex_{};
+    std::condition_variable wakeup_{};
+    std::condition_variable flushed_{};
+    std::vector<std::byte> active_{};
+    std::vector<std::byte> writing_{};
+    std::uint64_t appended_generation_{ 0 };
+    std::uint64_t written_generation_{ 0 };
+    std::uint64_t dropped_records_{ 0 };
+    bool flush_requested_{ false };
+    bool stopped_{ false };
+    std::thread worker_{};
+};
+
+/**
+ * Sequential reader of the capture file.
+ */
+class mcbp_capture_reader
+{
+  public:
+    /**
+     * @throws std::system_error if the file cannot be opened
+     * @throws std::runtime_error if the file is not a valid capture
+     */
+    explicit mcbp_capture_reader(const std::string& path);
+    mcbp_capture_reader(const mcbp_capture_reader&) = delete;
+    mcbp_capture_reader(mcbp_capture_reader&&) = delete;
+    mcbp_capture_reader& operator=(const mcbp_capture_reader&) = delete;
+    mcbp_capture_reader& operator=(mcbp_capture_reader&&) = delete;
+    ~mcbp_capture_reader();
+
+    /**
+     * @return false when the end of the file has been reached (truncated trailing record is ignored)
+     */
+    bool next(mcbp_capture_record& record);
+
+  private:
+    std::FILE* file_{ nullptr };
+};
+} // namespace couchbase::core::io
@@ -0,0 +1,47 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace couchbase::core::io
+{
+struct mcbp_capture_options {
+    /**
+     * Base name of the capture files. Empty string disables capture.
+     */
+    std::string path{};
+
+    /**
+     * The capture rotates to the next file, when the current one exceeds this size.
+     */
+    std::size_t max_file_size{ 64 * 1024 * 1024 };
+
+    /**
+     * Number of the most recent capture files to keep on disk (0 keeps all of them).
+     */
+    std::size_t max_files{ 4 };
+
+    /**
+     * Upper limit of the memory, used for the frames that have not been written to the disk yet. The frames are dropped if the disk
+     * cannot keep up with the traffic.
+     */
+    std::size_t max_buffered_size{ 16 * 1024 * 1024 };
+};
+} // namespace couchbase::core::io
@@ -140,7 +140,7 @@ struct mcbp_command : public std::enable_shared_from_this<mcbp_command<Manager,
         req.opaque(session_->next_opaque());
         req.body().collection_path(request.id.collection_path());
         session_->write_and_subscribe(req.opaque(),
-                                      req.data(session_->supports_feature(protocol::hello_feature::snappy)),
+                                      req.data(),
                                       [self = this->shared_from_this()](std::error_code ec,
                                                                         retry_reason /* reason */,
                                                                         io::mcbp_message&& msg,
@@ -188,6 +188,14 @@ struct mcbp_command : public std::enable_shared_from_this<mcbp_command<Manager,
         });
     }
 
+    void record_compression_metrics(const protocol::compression_result& compression)
+    {
+        const auto& recorders = manager_->compression_recorders(encoded_request_type::body_type::opcode);
+        auto saved_bytes = compression.compressed ? compression.original_size - compression.compressed_size : 0;
+        recorders.saved_bytes->record_value(static_cast<std::int64_t>(saved_bytes));
+        recorders.duration->record_value(compression.duration.count());
+    }
+
     void send()
     {
         opaque_ = session_->next_opaque();
@@ -223,9 +231,15 @@ struct mcbp_command : public std::enable_shared_from_this<mcbp_command<Manager,
             }
         }
 
+        protocol::compression_result compression{};
+        auto data = encoded.data(session_->compression(), &compression);
+        if (compression.duration.count() > 0) {
+            record_compression_metrics(compression);
+        }
+
         session_->write_and_subscribe(
           request.opaque,
-          encoded.data(session_->supports_feature(protocol::hello_feature::snappy)),
+          std::move(data),
           [self = this->shared_from_this(),
            start = std::chrono::steady_clock::now()](std::error_code ec,
                                                      retry_reason reason,
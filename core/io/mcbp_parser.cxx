@@ -18,11 +18,11 @@
 #include "mcbp_parser.hxx"
 
 #include "core/logger/logger.hxx"
+#include "core/protocol/compression.hxx"
 #include "core/protocol/datatype.hxx"
 #include "core/protocol/magic.hxx"
 #include "core/utils/byteswap.hxx"
 
-#include "third_party/snappy/snappy.h"
 #include <spdlog/fmt/bin_to_hex.h>
 
 #include <algorithm>
@@ -56,15 +56,11 @@ mcbp_parser::next(mcbp_message& msg)
     bool is_compressed = (msg.header.datatype & static_cast<std::uint8_t>(protocol::datatype::snappy)) != 0;
     bool use_raw_value = true;
     if (is_compressed) {
-        std::string uncompressed;
         std::size_t offset = header_size + prefix_size;
-        if (snappy::Uncompress(reinterpret_cast<const char*>(buf.data() + offset), body_size - prefix_size, &uncompressed)) {
-            msg.body.insert(msg.body.end(),
-                            reinterpret_cast<std::byte*>(&uncompressed.data()[0]),
-                            reinterpret_cast<std::byte*>(&uncompressed.data()[uncompressed.size()]));
+        if (protocol::decompress_value({ buf.data() + offset, body_size - prefix_size }, msg.body)) {
             use_raw_value = false;
             // patch header with new body size
-            msg.header.bodylen = utils::byte_swap(static_cast<std::uint32_t>(prefix_size + uncompressed.size()));
+            msg.header.bodylen = utils::byte_swap(static_cast<std::uint32_t>(msg.body.size()));
         }
     }
     if (use_raw_value) {
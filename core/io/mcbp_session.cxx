@@ -20,6 +20,7 @@
 #include "core/config_listener.hxx"
 #include "core/diagnostics.hxx"
 #include "core/impl/bootstrap_state_listener.hxx"
+#include "core/impl/dispatch_endpoints.hxx"
 #include "core/logger/logger.hxx"
 #include "core/mcbp/codec.hxx"
 #include "core/mcbp/queue_request.hxx"
@@ -44,13 +45,17 @@
 #include "core/sasl/error_fmt.h"
 #include "core/topology/capabilities_fmt.hxx"
 #include "core/topology/configuration_fmt.hxx"
+#include "mcbp_capture.hxx"
 #include "mcbp_context.hxx"
 #include "mcbp_message.hxx"
 #include "mcbp_parser.hxx"
 #include "retry_orchestrator.hxx"
+#include "connect_race.hxx"
+#include "resolve_cache.hxx"
 #include "streams.hxx"
 
 #include <couchbase/fmt/retry_reason.hxx>
+#include <couchbase/key_value_error_context.hxx>
 
 #include <asio.hpp>
 #include <spdlog/fmt/bin_to_hex.h>
@@ -613,7 +618,6 @@ class mcbp_session_impl
                       std::vector<protocol::hello_feature> known_features = {})
       : client_id_(client_id)
       , ctx_(ctx)
-      , resolver_(ctx_)
       , stream_(std::make_unique<plain_stream_impl>(ctx_))
       , bootstrap_deadline_(ctx_)
       , connection_deadline_(ctx_)
@@ -624,6 +628,7 @@ class mcbp_session_impl
       , is_tls_{ false }
       , state_listener_{ std::move(state_listener) }
       , codec_{ { supported_features_.begin(), supported_features_.end() } }
+      , capture_{ mcbp_capture_writer::open(origin_.options().mcbp_capture) }
     {
         log_prefix_ = fmt::format("[{}/{}/{}/{}]", client_id_, id_, stream_->log_prefix(), bucket_name_.value_or("-"));
     }
@@ -637,7 +642,6 @@ class mcbp_session_impl
                       std::vector<protocol::hello_feature> known_features = {})
       : client_id_(client_id)
       , ctx_(ctx)
-      , resolver_(ctx_)
       , stream_(std::make_unique<tls_stream_impl>(ctx_, tls))
       , bootstrap_deadline_(ctx_)
       , connection_deadline_(ctx_)
@@ -648,6 +652,7 @@ class mcbp_session_impl
       , is_tls_{ true }
       , state_listener_{ std::move(state_listener) }
       , codec_{ { supported_features_.begin(), supported_features_.end() } }
+      , capture_{ mcbp_capture_writer::open(origin_.options().mcbp_capture) }
     {
         log_prefix_ = fmt::format("[{}/{}/{}/{}]", client_id_, id_, stream_->log_prefix(), bucket_name_.value_or("-"));
     }
@@ -679,6 +684,11 @@ class mcbp_session_impl
         return fmt::format("{}:{}", local_endpoint_address_, local_endpoint_.port());
     }
 
+    [[nodiscard]] std::shared_ptr<const core::impl::dispatch_endpoints> dispatch_endpoints() const
+    {
+        return dispatch_endpoints_;
+    }
+
     [[nodiscard]] diag::endpoint_diag_info diag_info() const
     {
         return { service_type::key_value,
@@ -697,7 +707,7 @@ class mcbp_session_impl
         protocol::client_request<protocol::mcbp_noop_request_body> req;
         req.opaque(next_opaque());
         write_and_subscribe(req.opaque(),
-                            req.data(false),
+                            req.data(),
                             [start = std::chrono::steady_clock::now(), self = shared_from_this(), handler](
                               std::error_code ec,
                               retry_reason reason,
@@ -790,11 +800,19 @@ class mcbp_session_impl
                                   bootstrap_port_);
         CB_LOG_DEBUG("{} attempt to establish MCBP connection", log_prefix_);
 
-        async_resolve(origin_.options().use_ip_protocol,
-                      resolver_,
-                      bootstrap_hostname_,
-                      bootstrap_port_,
-                      std::bind(&mcbp_session_impl::on_resolve, shared_from_this(), std::placeholders::_1, std::placeholders::_2));
+        resolve_cache::instance().resolve(
+          origin_.options().use_ip_protocol,
+          bootstrap_hostname_,
+          bootstrap_port_,
+          origin_.options().dns_cache_ttl,
+          origin_.options().dns_negative_cache_ttl,
+          origin_.options().resolve_timeout,
+          [self = shared_from_this()](std::error_code ec, resolve_cache::endpoints_type endpoints) {
+              // the handler is invoked on the thread of the cache
+              asio::post(self->ctx_, [self, ec, endpoints = std::move(endpoints)]() mutable {
+                  self->on_resolve(ec, std::move(endpoints));
+              });
+          });
     }
 
     [[nodiscard]] const std::string& id() const
@@ -823,7 +841,9 @@ class mcbp_session_impl
         bootstrap_deadline_.cancel();
         connection_deadline_.cancel();
         retry_backoff_.cancel();
-        resolver_.cancel();
+        if (auto race = std::move(connect_race_); race) {
+            race->cancel();
+        }
         stream_->close([](std::error_code) {});
         if (auto h = std::move(bootstrap_handler_); h) {
             h->stop();
@@ -875,6 +895,9 @@ class mcbp_session_impl
         std::uint32_t opaque{ 0 };
         std::memcpy(&opaque, buf.data() + 12, sizeof(opaque));
         CB_LOG_TRACE("{} MCBP send, opaque={}, {:n}", log_prefix_, opaque, spdlog::to_hex(buf.begin(), buf.begin() + 24));
+        if (capture_) {
+            capture_->record(uuid_, capture_direction::send, buf.data(), buf.size());
+        }
         std::scoped_lock lock(output_buffer_mutex_);
         output_buffer_.emplace_back(std::move(buf));
     }
@@ -955,10 +978,10 @@ class mcbp_session_impl
     void write_and_subscribe(std::shared_ptr<mcbp::queue_request> request, std::shared_ptr<response_handler> handler)
     {
         auto opaque = request->opaque_;
-        auto data = codec_.encode_packet(*request);
-        if (!data) {
-            CB_LOG_DEBUG("unable to encode packet. opaque={}, ec={}", opaque, data.error().message());
-            request->try_callback({}, data.error());
+        auto data = acquire_buffer();
+        if (auto ec = codec_.encode_packet(*request, data); ec) {
+            CB_LOG_DEBUG("unable to encode packet. opaque={}, ec={}", opaque, ec.message());
+            request->try_callback({}, ec);
             return;
         }
 
@@ -969,14 +992,14 @@ class mcbp_session_impl
         }
         enqueue_request(opaque, std::move(request), std::move(handler));
         if (bootstrapped_ && stream_->is_open()) {
-            write_and_flush(std::move(data.value()));
+            write_and_flush(std::move(data));
         } else {
             CB_LOG_DEBUG("{} the stream is not ready yet, put the message into pending buffer, opaque={}", log_prefix_, opaque);
             std::scoped_lock lock(pending_buffer_mutex_);
             if (bootstrapped_ && stream_->is_open()) {
-                write_and_flush(std::move(data.value()));
+                write_and_flush(std::move(data));
             } else {
-                pending_buffer_.emplace_back(data.value());
+                pending_buffer_.emplace_back(std::move(data));
             }
         }
     }
@@ -1035,6 +1058,15 @@ class mcbp_session_impl
         return supported_features_;
     }
 
+    [[nodiscard]] protocol::compression_config compression()
+    {
+        return {
+            supports_feature(protocol::hello_feature::snappy),
+            origin_.options().compression_min_size,
+            origin_.options().compression_min_ratio,
+        };
+    }
+
     [[nodiscard]] bool supports_gcccp() const
     {
         return supports_gcccp_;
@@ -1238,7 +1270,7 @@ class mcbp_session_impl
         }
     }
 
-    void on_resolve(std::error_code ec, const asio::ip::tcp::resolver::results_type& endpoints)
+    void on_resolve(std::error_code ec, std::vector<asio::ip::tcp::endpoint> endpoints)
     {
         if (ec == asio::error::operation_aborted || stopped_) {
             return;
@@ -1248,88 +1280,88 @@ class mcbp_session_impl
             CB_LOG_ERROR("{} error on resolve: {} ({})", log_prefix_, ec.value(), ec.message());
             return initiate_bootstrap();
         }
-        endpoints_ = endpoints;
-        do_connect(endpoints_.begin());
-        connection_deadline_.expires_after(origin_.options().resolve_timeout);
+        CB_LOG_DEBUG("{} connecting to {} address(es), timeout={}ms, attempt_delay={}ms",
+                     log_prefix_,
+                     endpoints.size(),
+                     origin_.options().connect_timeout.count(),
+                     origin_.options().connection_attempt_delay.count());
+        connection_deadline_.expires_after(origin_.options().connect_timeout);
         connection_deadline_.async_wait([self = shared_from_this()](const auto timer_ec) {
             if (timer_ec == asio::error::operation_aborted || self->stopped_) {
                 return;
             }
-            return self->stream_->close([self](std::error_code) { self->initiate_bootstrap(); });
-        });
-    }
-
-    void do_connect(asio::ip::tcp::resolver::results_type::iterator it)
-    {
-        if (stopped_) {
-            return;
-        }
-        last_active_ = std::chrono::steady_clock::now();
-        if (it != endpoints_.end()) {
-            CB_LOG_DEBUG("{} connecting to {}:{}, timeout={}ms",
-                         log_prefix_,
-                         it->endpoint().address().to_string(),
-                         it->endpoint().port(),
-                         origin_.options().connect_timeout.count());
-            connection_deadline_.expires_after(origin_.options().connect_timeout);
-            connection_deadline_.async_wait([self = shared_from_this()](const auto timer_ec) {
-                if (timer_ec == asio::error::operation_aborted || self->stopped_) {
-                    return;
-                }
-                return self->stream_->close([self](std::error_code) { self->initiate_bootstrap(); });
-            });
-            stream_->async_connect(it->endpoint(),
-                                   std::bind(&mcbp_session_impl::on_connect, shared_from_this(), std::placeholders::_1, it));
-        } else {
-            CB_LOG_ERROR("{} no more endpoints left to connect, will try another address", log_prefix_);
-            if (state_listener_) {
-                state_listener_->report_bootstrap_error(fmt::format("{}:{}", bootstrap_hostname_, bootstrap_port_),
-                                                        errc::network::no_endpoints_left);
+            if (auto race = std::move(self->connect_race_); race) {
+                race->cancel();
             }
-            return initiate_bootstrap();
-        }
+            self->stream_->reopen();
+            return self->initiate_bootstrap();
+        });
+        connect_race_ = connect_race::start(
+          stream_->get_executor(),
+          std::move(endpoints),
+          origin_.options().connection_attempt_delay,
+          [self = shared_from_this()](std::error_code race_ec, asio::ip::tcp::socket socket, asio::ip::tcp::endpoint endpoint) {
+              if (self->stopped_) {
+                  return;
+              }
+              if (race_ec) {
+                  CB_LOG_ERROR("{} unable to connect to any address: {} ({}), will try another address",
+                               self->log_prefix_,
+                               race_ec.value(),
+                               race_ec.message());
+                  // the addresses might be stale, so the next attempt has to ask DNS again
+                  resolve_cache::instance().invalidate(self->bootstrap_hostname_, self->bootstrap_port_);
+                  if (self->state_listener_) {
+                      self->state_listener_->report_bootstrap_error(
+                        fmt::format("{}:{}", self->bootstrap_hostname_, self->bootstrap_port_), errc::network::no_endpoints_left);
+                  }
+                  return self->initiate_bootstrap();
+              }
+              self->stream_->set_server_name(self->bootstrap_hostname_, self->bootstrap_port_);
+              self->stream_->async_attach(std::move(socket), [self, endpoint](std::error_code ec_attach) {
+                  self->on_connect(ec_attach, endpoint);
+              });
+          });
     }
 
-    void on_connect(const std::error_code& ec, asio::ip::tcp::resolver::results_type::iterator it)
+    void on_connect(const std::error_code& ec, const asio::ip::tcp::endpoint& endpoint)
     {
         if (ec == asio::error::operation_aborted || stopped_) {
             return;
         }
         last_active_ = std::chrono::steady_clock::now();
         if (!stream_->is_open() || ec) {
-
             CB_LOG_WARNING("{} unable to connect to {}:{}: {} ({}){}. is_open={}",
                            log_prefix_,
-                           it->endpoint().address().to_string(),
-                           it->endpoint().port(),
+                           endpoint.address().to_string(),
+                           endpoint.port(),
                            ec.value(),
                            (ec.category() == asio::error::ssl_category) ? ERR_error_string(static_cast<unsigned long>(ec.value()), nullptr)
                                                                         : ec.message(),
                            (ec == asio::error::connection_refused) ? ", check server ports and cluster encryption setting" : "",
                            stream_->is_open());
-            if (stream_->is_open()) {
-                stream_->close(std::bind(&mcbp_session_impl::do_connect, shared_from_this(), ++it));
-            } else {
-                do_connect(++it);
-            }
-        } else {
-            stream_->set_options();
-            local_endpoint_ = stream_->local_endpoint();
-            local_endpoint_address_ = local_endpoint_.address().to_string();
-            endpoint_ = it->endpoint();
-            endpoint_address_ = endpoint_.address().to_string();
-            CB_LOG_DEBUG("{} connected to {}:{}", log_prefix_, endpoint_address_, it->endpoint().port());
-            log_prefix_ = fmt::format("[{}/{}/{}/{}] <{}/{}:{}>",
-                                      client_id_,
-                                      id_,
-                                      stream_->log_prefix(),
-                                      bucket_name_.value_or("-"),
-                                      bootstrap_hostname_,
-                                      endpoint_address_,
-                                      endpoint_.port());
-            bootstrap_handler_ = std::make_shared<bootstrap_handler>(shared_from_this());
             connection_deadline_.cancel();
+            stream_->reopen();
+            return initiate_bootstrap();
         }
+        stream_->set_options();
+        local_endpoint_ = stream_->local_endpoint();
+        local_endpoint_address_ = local_endpoint_.address().to_string();
+        endpoint_ = endpoint;
+        endpoint_address_ = endpoint_.address().to_string();
+        dispatch_endpoints_ =
+          std::make_shared<const core::impl::dispatch_endpoints>(core::impl::dispatch_endpoints{ remote_address(), local_address() });
+        CB_LOG_DEBUG("{} connected to {}:{}", log_prefix_, endpoint_address_, endpoint_.port());
+        log_prefix_ = fmt::format("[{}/{}/{}/{}] <{}/{}:{}>",
+                                  client_id_,
+                                  id_,
+                                  stream_->log_prefix(),
+                                  bucket_name_.value_or("-"),
+                                  bootstrap_hostname_,
+                                  endpoint_address_,
+                                  endpoint_.port());
+        bootstrap_handler_ = std::make_shared<bootstrap_handler>(shared_from_this());
+        connection_deadline_.cancel();
     }
 
     void check_deadline(std::error_code ec)
@@ -1343,6 +1375,37 @@ class mcbp_session_impl
         connection_deadline_.async_wait(std::bind(&mcbp_session_impl::check_deadline, shared_from_this(), std::placeholders::_1));
     }
 
+    /**
+     * @return buffer for the encoded packet, that reuses the storage of the packets that have been already written to the socket
+     */
+    std::vector<std::byte> acquire_buffer()
+    {
+        std::scoped_lock lock(buffer_pool_mutex_);
+        if (buffer_pool_.empty()) {
+            return {};
+        }
+        auto buffer = std::move(buffer_pool_.back());
+        buffer_pool_.pop_back();
+        return buffer;
+    }
+
+    void release_buffers(std::vector<std::vector<std::byte>>& buffers)
+    {
+        static constexpr std::size_t max_pooled_buffers{ 64 };
+        static constexpr std::size_t max_pooled_buffer_capacity{ 16 * 1024 };
+
+        std::scoped_lock lock(buffer_pool_mutex_);
+        for (auto& buffer : buffers) {
+            if (buffer_pool_.size() >= max_pooled_buffers) {
+                break;
+            }
+            if (buffer.capacity() <= max_pooled_buffer_capacity) {
+                buffer.clear();
+                buffer_pool_.emplace_back(std::move(buffer));
+            }
+        }
+    }
+
     void do_read()
     {
         if (stopped_ || reading_ || !stream_->is_open()) {
@@ -1373,6 +1436,9 @@ class mcbp_session_impl
                                ec.message());
                   return self->stop(retry_reason::socket_closed_while_in_flight);
               }
+              if (self->capture_) {
+                  self->capture_->record(self->uuid_, capture_direction::receive, self->input_buffer_.data(), bytes_transferred);
+              }
               self->parser_.feed(self->input_buffer_.data(), self->input_buffer_.data() + static_cast<std::ptrdiff_t>(bytes_transferred));
 
               for (;;) {
@@ -1436,6 +1502,7 @@ class mcbp_session_impl
             }
             {
                 std::scoped_lock inner_lock(self->writing_buffer_mutex_);
+                self->release_buffers(self->writing_buffer_);
                 self->writing_buffer_.clear();
             }
             asio::post(asio::bind_executor(self->ctx_, [self]() {
@@ -1446,10 +1513,11 @@ class mcbp_session_impl
     }
 
     const std::string client_id_;
-    const std::string id_{ uuid::to_string(uuid::random()) };
+    const uuid::uuid_t uuid_{ uuid::random() };
+    const std::string id_{ uuid::to_string(uuid_) };
     asio::io_context& ctx_;
-    asio::ip::tcp::resolver resolver_;
     std::unique_ptr<stream_impl> stream_;
+    std::shared_ptr<connect_race> connect_race_{};
     asio::steady_timer bootstrap_deadline_;
     asio::steady_timer connection_deadline_;
     asio::steady_timer retry_backoff_;
@@ -1480,13 +1548,15 @@ class mcbp_session_impl
     std::mutex output_buffer_mutex_{};
     std::mutex pending_buffer_mutex_{};
     std::mutex writing_buffer_mutex_{};
+    std::vector<std::vector<std::byte>> buffer_pool_{};
+    std::mutex buffer_pool_mutex_{};
     std::string bootstrap_hostname_{};
     std::string bootstrap_port_{};
     asio::ip::tcp::endpoint endpoint_{}; // connected endpoint
     std::string endpoint_address_{};     // cached string with endpoint address
     asio::ip::tcp::endpoint local_endpoint_{};
     std::string local_endpoint_address_{};
-    asio::ip::tcp::resolver::results_type endpoints_;
+    std::shared_ptr<const core::impl::dispatch_endpoints> dispatch_endpoints_{}; // formatted addresses for error contexts
     std::vector<protocol::hello_feature> supported_features_;
     std::optional<topology::configuration> config_;
     mutable std::mutex config_mutex_{};
@@ -1498,6 +1568,7 @@ class mcbp_session_impl
     std::shared_ptr<impl::bootstrap_state_listener> state_listener_{ nullptr };
 
     mcbp::codec codec_;
+    std::shared_ptr<mcbp_capture_writer> capture_{};
     std::recursive_mutex operations_mutex_{};
     std::map<std::uint32_t, std::pair<std::shared_ptr<mcbp::queue_request>, std::shared_ptr<response_handler>>> operations_{};
 
@@ -1582,6 +1653,12 @@ mcbp_session::supports_feature(protocol::hello_feature feature)
     return impl_->supports_feature(feature);
 }
 
+protocol::compression_config
+mcbp_session::compression()
+{
+    return impl_->compression();
+}
+
 // const std::string&
 // mcbp_session::id() const
 // {
@@ -1612,6 +1689,12 @@ mcbp_session::local_address() const
     return impl_->local_address();
 }
 
+std::shared_ptr<const core::impl::dispatch_endpoints>
+mcbp_session::dispatch_endpoints() const
+{
+    return impl_->dispatch_endpoints();
+}
+
 const std::string&
 mcbp_session::bootstrap_hostname() const
 {
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "core/protocol/compression.hxx"
 #include "core/protocol/hello_feature.hxx"
 #include "core/response_handler.hxx"
 #include "core/utils/movable_function.hxx"
@@ -59,6 +60,7 @@ struct endpoint_diag_info;
 namespace impl
 {
 class bootstrap_state_listener;
+struct dispatch_endpoints;
 } // namespace impl
 
 namespace io
@@ -100,11 +102,13 @@ class mcbp_session
     [[nodiscard]] std::optional<std::uint32_t> get_collection_uid(const std::string& collection_path);
     [[nodiscard]] mcbp_context context() const;
     [[nodiscard]] bool supports_feature(protocol::hello_feature feature);
+    [[nodiscard]] protocol::compression_config compression();
     [[nodiscard]] std::vector<protocol::hello_feature> supported_features() const;
     //[[nodiscard]] const std::string& id() const;
     [[nodiscard]] std::string id() const;
     [[nodiscard]] std::string remote_address() const;
     [[nodiscard]] std::string local_address() const;
+    [[nodiscard]] std::shared_ptr<const core::impl::dispatch_endpoints> dispatch_endpoints() const;
     [[nodiscard]] const std::string& bootstrap_hostname() const;
     [[nodiscard]] const std::string& bootstrap_port() const;
     void write_and_subscribe(std::shared_ptr<mcbp::queue_request>, std::shared_ptr<response_handler> handler);
@@ -0,0 +1,197 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "resolve_cache.hxx"
+
+#include "streams.hxx"
+
+#include "core/logger/logger.hxx"
+
+#include <asio/post.hpp>
+#include <asio/steady_timer.hpp>
+
+#include <memory>
+
+namespace couchbase::core::io
+{
+namespace
+{
+struct lookup {
+    explicit lookup(asio::io_context& ctx)
+      : resolver(ctx)
+      , deadline(ctx)
+    {
+    }
+
+    asio::ip::tcp::resolver resolver;
+    asio::steady_timer deadline;
+    bool completed{ false };
+};
+} // namespace
+
+resolve_cache::resolve_cache()
+  : thread_([this]() { ctx_.run(); })
+{
+}
+
+resolve_cache::~resolve_cache()
+{
+    work_.reset();
+    ctx_.stop();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+resolve_cache&
+resolve_cache::instance()
+{
+    static resolve_cache cache{};
+    return cache;
+}
+
+void
+resolve_cache::resolve(ip_protocol protocol,
+                       const std::string& hostname,
+                       const std::string& service,
+                       std::chrono::milliseconds ttl,
+                       std::chrono::milliseconds negative_ttl,
+                       std::chrono::milliseconds timeout,
+                       handler_type&& handler)
+{
+    key_type key{ hostname, service, protocol };
+    {
+        std::scoped_lock lock(mutex_);
+        auto& e = entries_[key];
+        if (e.in_flight) {
+            ++stats_.coalesced;
+            e.waiters.push_back(std::move(handler));
+            return;
+        }
+        if (std::chrono::steady_clock::now() < e.expiry) {
+            ++stats_.hits;
+            return asio::post(ctx_, [handler = std::move(handler), ec = e.ec, endpoints = e.endpoints]() mutable {
+                handler(ec, std::move(endpoints));
+            });
+        }
+        ++stats_.misses;
+        e.in_flight = true;
+        e.waiters.push_back(std::move(handler));
+    }
+
+    // the resolver is owned by the lookup rather than by the session, that has started it, because other sessions might be waiting
+    // for the result. Cancelling the resolver does not interrupt getaddrinfo, so the deadline completes the lookup by itself, and the
+    // late result is dropped.
+    auto l = std::make_shared<lookup>(ctx_);
+    l->deadline.expires_after(timeout);
+    l->deadline.async_wait([this, key, l, ttl, negative_ttl](std::error_code ec) {
+        if (ec == asio::error::operation_aborted || l->completed) {
+            return;
+        }
+        l->completed = true;
+        l->resolver.cancel();
+        complete(key, asio::error::timed_out, {}, ttl, negative_ttl);
+    });
+    async_resolve(protocol,
+                  l->resolver,
+                  hostname,
+                  service,
+                  [this, key, l, ttl, negative_ttl](std::error_code ec, const asio::ip::tcp::resolver::results_type& results) {
+                      if (l->completed) {
+                          return;
+                      }
+                      l->completed = true;
+                      l->deadline.cancel();
+                      endpoints_type endpoints{};
+                      if (!ec) {
+                          endpoints.reserve(results.size());
+                          for (const auto& result : results) {
+                              endpoints.push_back(result.endpoint());
+                          }
+                      }
+                      complete(key, ec, std::move(endpoints), ttl, negative_ttl);
+                  });
+}
+
+void
+resolve_cache::complete(const key_type& key,
+                        std::error_code ec,
+                        endpoints_type endpoints,
+                        std::chrono::milliseconds ttl,
+                        std::chrono::milliseconds negative_ttl)
+{
+    std::vector<handler_type> waiters{};
+    {
+        std::scoped_lock lock(mutex_);
+        auto& e = entries_[key];
+        e.in_flight = false;
+        std::swap(waiters, e.waiters);
+        if (ec == asio::error::operation_aborted || ec == asio::error::timed_out) {
+            // the result says nothing about the hostname
+            e.expiry = {};
+        } else {
+            e.ec = ec;
+            e.endpoints = endpoints;
+            e.expiry = std::chrono::steady_clock::now() + (ec ? negative_ttl : ttl);
+        }
+    }
+    if (ec) {
+        CB_LOG_DEBUG(R"(unable to resolve "{}:{}": {}, {} waiter(s))", std::get<0>(key), std::get<1>(key), ec.message(), waiters.size());
+    } else {
+        CB_LOG_TRACE(R"(resolved "{}:{}" to {} address(es), {} waiter(s))",
+                     std::get<0>(key),
+                     std::get<1>(key),
+                     endpoints.size(),
+                     waiters.size());
+    }
+    for (auto& handler : waiters) {
+        handler(ec, endpoints);
+    }
+}
+
+void
+resolve_cache::invalidate(const std::string& hostname, const std::string& service)
+{
+    std::scoped_lock lock(mutex_);
+    for (auto protocol : { ip_protocol::any, ip_protocol::force_ipv4, ip_protocol::force_ipv6 }) {
+        if (auto it = entries_.find({ hostname, service, protocol }); it != entries_.end() && !it->second.in_flight) {
+            entries_.erase(it);
+        }
+    }
+}
+
+void
+resolve_cache::clear()
+{
+    std::scoped_lock lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->second.in_flight) {
+            ++it;
+        } else {
+            it = entries_.erase(it);
+        }
+    }
+    stats_ = {};
+}
+
+resolve_cache_stats
+resolve_cache::stats() const
+{
+    std::scoped_lock lock(mutex_);
+    return stats_;
+}
+} // namespace couchbase::core::io
@@ -0,0 +1,126 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include "ip_protocol.hxx"
+
+#include "core/utils/movable_function.hxx"
+
+#include <asio/executor_work_guard.hpp>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace couchbase::core::io
+{
+struct resolve_cache_stats {
+    /** answered from the cache, including cached failures */
+    std::uint64_t hits{ 0 };
+    /** started new lookup */
+    std::uint64_t misses{ 0 };
+    /** joined the lookup, that has been already started by another session */
+    std::uint64_t coalesced{ 0 };
+};
+
+/**
+ * Process-wide cache of resolved addresses.
+ *
+ * When a node restarts, every session to it reconnects at the same time. Instead of blocking one resolver thread per session in
+ * getaddrinfo, the sessions share single lookup per hostname, and reuse its result until the TTL expires. Failed lookups are cached
+ * for a shorter time, so that a storm of reconnects to the node, that cannot be resolved, does not turn into a storm of DNS queries.
+ *
+ * getaddrinfo does not expose TTL of the records, so the TTL is configured with cluster_options::dns_cache_ttl.
+ *
+ * The cache is shared by the sessions of all clusters, so it does not rely on any of their IO contexts, which might be stopped or
+ * destroyed while the lookup is still running. The lookups are performed on the context owned by the cache, and the handlers are invoked
+ * on its thread, so the sessions have to post the result to their own context.
+ */
+class resolve_cache
+{
+  public:
+    using endpoints_type = std::vector<asio::ip::tcp::endpoint>;
+    using handler_type = utils::movable_function<void(std::error_code, endpoints_type)>;
+
+    resolve_cache();
+    resolve_cache(const resolve_cache&) = delete;
+    resolve_cache(resolve_cache&&) = delete;
+    resolve_cache& operator=(const resolve_cache&) = delete;
+    resolve_cache& operator=(resolve_cache&&) = delete;
+    ~resolve_cache();
+
+    [[nodiscard]] static resolve_cache& instance();
+
+    /**
+     * Resolves the hostname, or takes the addresses from the cache. The handler is invoked on the thread of the cache.
+     *
+     * @param ttl how long the addresses are cached, zero disables caching (but the concurrent lookups are still coalesced)
+     * @param negative_ttl how long the failure is cached
+     * @param timeout how long to wait for the lookup, that has to be started, before failing it with asio::error::timed_out. The
+     * sessions, that join the lookup, share its deadline.
+     */
+    void resolve(ip_protocol protocol,
+                 const std::string& hostname,
+                 const std::string& service,
+                 std::chrono::milliseconds ttl,
+                 std::chrono::milliseconds negative_ttl,
+                 std::chrono::milliseconds timeout,
+                 handler_type&& handler);
+
+    /**
+     * Forgets the addresses of the hostname, for example when none of them accepts connections anymore.
+     */
+    void invalidate(const std::string& hostname, const std::string& service);
+
+    void clear();
+
+    [[nodiscard]] resolve_cache_stats stats() const;
+
+  private:
+    using key_type = std::tuple<std::string, std::string, ip_protocol>;
+
+    struct entry {
+        std::error_code ec{};
+        endpoints_type endpoints{};
+        std::chrono::steady_clock::time_point expiry{};
+        bool in_flight{ false };
+        std::vector<handler_type> waiters{};
+    };
+
+    void complete(const key_type& key,
+                  std::error_code ec,
+                  endpoints_type endpoints,
+                  std::chrono::milliseconds ttl,
+                  std::chrono::milliseconds negative_ttl);
+
+    asio::io_context ctx_{ 1 };
+    asio::executor_work_guard<asio::io_context::executor_type> work_{ asio::make_work_guard(ctx_) };
+    std::thread thread_{};
+    mutable std::mutex mutex_{};
+    std::map<key_type, entry> entries_{};
+    resolve_cache_stats stats_{};
+};
+} // namespace couchbase::core::io
@@ -18,11 +18,16 @@
 #pragma once
 
 #include "ip_protocol.hxx"
+#include "tls_session_cache.hxx"
+
+#include "core/platform/uuid.h"
 
 #include <asio.hpp>
 #include <asio/ssl.hpp>
 
 #include <functional>
+#include <mutex>
+#include <string>
 
 namespace couchbase::core::io
 {
@@ -92,9 +97,23 @@ class stream_impl
 
     virtual void set_options() = 0;
 
+    /**
+     * Remembers the hostname and port, that the session is connecting to. TLS streams use them to look up the session to resume,
+     * because the hostname might resolve to different addresses, and the address might be reused by another server.
+     */
+    virtual void set_server_name(const std::string& /* hostname */, const std::string& /* service */)
+    {
+    }
+
     virtual void async_connect(const asio::ip::tcp::resolver::results_type::endpoint_type& endpoint,
                                std::function<void(std::error_code)>&& handler) = 0;
 
+    /**
+     * Takes over the socket, that has been already connected by the caller (e.g. by connect_race), and completes the handshake if
+     * the stream needs one.
+     */
+    virtual void async_attach(asio::ip::tcp::socket socket, std::function<void(std::error_code)>&& handler) = 0;
+
     virtual void async_write(std::vector<asio::const_buffer>& buffers, std::function<void(std::error_code, std::size_t)>&& handler) = 0;
 
     virtual void async_read_some(asio::mutable_buffer buffer, std::function<void(std::error_code, std::size_t)>&& handler) = 0;
@@ -160,6 +179,13 @@ class plain_stream_impl : public stream_impl
         });
     }
 
+    void async_attach(asio::ip::tcp::socket socket, std::function<void(std::error_code)>&& handler) override
+    {
+        *stream_ = std::move(socket);
+        open_ = stream_->is_open();
+        return asio::post(strand_, [h = std::move(handler)]() { h({}); });
+    }
+
     void async_write(std::vector<asio::const_buffer>& buffers, std::function<void(std::error_code, std::size_t)>&& handler) override
     {
         return asio::async_write(*stream_, buffers, std::move(handler));
@@ -176,12 +202,16 @@ class tls_stream_impl : public stream_impl
   private:
     std::shared_ptr<asio::ssl::stream<asio::ip::tcp::socket>> stream_;
     asio::ssl::context& tls_;
+    std::shared_ptr<tls_session_cache> sessions_;
+    mutable std::mutex server_name_mutex_{};
+    std::string server_name_{};
 
   public:
     tls_stream_impl(asio::io_context& ctx, asio::ssl::context& tls)
       : stream_impl(ctx, true)
       , stream_(std::make_shared<asio::ssl::stream<asio::ip::tcp::socket>>(asio::ip::tcp::socket(strand_), tls))
       , tls_(tls)
+      , sessions_(tls_session_cache::from(tls))
     {
     }
 
@@ -198,7 +228,10 @@ class tls_stream_impl : public stream_impl
     void close(std::function<void(std::error_code)>&& handler) override
     {
         open_ = false;
-        return asio::post(strand_, [stream = stream_, h = std::move(handler)]() {
+        return asio::post(strand_, [stream = stream_, sessions = sessions_, name = server_name(), h = std::move(handler)]() {
+            if (sessions && !name.empty()) {
+                sessions->connection_closed(stream->native_handle(), name);
+            }
             asio::error_code ec{};
             stream->lowest_layer().shutdown(asio::socket_base::shutdown_both, ec);
             stream->lowest_layer().close(ec);
@@ -224,6 +257,12 @@ class tls_stream_impl : public stream_impl
         stream_->lowest_layer().set_option(asio::socket_base::keep_alive{ true }, ec);
     }
 
+    void set_server_name(const std::string& hostname, const std::string& service) override
+    {
+        std::scoped_lock lock(server_name_mutex_);
+        server_name_ = hostname + ":" + service;
+    }
+
     void async_connect(const asio::ip::tcp::resolver::results_type::endpoint_type& endpoint,
                        std::function<void(std::error_code)>&& handler) override
     {
@@ -235,15 +274,17 @@ class tls_stream_impl : public stream_impl
                 return handler(ec_connect);
             }
             open_ = stream_->lowest_layer().is_open();
-            stream_->async_handshake(asio::ssl::stream_base::client, [handler](std::error_code ec_handshake) mutable {
-                if (ec_handshake == asio::error::operation_aborted) {
-                    return;
-                }
-                return handler(ec_handshake);
-            });
+            return do_handshake(std::move(handler));
         });
     }
 
+    void async_attach(asio::ip::tcp::socket socket, std::function<void(std::error_code)>&& handler) override
+    {
+        stream_->next_layer() = std::move(socket);
+        open_ = stream_->lowest_layer().is_open();
+        return do_handshake(std::move(handler));
+    }
+
     void async_write(std::vector<asio::const_buffer>& buffers, std::function<void(std::error_code, std::size_t)>&& handler) override
     {
         return asio::async_write(*stream_, buffers, std::move(handler));
@@ -253,6 +294,35 @@ class tls_stream_impl : public stream_impl
     {
         return stream_->async_read_some(buffer, std::move(handler));
     }
+
+  private:
+    [[nodiscard]] std::string server_name() const
+    {
+        std::scoped_lock lock(server_name_mutex_);
+        return server_name_;
+    }
+
+    void do_handshake(std::function<void(std::error_code)>&& handler)
+    {
+        auto name = server_name();
+        if (sessions_ && !name.empty()) {
+            sessions_->prepare(stream_->native_handle(), name);
+        }
+        stream_->async_handshake(asio::ssl::stream_base::client,
+                                 [this, name = std::move(name), handler = std::move(handler)](std::error_code ec) {
+                                     if (ec == asio::error::operation_aborted) {
+                                         return;
+                                     }
+                                     if (sessions_ && !name.empty()) {
+                                         if (ec) {
+                                             sessions_->invalidate(name);
+                                         } else {
+                                             sessions_->handshake_completed(stream_->native_handle(), name);
+                                         }
+                                     }
+                                     return handler(ec);
+                                 });
+    }
 };
 
 } // namespace couchbase::core::io
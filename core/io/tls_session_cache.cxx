@@ -0,0 +1,151 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "tls_session_cache.hxx"
+
+#include "core/logger/logger.hxx"
+
+namespace couchbase::core::io
+{
+namespace
+{
+void
+free_cache_reference(void* /* parent */, void* ptr, CRYPTO_EX_DATA* /* ad */, int /* index */, long /* argl */, void* /* argp */)
+{
+    delete static_cast<std::weak_ptr<tls_session_cache>*>(ptr);
+}
+
+int
+context_index()
+{
+    static const int index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, free_cache_reference);
+    return index;
+}
+} // namespace
+
+tls_session_cache::~tls_session_cache()
+{
+    for (auto& [endpoint, e] : entries_) {
+        replace_session(e, nullptr);
+    }
+}
+
+void
+tls_session_cache::attach(const std::shared_ptr<tls_session_cache>& cache, asio::ssl::context& tls)
+{
+    delete static_cast<std::weak_ptr<tls_session_cache>*>(SSL_CTX_get_ex_data(tls.native_handle(), context_index()));
+    SSL_CTX_set_ex_data(tls.native_handle(), context_index(), new std::weak_ptr<tls_session_cache>(cache));
+}
+
+std::shared_ptr<tls_session_cache>
+tls_session_cache::from(asio::ssl::context& tls)
+{
+    if (auto* reference = static_cast<std::weak_ptr<tls_session_cache>*>(SSL_CTX_get_ex_data(tls.native_handle(), context_index()));
+        reference != nullptr) {
+        return reference->lock();
+    }
+    return {};
+}
+
+void
+tls_session_cache::prepare(SSL* ssl, const std::string& endpoint)
+{
+    std::scoped_lock lock(mutex_);
+    if (auto it = entries_.find(endpoint); it != entries_.end() && it->second.session != nullptr) {
+        if (SSL_SESSION_is_resumable(it->second.session) != 1) {
+            replace_session(it->second, nullptr);
+            return;
+        }
+        // SSL_set_session takes its own reference
+        SSL_set_session(ssl, it->second.session);
+    }
+}
+
+void
+tls_session_cache::handshake_completed(SSL* ssl, const std::string& endpoint)
+{
+    bool resumed = SSL_session_reused(ssl) == 1;
+    {
+        std::scoped_lock lock(mutex_);
+        auto& e = entries_[endpoint];
+        ++e.handshakes;
+        if (resumed) {
+            ++e.resumed_handshakes;
+        }
+    }
+    CB_LOG_TRACE(R"(TLS handshake with "{}" completed, session resumed={})", endpoint, resumed);
+    store(ssl, endpoint);
+}
+
+void
+tls_session_cache::invalidate(const std::string& endpoint)
+{
+    std::scoped_lock lock(mutex_);
+    if (auto it = entries_.find(endpoint); it != entries_.end()) {
+        replace_session(it->second, nullptr);
+    }
+}
+
+void
+tls_session_cache::connection_closed(SSL* ssl, const std::string& endpoint)
+{
+    if (SSL_is_init_finished(ssl) != 1) {
+        return;
+    }
+    store(ssl, endpoint);
+    SSL_set_shutdown(ssl, SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
+}
+
+void
+tls_session_cache::store(SSL* ssl, const std::string& endpoint)
+{
+    if (SSL_is_init_finished(ssl) != 1) {
+        return;
+    }
+    SSL_SESSION* session = SSL_get1_session(ssl);
+    if (session == nullptr) {
+        return;
+    }
+    if (SSL_SESSION_is_resumable(session) != 1) {
+        SSL_SESSION_free(session);
+        return;
+    }
+    std::scoped_lock lock(mutex_);
+    replace_session(entries_[endpoint], session);
+}
+
+std::vector<diag::tls_session_info>
+tls_session_cache::stats() const
+{
+    std::vector<diag::tls_session_info> res;
+    std::scoped_lock lock(mutex_);
+    res.reserve(entries_.size());
+    for (const auto& [endpoint, e] : entries_) {
+        res.push_back({ endpoint, e.handshakes, e.resumed_handshakes });
+    }
+    return res;
+}
+
+void
+tls_session_cache::replace_session(entry& e, SSL_SESSION* session)
+{
+    if (e.session != nullptr) {
+        SSL_SESSION_free(e.session);
+    }
+    e.session = session;
+}
+} // namespace couchbase::core::io
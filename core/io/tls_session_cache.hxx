@@ -0,0 +1,103 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include "core/diagnostics.hxx"
+
+#include <asio/ssl/context.hpp>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace couchbase::core::io
+{
+/**
+ * Client-side cache of TLS sessions (session IDs and tickets), so that reconnects and new HTTP sessions to the same endpoint resume
+ * the previous session instead of doing a full handshake.
+ *
+ * The cache is attached to the SSL context of the cluster, and the TLS streams look it up there, so that every session created with
+ * this context participates without passing the cache around. Only the latest session is kept for each endpoint. The endpoints are
+ * identified by the hostname and port, that the session connects to, rather than by the resolved address.
+ *
+ * The context keeps only weak reference to the cache, and the streams share its ownership, so the stream, that is being closed after
+ * the cluster has been destroyed, can still store its session.
+ */
+class tls_session_cache
+{
+  public:
+    tls_session_cache() = default;
+    tls_session_cache(const tls_session_cache&) = delete;
+    tls_session_cache(tls_session_cache&&) = delete;
+    tls_session_cache& operator=(const tls_session_cache&) = delete;
+    tls_session_cache& operator=(tls_session_cache&&) = delete;
+    ~tls_session_cache();
+
+    /**
+     * Attaches the cache to the context, replacing the cache, that has been attached before.
+     */
+    static void attach(const std::shared_ptr<tls_session_cache>& cache, asio::ssl::context& tls);
+
+    /**
+     * @return the cache attached to the context, or empty pointer if there is none, or it has been destroyed already
+     */
+    [[nodiscard]] static std::shared_ptr<tls_session_cache> from(asio::ssl::context& tls);
+
+    /**
+     * Offers the cached session of the endpoint to the connection, that is about to start the handshake.
+     */
+    void prepare(SSL* ssl, const std::string& endpoint);
+
+    /**
+     * Records whether the session has been resumed, and remembers the session of the connection.
+     */
+    void handshake_completed(SSL* ssl, const std::string& endpoint);
+
+    /**
+     * Forgets the session of the endpoint, for example when the handshake with it has failed.
+     */
+    void invalidate(const std::string& endpoint);
+
+    /**
+     * Remembers the latest session of the connection, that is about to be closed. With TLS 1.3 the server sends session tickets after
+     * the handshake, so they are only available once the connection has read some data.
+     *
+     * The connection is marked as shut down, because OpenSSL invalidates the session of the connection, that is freed without
+     * close_notify.
+     */
+    void connection_closed(SSL* ssl, const std::string& endpoint);
+
+    [[nodiscard]] std::vector<diag::tls_session_info> stats() const;
+
+  private:
+    void store(SSL* ssl, const std::string& endpoint);
+    struct entry {
+        SSL_SESSION* session{ nullptr };
+        std::uint64_t handshakes{ 0 };
+        std::uint64_t resumed_handshakes{ 0 };
+    };
+
+    void replace_session(entry& e, SSL_SESSION* session);
+
+    mutable std::mutex mutex_{};
+    std::map<std::string, entry, std::less<>> entries_{};
+};
+} // namespace couchbase::core::io
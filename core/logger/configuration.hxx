@@ -19,6 +19,21 @@
 namespace couchbase::core::logger
 {
 
+/**
+ * What to do with the message, when the per-thread buffer of the deferred logger is full
+ */
+enum class overflow_policy {
+    /**
+     * wait until the background thread consumes some of the messages
+     */
+    block,
+
+    /**
+     * drop the message, and increment the counter (see dropped_messages())
+     */
+    drop,
+};
+
 struct configuration {
     /**
      *  The base name of the log files (we'll append: .000000.txt where
@@ -31,6 +46,22 @@ struct configuration {
      */
     std::size_t buffer_size{ 8192 };
 
+    /**
+     * Capture arguments of the log calls into per-thread lock-free buffers, and format the messages on the background thread.
+     * Reduces the cost of logging for the I/O threads, when verbose levels (trace, debug) are enabled.
+     */
+    bool deferred_formatting{ false };
+
+    /**
+     * Number of records in the buffer of each thread, when deferred_formatting is enabled (rounded up to the power of two)
+     */
+    std::size_t per_thread_buffer_size{ 1024 };
+
+    /**
+     * Overflow policy for the per-thread buffers, when deferred_formatting is enabled
+     */
+    logger::overflow_policy overflow_policy{ logger::overflow_policy::block };
+
     /**
      * 100 MB per cycled file
      */
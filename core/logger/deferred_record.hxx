@@ -0,0 +1,190 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include "level.hxx"
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace couchbase::core::logger::detail
+{
+/**
+ * Arguments of these types either own their values, or can be converted to owning values cheaply, so the message can be formatted
+ * later on the background thread.
+ *
+ * Arguments of the other types might refer to the buffers owned by the caller (for example spdlog::to_hex() or fmt::join()), so the
+ * messages with such arguments are formatted on the calling thread.
+ */
+template<typename T>
+struct is_deferrable_argument
+  : std::bool_constant<std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_same_v<T, std::string> ||
+                       std::is_same_v<T, std::string_view> || std::is_same_v<T, const char*> || std::is_same_v<T, char*> ||
+                       std::is_same_v<T, const void*> || std::is_same_v<T, std::error_code>> {
+};
+
+template<typename Rep, typename Period>
+struct is_deferrable_argument<std::chrono::duration<Rep, Period>> : std::true_type {
+};
+
+template<typename... Args>
+inline constexpr bool are_deferrable_arguments_v = (is_deferrable_argument<std::decay_t<Args>>::value && ...);
+
+/**
+ * Strings are always copied, as the caller might release them right after the log call.
+ */
+template<typename T>
+using captured_argument_t =
+  std::conditional_t<std::is_same_v<T, std::string_view> || std::is_same_v<T, const char*> || std::is_same_v<T, char*>, std::string, T>;
+
+/**
+ * Format strings of the CB_LOG_* macros are literals, so they could be referenced. Everything else is copied.
+ */
+template<typename String>
+using captured_format_t = std::conditional_t<std::is_array_v<String>, const char*, std::string>;
+
+template<typename Format, typename... Captured>
+class deferred_payload
+{
+  public:
+    template<typename String, typename... Args>
+    explicit deferred_payload(const String& format, Args&&... args)
+      : format_(format)
+      , args_(std::forward<Args>(args)...)
+    {
+    }
+
+    void format_to(fmt::memory_buffer& out) const
+    {
+        std::apply(
+          [this, &out](const auto&... args) {
+              fmt::vformat_to(std::back_inserter(out), fmt::string_view(format_), fmt::make_format_args(args...));
+          },
+          args_);
+    }
+
+  private:
+    Format format_;
+    std::tuple<Captured...> args_;
+};
+
+class preformatted_payload
+{
+  public:
+    explicit preformatted_payload(std::string message)
+      : message_(std::move(message))
+    {
+    }
+
+    void format_to(fmt::memory_buffer& out) const
+    {
+        out.append(message_.data(), message_.data() + message_.size());
+    }
+
+  private:
+    std::string message_;
+};
+
+/**
+ * Single entry of the per-thread ring buffer. Small payloads are constructed in-place, so the steady state does not allocate unless
+ * the message has string arguments.
+ */
+struct deferred_record {
+    static constexpr std::size_t inline_storage_size{ 256 };
+
+    const char* file{ nullptr };
+    int line{ 0 };
+    const char* function{ nullptr };
+    level lvl{ level::info };
+    std::chrono::system_clock::time_point time{};
+    std::size_t thread_id{ 0 };
+
+    void* payload{ nullptr };
+    void (*format)(const void* payload, fmt::memory_buffer& out){ nullptr };
+    void (*destroy)(void* payload){ nullptr };
+    alignas(std::max_align_t) std::byte storage[inline_storage_size];
+
+    template<typename Payload, typename... Args>
+    void emplace(Args&&... args)
+    {
+        if constexpr (sizeof(Payload) <= inline_storage_size && alignof(Payload) <= alignof(std::max_align_t)) {
+            payload = new (static_cast<void*>(storage)) Payload(std::forward<Args>(args)...);
+            destroy = [](void* p) { static_cast<Payload*>(p)->~Payload(); };
+        } else {
+            payload = new Payload(std::forward<Args>(args)...);
+            destroy = [](void* p) { delete static_cast<Payload*>(p); };
+        }
+        format = [](const void* p, fmt::memory_buffer& out) { static_cast<const Payload*>(p)->format_to(out); };
+    }
+
+    void reset()
+    {
+        if (payload != nullptr) {
+            destroy(payload);
+            payload = nullptr;
+        }
+    }
+};
+
+/**
+ * @return true if the logger has been configured with configuration::deferred_formatting
+ */
+bool
+deferred_formatting_enabled();
+
+/**
+ * Reserves the record in the ring buffer of the calling thread.
+ *
+ * @return nullptr if the buffer is full and the overflow policy allows to drop messages
+ */
+deferred_record*
+acquire_deferred_record(const char* file, int line, const char* function, level lvl);
+
+/**
+ * Makes the record, reserved by acquire_deferred_record(), visible for the background thread.
+ */
+void
+publish_deferred_record();
+
+template<typename String, typename... Args>
+void
+log_deferred(const char* file, int line, const char* function, level lvl, const String& msg, Args&&... args)
+{
+    auto* record = acquire_deferred_record(file, line, function, lvl);
+    if (record == nullptr) {
+        return;
+    }
+    if constexpr (are_deferrable_arguments_v<Args...>) {
+        record->emplace<deferred_payload<captured_format_t<String>, captured_argument_t<std::decay_t<Args>>...>>(
+          msg, std::forward<Args>(args)...);
+    } else {
+        record->emplace<preformatted_payload>(fmt::format(msg, std::forward<Args>(args)...));
+    }
+    publish_deferred_record();
+}
+} // namespace couchbase::core::logger::detail
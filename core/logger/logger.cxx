@@ -14,14 +14,24 @@
 #include "configuration.hxx"
 #include "custom_rotating_file_sink.hxx"
 
-#include <chrono>
 #include <spdlog/async.h>
 #include <spdlog/async_logger.h>
+#include <spdlog/details/os.h>
 #include <spdlog/sinks/dist_sink.h>
 #include <spdlog/sinks/null_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 static const std::string logger_name{ "couchbase_cxx_client_file_logger" };
 
 /**
@@ -65,6 +75,352 @@ translate_level(level level)
     return spdlog::level::level_enum::trace;
 }
 
+namespace
+{
+/**
+ * Logger, which receives already formatted messages from the deferred dispatcher, and preserves timestamp and thread ID of the
+ * original log call.
+ */
+class deferred_logger : public spdlog::logger
+{
+  public:
+    deferred_logger(std::string name, spdlog::sink_ptr sink)
+      : spdlog::logger(std::move(name), std::move(sink))
+    {
+    }
+
+    void log_record(const detail::deferred_record& record, spdlog::string_view_t message)
+    {
+        spdlog::details::log_msg msg{
+            record.time, spdlog::source_loc{ record.file, record.line, record.function }, name_, translate_level(record.lvl), message,
+        };
+        msg.thread_id = record.thread_id;
+        sink_it_(msg);
+    }
+};
+
+std::size_t
+round_up_to_power_of_two(std::size_t value)
+{
+    std::size_t result = 1;
+    while (result < value) {
+        result <<= 1U;
+    }
+    return result;
+}
+
+/**
+ * State shared between the dispatcher and the rings, so that the logging threads could wake up the dispatcher, and the dispatcher could
+ * wake up the threads blocked on the full rings. The flags allow to skip locking the mutex, when nobody is waiting.
+ */
+struct deferred_signal {
+    std::mutex mutex{};
+    std::condition_variable wakeup{};
+    std::condition_variable space{};
+    std::atomic_bool consumer_sleeping{ false };
+    std::atomic_size_t blocked_producers{ 0 };
+    bool stopping{ false };
+
+    void notify_consumer()
+    {
+        // pairs with the fence in deferred_dispatcher::run(), so that either the dispatcher sees the record, or we see the flag
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumer_sleeping.load(std::memory_order_relaxed)) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+            }
+            wakeup.notify_one();
+        }
+    }
+
+    void notify_producers()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (blocked_producers.load(std::memory_order_relaxed) > 0) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+            }
+            space.notify_all();
+        }
+    }
+
+    /**
+     * @return false if the dispatcher has been stopped
+     */
+    template<typename Predicate>
+    bool wait_for_space(Predicate&& has_space)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        blocked_producers.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        space.wait(lock, [this, &has_space]() { return stopping || has_space(); });
+        blocked_producers.fetch_sub(1);
+        return !stopping;
+    }
+};
+
+/**
+ * Single-producer/single-consumer ring of the records, which belongs to one logging thread.
+ */
+class deferred_ring
+{
+  public:
+    deferred_ring(std::size_t capacity, overflow_policy policy, std::uint64_t generation, std::shared_ptr<deferred_signal> signal)
+      : records_(round_up_to_power_of_two(std::max<std::size_t>(capacity, 2)))
+      , mask_(records_.size() - 1)
+      , policy_(policy)
+      , generation_(generation)
+      , signal_(std::move(signal))
+    {
+    }
+
+    deferred_ring(const deferred_ring&) = delete;
+    deferred_ring& operator=(const deferred_ring&) = delete;
+
+    ~deferred_ring()
+    {
+        for (auto& record : records_) {
+            record.reset();
+        }
+    }
+
+    [[nodiscard]] detail::deferred_record* reserve()
+    {
+        if (full()) {
+            return nullptr;
+        }
+        return &records_[tail_.load(std::memory_order_relaxed) & mask_];
+    }
+
+    /**
+     * Blocks the logging thread until the dispatcher consumes some records.
+     *
+     * @return false if the dispatcher has been stopped, and the ring will not be consumed anymore
+     */
+    [[nodiscard]] bool wait_for_space()
+    {
+        return signal_->wait_for_space([this]() { return !full(); });
+    }
+
+    void publish()
+    {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        signal_->notify_consumer();
+    }
+
+    template<typename Handler>
+    std::size_t consume(std::size_t limit, Handler&& handler)
+    {
+        auto head = head_.load(std::memory_order_relaxed);
+        auto tail = tail_.load(std::memory_order_acquire);
+        std::size_t consumed = 0;
+        while (head != tail && consumed < limit) {
+            auto& record = records_[head & mask_];
+            handler(record);
+            record.reset();
+            ++head;
+            ++consumed;
+            head_.store(head, std::memory_order_release);
+        }
+        return consumed;
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] overflow_policy policy() const
+    {
+        return policy_;
+    }
+
+    [[nodiscard]] std::uint64_t generation() const
+    {
+        return generation_;
+    }
+
+    void abandon()
+    {
+        abandoned_ = true;
+    }
+
+    [[nodiscard]] bool abandoned() const
+    {
+        return abandoned_;
+    }
+
+  private:
+    [[nodiscard]] bool full() const
+    {
+        return tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_acquire) >= records_.size();
+    }
+
+    std::vector<detail::deferred_record> records_;
+    const std::size_t mask_;
+    const overflow_policy policy_;
+    const std::uint64_t generation_;
+    const std::shared_ptr<deferred_signal> signal_;
+    std::atomic_bool abandoned_{ false };
+    std::atomic_size_t head_{ 0 };
+    std::atomic_size_t tail_{ 0 };
+};
+
+/**
+ * Background thread, which collects records from the rings of all logging threads, formats them and passes to the sinks.
+ */
+class deferred_dispatcher
+{
+  public:
+    deferred_dispatcher(std::shared_ptr<deferred_logger> logger, const configuration& settings, std::uint64_t generation)
+      : logger_(std::move(logger))
+      , per_thread_buffer_size_(settings.per_thread_buffer_size)
+      , policy_(settings.overflow_policy)
+      , generation_(generation)
+    {
+    }
+
+    deferred_dispatcher(const deferred_dispatcher&) = delete;
+    deferred_dispatcher& operator=(const deferred_dispatcher&) = delete;
+
+    ~deferred_dispatcher()
+    {
+        stop();
+    }
+
+    void start()
+    {
+        worker_ = std::thread([this]() { run(); });
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(signal_->mutex);
+            signal_->stopping = true;
+        }
+        signal_->wakeup.notify_all();
+        signal_->space.notify_all();
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    }
+
+    std::shared_ptr<deferred_ring> register_ring()
+    {
+        auto ring = std::make_shared<deferred_ring>(per_thread_buffer_size_, policy_, generation_, signal_);
+        std::lock_guard<std::mutex> lock(signal_->mutex);
+        rings_.push_back(ring);
+        return ring;
+    }
+
+    /**
+     * Waits until the background thread consumes all records, which were published before the call.
+     */
+    void drain(std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(signal_->mutex);
+        idle_.wait_for(lock, timeout, [this]() { return signal_->stopping || !has_pending_records(); });
+    }
+
+    [[nodiscard]] std::uint64_t generation() const
+    {
+        return generation_;
+    }
+
+    [[nodiscard]] const std::shared_ptr<deferred_logger>& logger() const
+    {
+        return logger_;
+    }
+
+  private:
+    [[nodiscard]] bool has_pending_records() const
+    {
+        return std::any_of(rings_.begin(), rings_.end(), [](const auto& ring) { return !ring->empty(); });
+    }
+
+    void run()
+    {
+        static constexpr std::size_t batch_size{ 256 };
+
+        fmt::memory_buffer buffer;
+        std::vector<std::shared_ptr<deferred_ring>> pending_rings;
+        while (true) {
+            {
+                // the lock only guards the list of the rings, formatting and writing to the sinks happen without it
+                std::unique_lock<std::mutex> lock(signal_->mutex);
+                rings_.remove_if([](const auto& ring) { return ring->abandoned() && ring->empty(); });
+                if (!has_pending_records()) {
+                    idle_.notify_all();
+                    if (signal_->stopping) {
+                        break;
+                    }
+                    signal_->consumer_sleeping = true;
+                    // pairs with the fence in deferred_signal::notify_consumer()
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    signal_->wakeup.wait(lock, [this]() { return signal_->stopping || has_pending_records(); });
+                    signal_->consumer_sleeping = false;
+                }
+                pending_rings.assign(rings_.begin(), rings_.end());
+            }
+            for (const auto& ring : pending_rings) {
+                ring->consume(batch_size, [this, &buffer](const detail::deferred_record& record) { write(record, buffer); });
+            }
+            pending_rings.clear();
+            signal_->notify_producers();
+        }
+        idle_.notify_all();
+    }
+
+    void write(const detail::deferred_record& record, fmt::memory_buffer& buffer)
+    {
+        buffer.clear();
+        try {
+            record.format(record.payload, buffer);
+        } catch (const fmt::format_error& e) {
+            buffer.clear();
+            fmt::format_to(std::back_inserter(buffer), "unable to format log message: {}", e.what());
+        }
+        logger_->log_record(record, spdlog::string_view_t{ buffer.data(), buffer.size() });
+    }
+
+    std::shared_ptr<deferred_logger> logger_;
+    const std::size_t per_thread_buffer_size_;
+    const overflow_policy policy_;
+    const std::uint64_t generation_;
+    std::thread worker_{};
+    std::shared_ptr<deferred_signal> signal_{ std::make_shared<deferred_signal>() };
+    std::condition_variable idle_{};
+    std::list<std::shared_ptr<deferred_ring>> rings_{};
+};
+
+struct thread_ring_holder {
+    std::shared_ptr<deferred_ring> ring{};
+
+    ~thread_ring_holder()
+    {
+        if (ring) {
+            ring->abandon();
+        }
+    }
+};
+
+std::shared_ptr<deferred_dispatcher> dispatcher{};
+std::atomic_bool deferred_enabled{ false };
+std::atomic_uint64_t dispatcher_generation{ 0 };
+std::atomic_uint64_t dropped_messages_counter{ 0 };
+thread_local thread_ring_holder current_ring{};
+
+void
+stop_deferred_dispatcher()
+{
+    deferred_enabled = false;
+    if (auto current = std::atomic_exchange(&dispatcher, std::shared_ptr<deferred_dispatcher>{}); current) {
+        current->stop();
+    }
+}
+} // namespace
+
 level
 level_from_str(const std::string& str)
 {
@@ -101,18 +457,83 @@ should_log(level lvl)
 
 namespace detail
 {
+bool
+deferred_formatting_enabled()
+{
+    return deferred_enabled.load(std::memory_order_relaxed);
+}
+
+deferred_record*
+acquire_deferred_record(const char* file, int line, const char* function, level lvl)
+{
+    auto& ring = current_ring.ring;
+    if (!ring || ring->generation() != dispatcher_generation.load(std::memory_order_acquire)) {
+        auto current = std::atomic_load(&dispatcher);
+        if (!current) {
+            return nullptr;
+        }
+        if (ring) {
+            ring->abandon();
+        }
+        ring = current->register_ring();
+    }
+
+    auto* record = ring->reserve();
+    if (record == nullptr) {
+        if (ring->policy() == overflow_policy::drop) {
+            dropped_messages_counter.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        while ((record = ring->reserve()) == nullptr) {
+            if (!deferred_formatting_enabled() || !ring->wait_for_space()) {
+                // the dispatcher has been stopped, nobody is going to consume the ring
+                return nullptr;
+            }
+        }
+    }
+    record->file = file;
+    record->line = line;
+    record->function = function;
+    record->lvl = lvl;
+    record->time = std::chrono::system_clock::now();
+    record->thread_id = spdlog::details::os::thread_id();
+    return record;
+}
+
+void
+publish_deferred_record()
+{
+    current_ring.ring->publish();
+}
+
 void
 log(const char* file, int line, const char* function, level lvl, std::string_view msg)
 {
+    if (deferred_formatting_enabled()) {
+        if (auto* record = acquire_deferred_record(file, line, function, lvl); record != nullptr) {
+            record->emplace<preformatted_payload>(std::string{ msg });
+            publish_deferred_record();
+        }
+        return;
+    }
     if (is_initialized()) {
         return file_logger->log(spdlog::source_loc{ file, line, function }, translate_level(lvl), msg);
     }
 }
 } // namespace detail
 
+std::uint64_t
+dropped_messages()
+{
+    return dropped_messages_counter.load(std::memory_order_relaxed);
+}
+
 void
 flush()
 {
+    if (auto current = std::atomic_load(&dispatcher); current) {
+        current->drain(std::chrono::seconds(1));
+    }
     if (is_initialized()) {
         file_logger->flush();
     }
@@ -136,6 +557,7 @@ shutdown()
      * If the logger is running in unit test mode (synchronous) then this is a
      * no-op.
      */
+    stop_deferred_dispatcher();
     file_logger.reset();
     spdlog::details::registry::instance().shutdown();
 }
@@ -215,9 +637,16 @@ create_file_logger(const configuration& logger_settings)
             sink->add_sink(logger_settings.sink);
         }
 
+        stop_deferred_dispatcher();
         spdlog::drop(logger_name);
 
-        if (logger_settings.unit_test) {
+        std::shared_ptr<deferred_dispatcher> new_dispatcher{};
+        if (logger_settings.deferred_formatting) {
+            // the sinks are invoked synchronously from the dispatcher thread, which does formatting too
+            auto logger = std::make_shared<deferred_logger>(logger_name, sink);
+            new_dispatcher = std::make_shared<deferred_dispatcher>(logger, logger_settings, dispatcher_generation.load() + 1);
+            file_logger = logger;
+        } else if (logger_settings.unit_test) {
             file_logger = std::make_shared<spdlog::logger>(logger_name, sink);
         } else {
             // Create the default thread pool for async logging
@@ -236,6 +665,14 @@ create_file_logger(const configuration& logger_settings)
         spdlog::flush_every(std::chrono::seconds(1));
 
         spdlog::register_logger(file_logger);
+
+        if (new_dispatcher) {
+            dropped_messages_counter = 0;
+            new_dispatcher->start();
+            std::atomic_store(&dispatcher, new_dispatcher);
+            dispatcher_generation = new_dispatcher->generation();
+            deferred_enabled = true;
+        }
     } catch (const spdlog::spdlog_ex& ex) {
         std::string msg = std::string{ "Log initialization failed: " } + ex.what();
         return std::optional<std::string>{ msg };
@@ -252,6 +689,7 @@ get()
 void
 reset()
 {
+    stop_deferred_dispatcher();
     spdlog::drop(logger_name);
     file_logger.reset();
 }
@@ -260,6 +698,7 @@ void
 create_blackhole_logger()
 {
     // delete if already exists
+    stop_deferred_dispatcher();
     spdlog::drop(logger_name);
 
     file_logger = std::make_shared<spdlog::logger>(logger_name, std::make_shared<spdlog::sinks::null_sink_mt>());
@@ -274,6 +713,7 @@ void
 create_console_logger()
 {
     // delete if already exists
+    stop_deferred_dispatcher();
     spdlog::drop(logger_name);
 
     auto stderrsink = std::make_shared<spdlog::sinks::stderr_color_sink_mt>();
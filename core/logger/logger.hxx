@@ -25,11 +25,13 @@
 
 #pragma once
 
+#include "deferred_record.hxx"
 #include "level.hxx"
 
 #include <fmt/core.h>
 #include <spdlog/fwd.h>
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -165,9 +167,19 @@ template<typename String, typename... Args>
 inline void
 log(const char* file, int line, const char* function, level lvl, const String& msg, Args&&... args)
 {
+    if (detail::deferred_formatting_enabled()) {
+        return detail::log_deferred(file, line, function, lvl, msg, std::forward<Args>(args)...);
+    }
     detail::log(file, line, function, lvl, fmt::format(msg, std::forward<Args>(args)...));
 }
 
+/**
+ * @return number of messages, dropped because the per-thread buffer was full (only with configuration::deferred_formatting and
+ *         overflow_policy::drop)
+ */
+std::uint64_t
+dropped_messages();
+
 /**
  * Tell the logger to flush its buffers
  */
@@ -19,6 +19,7 @@
 
 #include <cstddef>
 #include <cstring>
+#include <utility>
 
 namespace couchbase::core::mcbp
 {
@@ -27,11 +28,26 @@ buffer_writer::buffer_writer(std::size_t size)
 {
 }
 
+buffer_writer::buffer_writer(std::vector<std::byte>&& store, std::size_t offset)
+  : store_{ std::move(store) }
+  , offset_{ offset }
+{
+}
+
 void
 buffer_writer::write(const std::vector<std::byte>& val)
 {
-    std::memcpy(store_.data() + offset_, val.data(), val.size());
-    offset_ += val.size();
+    write(val.data(), val.size());
+}
+
+void
+buffer_writer::write(const std::byte* data, std::size_t size)
+{
+    if (size == 0) {
+        return;
+    }
+    std::memcpy(store_.data() + offset_, data, size);
+    offset_ += size;
 }
 
 void
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <cinttypes>
+#include <cstddef>
 #include <vector>
 
 namespace couchbase::core::mcbp
@@ -25,12 +26,18 @@ namespace couchbase::core::mcbp
 struct buffer_writer {
     explicit buffer_writer(std::size_t size);
 
+    /**
+     * Takes over the storage, that already has enough space allocated, and writes starting from the given offset.
+     */
+    buffer_writer(std::vector<std::byte>&& store, std::size_t offset);
+
     void write_byte(std::byte val);
     void write_uint16(std::uint16_t val);
     void write_uint32(std::uint32_t val);
     void write_uint64(std::uint64_t val);
     void write_frame_header(std::uint8_t type, std::size_t length);
     void write(const std::vector<std::byte>& val);
+    void write(const std::byte* data, std::size_t size);
 
     std::vector<std::byte> store_;
     std::size_t offset_{ 0 };
@@ -29,15 +29,18 @@
 namespace couchbase::core::mcbp
 {
 codec::codec(std::set<protocol::hello_feature> enabled_features)
-  : enabled_features_{ std::move(enabled_features) }
-  , collections_enabled_{ enabled_features_.count(protocol::hello_feature::collections) > 0 }
 {
+    for (const auto& feature : enabled_features) {
+        enable_feature(feature);
+    }
 }
 
 void
 codec::enable_feature(protocol::hello_feature feature)
 {
-    enabled_features_.insert(feature);
+    if (auto index = static_cast<std::size_t>(feature); index < enabled_features_.size()) {
+        enabled_features_.set(index);
+    }
     if (feature == protocol::hello_feature::collections) {
         collections_enabled_ = true;
     }
@@ -46,81 +49,144 @@ codec::enable_feature(protocol::hello_feature feature)
 bool
 codec::is_feature_enabled(protocol::hello_feature feature) const
 {
-    return enabled_features_.count(feature) > 0;
+    auto index = static_cast<std::size_t>(feature);
+    return index < enabled_features_.size() && enabled_features_.test(index);
+}
+
+namespace
+{
+constexpr auto
+variable_frame_header_size(std::size_t length) -> std::size_t
+{
+    return length < 15 ? 1 : 2;
 }
+} // namespace
 
 auto
 codec::encode_packet(const couchbase::core::mcbp::packet& packet) -> tl::expected<std::vector<std::byte>, std::error_code>
 {
-    auto encoded_key = packet.key_;
-    auto extras = packet.extras_;
+    std::vector<std::byte> output{};
+    if (auto ec = encode_packet(packet, output); ec) {
+        return tl::unexpected(ec);
+    }
+    return output;
+}
 
+auto
+codec::encode_packet(const couchbase::core::mcbp::packet& packet, std::vector<std::byte>& output) -> std::error_code
+{
+    // Validate the packet and compute the size of every section first, so that the output could be written in a single pass, and left
+    // untouched in case of error.
+
+    bool collection_id_in_key{ false };
+    bool collection_id_in_extras{ false };
     if (collections_enabled_) {
         if (packet.command_ == protocol::client_opcode::observe) {
             // While it's possible that the Observe operation is in fact supported with collections
             // enabled, we don't currently implement that operation for simplicity, as the key is
             // actually hidden away in the value data instead of the usual key data.
             CB_LOG_DEBUG("the observe operation is not supported with collections enabled");
-            return tl::unexpected(errc::common::unsupported_operation);
+            return errc::common::unsupported_operation;
         }
         if (supports_collection_id(packet.command_)) {
-            core::utils::unsigned_leb128<std::uint32_t> encoded(packet.collection_id_);
-            encoded_key.reserve(encoded_key.size() + encoded.size());
-            encoded_key.insert(encoded_key.begin(), encoded.begin(), encoded.end());
+            // RangeScanCreate has no key, the collection is the member of the JSON body
+            collection_id_in_key = packet.command_ != protocol::client_opcode::range_scan_create;
         } else if (packet.command_ == protocol::client_opcode::get_random_key) {
             // GetRandom expects the cid to be in the extras
             // GetRandom MUST not have any extras if not using collections, so we're ok to just set it.
             // It also doesn't expect the collection ID to be leb encoded.
-            extras.resize(sizeof(std::uint32_t));
-            big_endian::put_uint32(extras, packet.collection_id_);
-        }
-        if (packet.collection_id_ > 0) {
+            collection_id_in_extras = true;
+        } else if (packet.collection_id_ > 0) {
             CB_LOG_DEBUG("cannot encode collection id with a non-collection command");
-            return tl::unexpected(errc::common::invalid_argument);
+            return errc::common::invalid_argument;
         }
+    } else if (packet.collection_id_ > 0) {
+        CB_LOG_DEBUG("cannot encode collection id with a non-collection command");
+        return errc::common::invalid_argument;
     }
+    const core::utils::unsigned_leb128<std::uint32_t> encoded_collection_id(packet.collection_id_);
 
-    std::size_t ext_len = extras.size();
-    std::size_t key_len = encoded_key.size();
+    std::size_t ext_len = collection_id_in_extras ? sizeof(std::uint32_t) : packet.extras_.size();
+    std::size_t key_len = packet.key_.size() + (collection_id_in_key ? encoded_collection_id.size() : 0);
     std::size_t val_len = packet.value_.size();
     std::size_t frames_len = 0;
 
+    const bool is_request = packet.magic_ == protocol::magic::client_request;
+
     if (packet.barrier_frame_) {
+        if (!is_request) {
+            CB_LOG_DEBUG("cannot use barrier frame in non-request packets");
+            return errc::common::invalid_argument;
+        }
         frames_len += 1;
     }
     if (packet.durability_level_frame_) {
+        if (!is_request) {
+            CB_LOG_DEBUG("cannot use durability level frame in non-request packets");
+            return errc::common::invalid_argument;
+        }
+        if (!is_feature_enabled(protocol::hello_feature::sync_replication)) {
+            CB_LOG_DEBUG("cannot use sync replication frames without enabling the feature");
+            return errc::common::feature_not_available;
+        }
         frames_len += 2;
         if (packet.durability_timeout_frame_) {
             frames_len += 2;
         }
     }
     if (packet.stream_id_frame_) {
+        if (!is_request) {
+            CB_LOG_DEBUG("cannot use stream id frame in non-request packets");
+            return errc::common::invalid_argument;
+        }
         frames_len += 3;
     }
     if (packet.open_tracing_frame_) {
-        std::size_t trace_ctx_len = packet.open_tracing_frame_->trace_context.size();
-        frames_len = trace_ctx_len;
-        if (trace_ctx_len < 15) {
-            frames_len += 1;
-        } else {
-            frames_len += 2;
+        if (!is_request) {
+            CB_LOG_DEBUG("cannot use open tracing frame in non-request packets");
+            return errc::common::invalid_argument;
+        }
+        if (!is_feature_enabled(protocol::hello_feature::open_tracing)) {
+            CB_LOG_DEBUG("cannot use open tracing frames without enabling the feature");
+            return errc::common::feature_not_available;
         }
+        std::size_t trace_ctx_len = packet.open_tracing_frame_->trace_context.size();
+        frames_len += variable_frame_header_size(trace_ctx_len) + trace_ctx_len;
     }
     if (packet.server_duration_frame_) {
+        if (packet.magic_ != protocol::magic::client_response) {
+            CB_LOG_DEBUG("cannot use server duration frame in non-response packets");
+            return errc::common::invalid_argument;
+        }
+        if (!is_feature_enabled(protocol::hello_feature::tracing)) {
+            CB_LOG_DEBUG("cannot use server duration frames without enabling the feature");
+            return errc::common::feature_not_available;
+        }
         frames_len += 3;
     }
     if (packet.user_impersonation_frame_) {
-        std::size_t user_len = packet.user_impersonation_frame_->user.size();
-        frames_len += user_len;
-        if (user_len < 15) {
-            frames_len += 1;
-        } else {
-            frames_len += 2;
+        if (!is_request) {
+            CB_LOG_DEBUG("cannot use user impersonation frame in non-request packets");
+            return errc::common::invalid_argument;
         }
+        std::size_t user_len = packet.user_impersonation_frame_->user.size();
+        frames_len += variable_frame_header_size(user_len) + user_len;
     }
     if (packet.preserve_expiry_frame_) {
+        if (!is_request) {
+            CB_LOG_DEBUG("cannot use preserve expiry frame in non-request packets");
+            return errc::common::invalid_argument;
+        }
+        if (!is_feature_enabled(protocol::hello_feature::preserve_ttl)) {
+            CB_LOG_DEBUG("cannot use preserve expiry frame without enabling the feature");
+            return errc::common::feature_not_available;
+        }
         frames_len += 1;
     }
+    if (!packet.unsupported_frames_.empty()) {
+        CB_LOG_DEBUG("cannot use send packets with unsupported frames");
+        return errc::common::invalid_argument;
+    }
 
     // We automatically upgrade a packet from normal Req or Res magic into the frame variant depending on the usage of them.
     auto packet_magic = packet.magic_;
@@ -129,7 +195,7 @@ codec::encode_packet(const couchbase::core::mcbp::packet& packet) -> tl::expecte
             case protocol::magic::client_request:
                 if (!is_feature_enabled(protocol::hello_feature::alt_request_support)) {
                     CB_LOG_DEBUG("cannot use frames in req packets without enabling the feature");
-                    return tl::unexpected(errc::common::unsupported_operation);
+                    return errc::common::unsupported_operation;
                 }
                 packet_magic = protocol::magic::alt_client_request;
                 break;
@@ -138,48 +204,53 @@ codec::encode_packet(const couchbase::core::mcbp::packet& packet) -> tl::expecte
                 break;
             default:
                 CB_LOG_DEBUG("cannot use frames with an unsupported magic");
-                return tl::unexpected(errc::common::unsupported_operation);
+                return errc::common::unsupported_operation;
         }
     }
-    std::size_t packet_len = 24 + ext_len + frames_len + key_len + val_len;
-    buffer_writer buffer{ packet_len };
-    buffer.write_byte(static_cast<std::byte>(packet_magic));
-    buffer.write_byte(static_cast<std::byte>(packet.command_));
-
-    // This is safe to do without checking the magic as we check the magic above before incrementing the framesLen variable
-    if (frames_len > 0) {
-        buffer.write_byte(static_cast<std::byte>(frames_len));
-        buffer.write_byte(static_cast<std::byte>(key_len));
-    } else {
-        buffer.write_uint16(static_cast<std::uint16_t>(key_len));
-    }
-    buffer.write_byte(static_cast<std::byte>(ext_len));
-    buffer.write_byte(packet.datatype_);
 
+    std::uint16_t vbucket_or_status{ 0 };
     switch (packet.magic_) {
         case protocol::magic::client_request:
         case protocol::magic::alt_client_request:
             if (static_cast<std::uint32_t>(packet.status_) != 0) {
                 CB_LOG_DEBUG("cannot specify status in a request packet");
-                return tl::unexpected(errc::common::invalid_argument);
+                return errc::common::invalid_argument;
             }
-            buffer.write_uint16(packet.vbucket_);
+            vbucket_or_status = packet.vbucket_;
             break;
 
         case protocol::magic::client_response:
         case protocol::magic::alt_client_response:
             if (static_cast<std::uint32_t>(packet.vbucket_) != 0) {
                 CB_LOG_DEBUG("cannot specify vbucket in a response packet");
-                return tl::unexpected(errc::common::invalid_argument);
+                return errc::common::invalid_argument;
             }
-            buffer.write_uint16(packet.status_);
+            vbucket_or_status = packet.status_;
             break;
 
         default:
             CB_LOG_DEBUG("cannot encode status/vbucket for unknown packet magic");
-            return tl::unexpected(errc::common::invalid_argument);
+            return errc::common::invalid_argument;
     }
 
+    std::size_t packet_len = 24 + ext_len + frames_len + key_len + val_len;
+    std::size_t offset = output.size();
+    output.resize(offset + packet_len);
+    buffer_writer buffer{ std::move(output), offset };
+
+    buffer.write_byte(static_cast<std::byte>(packet_magic));
+    buffer.write_byte(static_cast<std::byte>(packet.command_));
+
+    // This is safe to do without checking the magic as we check the magic above before incrementing the framesLen variable
+    if (frames_len > 0) {
+        buffer.write_byte(static_cast<std::byte>(frames_len));
+        buffer.write_byte(static_cast<std::byte>(key_len));
+    } else {
+        buffer.write_uint16(static_cast<std::uint16_t>(key_len));
+    }
+    buffer.write_byte(static_cast<std::byte>(ext_len));
+    buffer.write_byte(packet.datatype_);
+    buffer.write_uint16(vbucket_or_status);
     buffer.write_uint32(static_cast<std::uint32_t>(key_len + ext_len + val_len + frames_len));
     buffer.write_uint32(packet.opaque_);
     buffer.write_uint64(packet.cas_);
@@ -187,24 +258,10 @@ codec::encode_packet(const couchbase::core::mcbp::packet& packet) -> tl::expecte
     // Generate the framing extra data
 
     if (packet.barrier_frame_) {
-        if (packet.magic_ != protocol::magic::client_request) {
-            CB_LOG_DEBUG("cannot use barrier frame in non-request packets");
-            return tl::unexpected(errc::common::invalid_argument);
-        }
         buffer.write_frame_header(mcbp::request_barrier, 0);
     }
 
     if (packet.durability_level_frame_) {
-        if (packet.magic_ != protocol::magic::client_request) {
-            CB_LOG_DEBUG("cannot use durability level frame in non-request packets");
-            return tl::unexpected(errc::common::invalid_argument);
-        }
-
-        if (!is_feature_enabled(protocol::hello_feature::sync_replication)) {
-            CB_LOG_DEBUG("cannot use sync replication frames without enabling the feature");
-            return tl::unexpected(errc::common::feature_not_available);
-        }
-
         if (packet.durability_timeout_frame_) {
             auto millis = packet.durability_timeout_frame_->timeout.count();
             if (millis > 65535) {
@@ -220,95 +277,56 @@ codec::encode_packet(const couchbase::core::mcbp::packet& packet) -> tl::expecte
     }
 
     if (packet.stream_id_frame_) {
-        if (packet.magic_ != protocol::magic::client_request) {
-            CB_LOG_DEBUG("cannot use stream id frame in non-request packets");
-            return tl::unexpected(errc::common::invalid_argument);
-        }
-
         buffer.write_frame_header(mcbp::request_stream_id, 2);
         buffer.write_uint16(packet.stream_id_frame_->stream_id);
     }
 
     if (packet.open_tracing_frame_) {
-        if (packet.magic_ != protocol::magic::client_request) {
-            CB_LOG_DEBUG("cannot use open tracing frame in non-request packets");
-            return tl::unexpected(errc::common::invalid_argument);
-        }
-
-        if (!is_feature_enabled(protocol::hello_feature::open_tracing)) {
-            CB_LOG_DEBUG("cannot use open tracing frames without enabling the feature");
-            return tl::unexpected(errc::common::feature_not_available);
-        }
-
         std::size_t trace_ctx_len = packet.open_tracing_frame_->trace_context.size();
         if (trace_ctx_len < 15) {
             buffer.write_frame_header(mcbp::request_open_tracing, trace_ctx_len);
-            buffer.write(packet.open_tracing_frame_->trace_context);
         } else {
             buffer.write_frame_header(mcbp::request_open_tracing, 15);
             buffer.write_byte(static_cast<std::byte>(trace_ctx_len - 15));
-            buffer.write(packet.open_tracing_frame_->trace_context);
         }
+        buffer.write(packet.open_tracing_frame_->trace_context);
     }
 
     if (packet.server_duration_frame_) {
-        if (packet.magic_ != protocol::magic::client_response) {
-            CB_LOG_DEBUG("cannot use server duration frame in non-response packets");
-            return tl::unexpected(errc::common::invalid_argument);
-        }
-
-        if (!is_feature_enabled(protocol::hello_feature::tracing)) {
-            buffer.write_frame_header(mcbp::response_server_duration, 2);
-            buffer.write_uint16(mcbp::encode_server_duration(packet.server_duration_frame_->server_duration));
-        }
+        buffer.write_frame_header(mcbp::response_server_duration, 2);
+        buffer.write_uint16(mcbp::encode_server_duration(packet.server_duration_frame_->server_duration));
     }
 
     if (packet.user_impersonation_frame_) {
-        if (packet.magic_ != protocol::magic::client_request) {
-            CB_LOG_DEBUG("cannot use user impersonation frame in non-request packets");
-            return tl::unexpected(errc::common::invalid_argument);
-        }
-
         std::size_t user_len = packet.user_impersonation_frame_->user.size();
         if (user_len < 15) {
             buffer.write_frame_header(mcbp::request_user_impersonation, user_len);
-            buffer.write(packet.user_impersonation_frame_->user);
         } else {
             buffer.write_frame_header(mcbp::request_user_impersonation, 15);
             buffer.write_byte(static_cast<std::byte>(user_len - 15));
-            buffer.write(packet.user_impersonation_frame_->user);
         }
+        buffer.write(packet.user_impersonation_frame_->user);
     }
 
     if (packet.preserve_expiry_frame_) {
-        if (packet.magic_ != protocol::magic::client_request) {
-            CB_LOG_DEBUG("cannot use preserve expiry frame in non-request packets");
-            return tl::unexpected(errc::common::invalid_argument);
-        }
-
-        if (!is_feature_enabled(protocol::hello_feature::preserve_ttl)) {
-            CB_LOG_DEBUG("cannot use preserve expiry frame without enabling the feature");
-            return tl::unexpected(errc::common::feature_not_available);
-        }
-
         buffer.write_frame_header(mcbp::request_preserve_expiry, 0);
     }
 
-    if (!packet.unsupported_frames_.empty()) {
-        CB_LOG_DEBUG("cannot use send packets with unsupported frames");
-        return tl::unexpected(errc::common::invalid_argument);
+    if (collection_id_in_extras) {
+        buffer.write_uint32(packet.collection_id_);
+    } else {
+        buffer.write(packet.extras_);
     }
 
-    // Copy the extras into the body of the packet
-    buffer.write(extras);
-
-    // Copy the encoded key into the body of the packet
-    buffer.write(encoded_key);
+    if (collection_id_in_key) {
+        buffer.write(encoded_collection_id.data(), encoded_collection_id.size());
+    }
+    buffer.write(packet.key_);
 
-    // Copy the value into the body of the packet
     buffer.write(packet.value_);
 
-    return buffer.store_;
+    output = std::move(buffer.store_);
+    return {};
 }
 
 std::tuple<packet, std::size_t, std::error_code>
@@ -25,6 +25,7 @@
 #include <tl/expected.hpp>
 
 #include <array>
+#include <bitset>
 #include <set>
 #include <system_error>
 #include <utility>
@@ -39,13 +40,20 @@ class codec
     explicit codec(std::set<protocol::hello_feature> enabled_features);
 
     auto encode_packet(const packet& packet) -> tl::expected<std::vector<std::byte>, std::error_code>;
+
+    /**
+     * Appends encoded packet to the output buffer, so that the caller could reuse the storage between the packets.
+     * The buffer is left untouched if the packet cannot be encoded.
+     */
+    auto encode_packet(const packet& packet, std::vector<std::byte>& output) -> std::error_code;
     auto decode_packet(gsl::span<std::byte> input) -> std::tuple<packet, std::size_t, std::error_code>;
     auto decode_packet(gsl::span<std::byte> header, gsl::span<std::byte> body) -> std::tuple<packet, std::size_t, std::error_code>;
     void enable_feature(protocol::hello_feature feature);
     [[nodiscard]] auto is_feature_enabled(protocol::hello_feature feature) const -> bool;
 
   private:
-    std::set<protocol::hello_feature> enabled_features_{};
+    // indexed by the code of the hello_feature
+    std::bitset<64> enabled_features_{};
     bool collections_enabled_{ false };
 };
 
@@ -68,6 +68,7 @@ supports_collection_id(protocol::client_opcode command)
         case protocol::client_opcode::remove_with_meta:
         case protocol::client_opcode::subdoc_multi_lookup:
         case protocol::client_opcode::subdoc_multi_mutation:
+        case protocol::client_opcode::range_scan_create:
             return true;
         default:
             break;
@@ -31,6 +31,11 @@
 #include <mutex>
 #include <set>
 
+namespace couchbase::tracing
+{
+class request_span;
+} // namespace couchbase::tracing
+
 namespace couchbase::core
 {
 class operation_map;
@@ -85,6 +90,10 @@ class queue_request
     // time period.
     std::shared_ptr<couchbase::retry_strategy> retry_strategy_{};
 
+    // This is the span of the operation. It is ended by the callback, or by the caller when the request could not be dispatched, and
+    // the callback will never be invoked.
+    std::shared_ptr<couchbase::tracing::request_span> span_{};
+
   private:
     // Static routing properties
     queue_callback callback_;
@@ -23,15 +23,263 @@
 
 #include <couchbase/error_codes.hxx>
 
+#include <tao/json.hpp>
 #include <tao/json/contrib/traits.hpp>
 
+#include <optional>
+
 namespace couchbase::core::operations
 {
+namespace
+{
+auto
+json_view(const couchbase::core::json_string& value) -> std::string_view
+{
+    if (value.is_binary()) {
+        const auto& bytes = value.bytes();
+        return { reinterpret_cast<const char*>(bytes.data()), bytes.size() };
+    }
+    if (value.is_string()) {
+        return value.str();
+    }
+    return "null";
+}
+
+/**
+ * Appends member to the JSON object, that has not been closed yet.
+ */
+void
+append_member(std::string& body, std::string_view name, std::string_view encoded_value)
+{
+    if (body.back() != '{') {
+        body.append(1, ',');
+    }
+    body.append(utils::json::generate(tao::json::value(std::string{ name }))).append(1, ':').append(encoded_value);
+}
+
+/**
+ * Fills search_row from the JSON events of the single hit, so that the hit is never materialized as tao::json::value.
+ *
+ * Depth of the events (the hit object itself is at depth 1):
+ *
+ *   {"locations": {"field": {"term": [{"pos": 1, "array_positions": [0]}]}}, "fragments": {"field": ["..."]}}
+ *   1             2         3        4 5                                6      2             3
+ *
+ * "fields" and "explanation" are opaque for the SDK, so their events are re-encoded into JSON strings.
+ */
+class search_hit_consumer
+{
+  public:
+    explicit search_hit_consumer(search_response::search_row& row)
+      : row_(row)
+    {
+    }
+
+    void null()
+    {
+        if (capture_) {
+            capture_->null();
+        }
+    }
+
+    void boolean(const bool value)
+    {
+        if (capture_) {
+            capture_->boolean(value);
+        }
+    }
+
+    void number(const std::int64_t value)
+    {
+        on_number(value);
+    }
+
+    void number(const std::uint64_t value)
+    {
+        on_number(value);
+    }
+
+    void number(const double value)
+    {
+        on_number(value);
+    }
+
+    void string(const std::string_view value)
+    {
+        if (capture_) {
+            return capture_->string(value);
+        }
+        if (depth_ == 1) {
+            if (hit_key_ == "index") {
+                row_.index = value;
+            } else if (hit_key_ == "id") {
+                row_.id = value;
+            }
+        } else if (section_ == section::fragments && depth_ == 3) {
+            row_.fragments[field_].emplace_back(value);
+        }
+    }
+
+    void begin_array(const std::size_t /* size */ = 0)
+    {
+        ++depth_;
+        if (capture_) {
+            return capture_->begin_array();
+        }
+        if (section_ == section::locations && depth_ == 6 && location_ && location_key_ == "array_positions") {
+            location_->array_positions.emplace();
+        }
+    }
+
+    void element()
+    {
+        if (capture_) {
+            capture_->element();
+        }
+    }
+
+    void end_array(const std::size_t /* size */ = 0)
+    {
+        if (capture_) {
+            capture_->end_array();
+        } else if (depth_ == 2) {
+            section_ = section::other;
+        }
+        --depth_;
+    }
+
+    void begin_object(const std::size_t /* size */ = 0)
+    {
+        ++depth_;
+        if (capture_) {
+            return capture_->begin_object();
+        }
+        if (depth_ == 2) {
+            if (hit_key_ == "locations") {
+                section_ = section::locations;
+            } else if (hit_key_ == "fragments") {
+                section_ = section::fragments;
+            } else if (hit_key_ == "fields") {
+                start_capture(row_.fields);
+            } else if (hit_key_ == "explanation") {
+                start_capture(row_.explanation);
+            }
+        } else if (section_ == section::locations && depth_ == 5) {
+            location_.emplace();
+            location_->field = field_;
+            location_->term = term_;
+        }
+    }
+
+    void key(const std::string_view name)
+    {
+        if (capture_) {
+            return capture_->key(name);
+        }
+        if (depth_ == 1) {
+            hit_key_ = name;
+        } else if (section_ == section::locations) {
+            if (depth_ == 2) {
+                field_ = name;
+            } else if (depth_ == 3) {
+                term_ = name;
+            } else if (depth_ == 5) {
+                location_key_ = name;
+            }
+        } else if (section_ == section::fragments && depth_ == 2) {
+            field_ = name;
+        }
+    }
+
+    void member()
+    {
+        if (capture_) {
+            capture_->member();
+        }
+    }
+
+    void end_object(const std::size_t /* size */ = 0)
+    {
+        if (capture_) {
+            capture_->end_object();
+            if (depth_ == capture_depth_) {
+                *capture_target_ = capture_->value();
+                capture_.reset();
+            }
+        } else if (section_ == section::locations && depth_ == 5 && location_) {
+            row_.locations.emplace_back(std::move(location_.value()));
+            location_.reset();
+        } else if (depth_ == 2) {
+            section_ = section::other;
+        }
+        --depth_;
+    }
+
+  private:
+    enum class section {
+        other,
+        locations,
+        fragments,
+    };
+
+    template<typename Number>
+    void on_number(Number value)
+    {
+        if (capture_) {
+            return capture_->number(value);
+        }
+        if (depth_ == 1 && hit_key_ == "score") {
+            row_.score = static_cast<double>(value);
+        } else if (section_ == section::locations && location_) {
+            if (depth_ == 5) {
+                if (location_key_ == "pos") {
+                    location_->position = static_cast<std::uint64_t>(value);
+                } else if (location_key_ == "start") {
+                    location_->start_offset = static_cast<std::uint64_t>(value);
+                } else if (location_key_ == "end") {
+                    location_->end_offset = static_cast<std::uint64_t>(value);
+                }
+            } else if (depth_ == 6 && location_->array_positions) {
+                location_->array_positions->emplace_back(static_cast<std::uint64_t>(value));
+            }
+        }
+    }
+
+    void start_capture(std::string& target)
+    {
+        capture_.emplace();
+        capture_target_ = &target;
+        capture_depth_ = depth_;
+        capture_->begin_object();
+    }
+
+    search_response::search_row& row_;
+    std::size_t depth_{ 0 };
+    section section_{ section::other };
+    std::string hit_key_{};
+    std::string field_{};
+    std::string term_{};
+    std::string location_key_{};
+    std::optional<search_response::search_location> location_{};
+    std::optional<tao::json::events::to_string> capture_{};
+    std::string* capture_target_{ nullptr };
+    std::size_t capture_depth_{ 0 };
+};
+} // namespace
+
+search_response::search_row
+decode_search_hit(std::string_view hit)
+{
+    search_response::search_row row{};
+    search_hit_consumer consumer{ row };
+    tao::json::events::from_string(consumer, hit);
+    return row;
+}
+
 std::error_code
 search_request::encode_to(search_request::encoded_request_type& encoded, http_context& context)
 {
     auto body = tao::json::value{
-        { "query", utils::json::parse(query) },
         { "ctl", { { "timeout", encoded.timeout.count() } } },
     };
     if (explain) {
@@ -69,18 +317,6 @@ search_request::encode_to(search_request::encoded_request_type& encoded, http_co
     if (!fields.empty()) {
         body["fields"] = fields;
     }
-    if (!sort_specs.empty()) {
-        body["sort"] = tao::json::empty_array;
-        for (const auto& spec : sort_specs) {
-            body["sort"].get_array().push_back(utils::json::parse(spec));
-        }
-    }
-    if (!facets.empty()) {
-        body["facets"] = tao::json::empty_object;
-        for (const auto& [name, facet] : facets) {
-            body["facets"][name] = utils::json::parse(facet);
-        }
-    }
     if (!mutation_state.empty()) {
         tao::json::value scan_vectors = tao::json::empty_object;
         for (const auto& token : mutation_state) {
@@ -99,22 +335,70 @@ search_request::encode_to(search_request::encoded_request_type& encoded, http_co
         body["collections"] = collections;
     }
 
+    // The query, sort specs, facets and raw options are already encoded by the caller, so they are spliced into the body as is,
+    // instead of being parsed just to be generated again. The raw options override the options above, and the body must not contain
+    // duplicate keys, so the overridden members are not emitted at all.
     for (const auto& [key, value] : raw) {
-        body[key] = utils::json::parse(value);
+        body.get_object().erase(key);
+    }
+    body_str = utils::json::generate(body);
+    body_str.pop_back(); // closing brace of the body object
+    if (raw.count("query") == 0) {
+        append_member(body_str, "query", json_view(query));
     }
+    if (!sort_specs.empty() && raw.count("sort") == 0) {
+        std::string sort{ "[" };
+        for (const auto& spec : sort_specs) {
+            if (sort.size() > 1) {
+                sort.append(1, ',');
+            }
+            sort.append(spec);
+        }
+        sort.append(1, ']');
+        append_member(body_str, "sort", sort);
+    }
+    if (!facets.empty() && raw.count("facets") == 0) {
+        std::string encoded_facets{ "{" };
+        for (const auto& [name, facet] : facets) {
+            append_member(encoded_facets, name, facet);
+        }
+        encoded_facets.append(1, '}');
+        append_member(body_str, "facets", encoded_facets);
+    }
+    for (const auto& [key, value] : raw) {
+        append_member(body_str, key, json_view(value));
+    }
+    body_str.append(1, '}');
 
     encoded.type = type;
     encoded.headers["content-type"] = "application/json";
     encoded.method = "POST";
     encoded.path = fmt::format("/api/index/{}/query", index_name);
-    body_str = utils::json::generate(body);
     encoded.body = body_str;
     if (context.options.show_queries) {
-        CB_LOG_INFO("SEARCH: {}", utils::json::generate(body["query"]));
+        CB_LOG_INFO("SEARCH: {}", json_view(query));
     } else {
-        CB_LOG_DEBUG("SEARCH: {}", utils::json::generate(body["query"]));
+        CB_LOG_DEBUG("SEARCH: {}", json_view(query));
     }
-    if (row_callback) {
+    if (hit_callback) {
+        hit_error = std::make_shared<std::error_code>();
+        encoded.streaming.emplace(couchbase::core::io::streaming_settings{
+          "/hits/^",
+          4,
+          [callback = std::move(hit_callback.value()), error = hit_error, client_context_id = encoded.client_context_id](
+            std::string&& hit) {
+              search_response::search_row row{};
+              try {
+                  row = decode_search_hit(hit);
+              } catch (const tao::pegtl::parse_error& e) {
+                  CB_LOG_WARNING(R"(unable to decode search hit, client_context_id="{}": {})", client_context_id, e.what());
+                  *error = errc::common::parsing_failure;
+                  return utils::json::stream_control::stop;
+              }
+              return callback(std::move(row));
+          },
+        });
+    } else if (row_callback) {
         encoded.streaming.emplace(couchbase::core::io::streaming_settings{
           "/hits/^",
           4,
@@ -130,8 +414,12 @@ search_request::make_response(error_context::search&& ctx, const encoded_respons
     search_response response{ std::move(ctx) };
     response.meta.client_context_id = response.ctx.client_context_id;
     response.ctx.index_name = index_name;
-    response.ctx.query = query.str();
+    response.ctx.query = json_view(query);
     response.ctx.parameters = body_str;
+    if (!response.ctx.ec && hit_error && *hit_error) {
+        // some of the hits have not been delivered to hit_callback, so the result must not look complete
+        response.ctx.ec = *hit_error;
+    }
     if (!response.ctx.ec) {
         if (encoded.status_code == 200) {
             tao::json::value payload{};
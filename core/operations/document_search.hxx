@@ -31,6 +31,7 @@
 #include <couchbase/mutation_token.hxx>
 
 #include <map>
+#include <string_view>
 #include <variant>
 #include <vector>
 
@@ -152,8 +153,29 @@ struct search_request {
     std::string body_str{};
 
     std::shared_ptr<couchbase::tracing::request_span> parent_span{ nullptr };
+
+    /**
+     * If set, the hits are decoded one by one as soon as they have been received, and passed to the callback instead of being
+     * collected in search_response::rows, so that the memory used by the request does not grow with the number of hits.
+     * Takes precedence over row_callback.
+     */
+    std::optional<std::function<utils::json::stream_control(search_response::search_row&&)>> hit_callback{};
+
+    /**
+     * Set by encode_to() when hit_callback is used. Receives parsing_failure if one of the hits cannot be decoded, so that
+     * make_response() reports the failure instead of the truncated result.
+     */
+    std::shared_ptr<std::error_code> hit_error{};
 };
 
+/**
+ * Decodes single element of the "hits" array of the search response.
+ *
+ * @throws tao::pegtl::parse_error if the hit is not a valid JSON
+ */
+[[nodiscard]] search_response::search_row
+decode_search_hit(std::string_view hit);
+
 } // namespace couchbase::core::operations
 namespace couchbase::core::io::http_traits
 {
@@ -21,6 +21,7 @@
 
 #include "client_opcode.hxx"
 #include "client_response.hxx"
+#include "compression.hxx"
 #include "core/utils/binary.hxx"
 #include "core/utils/byteswap.hxx"
 #include "magic.hxx"
@@ -33,9 +34,6 @@
 
 namespace couchbase::core::protocol
 {
-std::pair<bool, std::uint32_t>
-compress_value(const std::vector<std::byte>& value, std::vector<std::byte>::iterator& output);
-
 template<typename Body>
 class client_request
 {
@@ -96,28 +94,40 @@ class client_request
         return body_;
     }
 
-    [[nodiscard]] std::vector<std::byte> data(bool try_to_compress = false)
+    /**
+     * @param compression the value is compressed only for the commands, that accept Snappy-compressed documents
+     * @param compression_info if not null, receives the outcome of the compression
+     */
+    [[nodiscard]] std::vector<std::byte> data(const compression_config& compression = {}, compression_result* compression_info = nullptr)
     {
         switch (opcode_) {
             case protocol::client_opcode::insert:
             case protocol::client_opcode::upsert:
             case protocol::client_opcode::replace:
-                return generate_payload(try_to_compress);
+            case protocol::client_opcode::append:
+            case protocol::client_opcode::prepend:
+                return generate_payload(compression, compression_info);
             default:
                 break;
         }
-        return generate_payload(false);
+        return generate_payload({}, compression_info);
     }
 
   private:
-    [[nodiscard]] std::vector<std::byte> generate_payload(bool try_to_compress)
+    [[nodiscard]] std::vector<std::byte> generate_payload(const compression_config& compression, compression_result* compression_info)
     {
         // SA: for some reason GCC 8.5.0 on CentOS 8 sees here null-pointer dereference
 #if defined(__GNUC__) && __GNUC__ == 8
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wnull-dereference"
 #endif
-        std::vector<std::byte> payload(header_size + body_.size(), std::byte{});
+        std::vector<std::byte> payload{};
+        if (compression.enabled) {
+            // leave enough room to compress the value in-place
+            const auto value_size = body_.value().size();
+            payload.reserve(header_size + body_.size() - value_size + max_compressed_size(value_size));
+        }
+        payload.resize(header_size + body_.size());
         payload[0] = static_cast<std::byte>(magic_);
         payload[1] = static_cast<std::byte>(opcode_);
 #if defined(__GNUC__) && __GNUC__ == 8
@@ -157,19 +167,18 @@ class client_request
         body_itr = std::copy(body_.extras().begin(), body_.extras().end(), body_itr);
         body_itr = utils::to_binary(body_.key(), body_itr);
 
-        if (static const std::size_t min_size_to_compress = 32; try_to_compress && body_.value().size() > min_size_to_compress) {
-            if (auto [compressed, new_value_size] = compress_value(body_.value(), body_itr); compressed) {
-                /* the compressed value meets requirements and was copied to the payload */
-                payload[5] |= static_cast<std::byte>(protocol::datatype::snappy);
-                std::uint32_t new_body_size =
-                  utils::byte_swap(body_size) - gsl::narrow_cast<std::uint32_t>(body_.value().size()) + new_value_size;
-                payload.resize(header_size + new_body_size);
-                new_body_size = utils::byte_swap(new_body_size);
-                memcpy(payload.data() + 8, &new_body_size, sizeof(new_body_size));
-                return payload;
-            }
+        const auto& value = body_.value();
+        auto result = write_value(value, compression, payload, static_cast<std::size_t>(std::distance(payload.begin(), body_itr)));
+        if (result.compressed) {
+            /* the compressed value meets requirements and was written to the payload */
+            payload[5] |= static_cast<std::byte>(protocol::datatype::snappy);
+            std::uint32_t new_body_size = gsl::narrow_cast<std::uint32_t>(payload.size() - header_size);
+            new_body_size = utils::byte_swap(new_body_size);
+            memcpy(payload.data() + 8, &new_body_size, sizeof(new_body_size));
+        }
+        if (compression_info != nullptr) {
+            *compression_info = result;
         }
-        std::copy(body_.value().begin(), body_.value().end(), body_itr);
         return payload;
     }
 };
@@ -0,0 +1,125 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "compression.hxx"
+
+#include "third_party/snappy/snappy.h"
+
+#include <atomic>
+#include <cstring>
+
+namespace couchbase::core::protocol
+{
+namespace
+{
+struct compression_counters {
+    std::atomic_uint64_t values_compressed{ 0 };
+    std::atomic_uint64_t values_not_compressed{ 0 };
+    std::atomic_uint64_t bytes_saved{ 0 };
+    std::atomic_uint64_t compression_time_ns{ 0 };
+    std::atomic_uint64_t values_decompressed{ 0 };
+    std::atomic_uint64_t bytes_decompressed{ 0 };
+    std::atomic_uint64_t decompression_time_ns{ 0 };
+};
+
+auto
+counters() -> compression_counters&
+{
+    static compression_counters instance{};
+    return instance;
+}
+} // namespace
+
+auto
+compression_statistics() -> compression_stats
+{
+    const auto& c = counters();
+    return {
+        c.values_compressed.load(std::memory_order_relaxed),
+        c.values_not_compressed.load(std::memory_order_relaxed),
+        c.bytes_saved.load(std::memory_order_relaxed),
+        std::chrono::nanoseconds(c.compression_time_ns.load(std::memory_order_relaxed)),
+        c.values_decompressed.load(std::memory_order_relaxed),
+        c.bytes_decompressed.load(std::memory_order_relaxed),
+        std::chrono::nanoseconds(c.decompression_time_ns.load(std::memory_order_relaxed)),
+    };
+}
+
+auto
+max_compressed_size(std::size_t size) -> std::size_t
+{
+    return snappy::MaxCompressedLength(size);
+}
+
+auto
+write_value(gsl::span<const std::byte> value, const compression_config& config, std::vector<std::byte>& output, std::size_t offset)
+  -> compression_result
+{
+    compression_result result{ false, value.size(), value.size() };
+
+    if (config.enabled && value.size() > config.min_size) {
+        auto start = std::chrono::steady_clock::now();
+        output.resize(offset + snappy::MaxCompressedLength(value.size()));
+        std::size_t compressed_size{ 0 };
+        snappy::RawCompress(reinterpret_cast<const char*>(value.data()),
+                            value.size(),
+                            reinterpret_cast<char*>(output.data() + offset),
+                            &compressed_size);
+        result.duration = std::chrono::steady_clock::now() - start;
+        counters().compression_time_ns.fetch_add(static_cast<std::uint64_t>(result.duration.count()), std::memory_order_relaxed);
+
+        if (static_cast<double>(compressed_size) / static_cast<double>(value.size()) < config.min_ratio) {
+            output.resize(offset + compressed_size);
+            result.compressed = true;
+            result.compressed_size = compressed_size;
+            counters().values_compressed.fetch_add(1, std::memory_order_relaxed);
+            counters().bytes_saved.fetch_add(value.size() - compressed_size, std::memory_order_relaxed);
+            return result;
+        }
+        counters().values_not_compressed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    output.resize(offset + value.size());
+    if (!value.empty()) {
+        std::memcpy(output.data() + offset, value.data(), value.size());
+    }
+    return result;
+}
+
+auto
+decompress_value(gsl::span<const std::byte> compressed, std::vector<std::byte>& output) -> bool
+{
+    auto start = std::chrono::steady_clock::now();
+    const auto* input = reinterpret_cast<const char*>(compressed.data());
+    std::size_t uncompressed_size{ 0 };
+    if (!snappy::GetUncompressedLength(input, compressed.size(), &uncompressed_size)) {
+        return false;
+    }
+    auto offset = output.size();
+    output.resize(offset + uncompressed_size);
+    if (!snappy::RawUncompress(input, compressed.size(), reinterpret_cast<char*>(output.data() + offset))) {
+        output.resize(offset);
+        return false;
+    }
+    auto duration = std::chrono::steady_clock::now() - start;
+    counters().values_decompressed.fetch_add(1, std::memory_order_relaxed);
+    counters().bytes_decompressed.fetch_add(uncompressed_size, std::memory_order_relaxed);
+    counters().decompression_time_ns.fetch_add(
+      static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()), std::memory_order_relaxed);
+    return true;
+}
+} // namespace couchbase::core::protocol
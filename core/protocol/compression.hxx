@@ -0,0 +1,94 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <gsl/span>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace couchbase::core::protocol
+{
+struct compression_config {
+    /**
+     * Whether the server negotiated Snappy compression (and the user did not disable it)
+     */
+    bool enabled{ false };
+
+    /**
+     * Values of this size or smaller are sent as is.
+     */
+    std::size_t min_size{ 32 };
+
+    /**
+     * The compressed value is sent only if compressed_size / original_size is less than this ratio.
+     */
+    double min_ratio{ 0.83 };
+};
+
+struct compression_result {
+    bool compressed{ false };
+    std::size_t original_size{ 0 };
+    std::size_t compressed_size{ 0 };
+
+    /**
+     * CPU time spent on compression, zero if the value has not been considered for compression.
+     */
+    std::chrono::nanoseconds duration{};
+};
+
+/**
+ * Process-wide counters, shared by all connections.
+ */
+struct compression_stats {
+    std::uint64_t values_compressed{ 0 };
+    std::uint64_t values_not_compressed{ 0 };
+    std::uint64_t bytes_saved{ 0 };
+    std::chrono::nanoseconds compression_time{};
+    std::uint64_t values_decompressed{ 0 };
+    std::uint64_t bytes_decompressed{ 0 };
+    std::chrono::nanoseconds decompression_time{};
+};
+
+[[nodiscard]] auto
+compression_statistics() -> compression_stats;
+
+/**
+ * @return the upper bound of the compressed size for the value of the given size
+ */
+[[nodiscard]] auto
+max_compressed_size(std::size_t size) -> std::size_t;
+
+/**
+ * Writes the value into the output buffer at the given offset, compressing it with Snappy straight into the buffer when the config
+ * allows it and the compressed value is small enough. The output is resized to end right after the value.
+ */
+auto
+write_value(gsl::span<const std::byte> value, const compression_config& config, std::vector<std::byte>& output, std::size_t offset)
+  -> compression_result;
+
+/**
+ * Appends the inflated value to the output buffer.
+ *
+ * @return false if the input is not a valid Snappy buffer (the output is left untouched)
+ */
+auto
+decompress_value(gsl::span<const std::byte> compressed, std::vector<std::byte>& output) -> bool;
+} // namespace couchbase::core::protocol
@@ -54,4 +54,16 @@ range_scan_item_body::expiry_time() const -> std::chrono::system_clock::time_poi
 {
     return std::chrono::system_clock::time_point(std::chrono::seconds{ expiry });
 }
+
+auto
+range_scan_item_view::to_item() const -> range_scan_item
+{
+    range_scan_item item{ { key.begin(), key.end() } };
+    if (body) {
+        item.body = range_scan_item_body{
+            body->flags, body->expiry, body->cas, body->sequence_number, body->datatype, { body->value.begin(), body->value.end() },
+        };
+    }
+    return item;
+}
 } // namespace couchbase::core
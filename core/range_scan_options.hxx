@@ -19,6 +19,8 @@
 #include "couchbase/retry_strategy.hxx"
 #include "utils/movable_function.hxx"
 
+#include <gsl/span>
+
 #include <cinttypes>
 #include <memory>
 #include <optional>
@@ -132,6 +134,31 @@ struct range_scan_item {
 
 using range_scan_item_callback = utils::movable_function<void(range_scan_item item)>;
 
+struct range_scan_item_body_view {
+    std::uint32_t flags{};
+    std::uint32_t expiry{};
+    couchbase::cas cas{};
+    std::uint64_t sequence_number{};
+    std::byte datatype{};
+    gsl::span<const std::byte> value{};
+};
+
+/**
+ * Non-owning representation of the item, that refers to the response buffer (or to the decompression buffer of the parser), and valid
+ * only until the callback returns.
+ */
+struct range_scan_item_view {
+    gsl::span<const std::byte> key{};
+    std::optional<range_scan_item_body_view> body{};
+
+    /**
+     * Copies the item, so that it could outlive the response.
+     */
+    [[nodiscard]] auto to_item() const -> range_scan_item;
+};
+
+using range_scan_item_view_callback = utils::movable_function<void(const range_scan_item_view& item)>;
+
 struct range_scan_cancel_result {
 };
 
@@ -215,9 +215,11 @@ class range_scan_stream : public std::enable_shared_from_this<range_scan_stream>
           uuid(),
           vbucket_id_,
           continue_options_,
-          [self = shared_from_this()](auto item) {
-              self->last_seen_key_ = item.key;
-              self->items_.async_send({}, std::move(item), [self](std::error_code ec) {
+          [self = shared_from_this()](const range_scan_item_view& item) {
+              // reuses the capacity of the previous key
+              self->last_seen_key_.assign(item.key.begin(), item.key.end());
+              // the items are queued until the application consumes them, so only here they are copied out of the response
+              self->items_.async_send({}, item.to_item(), [self](std::error_code ec) {
                   if (ec) {
                       self->fail(ec);
                   }
@@ -42,4 +42,7 @@ constexpr std::chrono::milliseconds config_poll_interval{ 2'500 };
 constexpr std::chrono::milliseconds config_poll_floor{ 50 };
 constexpr std::chrono::milliseconds config_idle_redial_timeout{ 5 * 60'000 };
 constexpr std::chrono::milliseconds idle_http_connection_timeout{ 4'500 };
+constexpr std::chrono::milliseconds dns_cache_ttl{ 60'000 };
+constexpr std::chrono::milliseconds dns_negative_cache_ttl{ 1'000 };
+constexpr std::chrono::milliseconds connection_attempt_delay{ 250 };
 } // namespace couchbase::core::timeout_defaults
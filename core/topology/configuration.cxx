@@ -219,7 +219,7 @@ configuration::index_for_this_node() const
 }
 
 std::optional<std::size_t>
-configuration::server_by_vbucket(std::uint16_t vbucket, std::size_t index)
+configuration::server_by_vbucket(std::uint16_t vbucket, std::size_t index) const
 {
     if (!vbmap.has_value() || vbucket >= vbmap->size()) {
         return {};
@@ -127,7 +127,7 @@ struct configuration {
                                 const std::string& port) const;
 
     template<typename Key>
-    std::pair<std::uint16_t, std::optional<std::size_t>> map_key(const Key& key, std::size_t index)
+    std::pair<std::uint16_t, std::optional<std::size_t>> map_key(const Key& key, std::size_t index) const
     {
         if (!vbmap.has_value()) {
             return { 0, {} };
@@ -137,7 +137,7 @@ struct configuration {
         return { vbucket, server_by_vbucket(vbucket, index) };
     }
 
-    std::optional<std::size_t> server_by_vbucket(std::uint16_t vbucket, std::size_t index);
+    std::optional<std::size_t> server_by_vbucket(std::uint16_t vbucket, std::size_t index) const;
 };
 
 configuration
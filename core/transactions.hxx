@@ -27,10 +27,14 @@
 
 #include "core/logger/logger.hxx"
 
+#include <asio/thread_pool.hpp>
 #include <spdlog/common.h>
 
 #include <cmath>
 #include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <thread>
 
 // workaround for MSVC define overlap with log levels
@@ -244,12 +248,41 @@ class transactions : public couchbase::transactions::transactions
         return cluster_;
     }
 
+    /**
+     * @internal
+     * Executor, which runs the blocking parts of the asynchronous transactions (the logic, commit and rollback). The pool is created
+     * on the first use, and the number of its threads is bounded by transactions_config::async_executor_threads(), so the transactions
+     * above that limit are queued instead of spawning new threads.
+     */
+    [[nodiscard]] asio::thread_pool::executor_type executor();
+
+    /**
+     * @internal
+     * Registers asynchronous transaction, that has not completed yet. When the object is destroyed before the transaction completes,
+     * the transaction is failed through the given function, so that its callback is always called.
+     *
+     * @return identifier for remove_pending_async_run()
+     */
+    std::uint64_t add_pending_async_run(std::function<void()>&& fail);
+
+    /**
+     * @internal
+     */
+    void remove_pending_async_run(std::uint64_t id);
+
   private:
+    void fail_pending_async_runs();
+
     std::shared_ptr<core::cluster> cluster_;
     couchbase::transactions::transactions_config::built config_;
     std::unique_ptr<transactions_cleanup> cleanup_;
     const std::size_t max_attempts_{ 1000 };
     const std::chrono::milliseconds min_retry_delay_{ 1 };
+    std::mutex executor_mutex_{};
+    std::unique_ptr<asio::thread_pool> executor_{};
+    std::mutex pending_async_runs_mutex_{};
+    std::uint64_t next_pending_async_run_id_{ 0 };
+    std::map<std::uint64_t, std::function<void()>> pending_async_runs_{};
 };
 } // namespace transactions
 } // namespace couchbase::core
\ No newline at end of file
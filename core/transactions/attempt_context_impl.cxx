@@ -28,6 +28,8 @@
 #include "internal/logging.hxx"
 #include "internal/utils.hxx"
 
+#include <asio/dispatch.hpp>
+
 namespace couchbase::core::transactions
 {
 
@@ -1581,8 +1583,8 @@ attempt_context_impl::atr_complete()
 void
 attempt_context_impl::commit(VoidCallback&& cb)
 {
-    // for now, lets keep the blocking implementation
-    std::thread([cb = std::move(cb), this]() mutable {
+    // for now, lets keep the blocking implementation, but run it on the transactions executor (inline, when already there)
+    asio::dispatch(overall_.executor(), [cb = std::move(cb), this]() mutable {
         try {
             commit();
             return cb({});
@@ -1591,7 +1593,7 @@ attempt_context_impl::commit(VoidCallback&& cb)
         } catch (const std::exception& e) {
             return cb(std::make_exception_ptr(transaction_operation_failed(FAIL_OTHER, e.what())));
         }
-    }).detach();
+    });
 }
 
 void
@@ -1760,8 +1762,8 @@ attempt_context_impl::atr_rollback_complete()
 void
 attempt_context_impl::rollback(VoidCallback&& cb)
 {
-    // for now, lets keep the blocking implementation
-    std::thread([cb = std::move(cb), this]() mutable {
+    // for now, lets keep the blocking implementation, but run it on the transactions executor (inline, when already there)
+    asio::dispatch(overall_.executor(), [cb = std::move(cb), this]() mutable {
         if (op_list_.get_mode().is_query()) {
             return rollback_with_query(std::move(cb));
         }
@@ -1775,7 +1777,7 @@ attempt_context_impl::rollback(VoidCallback&& cb)
         } catch (...) {
             return cb(std::make_exception_ptr(transaction_operation_failed(FAIL_OTHER, "unexpected exception during rollback")));
         }
-    }).detach();
+    });
 }
 
 void
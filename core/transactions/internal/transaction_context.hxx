@@ -77,6 +77,11 @@ class transaction_context
         return transactions_.cluster_ref();
     }
 
+    [[nodiscard]] asio::thread_pool::executor_type executor()
+    {
+        return transactions_.executor();
+    }
+
     const couchbase::transactions::transactions_config::built& config() const
     {
         return config_;
@@ -21,8 +21,17 @@
 #include "couchbase/transactions/transactions_config.hxx"
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <functional>
+#include <list>
 #include <thread>
+#include <vector>
+
+namespace asio
+{
+class thread_pool;
+} // namespace asio
 
 namespace couchbase::core
 {
@@ -84,6 +93,21 @@ struct atr_cleanup_stats {
     }
 };
 
+struct lost_attempts_cleanup_stats {
+    couchbase::transactions::transaction_keyspace keyspace;
+    // ATRs assigned to this client in the current pass
+    std::size_t atrs_in_pass{ 0 };
+    // ATRs of the current pass, which have not been examined yet
+    std::size_t atrs_backlog{ 0 };
+    std::size_t atrs_checked{ 0 };
+    std::size_t atrs_failed{ 0 };
+    std::size_t entries_found{ 0 };
+    std::size_t passes_completed{ 0 };
+    // throughput of the last completed pass
+    double atrs_per_second{ 0 };
+    std::chrono::milliseconds last_pass_duration{};
+};
+
 class transactions_cleanup
 {
   public:
@@ -125,6 +149,7 @@ class transactions_cleanup
     void force_cleanup_entry(atr_cleanup_entry& entry, transactions_cleanup_attempt& attempt);
     // only used for testing
     const atr_cleanup_stats force_cleanup_atr(const core::document_id& atr_id, std::vector<transactions_cleanup_attempt>& results);
+    std::vector<lost_attempts_cleanup_stats> lost_attempts_stats() const;
     const client_record_details get_active_clients(const couchbase::transactions::transaction_keyspace& keyspace, const std::string& uuid);
     void remove_client_record_from_all_buckets(const std::string& uuid);
     void close();
@@ -142,6 +167,8 @@ class transactions_cleanup
 
     const std::string client_uuid_;
     std::list<couchbase::transactions::transaction_keyspace> collections_;
+    mutable std::mutex stats_mutex_;
+    std::list<lost_attempts_cleanup_stats> lost_attempts_stats_;
 
     void attempts_loop();
 
@@ -156,6 +183,11 @@ class transactions_cleanup
 
     void lost_attempts_loop();
     void clean_collection(const couchbase::transactions::transaction_keyspace& keyspace);
+    bool clean_atrs(const couchbase::transactions::transaction_keyspace& keyspace,
+                    const std::vector<std::string>& atrs,
+                    asio::thread_pool* workers);
+    void update_lost_attempts_stats(const couchbase::transactions::transaction_keyspace& keyspace,
+                                    const std::function<void(lost_attempts_cleanup_stats&)>& update);
     void create_client_record(const couchbase::transactions::transaction_keyspace& keyspace);
     const atr_cleanup_stats handle_atr_cleanup(const core::document_id& atr_id,
                                                std::vector<transactions_cleanup_attempt>* result = nullptr);
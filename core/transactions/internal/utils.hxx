@@ -85,6 +85,12 @@ wrap_durable_request(T&& req, const couchbase::transactions::transactions_config
 result
 wrap_operation_future(std::future<result>& fut, bool ignore_subdoc_errors = true);
 
+/**
+ * Same as wrap_operation_future(), but for the result, that has been already received.
+ */
+result
+wrap_operation_result(result res, bool ignore_subdoc_errors = true);
+
 inline void
 wrap_collection_call(result& res, std::function<void(result&)> call);
 
@@ -22,9 +22,28 @@
 #include "internal/utils.hxx"
 #include "result.hxx"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <vector>
+
 namespace couchbase::core::transactions
 {
 
+std::string
+staged_mutation_queue::index_key(const core::document_id& id)
+{
+    // bucket, scope and collection names cannot contain '/', so the key of the document is the only part that might
+    std::string key;
+    key.reserve(id.bucket().size() + id.scope().size() + id.collection().size() + id.key().size() + 3);
+    key.append(id.bucket()).append(1, '/').append(id.scope()).append(1, '/').append(id.collection()).append(1, '/').append(id.key());
+    return key;
+}
+
 bool
 staged_mutation_queue::empty()
 {
@@ -37,11 +56,12 @@ staged_mutation_queue::add(const staged_mutation& mutation)
 {
     std::lock_guard<std::mutex> lock(mutex_);
     // Can only have one staged mutation per document.
-    queue_.erase(std::remove_if(queue_.begin(),
-                                queue_.end(),
-                                [&mutation](const staged_mutation& item) { return document_ids_equal(item.id(), mutation.id()); }),
-                 queue_.end());
-    queue_.push_back(mutation);
+    auto key = index_key(mutation.id());
+    auto pos = queue_.insert(queue_.end(), mutation);
+    if (auto [it, inserted] = index_.try_emplace(std::move(key), pos); !inserted) {
+        queue_.erase(it->second);
+        it->second = pos;
+    }
 }
 
 void
@@ -52,6 +72,16 @@ staged_mutation_queue::extract_to(const std::string& prefix, core::operations::m
     tao::json::value replaces = tao::json::empty_array;
     tao::json::value removes = tao::json::empty_array;
 
+    std::size_t number_of_inserts{ 0 };
+    std::size_t number_of_removes{ 0 };
+    for (const auto& mutation : queue_) {
+        number_of_inserts += mutation.type() == staged_mutation_type::INSERT ? 1 : 0;
+        number_of_removes += mutation.type() == staged_mutation_type::REMOVE ? 1 : 0;
+    }
+    inserts.get_array().reserve(number_of_inserts);
+    removes.get_array().reserve(number_of_removes);
+    replaces.get_array().reserve(queue_.size() - number_of_inserts - number_of_removes);
+
     for (const auto& mutation : queue_) {
         tao::json::value doc{ { ATR_FIELD_PER_DOC_ID, mutation.doc().id().key() },
                               { ATR_FIELD_PER_DOC_BUCKET, mutation.doc().id().bucket() },
@@ -59,13 +89,13 @@ staged_mutation_queue::extract_to(const std::string& prefix, core::operations::m
                               { ATR_FIELD_PER_DOC_COLLECTION, mutation.doc().id().collection() } };
         switch (mutation.type()) {
             case staged_mutation_type::INSERT:
-                inserts.push_back(doc);
+                inserts.push_back(std::move(doc));
                 break;
             case staged_mutation_type::REMOVE:
-                removes.push_back(doc);
+                removes.push_back(std::move(doc));
                 break;
             case staged_mutation_type::REPLACE:
-                replaces.push_back(doc);
+                replaces.push_back(std::move(doc));
                 break;
         }
     }
@@ -89,58 +119,47 @@ void
 staged_mutation_queue::remove_any(const core::document_id& id)
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto new_end =
-      std::remove_if(queue_.begin(), queue_.end(), [id](const staged_mutation& item) { return document_ids_equal(item.id(), id); });
-    queue_.erase(new_end, queue_.end());
+    if (auto it = index_.find(index_key(id)); it != index_.end()) {
+        queue_.erase(it->second);
+        index_.erase(it);
+    }
 }
 
 staged_mutation*
-staged_mutation_queue::find_any(const core::document_id& id)
+staged_mutation_queue::find(const core::document_id& id, std::optional<staged_mutation_type> type)
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    for (auto& item : queue_) {
-        if (document_ids_equal(item.doc().id(), id)) {
-            return &item;
-        }
+    auto it = index_.find(index_key(id));
+    if (it == index_.end() || (type.has_value() && it->second->type() != type.value())) {
+        return nullptr;
     }
-    return nullptr;
+    return &*it->second;
+}
+
+staged_mutation*
+staged_mutation_queue::find_any(const core::document_id& id)
+{
+    return find(id, std::nullopt);
 }
 
 staged_mutation*
 staged_mutation_queue::find_replace(const core::document_id& id)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (auto& item : queue_) {
-        if (item.type() == staged_mutation_type::REPLACE && document_ids_equal(item.doc().id(), id)) {
-            return &item;
-        }
-    }
-    return nullptr;
+    return find(id, staged_mutation_type::REPLACE);
 }
 
 staged_mutation*
 staged_mutation_queue::find_insert(const core::document_id& id)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (auto& item : queue_) {
-        if (item.type() == staged_mutation_type::INSERT && document_ids_equal(item.doc().id(), id)) {
-            return &item;
-        }
-    }
-    return nullptr;
+    return find(id, staged_mutation_type::INSERT);
 }
 
 staged_mutation*
 staged_mutation_queue::find_remove(const core::document_id& id)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (auto& item : queue_) {
-        if (item.type() == staged_mutation_type::REMOVE && document_ids_equal(item.doc().id(), id)) {
-            return &item;
-        }
-    }
-    return nullptr;
+    return find(id, staged_mutation_type::REMOVE);
 }
+
 void
 staged_mutation_queue::iterate(std::function<void(staged_mutation&)> op)
 {
@@ -150,43 +169,383 @@ staged_mutation_queue::iterate(std::function<void(staged_mutation&)> op)
     }
 }
 
-void
-staged_mutation_queue::commit(attempt_context_impl* ctx)
+/**
+ * Bounded window of the documents being unstaged. The window is driven by the thread that commits or rolls back the attempt: it starts
+ * the operations, and runs their continuations, while the KV requests are dispatched asynchronously and their completions are only
+ * queued here. As a result the hooks and the error handling of the attempt never run concurrently, and no threads are created.
+ */
+class unstaging_window
 {
-    CB_ATTEMPT_CTX_LOG_TRACE(ctx, "staged mutations committing...");
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (auto& item : queue_) {
-        switch (item.type()) {
-            case staged_mutation_type::REMOVE:
-                remove_doc(ctx, item);
-                break;
-            case staged_mutation_type::INSERT:
-            case staged_mutation_type::REPLACE:
-                commit_doc(ctx, item);
+  public:
+    using task = std::function<void()>;
+
+    explicit unstaging_window(std::size_t max_in_flight)
+      : max_in_flight_{ std::max<std::size_t>(max_in_flight, 1) }
+    {
+    }
+
+    /**
+     * Might be called from any thread.
+     */
+    void post(task&& t, std::chrono::nanoseconds delay = {})
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back({ std::chrono::steady_clock::now() + delay, std::move(t) });
+        }
+        cv_.notify_one();
+    }
+
+    /**
+     * Must be called on the driving thread exactly once for every started operation.
+     */
+    void finish(std::exception_ptr error)
+    {
+        --in_flight_;
+        if (error && !first_error_) {
+            first_error_ = std::move(error);
+        }
+    }
+
+    /**
+     * Starts operation for every index in [0, number_of_items), but keeps at most max_in_flight of them running. After the first failure
+     * the remaining operations are not started, but those in flight are allowed to complete. Rethrows the first failure.
+     */
+    void run(std::size_t number_of_items, const std::function<void(std::size_t)>& start)
+    {
+        std::size_t next_index{ 0 };
+        while (true) {
+            while (!first_error_ && in_flight_ < max_in_flight_ && next_index < number_of_items) {
+                ++in_flight_;
+                start(next_index++);
+            }
+            if (in_flight_ == 0) {
                 break;
+            }
+            next_task()();
+        }
+        if (first_error_) {
+            std::rethrow_exception(first_error_);
+        }
+    }
+
+  private:
+    struct scheduled_task {
+        std::chrono::steady_clock::time_point not_before;
+        task fn;
+    };
+
+    auto next_task() -> task
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            auto earliest = std::min_element(tasks_.begin(), tasks_.end(), [](const auto& lhs, const auto& rhs) {
+                return lhs.not_before < rhs.not_before;
+            });
+            if (earliest == tasks_.end()) {
+                cv_.wait(lock);
+            } else if (earliest->not_before > std::chrono::steady_clock::now()) {
+                cv_.wait_until(lock, earliest->not_before);
+            } else {
+                auto fn = std::move(earliest->fn);
+                tasks_.erase(earliest);
+                return fn;
+            }
+        }
+    }
+
+    const std::size_t max_in_flight_;
+    std::size_t in_flight_{ 0 };
+    std::exception_ptr first_error_{};
+    std::mutex mutex_{};
+    std::condition_variable cv_{};
+    std::vector<scheduled_task> tasks_{};
+};
+
+/**
+ * Unstaging of the single document. The attempt is invoked again when it throws retry_operation, either with constant delay like
+ * retry_op(), or with exponential backoff and limited number of retries like retry_op_exp().
+ */
+class unstaging_operation : public std::enable_shared_from_this<unstaging_operation>
+{
+  public:
+    enum class retry_policy {
+        constant_delay,
+        exponential_backoff,
+    };
+
+    using attempt_function = std::function<void(const std::shared_ptr<unstaging_operation>&)>;
+
+    unstaging_operation(std::shared_ptr<unstaging_window> window, retry_policy policy, attempt_function attempt)
+      : window_{ std::move(window) }
+      , policy_{ policy }
+      , attempt_{ std::move(attempt) }
+    {
+    }
+
+    void start()
+    {
+        run([self = shared_from_this()]() { self->attempt_(self); });
+    }
+
+    /**
+     * Dispatches the request, and passes its result to the continuation on the driving thread.
+     */
+    template<typename Request, typename Continuation>
+    void execute(const std::shared_ptr<core::cluster>& cluster, Request request, Continuation&& next)
+    {
+        using response_type = typename Request::response_type;
+        cluster->execute(
+          std::move(request), [self = shared_from_this(), next = std::forward<Continuation>(next)](response_type resp) mutable {
+              auto res = to_result(resp);
+              self->window_->post([self, next = std::move(next), res = std::move(res)]() mutable {
+                  self->run([&next, &res]() { next(std::move(res)); });
+              });
+          });
+    }
+
+    void done()
+    {
+        window_->finish({});
+    }
+
+  private:
+    static auto to_result(const core::operations::mutate_in_response& resp) -> result
+    {
+        return result::create_from_subdoc_response(resp);
+    }
+
+    template<typename Response>
+    static auto to_result(const Response& resp) -> result
+    {
+        return result::create_from_mutation_response(resp);
+    }
+
+    template<typename Step>
+    void run(Step&& step)
+    {
+        try {
+            step();
+        } catch (const retry_operation&) {
+            retry();
+        } catch (...) {
+            window_->finish(std::current_exception());
         }
     }
+
+    void retry()
+    {
+        std::chrono::nanoseconds delay = DEFAULT_RETRY_OP_DELAY;
+        if (policy_ == retry_policy::exponential_backoff) {
+            if (retries_ >= DEFAULT_RETRY_OP_MAX_RETRIES) {
+                return window_->finish(std::make_exception_ptr(retry_operation_retries_exhausted("retry_op hit max retries!")));
+            }
+            delay = std::chrono::duration_cast<std::chrono::nanoseconds>(
+              DEFAULT_RETRY_OP_EXP_DELAY *
+              (jitter() * std::pow(2, std::fmin(DEFAULT_RETRY_OP_EXPONENT_CAP, static_cast<double>(retries_)))));
+        }
+        ++retries_;
+        window_->post([self = shared_from_this()]() { self->start(); }, delay);
+    }
+
+    std::shared_ptr<unstaging_window> window_;
+    retry_policy policy_;
+    attempt_function attempt_;
+    std::size_t retries_{ 0 };
+};
+
+namespace
+{
+/**
+ * Unstages every document of the queue, with at most max_in_flight_mutations documents at a time. The caller must hold the lock of the
+ * queue, and the items are referenced by the continuations until all operations complete.
+ */
+void
+unstage_concurrently(std::list<staged_mutation>& queue,
+                     unstaging_operation::retry_policy policy,
+                     const std::function<unstaging_operation::attempt_function(staged_mutation&)>& make_attempt)
+{
+    std::vector<staged_mutation*> items{};
+    items.reserve(queue.size());
+    for (auto& item : queue) {
+        items.push_back(&item);
+    }
+
+    auto window = std::make_shared<unstaging_window>(staged_mutation_queue::max_in_flight_mutations);
+    window->run(items.size(), [&window, &items, &make_attempt, policy](std::size_t index) {
+        std::make_shared<unstaging_operation>(window, policy, make_attempt(*items[index]))->start();
+    });
 }
 
+} // namespace
+
+struct commit_doc_mode {
+    bool ambiguity_resolution{ false };
+    bool cas_zero{ false };
+};
+
 void
-staged_mutation_queue::rollback(attempt_context_impl* ctx)
+staged_mutation_queue::handle_commit_doc_error(attempt_context_impl* ctx, const client_error& e, commit_doc_mode& mode)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (auto& item : queue_) {
-        switch (item.type()) {
-            case staged_mutation_type::INSERT:
-                retry_op_exp<void>([&]() { rollback_insert(ctx, item); });
-                break;
-            case staged_mutation_type::REMOVE:
-            case staged_mutation_type::REPLACE:
-                retry_op_exp<void>([&]() { rollback_remove_or_replace(ctx, item); });
-                break;
+    error_class ec = e.ec();
+    if (ctx->expiry_overtime_mode_.load()) {
+        throw transaction_operation_failed(FAIL_EXPIRY, "expired during commit").no_rollback().failed_post_commit();
+    }
+    switch (ec) {
+        case FAIL_AMBIGUOUS:
+            mode.ambiguity_resolution = true;
+            throw retry_operation("FAIL_AMBIGUOUS in commit_doc");
+        case FAIL_CAS_MISMATCH:
+        case FAIL_DOC_ALREADY_EXISTS:
+            if (mode.ambiguity_resolution) {
+                throw transaction_operation_failed(ec, e.what()).no_rollback().failed_post_commit();
+            }
+            mode.ambiguity_resolution = true;
+            mode.cas_zero = true;
+            throw retry_operation("FAIL_DOC_ALREADY_EXISTS in commit_doc");
+        default:
+            throw transaction_operation_failed(ec, e.what()).no_rollback().failed_post_commit();
+    }
+}
+
+void
+staged_mutation_queue::commit_doc(attempt_context_impl* ctx,
+                                  staged_mutation& item,
+                                  const std::shared_ptr<unstaging_operation>& op,
+                                  const std::shared_ptr<commit_doc_mode>& mode)
+{
+    CB_ATTEMPT_CTX_LOG_TRACE(
+      ctx, "commit doc {}, cas_zero_mode {}, ambiguity_resolution_mode {}", item.doc().id(), mode->cas_zero, mode->ambiguity_resolution);
+    try {
+        ctx->check_expiry_during_commit_or_rollback(STAGE_COMMIT_DOC, std::optional<const std::string>(item.doc().id().key()));
+        auto ec = ctx->hooks_.before_doc_committed(ctx, item.doc().id().key());
+        if (ec) {
+            throw client_error(*ec, "before_doc_committed hook threw error");
         }
+
+        // move staged content into doc
+        CB_ATTEMPT_CTX_LOG_TRACE(
+          ctx, "commit doc id {}, content {}, cas {}", item.doc().id(), to_string(item.content()), item.doc().cas().value());
+
+        auto on_result = [ctx, &item, op, mode](result&& raw) {
+            try {
+                auto res = wrap_operation_result(std::move(raw));
+                CB_ATTEMPT_CTX_LOG_TRACE(ctx, "commit doc result {}", res);
+                // TODO: mutation tokens
+                auto ec = ctx->hooks_.after_doc_committed_before_saving_cas(ctx, item.doc().id().key());
+                if (ec) {
+                    throw client_error(*ec, "after_doc_committed_before_saving_cas threw error");
+                }
+                item.doc().cas(res.cas);
+                ec = ctx->hooks_.after_doc_committed(ctx, item.doc().id().key());
+                if (ec) {
+                    throw client_error(*ec, "after_doc_committed threw error");
+                }
+                op->done();
+            } catch (const client_error& e) {
+                handle_commit_doc_error(ctx, e, *mode);
+            }
+        };
+        if (item.type() == staged_mutation_type::INSERT && !mode->cas_zero) {
+            core::operations::insert_request req{ item.doc().id(), item.content() };
+            req.flags = couchbase::codec::codec_flags::json_common_flags;
+            wrap_durable_request(req, ctx->overall_.config());
+            return op->execute(ctx->cluster_ref(), std::move(req), std::move(on_result));
+        }
+        core::operations::mutate_in_request req{ item.doc().id() };
+        req.specs =
+          couchbase::mutate_in_specs{
+              couchbase::mutate_in_specs::remove(TRANSACTION_INTERFACE_PREFIX_ONLY).xattr(),
+              // subdoc::opcode::set_doc used in replace w/ empty path
+              couchbase::mutate_in_specs::replace_raw("", item.content()),
+          }
+            .specs();
+        req.store_semantics = couchbase::store_semantics::replace;
+        req.cas = couchbase::cas(mode->cas_zero ? 0 : item.doc().cas().value());
+        wrap_durable_request(req, ctx->overall_.config());
+        return op->execute(ctx->cluster_ref(), std::move(req), std::move(on_result));
+    } catch (const client_error& e) {
+        handle_commit_doc_error(ctx, e, *mode);
+    }
+}
+
+void
+staged_mutation_queue::handle_remove_doc_error(attempt_context_impl* ctx, const client_error& e)
+{
+    error_class ec = e.ec();
+    if (ctx->expiry_overtime_mode_.load()) {
+        throw transaction_operation_failed(ec, e.what()).no_rollback().failed_post_commit();
+    }
+    switch (ec) {
+        case FAIL_AMBIGUOUS:
+            throw retry_operation("remove_doc got FAIL_AMBIGUOUS");
+        default:
+            throw transaction_operation_failed(ec, e.what()).no_rollback().failed_post_commit();
     }
 }
 
 void
-staged_mutation_queue::rollback_insert(attempt_context_impl* ctx, const staged_mutation& item)
+staged_mutation_queue::remove_doc(attempt_context_impl* ctx, const staged_mutation& item, const std::shared_ptr<unstaging_operation>& op)
+{
+    try {
+        ctx->check_expiry_during_commit_or_rollback(STAGE_REMOVE_DOC, std::optional<const std::string>(item.doc().id().key()));
+        auto ec = ctx->hooks_.before_doc_removed(ctx, item.doc().id().key());
+        if (ec) {
+            throw client_error(*ec, "before_doc_removed hook threw error");
+        }
+        core::operations::remove_request req{ item.doc().id() };
+        wrap_durable_request(req, ctx->overall_.config());
+        op->execute(ctx->cluster_ref(), std::move(req), [ctx, &item, op](result&& raw) {
+            try {
+                wrap_operation_result(std::move(raw));
+                auto ec = ctx->hooks_.after_doc_removed_pre_retry(ctx, item.doc().id().key());
+                if (ec) {
+                    throw client_error(*ec, "after_doc_removed_pre_retry threw error");
+                }
+                op->done();
+            } catch (const client_error& e) {
+                handle_remove_doc_error(ctx, e);
+            }
+        });
+    } catch (const client_error& e) {
+        handle_remove_doc_error(ctx, e);
+    }
+}
+
+void
+staged_mutation_queue::handle_rollback_insert_error(attempt_context_impl* ctx,
+                                                    const staged_mutation& item,
+                                                    const std::shared_ptr<unstaging_operation>& op,
+                                                    const client_error& e)
+{
+    auto ec = e.ec();
+    if (ctx->expiry_overtime_mode_.load()) {
+        CB_ATTEMPT_CTX_LOG_TRACE(ctx, "rollback_insert for {} error while in overtime mode {}", item.doc().id(), e.what());
+        throw transaction_operation_failed(FAIL_EXPIRY, std::string("expired while rolling back insert with {} ") + e.what())
+          .no_rollback()
+          .expired();
+    }
+    switch (ec) {
+        case FAIL_HARD:
+        case FAIL_CAS_MISMATCH:
+            throw transaction_operation_failed(ec, e.what()).no_rollback();
+        case FAIL_EXPIRY:
+            ctx->expiry_overtime_mode_ = true;
+            CB_ATTEMPT_CTX_LOG_TRACE(ctx, "rollback_insert in expiry overtime mode, retrying...");
+            throw retry_operation("retry rollback_insert");
+        case FAIL_DOC_NOT_FOUND:
+        case FAIL_PATH_NOT_FOUND:
+            // already cleaned up?
+            return op->done();
+        default:
+            throw retry_operation("retry rollback insert");
+    }
+}
+
+void
+staged_mutation_queue::rollback_insert(attempt_context_impl* ctx,
+                                       const staged_mutation& item,
+                                       const std::shared_ptr<unstaging_operation>& op)
 {
     try {
         CB_ATTEMPT_CTX_LOG_TRACE(ctx, "rolling back staged insert for {} with cas {}", item.doc().id(), item.doc().cas().value());
@@ -207,44 +566,54 @@ staged_mutation_queue::rollback_insert(attempt_context_impl* ctx, const staged_m
         req.access_deleted = true;
         req.cas = item.doc().cas();
         wrap_durable_request(req, ctx->overall_.config());
-        auto barrier = std::make_shared<std::promise<result>>();
-        auto f = barrier->get_future();
-        ctx->cluster_ref()->execute(
-          req, [barrier](core::operations::mutate_in_response resp) { barrier->set_value(result::create_from_subdoc_response(resp)); });
-        auto res = wrap_operation_future(f);
-        CB_ATTEMPT_CTX_LOG_TRACE(ctx, "rollback result {}", res);
-        ec = ctx->hooks_.after_rollback_delete_inserted(ctx, item.doc().id().key());
-        if (ec) {
-            throw client_error(*ec, "after_rollback_delete_insert hook threw error");
-        }
+        op->execute(ctx->cluster_ref(), std::move(req), [ctx, &item, op](result&& raw) {
+            try {
+                auto res = wrap_operation_result(std::move(raw));
+                CB_ATTEMPT_CTX_LOG_TRACE(ctx, "rollback result {}", res);
+                auto ec = ctx->hooks_.after_rollback_delete_inserted(ctx, item.doc().id().key());
+                if (ec) {
+                    throw client_error(*ec, "after_rollback_delete_insert hook threw error");
+                }
+                op->done();
+            } catch (const client_error& e) {
+                handle_rollback_insert_error(ctx, item, op, e);
+            }
+        });
     } catch (const client_error& e) {
-        auto ec = e.ec();
-        if (ctx->expiry_overtime_mode_.load()) {
-            CB_ATTEMPT_CTX_LOG_TRACE(ctx, "rollback_insert for {} error while in overtime mode {}", item.doc().id(), e.what());
-            throw transaction_operation_failed(FAIL_EXPIRY, std::string("expired while rolling back insert with {} ") + e.what())
-              .no_rollback()
-              .expired();
-        }
-        switch (ec) {
-            case FAIL_HARD:
-            case FAIL_CAS_MISMATCH:
-                throw transaction_operation_failed(ec, e.what()).no_rollback();
-            case FAIL_EXPIRY:
-                ctx->expiry_overtime_mode_ = true;
-                CB_ATTEMPT_CTX_LOG_TRACE(ctx, "rollback_insert in expiry overtime mode, retrying...");
-                throw retry_operation("retry rollback_insert");
-            case FAIL_DOC_NOT_FOUND:
-            case FAIL_PATH_NOT_FOUND:
-                // already cleaned up?
-                return;
-            default:
-                throw retry_operation("retry rollback insert");
-        }
+        handle_rollback_insert_error(ctx, item, op, e);
     }
 }
 
 void
-staged_mutation_queue::rollback_remove_or_replace(attempt_context_impl* ctx, const staged_mutation& item)
+staged_mutation_queue::handle_rollback_remove_or_replace_error(attempt_context_impl* ctx,
+                                                               const std::shared_ptr<unstaging_operation>& op,
+                                                               const client_error& e)
+{
+    auto ec = e.ec();
+    if (ctx->expiry_overtime_mode_.load()) {
+        throw transaction_operation_failed(FAIL_EXPIRY, std::string("expired while handling ") + e.what()).no_rollback();
+    }
+    switch (ec) {
+        case FAIL_HARD:
+        case FAIL_DOC_NOT_FOUND:
+        case FAIL_CAS_MISMATCH:
+            throw transaction_operation_failed(ec, e.what()).no_rollback();
+        case FAIL_EXPIRY:
+            ctx->expiry_overtime_mode_ = true;
+            CB_ATTEMPT_CTX_LOG_TRACE(ctx, "setting expiry overtime mode in {}", STAGE_ROLLBACK_DOC);
+            throw retry_operation("retry rollback_remove_or_replace");
+        case FAIL_PATH_NOT_FOUND:
+            // already cleaned up?
+            return op->done();
+        default:
+            throw retry_operation("retry rollback_remove_or_replace");
+    }
+}
+
+void
+staged_mutation_queue::rollback_remove_or_replace(attempt_context_impl* ctx,
+                                                  const staged_mutation& item,
+                                                  const std::shared_ptr<unstaging_operation>& op)
 {
     try {
         CB_ATTEMPT_CTX_LOG_TRACE(ctx, "rolling back staged remove/replace for {} with cas {}", item.doc().id(), item.doc().cas().value());
@@ -264,153 +633,63 @@ staged_mutation_queue::rollback_remove_or_replace(attempt_context_impl* ctx, con
             .specs();
         req.cas = item.doc().cas();
         wrap_durable_request(req, ctx->overall_.config());
-        auto barrier = std::make_shared<std::promise<result>>();
-        auto f = barrier->get_future();
-        ctx->cluster_ref()->execute(
-          req, [barrier](core::operations::mutate_in_response resp) { barrier->set_value(result::create_from_subdoc_response(resp)); });
-        auto res = wrap_operation_future(f);
-        CB_ATTEMPT_CTX_LOG_TRACE(ctx, "rollback result {}", res);
-        ec = ctx->hooks_.after_rollback_replace_or_remove(ctx, item.doc().id().key());
-        if (ec) {
-            throw client_error(*ec, "after_rollback_replace_or_remove hook threw error");
-        }
+        op->execute(ctx->cluster_ref(), std::move(req), [ctx, &item, op](result&& raw) {
+            try {
+                auto res = wrap_operation_result(std::move(raw));
+                CB_ATTEMPT_CTX_LOG_TRACE(ctx, "rollback result {}", res);
+                auto ec = ctx->hooks_.after_rollback_replace_or_remove(ctx, item.doc().id().key());
+                if (ec) {
+                    throw client_error(*ec, "after_rollback_replace_or_remove hook threw error");
+                }
+                op->done();
+            } catch (const client_error& e) {
+                handle_rollback_remove_or_replace_error(ctx, op, e);
+            }
+        });
     } catch (const client_error& e) {
-        auto ec = e.ec();
-        if (ctx->expiry_overtime_mode_.load()) {
-            throw transaction_operation_failed(FAIL_EXPIRY, std::string("expired while handling ") + e.what()).no_rollback();
-        }
-        switch (ec) {
-            case FAIL_HARD:
-            case FAIL_DOC_NOT_FOUND:
-            case FAIL_CAS_MISMATCH:
-                throw transaction_operation_failed(ec, e.what()).no_rollback();
-            case FAIL_EXPIRY:
-                ctx->expiry_overtime_mode_ = true;
-                CB_ATTEMPT_CTX_LOG_TRACE(ctx, "setting expiry overtime mode in {}", STAGE_ROLLBACK_DOC);
-                throw retry_operation("retry rollback_remove_or_replace");
-            case FAIL_PATH_NOT_FOUND:
-                // already cleaned up?
-                return;
-            default:
-                throw retry_operation("retry rollback_remove_or_replace");
-        }
+        handle_rollback_remove_or_replace_error(ctx, op, e);
     }
 }
+
 void
-staged_mutation_queue::commit_doc(attempt_context_impl* ctx, staged_mutation& item, bool ambiguity_resolution_mode, bool cas_zero_mode)
+staged_mutation_queue::commit(attempt_context_impl* ctx)
 {
-    retry_op<void>([&]() {
-        CB_ATTEMPT_CTX_LOG_TRACE(
-          ctx, "commit doc {}, cas_zero_mode {}, ambiguity_resolution_mode {}", item.doc().id(), cas_zero_mode, ambiguity_resolution_mode);
-        try {
-            ctx->check_expiry_during_commit_or_rollback(STAGE_COMMIT_DOC, std::optional<const std::string>(item.doc().id().key()));
-            auto ec = ctx->hooks_.before_doc_committed(ctx, item.doc().id().key());
-            if (ec) {
-                throw client_error(*ec, "before_doc_committed hook threw error");
-            }
-
-            // move staged content into doc
-            CB_ATTEMPT_CTX_LOG_TRACE(
-              ctx, "commit doc id {}, content {}, cas {}", item.doc().id(), to_string(item.content()), item.doc().cas().value());
-
-            result res;
-            if (item.type() == staged_mutation_type::INSERT && !cas_zero_mode) {
-                core::operations::insert_request req{ item.doc().id(), item.content() };
-                req.flags = couchbase::codec::codec_flags::json_common_flags;
-                wrap_durable_request(req, ctx->overall_.config());
-                auto barrier = std::make_shared<std::promise<result>>();
-                auto f = barrier->get_future();
-                ctx->cluster_ref()->execute(req, [barrier](core::operations::insert_response resp) {
-                    barrier->set_value(result::create_from_mutation_response(resp));
-                });
-                res = wrap_operation_future(f);
-            } else {
-                core::operations::mutate_in_request req{ item.doc().id() };
-                req.specs =
-                  couchbase::mutate_in_specs{
-                      couchbase::mutate_in_specs::remove(TRANSACTION_INTERFACE_PREFIX_ONLY).xattr(),
-                      // subdoc::opcode::set_doc used in replace w/ empty path
-                      couchbase::mutate_in_specs::replace_raw("", item.content()),
-                  }
-                    .specs();
-                req.store_semantics = couchbase::store_semantics::replace;
-                req.cas = couchbase::cas(cas_zero_mode ? 0 : item.doc().cas().value());
-                wrap_durable_request(req, ctx->overall_.config());
-                auto barrier = std::make_shared<std::promise<result>>();
-                auto f = barrier->get_future();
-                ctx->cluster_ref()->execute(req, [barrier](core::operations::mutate_in_response resp) {
-                    barrier->set_value(result::create_from_subdoc_response(resp));
-                });
-                res = wrap_operation_future(f);
-            }
-            CB_ATTEMPT_CTX_LOG_TRACE(ctx, "commit doc result {}", res);
-            // TODO: mutation tokens
-            ec = ctx->hooks_.after_doc_committed_before_saving_cas(ctx, item.doc().id().key());
-            if (ec) {
-                throw client_error(*ec, "after_doc_committed_before_saving_cas threw error");
-            }
-            item.doc().cas(res.cas);
-            ec = ctx->hooks_.after_doc_committed(ctx, item.doc().id().key());
-            if (ec) {
-                throw client_error(*ec, "after_doc_committed threw error");
-            }
-        } catch (const client_error& e) {
-            error_class ec = e.ec();
-            if (ctx->expiry_overtime_mode_.load()) {
-                throw transaction_operation_failed(FAIL_EXPIRY, "expired during commit").no_rollback().failed_post_commit();
-            }
-            switch (ec) {
-                case FAIL_AMBIGUOUS:
-                    ambiguity_resolution_mode = true;
-                    throw retry_operation("FAIL_AMBIGUOUS in commit_doc");
-                case FAIL_CAS_MISMATCH:
-                case FAIL_DOC_ALREADY_EXISTS:
-                    if (ambiguity_resolution_mode) {
-                        throw transaction_operation_failed(ec, e.what()).no_rollback().failed_post_commit();
-                    }
-                    ambiguity_resolution_mode = true;
-                    cas_zero_mode = true;
-                    throw retry_operation("FAIL_DOC_ALREADY_EXISTS in commit_doc");
-                default:
-                    throw transaction_operation_failed(ec, e.what()).no_rollback().failed_post_commit();
-            }
+    CB_ATTEMPT_CTX_LOG_TRACE(ctx, "staged mutations committing...");
+    std::lock_guard<std::mutex> lock(mutex_);
+    CB_ATTEMPT_CTX_LOG_TRACE(
+      ctx, "committing {} staged mutations, at most {} at a time", queue_.size(), std::min(queue_.size(), max_in_flight_mutations));
+    auto make_attempt = [this, ctx](staged_mutation& item) -> unstaging_operation::attempt_function {
+        switch (item.type()) {
+            case staged_mutation_type::REMOVE:
+                return [this, ctx, &item](const std::shared_ptr<unstaging_operation>& op) { remove_doc(ctx, item, op); };
+            case staged_mutation_type::INSERT:
+            case staged_mutation_type::REPLACE:
+                break;
         }
-    });
+        // the mode is shared by all retries of the document
+        return [this, ctx, &item, mode = std::make_shared<commit_doc_mode>()](const std::shared_ptr<unstaging_operation>& op) {
+            commit_doc(ctx, item, op, mode);
+        };
+    };
+    unstage_concurrently(queue_, unstaging_operation::retry_policy::constant_delay, make_attempt);
 }
 
 void
-staged_mutation_queue::remove_doc(attempt_context_impl* ctx, const staged_mutation& item)
+staged_mutation_queue::rollback(attempt_context_impl* ctx)
 {
-    retry_op<void>([&] {
-        try {
-            ctx->check_expiry_during_commit_or_rollback(STAGE_REMOVE_DOC, std::optional<const std::string>(item.doc().id().key()));
-            auto ec = ctx->hooks_.before_doc_removed(ctx, item.doc().id().key());
-            if (ec) {
-                throw client_error(*ec, "before_doc_removed hook threw error");
-            }
-            core::operations::remove_request req{ item.doc().id() };
-            wrap_durable_request(req, ctx->overall_.config());
-            auto barrier = std::make_shared<std::promise<result>>();
-            auto f = barrier->get_future();
-            ctx->cluster_ref()->execute(
-              req, [barrier](core::operations::remove_response resp) { barrier->set_value(result::create_from_mutation_response(resp)); });
-            wrap_operation_future(f);
-            ec = ctx->hooks_.after_doc_removed_pre_retry(ctx, item.doc().id().key());
-            if (ec) {
-                throw client_error(*ec, "after_doc_removed_pre_retry threw error");
-            }
-        } catch (const client_error& e) {
-            error_class ec = e.ec();
-            if (ctx->expiry_overtime_mode_.load()) {
-                throw transaction_operation_failed(ec, e.what()).no_rollback().failed_post_commit();
-            }
-            switch (ec) {
-                case FAIL_AMBIGUOUS:
-                    throw retry_operation("remove_doc got FAIL_AMBIGUOUS");
-                default:
-                    throw transaction_operation_failed(ec, e.what()).no_rollback().failed_post_commit();
-            }
+    std::lock_guard<std::mutex> lock(mutex_);
+    CB_ATTEMPT_CTX_LOG_TRACE(
+      ctx, "rolling back {} staged mutations, at most {} at a time", queue_.size(), std::min(queue_.size(), max_in_flight_mutations));
+    auto make_attempt = [this, ctx](staged_mutation& item) -> unstaging_operation::attempt_function {
+        switch (item.type()) {
+            case staged_mutation_type::INSERT:
+                return [this, ctx, &item](const std::shared_ptr<unstaging_operation>& op) { rollback_insert(ctx, item, op); };
+            case staged_mutation_type::REMOVE:
+            case staged_mutation_type::REPLACE:
+                break;
         }
-    });
+        return [this, ctx, &item](const std::shared_ptr<unstaging_operation>& op) { rollback_remove_or_replace(ctx, item, op); };
+    };
+    unstage_concurrently(queue_, unstaging_operation::retry_policy::exponential_backoff, make_attempt);
 }
 } // namespace couchbase::core::transactions
@@ -21,8 +21,13 @@
 #include "transaction_get_result.hxx"
 #include "uid_generator.hxx"
 
+#include <functional>
+#include <list>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace couchbase::core::transactions
@@ -109,15 +114,47 @@ class staged_mutation
     }
 };
 
+class unstaging_operation;
+struct commit_doc_mode;
+
 class staged_mutation_queue
 {
+  public:
+    /**
+     * Upper bound for the number of staged mutations, which are being committed or rolled back at the same time.
+     */
+    static constexpr std::size_t max_in_flight_mutations{ 32 };
+
   private:
     std::mutex mutex_;
-    std::vector<staged_mutation> queue_;
-    void commit_doc(attempt_context_impl* ctx, staged_mutation& item, bool ambiguity_resolution_mode = false, bool cas_zero_mode = false);
-    void remove_doc(attempt_context_impl* ctx, const staged_mutation& item);
-    void rollback_insert(attempt_context_impl* ctx, const staged_mutation& item);
-    void rollback_remove_or_replace(attempt_context_impl* ctx, const staged_mutation& item);
+    /**
+     * Mutations in the order they have been staged. The list keeps the elements in place, so that the index and the pointers
+     * returned by find_*() survive staging of other documents.
+     */
+    std::list<staged_mutation> queue_;
+    /**
+     * At most one staged mutation per document, keyed by index_key() of its id.
+     */
+    std::unordered_map<std::string, std::list<staged_mutation>::iterator> index_;
+
+    [[nodiscard]] static std::string index_key(const core::document_id& id);
+    staged_mutation* find(const core::document_id& id, std::optional<staged_mutation_type> type);
+    void commit_doc(attempt_context_impl* ctx,
+                    staged_mutation& item,
+                    const std::shared_ptr<unstaging_operation>& op,
+                    const std::shared_ptr<commit_doc_mode>& mode);
+    void remove_doc(attempt_context_impl* ctx, const staged_mutation& item, const std::shared_ptr<unstaging_operation>& op);
+    void rollback_insert(attempt_context_impl* ctx, const staged_mutation& item, const std::shared_ptr<unstaging_operation>& op);
+    void rollback_remove_or_replace(attempt_context_impl* ctx, const staged_mutation& item, const std::shared_ptr<unstaging_operation>& op);
+    [[noreturn]] static void handle_commit_doc_error(attempt_context_impl* ctx, const client_error& e, commit_doc_mode& mode);
+    [[noreturn]] static void handle_remove_doc_error(attempt_context_impl* ctx, const client_error& e);
+    static void handle_rollback_insert_error(attempt_context_impl* ctx,
+                                             const staged_mutation& item,
+                                             const std::shared_ptr<unstaging_operation>& op,
+                                             const client_error& e);
+    static void handle_rollback_remove_or_replace_error(attempt_context_impl* ctx,
+                                                        const std::shared_ptr<unstaging_operation>& op,
+                                                        const client_error& e);
 
   public:
     bool empty();
@@ -25,8 +25,29 @@
 #include "internal/transactions_cleanup.hxx"
 #include "internal/utils.hxx"
 
+#include <asio/executor_work_guard.hpp>
+#include <asio/post.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
 namespace couchbase::core::transactions
 {
+namespace
+{
+std::size_t
+async_executor_threads(const couchbase::transactions::transactions_config::built& config)
+{
+    if (config.async_executor_threads) {
+        return std::max<std::size_t>(1, config.async_executor_threads.value());
+    }
+    // the logic of asynchronous transaction occupies the thread while it waits for its operations, so by default the pool is larger
+    // than the number of cores, while still bounded
+    return std::max<std::size_t>(16, 4 * std::thread::hardware_concurrency());
+}
+} // namespace
+
 transactions::transactions(std::shared_ptr<core::cluster> cluster, const couchbase::transactions::transactions_config& config)
   : transactions(cluster, config.build())
 {
@@ -65,7 +86,66 @@ transactions::transactions(std::shared_ptr<core::cluster> cluster, const couchba
     }
 }
 
-transactions::~transactions() = default;
+transactions::~transactions()
+{
+    // the lock is not taken, because the queued transactions, that the pool is joining, call executor() themselves. The pool
+    // cannot be created concurrently with the destructor, because only the transactions started by this object create it.
+    if (!executor_) {
+        return;
+    }
+    if (executor_->get_executor().running_in_this_thread()) {
+        // the last reference has been released by the asynchronous transaction itself, the queued transactions will never run, so they
+        // are failed here. The thread cannot join the pool it belongs to, so the pool is joined and destroyed by the separate thread as
+        // soon as the threads of the pool return from the current handlers
+        CB_TXN_LOG_DEBUG("transactions object is destroyed by its own executor, failing pending asynchronous transactions");
+        executor_->stop();
+        fail_pending_async_runs();
+        std::thread([executor = std::move(executor_)]() { executor->join(); }).detach();
+        return;
+    }
+    // let the queued asynchronous transactions to complete, as they refer to this object
+    executor_->join();
+    executor_.reset();
+}
+
+std::uint64_t
+transactions::add_pending_async_run(std::function<void()>&& fail)
+{
+    std::scoped_lock lock(pending_async_runs_mutex_);
+    auto id = next_pending_async_run_id_++;
+    pending_async_runs_.try_emplace(id, std::move(fail));
+    return id;
+}
+
+void
+transactions::remove_pending_async_run(std::uint64_t id)
+{
+    std::scoped_lock lock(pending_async_runs_mutex_);
+    pending_async_runs_.erase(id);
+}
+
+void
+transactions::fail_pending_async_runs()
+{
+    std::map<std::uint64_t, std::function<void()>> pending_async_runs;
+    {
+        std::scoped_lock lock(pending_async_runs_mutex_);
+        std::swap(pending_async_runs, pending_async_runs_);
+    }
+    for (auto& [id, fail] : pending_async_runs) {
+        fail();
+    }
+}
+
+asio::thread_pool::executor_type
+transactions::executor()
+{
+    std::scoped_lock lock(executor_mutex_);
+    if (!executor_) {
+        executor_ = std::make_unique<asio::thread_pool>(async_executor_threads(config_));
+    }
+    return executor_->get_executor();
+}
 
 template<typename Handler>
 ::couchbase::transactions::transaction_result
@@ -115,6 +195,122 @@ wrap_run(transactions& txns, const couchbase::transactions::transaction_options&
     return overall.get_transaction_result();
 }
 
+/**
+ * State of the asynchronous transaction, that is shared by the callbacks of its attempts.
+ */
+template<typename Handler>
+struct async_run_state {
+    async_run_state(transactions& txns,
+                    const couchbase::transactions::transaction_options& config,
+                    std::size_t attempts_limit,
+                    Handler&& code,
+                    txn_complete_callback&& cb)
+      : owner(txns)
+      , work(asio::make_work_guard(txns.executor()))
+      , overall(txns, config)
+      , max_attempts(attempts_limit)
+      , logic(std::move(code))
+      , done(std::move(cb))
+    {
+    }
+
+    /**
+     * Calls the callback of the transaction, unless it has been already failed because the transactions object has been destroyed.
+     */
+    void complete(std::optional<transaction_exception> err, std::optional<couchbase::transactions::transaction_result> result)
+    {
+        if (completed.exchange(true)) {
+            return;
+        }
+        owner.remove_pending_async_run(id);
+        done(std::move(err), std::move(result));
+    }
+
+    transactions& owner;
+    // keeps the pool from being joined, while the transaction waits for its operations outside of the pool
+    asio::executor_work_guard<asio::thread_pool::executor_type> work;
+    transaction_context overall;
+    std::size_t attempts{ 0 };
+    const std::size_t max_attempts;
+    Handler logic;
+    txn_complete_callback done;
+    std::uint64_t id{ 0 };
+    std::atomic_bool completed{ false };
+};
+
+/**
+ * Registers the transaction in the transactions object, so that its callback is called even if the object is destroyed first.
+ */
+template<typename Handler>
+std::shared_ptr<async_run_state<Handler>>
+track_async_run(std::shared_ptr<async_run_state<Handler>> state)
+{
+    state->id = state->owner.add_pending_async_run([weak_state = std::weak_ptr<async_run_state<Handler>>(state)]() {
+        if (auto pending = weak_state.lock(); pending) {
+            pending->complete(
+              transaction_operation_failed(FAIL_OTHER, "transactions object has been destroyed before the transaction completed")
+                .no_rollback()
+                .get_final_exception(pending->overall),
+              std::nullopt);
+        }
+    });
+    return state;
+}
+
+/**
+ * Asynchronous version of wrap_run. The next attempt is started from the callback of the previous one, so the thread is not blocked
+ * while the attempt is being committed or rolled back.
+ */
+template<typename Handler>
+void
+run_async_attempt(std::shared_ptr<async_run_state<Handler>> state)
+{
+    if (state->attempts++ >= state->max_attempts) {
+        // only thing to do here is return, but we really exceeded the max attempts
+        return state->complete(std::nullopt, state->overall.get_transaction_result());
+    }
+    // NOTE: new_attempt_context has the exponential backoff built in, see wrap_run
+    state->overall.new_attempt_context([state](std::exception_ptr err) {
+        if (err) {
+            try {
+                std::rethrow_exception(err);
+            } catch (const transaction_exception& e) {
+                return state->complete(e, std::nullopt);
+            } catch (const retry_operation_timeout& e) {
+                return state->complete(
+                  transaction_operation_failed(FAIL_EXPIRY, e.what()).no_rollback().expired().get_final_exception(state->overall),
+                  std::nullopt);
+            } catch (const std::exception& e) {
+                return state->complete(transaction_operation_failed(FAIL_OTHER, e.what()).get_final_exception(state->overall),
+                                       std::nullopt);
+            } catch (...) {
+                return state->complete(transaction_operation_failed(FAIL_OTHER, "Unexpected error").get_final_exception(state->overall),
+                                       std::nullopt);
+            }
+        }
+        // the logic might block, so it runs on the executor rather than on the IO thread, that has created the attempt
+        asio::post(state->overall.executor(), [state]() {
+            auto finalize_handler = [state](std::optional<transaction_exception> finalize_err,
+                                            std::optional<couchbase::transactions::transaction_result> result) {
+                if (result) {
+                    return state->complete(std::nullopt, result);
+                }
+                if (finalize_err) {
+                    return state->complete(finalize_err, std::nullopt);
+                }
+                // no return value, no exception means retry.
+                run_async_attempt(state);
+            };
+            try {
+                state->logic(*state->overall.current_attempt_context());
+            } catch (...) {
+                return state->overall.handle_error(std::current_exception(), finalize_handler);
+            }
+            state->overall.finalize(finalize_handler);
+        });
+    });
+}
+
 ::couchbase::transactions::transaction_result
 transactions::run(logic&& code)
 {
@@ -142,29 +338,26 @@ transactions::run(couchbase::transactions::txn_logic&& code, const couchbase::tr
 void
 transactions::run(const couchbase::transactions::transaction_options& config, async_logic&& code, txn_complete_callback&& cb)
 {
-    std::thread([this, config, code = std::move(code), cb = std::move(cb)]() {
-        try {
-            auto result = wrap_run(*this, config, max_attempts_, std::move(code));
-            return cb({}, result);
-        } catch (const transaction_exception& e) {
-            return cb(e, std::nullopt);
-        }
-    }).detach();
+    run_async_attempt(
+      track_async_run(std::make_shared<async_run_state<async_logic>>(*this, config, max_attempts_, std::move(code), std::move(cb))));
 }
 void
 transactions::run(couchbase::transactions::async_txn_logic&& code,
                   couchbase::transactions::async_txn_complete_logic&& cb,
                   const couchbase::transactions::transaction_options& config)
 {
-    std::thread([this, config, code = std::move(code), cb = std::move(cb)]() {
-        try {
-            auto result = wrap_run(*this, config, max_attempts_, std::move(code));
-            return cb({}, result);
-        } catch (const transaction_exception& e) {
-            auto [ctx, res] = e.get_transaction_result();
-            return cb(ctx, res);
-        }
-    }).detach();
+    run_async_attempt(track_async_run(std::make_shared<async_run_state<couchbase::transactions::async_txn_logic>>(
+      *this,
+      config,
+      max_attempts_,
+      std::move(code),
+      [cb = std::move(cb)](std::optional<transaction_exception> err, std::optional<couchbase::transactions::transaction_result> result) {
+          if (err) {
+              auto [ctx, res] = err->get_transaction_result();
+              return cb(ctx, res);
+          }
+          return cb({}, result.value());
+      })));
 }
 
 void
@@ -26,9 +26,17 @@
 #include "internal/transactions_cleanup.hxx"
 #include "internal/utils.hxx"
 
+#include <asio/post.hpp>
+#include <asio/thread_pool.hpp>
+
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <functional>
+#include <memory>
+#include <system_error>
+#include <thread>
 
 namespace couchbase::core::transactions
 {
@@ -123,6 +131,11 @@ transactions_cleanup::interruptable_wait(std::chrono::duration<R, P> delay)
 void
 transactions_cleanup::clean_collection(const couchbase::transactions::transaction_keyspace& keyspace)
 {
+    // helpers of the passes live as long as the collection is being cleaned, the thread of the collection is the first worker
+    std::unique_ptr<asio::thread_pool> workers;
+    if (config_.cleanup_config.lost_attempts_cleanup_concurrency > 1) {
+        workers = std::make_unique<asio::thread_pool>(config_.cleanup_config.lost_attempts_cleanup_concurrency - 1);
+    }
     // first make sure the collection is in the list
     while (is_running()) {
         {
@@ -138,57 +151,20 @@ transactions_cleanup::clean_collection(const couchbase::transactions::transactio
             auto details = get_active_clients(keyspace, client_uuid_);
 
             auto all_atrs = atr_ids::all();
+            std::vector<std::string> atrs_of_this_client;
+            for (std::size_t idx = details.index_of_this_client; idx < all_atrs.size();
+                 idx += std::max<std::size_t>(1, details.num_active_clients)) {
+                atrs_of_this_client.emplace_back(all_atrs[idx]);
+            }
 
-            std::chrono::microseconds cleanup_window =
-              std::chrono::duration_cast<std::chrono::microseconds>(config_.cleanup_config.cleanup_window);
-            auto start = std::chrono::steady_clock::now();
             CB_LOST_ATTEMPT_CLEANUP_LOG_INFO("{} active clients (including this one), {} ATRs to check in {}ms",
                                              details.num_active_clients,
-                                             all_atrs.size(),
+                                             atrs_of_this_client.size(),
                                              config_.cleanup_config.cleanup_window.count());
 
-            for (auto it = all_atrs.begin() + details.index_of_this_client; it < all_atrs.end(); it += details.num_active_clients) {
-                auto atrs_left_for_this_client =
-                  std::distance(it, all_atrs.end()) / std::max<decltype(it)::difference_type>(1, details.num_active_clients);
-                auto now = std::chrono::steady_clock::now();
-                std::chrono::microseconds elapsed_in_cleanup_window = std::chrono::duration_cast<std::chrono::microseconds>(now - start);
-                std::chrono::microseconds remaining_in_cleanup_window = cleanup_window - elapsed_in_cleanup_window;
-                std::chrono::microseconds budget_for_this_atr = std::chrono::microseconds(
-                  remaining_in_cleanup_window.count() / std::max<decltype(it)::difference_type>(1, atrs_left_for_this_client));
-                // clean the ATR entry
-                std::string atr_id = *it;
-                if (!is_running()) {
-                    CB_LOST_ATTEMPT_CLEANUP_LOG_DEBUG("cleanup of {} complete", keyspace);
-                    return;
-                }
-
-                try {
-                    handle_atr_cleanup({ keyspace.bucket, keyspace.scope, keyspace.collection, atr_id });
-                } catch (const std::exception& e) {
-                    CB_LOST_ATTEMPT_CLEANUP_LOG_ERROR("cleanup of atr {} failed with {}, moving on", atr_id, e.what());
-                }
-
-                auto atr_end = std::chrono::steady_clock::now();
-                std::chrono::microseconds atr_used = std::chrono::duration_cast<std::chrono::microseconds>(atr_end - now);
-                std::chrono::microseconds atr_left = budget_for_this_atr - atr_used;
-
-                // Too verbose to log, but leaving here commented as it may be useful later for internal debugging
-                /*CB_LOST_ATTEMPT_CLEANUP_LOG_INFO("{} {} atrs_left_for_this_client={} elapsed_in_cleanup_window={}us "
-                                            "remaining_in_cleanup_window={}us budget_for_this_atr={}us atr_used={}us atr_left={}us",
-                                            bucket_name,
-                                            atr_id,
-                                            atrs_left_for_this_client,
-                                            elapsed_in_cleanup_window.count(),
-                                            remaining_in_cleanup_window.count(),
-                                            budget_for_this_atr.count(),
-                                            atr_used.count(),
-                                            atr_left.count());*/
-
-                if (atr_left.count() > 0 && atr_left.count() < 1000000000) { // safety check protects against bugs
-                    if (!interruptable_wait(atr_left)) {
-                        return;
-                    }
-                }
+            if (!clean_atrs(keyspace, atrs_of_this_client, workers.get())) {
+                CB_LOST_ATTEMPT_CLEANUP_LOG_DEBUG("cleanup of {} complete", keyspace);
+                return;
             }
         } catch (const std::exception& ex) {
             CB_LOST_ATTEMPT_CLEANUP_LOG_ERROR("cleanup failed with {}, trying again in 3 sec...", ex.what());
@@ -198,6 +174,153 @@ transactions_cleanup::clean_collection(const couchbase::transactions::transactio
     }
 }
 
+bool
+transactions_cleanup::clean_atrs(const couchbase::transactions::transaction_keyspace& keyspace,
+                                 const std::vector<std::string>& atrs,
+                                 asio::thread_pool* workers)
+{
+    const std::size_t concurrency =
+      workers == nullptr ? 1 : std::max<std::size_t>(1, std::min(config_.cleanup_config.lost_attempts_cleanup_concurrency, atrs.size()));
+    const std::size_t rate_limit = config_.cleanup_config.lost_attempts_cleanup_rate_limit;
+    const std::chrono::microseconds cleanup_window =
+      std::chrono::duration_cast<std::chrono::microseconds>(config_.cleanup_config.cleanup_window);
+    const auto start = std::chrono::steady_clock::now();
+    // every worker gets its share of the ATRs, spacing them by this interval completes the whole pass within the cleanup window
+    const std::size_t atrs_per_worker = std::max<std::size_t>(1, (atrs.size() + concurrency - 1) / concurrency);
+    const std::chrono::microseconds interval_per_atr = cleanup_window / static_cast<std::int64_t>(atrs_per_worker);
+
+    update_lost_attempts_stats(keyspace, [&atrs](lost_attempts_cleanup_stats& stats) {
+        stats.atrs_in_pass = atrs.size();
+        stats.atrs_backlog = atrs.size();
+    });
+
+    std::atomic_size_t next_atr{ 0 };
+    std::atomic_bool interrupted{ false };
+    std::mutex rate_limit_mutex;
+    auto next_allowed_start = start;
+
+    auto worker = [&]() {
+        auto next_atr_start = start;
+        while (!interrupted.load()) {
+            auto index = next_atr.fetch_add(1);
+            if (index >= atrs.size()) {
+                return;
+            }
+            // the worker, that started late (or has been slowed down by the server), does not wait until it catches up
+            if (auto delay = next_atr_start - std::chrono::steady_clock::now(); delay.count() > 0 && !interruptable_wait(delay)) {
+                interrupted = true;
+                return;
+            }
+            next_atr_start += interval_per_atr;
+            if (rate_limit > 0) {
+                // reserve the next slot, so that all workers together stay below the limit
+                std::chrono::steady_clock::time_point slot;
+                {
+                    std::lock_guard<std::mutex> lock(rate_limit_mutex);
+                    slot = std::max(next_allowed_start, std::chrono::steady_clock::now());
+                    next_allowed_start = slot + std::chrono::microseconds(1'000'000 / rate_limit);
+                }
+                auto delay = slot - std::chrono::steady_clock::now();
+                if (delay.count() > 0 && !interruptable_wait(delay)) {
+                    interrupted = true;
+                    return;
+                }
+            }
+
+            // clean the ATR entry
+            const auto& atr_id = atrs[index];
+            if (!is_running()) {
+                interrupted = true;
+                return;
+            }
+
+            atr_cleanup_stats atr_stats{};
+            bool failed = false;
+            try {
+                atr_stats = handle_atr_cleanup({ keyspace.bucket, keyspace.scope, keyspace.collection, atr_id });
+            } catch (const std::exception& e) {
+                CB_LOST_ATTEMPT_CLEANUP_LOG_ERROR("cleanup of atr {} failed with {}, moving on", atr_id, e.what());
+                failed = true;
+            }
+            update_lost_attempts_stats(keyspace, [&atr_stats, failed](lost_attempts_cleanup_stats& stats) {
+                ++stats.atrs_checked;
+                if (stats.atrs_backlog > 0) {
+                    --stats.atrs_backlog;
+                }
+                if (failed) {
+                    ++stats.atrs_failed;
+                }
+                stats.entries_found += atr_stats.num_entries;
+            });
+        }
+    };
+
+    std::size_t running_helpers{ concurrency - 1 };
+    std::mutex helpers_mutex;
+    std::condition_variable helpers_done;
+    for (std::size_t i = 1; i < concurrency; ++i) {
+        asio::post(*workers, [&]() {
+            worker();
+            std::lock_guard<std::mutex> lock(helpers_mutex);
+            if (--running_helpers == 0) {
+                helpers_done.notify_all();
+            }
+        });
+    }
+    worker();
+    {
+        std::unique_lock<std::mutex> lock(helpers_mutex);
+        helpers_done.wait(lock, [&running_helpers]() { return running_helpers == 0; });
+    }
+    if (interrupted.load()) {
+        return false;
+    }
+
+    auto pass_duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    double atrs_per_second =
+      pass_duration.count() > 0 ? static_cast<double>(atrs.size()) * 1000.0 / static_cast<double>(pass_duration.count()) : 0;
+    std::size_t entries_found{ 0 };
+    std::size_t atrs_failed{ 0 };
+    update_lost_attempts_stats(keyspace, [&](lost_attempts_cleanup_stats& stats) {
+        ++stats.passes_completed;
+        stats.last_pass_duration = pass_duration;
+        stats.atrs_per_second = atrs_per_second;
+        entries_found = stats.entries_found;
+        atrs_failed = stats.atrs_failed;
+    });
+    CB_LOST_ATTEMPT_CLEANUP_LOG_INFO("cleanup pass for {} done: {} ATRs in {}ms ({:.2f} ATRs/s, concurrency {}), {} entries found so far, "
+                                     "{} ATRs failed so far",
+                                     keyspace,
+                                     atrs.size(),
+                                     pass_duration.count(),
+                                     atrs_per_second,
+                                     concurrency,
+                                     entries_found,
+                                     atrs_failed);
+    return true;
+}
+
+void
+transactions_cleanup::update_lost_attempts_stats(const couchbase::transactions::transaction_keyspace& keyspace,
+                                                 const std::function<void(lost_attempts_cleanup_stats&)>& update)
+{
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    auto it = std::find_if(lost_attempts_stats_.begin(), lost_attempts_stats_.end(), [&keyspace](lost_attempts_cleanup_stats& stats) {
+        return stats.keyspace == keyspace;
+    });
+    if (it == lost_attempts_stats_.end()) {
+        it = lost_attempts_stats_.insert(lost_attempts_stats_.end(), lost_attempts_cleanup_stats{ keyspace });
+    }
+    update(*it);
+}
+
+std::vector<lost_attempts_cleanup_stats>
+transactions_cleanup::lost_attempts_stats() const
+{
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return std::vector<lost_attempts_cleanup_stats>(lost_attempts_stats_.begin(), lost_attempts_stats_.end());
+}
+
 const atr_cleanup_stats
 transactions_cleanup::handle_atr_cleanup(const core::document_id& atr_id, std::vector<transactions_cleanup_attempt>* results)
 {
@@ -42,6 +42,7 @@ transactions_config::transactions_config(transactions_config&& c) noexcept
   , metadata_collection_(std::move(c.metadata_collection_))
   , query_config_(c.query_config_)
   , cleanup_config_(std::move(c.cleanup_config_))
+  , async_executor_threads_(c.async_executor_threads_)
 {
 }
 
@@ -53,6 +54,7 @@ transactions_config::transactions_config(const transactions_config& config)
   , metadata_collection_(config.metadata_collection())
   , query_config_(config.query_config())
   , cleanup_config_(config.cleanup_config())
+  , async_executor_threads_(config.async_executor_threads())
 {
 }
 
@@ -67,6 +69,7 @@ transactions_config::operator=(const transactions_config& c)
         query_config_ = c.query_config_;
         metadata_collection_ = c.metadata_collection_;
         cleanup_config_ = c.cleanup_config_;
+        async_executor_threads_ = c.async_executor_threads_;
     }
     return *this;
 }
@@ -74,8 +77,9 @@ transactions_config::operator=(const transactions_config& c)
 transactions_config::built
 transactions_config::build() const
 {
-    return { level_,         expiration_time_,     kv_timeout_,           attempt_context_hooks_,
-             cleanup_hooks_, metadata_collection_, query_config_.build(), cleanup_config_.build() };
+    return { level_,                 expiration_time_,        kv_timeout_,
+             attempt_context_hooks_, cleanup_hooks_,          metadata_collection_,
+             query_config_.build(),  cleanup_config_.build(), async_executor_threads_ };
 }
 
 } // namespace couchbase::transactions
@@ -66,7 +66,12 @@ wrap_collection_call(result& res, std::function<void(result&)> call)
 result
 wrap_operation_future(std::future<result>& fut, bool ignore_subdoc_errors)
 {
-    auto res = fut.get();
+    return wrap_operation_result(fut.get(), ignore_subdoc_errors);
+}
+
+result
+wrap_operation_result(result res, bool ignore_subdoc_errors)
+{
     if (!res.is_success()) {
         throw client_error(res);
     }
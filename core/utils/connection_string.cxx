@@ -231,6 +231,18 @@ parse_option(std::size_t& receiver, const std::string& name, const std::string&
     }
 }
 
+void
+parse_option(double& receiver, const std::string& name, const std::string& value)
+{
+    try {
+        receiver = std::stod(value);
+    } catch (const std::invalid_argument& ex1) {
+        CB_LOG_WARNING(R"(unable to parse "{}" parameter in connection string (value "{}" is not a number): {})", name, value, ex1.what());
+    } catch (const std::out_of_range& ex2) {
+        CB_LOG_WARNING(R"(unable to parse "{}" parameter in connection string (value "{}" is out of range): {})", name, value, ex2.what());
+    }
+}
+
 void
 parse_option(std::chrono::milliseconds& receiver, const std::string& name, const std::string& value)
 {
@@ -336,12 +348,38 @@ extract_options(connection_string& connstr)
             parse_option(connstr.options.config_poll_interval, name, value);
         } else if (name == "config_poll_floor") {
             parse_option(connstr.options.config_poll_floor, name, value);
+        } else if (name == "dns_cache_ttl") {
+            /**
+             * How long the resolved addresses of the nodes are cached. 0 resolves the hostname on every connection attempt.
+             */
+            parse_option(connstr.options.dns_cache_ttl, name, value);
+        } else if (name == "dns_negative_cache_ttl") {
+            /**
+             * How long the failure to resolve the hostname of the node is cached.
+             */
+            parse_option(connstr.options.dns_negative_cache_ttl, name, value);
+        } else if (name == "connection_attempt_delay") {
+            /**
+             * Delay before connecting to the next address of the node, when the previous attempt has not completed yet.
+             */
+            parse_option(connstr.options.connection_attempt_delay, name, value);
         } else if (name == "max_http_connections") {
             /**
              * The maximum number of HTTP connections allowed on a per-host and per-port basis.  0 indicates an unlimited number of
              * connections are permitted.
              */
             parse_option(connstr.options.max_http_connections, name, value);
+        } else if (name == "io_shards") {
+            /**
+             * Number of IO contexts owned by the cluster, each run by its own thread. 0 keeps all sessions on the IO context of the
+             * application.
+             */
+            parse_option(connstr.options.io_shards, name, value);
+        } else if (name == "pin_io_shards") {
+            /**
+             * Pin the thread of each IO shard to its own CPU (Linux only).
+             */
+            parse_option(connstr.options.pin_io_shards, name, value);
         } else if (name == "idle_http_connection_timeout") {
             /**
              * The period of time an HTTP connection can be idle before it is forcefully disconnected.
@@ -388,6 +426,16 @@ extract_options(connection_string& connstr)
              * Announce support of compression (snappy) to server
              */
             parse_option(connstr.options.enable_compression, name, value);
+        } else if (name == "compression_min_size") {
+            /**
+             * Values of this size or smaller are never compressed
+             */
+            parse_option(connstr.options.compression_min_size, name, value);
+        } else if (name == "compression_min_ratio") {
+            /**
+             * Compressed value is sent only if compressed_size / original_size is less than this ratio
+             */
+            parse_option(connstr.options.compression_min_ratio, name, value);
         } else if (name == "enable_tracing") {
             /**
              * true - use threshold_logging_tracer
@@ -415,6 +463,15 @@ extract_options(connection_string& connstr)
              * Whether to dump every new configuration on TRACE level
              */
             parse_option(connstr.options.dump_configuration, name, value);
+        } else if (name == "mcbp_capture_path") {
+            /**
+             * Base name of the files to capture raw MCBP traffic to (use "cbc replay" to analyze the capture)
+             */
+            parse_option(connstr.options.mcbp_capture.path, name, value);
+        } else if (name == "mcbp_capture_max_file_size") {
+            parse_option(connstr.options.mcbp_capture.max_file_size, name, value);
+        } else if (name == "mcbp_capture_max_files") {
+            parse_option(connstr.options.mcbp_capture.max_files, name, value);
         } else {
             CB_LOG_WARNING(R"(unknown parameter "{}" in connection string (value "{}"))", name, value);
         }
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <couchbase/append_options.hxx>
+#include <couchbase/completion_token.hxx>
 #include <couchbase/decrement_options.hxx>
 #include <couchbase/increment_options.hxx>
 #include <couchbase/prepend_options.hxx>
@@ -87,12 +88,12 @@ class binary_collection
     /**
      * Appends binary content to the document.
      *
-     * @tparam Handler type of the handler that implements @ref append_handler
+     * @tparam CompletionToken callable that implements @ref append_handler signature, or asio completion token
      *
      * @param document_id the document id which is used to uniquely identify it.
      * @param data the document content to append.
      * @param options custom options to customize the append behavior.
-     * @param handler callable that implements @ref append_handler
+     * @param token the handler that implements @ref append_handler, or asio completion token
      *
      * @exception errc::key_value::document_not_found the given document id is not found in the collection.
      * @exception errc::common::cas_mismatch if the document has been concurrently modified on the server.
@@ -102,17 +103,24 @@ class binary_collection
      * @since 1.0.0
      * @committed
      */
-    template<typename Handler>
-    void append(std::string document_id, std::vector<std::byte> data, const append_options& options, Handler&& handler) const
+    template<typename CompletionToken>
+    auto append(std::string document_id, std::vector<std::byte> data, const append_options& options, CompletionToken&& token) const
     {
-        return core::impl::initiate_append_operation(core_,
-                                                     bucket_name_,
-                                                     scope_name_,
-                                                     name_,
-                                                     std::move(document_id),
-                                                     std::move(data),
-                                                     options.build(),
-                                                     std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(key_value_error_context, mutation_result)>(
+          [*this](auto&& handler, std::string id, std::vector<std::byte> bytes, append_options::built built_options) {
+              core::impl::initiate_append_operation(core_,
+                                                    bucket_name_,
+                                                    scope_name_,
+                                                    name_,
+                                                    std::move(id),
+                                                    std::move(bytes),
+                                                    std::move(built_options),
+                                                    std::forward<decltype(handler)>(handler));
+          },
+          token,
+          std::move(document_id),
+          std::move(data),
+          options.build());
     }
 
     /**
@@ -145,12 +153,12 @@ class binary_collection
     /**
      * Prepends binary content to the document.
      *
-     * @tparam Handler type of the handler that implements @ref prepend_handler
+     * @tparam CompletionToken callable that implements @ref prepend_handler signature, or asio completion token
      *
      * @param document_id the document id which is used to uniquely identify it.
      * @param data the document content to prepend.
      * @param options custom options to customize the prepend behavior.
-     * @param handler callable that implements @ref prepend_handler
+     * @param token the handler that implements @ref prepend_handler, or asio completion token
      *
      * @exception errc::key_value::document_not_found the given document id is not found in the collection.
      * @exception errc::common::cas_mismatch if the document has been concurrently modified on the server.
@@ -160,17 +168,24 @@ class binary_collection
      * @since 1.0.0
      * @committed
      */
-    template<typename Handler>
-    void prepend(std::string document_id, std::vector<std::byte> data, const prepend_options& options, Handler&& handler) const
+    template<typename CompletionToken>
+    auto prepend(std::string document_id, std::vector<std::byte> data, const prepend_options& options, CompletionToken&& token) const
     {
-        return core::impl::initiate_prepend_operation(core_,
-                                                      bucket_name_,
-                                                      scope_name_,
-                                                      name_,
-                                                      std::move(document_id),
-                                                      std::move(data),
-                                                      options.build(),
-                                                      std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(key_value_error_context, mutation_result)>(
+          [*this](auto&& handler, std::string id, std::vector<std::byte> bytes, prepend_options::built built_options) {
+              core::impl::initiate_prepend_operation(core_,
+                                                     bucket_name_,
+                                                     scope_name_,
+                                                     name_,
+                                                     std::move(id),
+                                                     std::move(bytes),
+                                                     std::move(built_options),
+                                                     std::forward<decltype(handler)>(handler));
+          },
+          token,
+          std::move(document_id),
+          std::move(data),
+          options.build());
     }
 
     /**
@@ -203,11 +218,11 @@ class binary_collection
     /**
      * Increments the counter document by one or the number defined in the options.
      *
-     * @tparam Handler type of the handler that implements @ref increment_handler
+     * @tparam CompletionToken callable that implements @ref increment_handler signature, or asio completion token
      *
      * @param document_id the document id which is used to uniquely identify it.
      * @param options custom options to customize the increment behavior.
-     * @param handler callable that implements @ref increment_handler
+     * @param token the handler that implements @ref increment_handler, or asio completion token
      *
      * @exception errc::key_value::document_not_found the given document id is not found in the collection.
      * @exception errc::common::ambiguous_timeout
@@ -216,11 +231,22 @@ class binary_collection
      * @since 1.0.0
      * @committed
      */
-    template<typename Handler>
-    void increment(std::string document_id, const increment_options& options, Handler&& handler) const
+    template<typename CompletionToken>
+    auto increment(std::string document_id, const increment_options& options, CompletionToken&& token) const
     {
-        return core::impl::initiate_increment_operation(
-          core_, bucket_name_, scope_name_, name_, std::move(document_id), options.build(), std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(key_value_error_context, counter_result)>(
+          [*this](auto&& handler, std::string id, increment_options::built built_options) {
+              core::impl::initiate_increment_operation(core_,
+                                                       bucket_name_,
+                                                       scope_name_,
+                                                       name_,
+                                                       std::move(id),
+                                                       std::move(built_options),
+                                                       std::forward<decltype(handler)>(handler));
+          },
+          token,
+          std::move(document_id),
+          options.build());
     }
 
     /**
@@ -251,11 +277,11 @@ class binary_collection
     /**
      * Decrements the counter document by one or the number defined in the options.
      *
-     * @tparam Handler type of the handler that implements @ref decrement_handler
+     * @tparam CompletionToken callable that implements @ref decrement_handler signature, or asio completion token
      *
      * @param document_id the document id which is used to uniquely identify it.
      * @param options custom options to customize the decrement behavior.
-     * @param handler callable that implements @ref decrement_handler
+     * @param token the handler that implements @ref decrement_handler, or asio completion token
      *
      * @exception errc::key_value::document_not_found the given document id is not found in the collection.
      * @exception errc::common::ambiguous_timeout
@@ -264,11 +290,22 @@ class binary_collection
      * @since 1.0.0
      * @committed
      */
-    template<typename Handler>
-    void decrement(std::string document_id, const decrement_options& options, Handler&& handler) const
+    template<typename CompletionToken>
+    auto decrement(std::string document_id, const decrement_options& options, CompletionToken&& token) const
     {
-        return core::impl::initiate_decrement_operation(
-          core_, bucket_name_, scope_name_, name_, std::move(document_id), options.build(), std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(key_value_error_context, counter_result)>(
+          [*this](auto&& handler, std::string id, decrement_options::built built_options) {
+              core::impl::initiate_decrement_operation(core_,
+                                                       bucket_name_,
+                                                       scope_name_,
+                                                       name_,
+                                                       std::move(id),
+                                                       std::move(built_options),
+                                                       std::forward<decltype(handler)>(handler));
+          },
+          token,
+          std::move(document_id),
+          options.build());
     }
 
     /**
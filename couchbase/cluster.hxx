@@ -20,6 +20,7 @@
 #include <couchbase/analytics_options.hxx>
 #include <couchbase/bucket.hxx>
 #include <couchbase/cluster_options.hxx>
+#include <couchbase/completion_token.hxx>
 #include <couchbase/query_index_manager.hxx>
 #include <couchbase/query_options.hxx>
 #include <couchbase/search_options.hxx>
@@ -54,20 +55,26 @@ class cluster
     /**
      * Connect to a Couchbase cluster.
      *
-     * @tparam Handler callable type that implements @ref cluster_connect_handler signature
+     * @tparam CompletionToken callable that implements @ref cluster_connect_handler signature, or asio completion token
      *
      * @param io IO context
      * @param connection_string connection string used to locate the Couchbase cluster object.
      * @param options options to customize connection (note, that connection_string takes precedence over this options).
-     * @param handler the handler that implements @ref cluster_connect_handler
+     * @param token the handler that implements @ref cluster_connect_handler, or asio completion token
      *
      * @since 1.0.0
      * @committed
      */
-    template<typename Handler>
-    static void connect(asio::io_context& io, const std::string& connection_string, const cluster_options& options, Handler&& handler)
+    template<typename CompletionToken>
+    static auto connect(asio::io_context& io, const std::string& connection_string, const cluster_options& options, CompletionToken&& token)
     {
-        return core::impl::initiate_cluster_connect(io, connection_string, options, std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(cluster, std::error_code)>(
+          [&io](auto&& handler, const std::string& connection, const cluster_options& connect_options) {
+              core::impl::initiate_cluster_connect(io, connection, connect_options, std::forward<decltype(handler)>(handler));
+          },
+          token,
+          connection_string,
+          options);
     }
 
     /**
@@ -129,11 +136,11 @@ class cluster
     /**
      * Performs a query against the query (N1QL) services.
      *
-     * @tparam Handler callable type that implements @ref query_handler signature
+     * @tparam CompletionToken callable that implements @ref query_handler signature, or asio completion token
      *
      * @param statement the N1QL query statement.
      * @param options options to customize the query request.
-     * @param handler the handler that implements @ref query_handler
+     * @param token the handler that implements @ref query_handler, or asio completion token
      *
      * @exception errc::common::ambiguous_timeout
      * @exception errc::common::unambiguous_timeout
@@ -141,10 +148,17 @@ class cluster
      * @since 1.0.0
      * @committed
      */
-    template<typename Handler>
-    void query(std::string statement, const query_options& options, Handler&& handler) const
+    template<typename CompletionToken>
+    auto query(std::string statement, const query_options& options, CompletionToken&& token) const
     {
-        return core::impl::initiate_query_operation(core_, std::move(statement), {}, options.build(), std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(query_error_context, query_result)>(
+          [*this](auto&& handler, std::string query_statement, query_options::built built_options) {
+              core::impl::initiate_query_operation(
+                core_, std::move(query_statement), {}, std::move(built_options), std::forward<decltype(handler)>(handler));
+          },
+          token,
+          std::move(statement),
+          options.build());
     }
 
     /**
@@ -186,6 +200,30 @@ class cluster
      */
     void search_query(std::string index_name, const search_query& query, const search_options& options, search_handler&& handler) const;
 
+    /**
+     * Performs a query against the full text search services, and streams the hits to the row handler instead of collecting them in
+     * the result, so that the memory used by the query does not grow with the number of hits.
+     *
+     * @param index_name name of the search index
+     * @param query query object, see hierarchy of @ref search_query for more details.
+     * @param options options to customize the query request.
+     * @param row_handler the handler that implements @ref search_row_handler, invoked on the IO thread for every hit
+     * @param handler the handler that implements @ref search_handler, receives the metadata and the facets, and empty list of rows
+     *
+     * @exception errc::common::ambiguous_timeout
+     * @exception errc::common::unambiguous_timeout
+     *
+     * @see https://docs.couchbase.com/server/current/fts/fts-introduction.html
+     *
+     * @since 1.0.0
+     * @volatile
+     */
+    void search_query(std::string index_name,
+                      const search_query& query,
+                      const search_options& options,
+                      search_row_handler&& row_handler,
+                      search_handler&& handler) const;
+
     /**
      * Performs a query against the full text search services.
      *
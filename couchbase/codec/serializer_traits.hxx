@@ -17,7 +17,9 @@
 
 #pragma once
 
+#include <string_view>
 #include <type_traits>
+#include <utility>
 
 namespace couchbase::codec
 {
@@ -28,4 +30,22 @@ struct is_serializer : public std::false_type {
 template<typename T>
 inline constexpr bool is_serializer_v = is_serializer<T>::value;
 
+/**
+ * Serializers might declare deserialize() overload, that accepts std::string_view, so that the documents could be decoded without
+ * copying them into codec::binary first.
+ */
+template<typename Serializer, typename Document, typename = void>
+struct is_view_deserializer : public std::false_type {
+};
+
+template<typename Serializer, typename Document>
+struct is_view_deserializer<Serializer,
+                            Document,
+                            std::void_t<decltype(Serializer::template deserialize<Document>(std::declval<std::string_view>()))>>
+  : public std::true_type {
+};
+
+template<typename Serializer, typename Document>
+inline constexpr bool is_view_deserializer_v = is_view_deserializer<Serializer, Document>::value;
+
 } // namespace couchbase::codec
@@ -23,6 +23,8 @@
 
 #include <tao/json/value.hpp>
 
+#include <string_view>
+
 namespace couchbase
 {
 #ifndef COUCHBASE_CXX_CLIENT_DOXYGEN
@@ -32,7 +34,7 @@ std::vector<std::byte>
 generate_binary(const tao::json::value& object);
 
 tao::json::value
-parse_binary(const std::vector<std::byte>& input);
+parse(std::string_view input);
 } // namespace core::utils::json
 #endif
 
@@ -55,12 +57,18 @@ class tao_json_serializer
 
     template<typename Document>
     static auto deserialize(const binary& data) -> Document
+    {
+        return deserialize<Document>(std::string_view{ reinterpret_cast<const char*>(data.data()), data.size() });
+    }
+
+    template<typename Document>
+    static auto deserialize(std::string_view data) -> Document
     {
         try {
             if constexpr (std::is_same_v<Document, tao::json::value>) {
-                return core::utils::json::parse_binary(data);
+                return core::utils::json::parse(data);
             } else {
-                return core::utils::json::parse_binary(data).as<Document>();
+                return core::utils::json::parse(data).as<Document>();
             }
         } catch (const tao::pegtl::parse_error& e) {
             throw std::system_error(errc::common::decoding_failure,
@@ -19,6 +19,7 @@
 
 #include <couchbase/binary_collection.hxx>
 #include <couchbase/codec/default_json_transcoder.hxx>
+#include <couchbase/completion_token.hxx>
 #include <couchbase/collection_query_index_manager.hxx>
 #include <couchbase/exists_options.hxx>
 #include <couchbase/expiry.hxx>
@@ -127,11 +128,11 @@ class collection
     /**
      * Fetches the full document from this collection.
      *
-     * @tparam Handler callable type that implements @ref get_handler signature
+     * @tparam CompletionToken callable that implements @ref get_handler signature, or asio completion token
      *
      * @param document_id the document id which is used to uniquely identify it.
      * @param options options to customize the get request.
-     * @param handler the handler that implements @ref get_handler
+     * @param token the handler that implements @ref get_handler, or asio completion token
      *
      * @exception errc::key_value::document_not_found the given document id is not found in the collection.
      * @exception errc::common::ambiguous_timeout
@@ -140,11 +141,22 @@ class collection
      * @since 1.0.0
      * @committed
      */
-    template<typename Handler>
-    void get(std::string document_id, const get_options& options, Handler&& handler) const
+    template<typename CompletionToken>
+    auto get(std::string document_id, const get_options& options, CompletionToken&& token) const
     {
-        return core::impl::initiate_get_operation(
-          core_, bucket_name_, scope_name_, name_, std::move(document_id), options.build(), std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(key_value_error_context, get_result)>(
+          [*this](auto&& handler, std::string id, get_options::built built_options) {
+              core::impl::initiate_get_operation(core_,
+                                                 bucket_name_,
+                                                 scope_name_,
+                                                 name_,
+                                                 std::move(id),
+                                                 std::move(built_options),
+                                                 std::forward<decltype(handler)>(handler));
+          },
+          token,
+          std::move(document_id),
+          options.build());
     }
 
     /**
@@ -175,12 +187,12 @@ class collection
     /**
      * Fetches a full document and resets its expiration time to the value provided.
      *
-     * @tparam Handler callable type that implements @ref get_and_touch_handler signature
+     * @tparam CompletionToken callable that implements @ref get_and_touch_handler signature, or asio completion token
      *
      * @param document_id the document id which is used to uniquely identify it.
      * @param duration the new expiration time for the document.
      * @param options custom options to change the default behavior.
-     * @param handler the handler that implements @ref get_and_touch_handler
+     * @param token the handler that implements @ref get_and_touch_handler, or asio completion token
      *
      * @exception errc::key_value::document_not_found the given document id is not found in the collection.
      * @exception errc::common::ambiguous_timeout
@@ -189,20 +201,27 @@ class collection
      * @since 1.0.0
      * @committed
      */
-    template<typename Handler>
-    void get_and_touch(std::string document_id,
+    template<typename CompletionToken>
+    auto get_and_touch(std::string document_id,
                        std::chrono::seconds duration,
                        const get_and_touch_options& options,
-                       Handler&& handler) const
+                       CompletionToken&& token) const
     {
-        return core::impl::initiate_get_and_touch_operation(core_,
-                                                            bucket_name_,
-                                                            scope_name_,
-                                                            name_,
-                                                            std::move(document_id),
-                                                            core::impl::expiry_relative(duration),
-                                                            options.build(),
-                                                            std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(key_value_error_context, get_result)>(
+          [*this](auto&& handler, std::string id, std::uint32_t expiry, get_and_touch_options::built built_options) {
+              core::impl::initiate_get_and_touch_operation(core_,
+                                                           bucket_name_,
+                                                           scope_name_,
+                                                           name_,
+                                                           std::move(id),
+                                                           expiry,
+                                                           std::move(built_options),
+                                                           std::forward<decltype(handler)>(handler));
+          },
+          token,
+          std::move(document_id),
+          core::impl::expiry_relative(duration),
+          options.build());
     }
 
     /**
@@ -236,12 +255,12 @@ class collection
     /**
      * Fetches a full document and resets its expiration time to the absolute value provided.
      *
-     * @tparam Handler callable type that implements @ref get_and_touch_handler signature
+     * @tparam CompletionToken callable that implements @ref get_and_touch_handler signature, or asio completion token
      *
      * @param document_id the document id which is used to uniquely identify it.
      * @param time_point the new expiration time point for the document.
      * @param options custom options to change the default behavior.
-     * @param handler the handler that implements @ref get_and_touch_handler
+     * @param token the handler that implements @ref get_and_touch_handler, or asio completion token
      *
      * @exception errc::key_value::document_not_found the given document id is not found in the collection.
      * @exception errc::common::ambiguous_timeout
@@ -250,20 +269,27 @@ class collection
      * @since 1.0.0
      * @committed
      */
-    template<typename Handler>
-    void get_and_touch(std::string document_id,
+    template<typename CompletionToken>
+    auto get_and_touch(std::string document_id,
                        std::chrono::system_clock::time_point time_point,
                        const get_and_touch_options& options,
-                       Handler&& handler) const
+                       CompletionToken&& token) const
     {
-        return core::impl::initiate_get_and_touch_operation(core_,
-                                                            bucket_name_,
-                                                            scope_name_,
-                                                            name_,
-                                                            std::move(document_id),
-                                                            core::impl::expiry_absolute(time_point),
-                                                            options.build(),
-                                                            std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(key_value_error_context, get_result)>(
+          [*this](auto&& handler, std::string id, std::uint32_t expiry, get_and_touch_options::built built_options) {
+              core::impl::initiate_get_and_touch_operation(core_,
+                                                           bucket_name_,
+                                                           scope_name_,
+                                                           name_,
+                                                           std::move(id),
+                                                           expiry,
+                                                           std::move(built_options),
+                                                           std::forward<decltype(handler)>(handler));
+          },
+          token,
+          std::move(document_id),
+          core::impl::expiry_absolute(time_point),
+          options.build());
     }
 
     /**
@@ -297,12 +323,12 @@ class collection
     /**
      * Updates the expiration a document given an id, without modifying or returning its value.
      *
-     * @tparam Handler callable type that implements @ref touch_handler signature
+     * @tparam CompletionToken callable that implements @ref touch_handler signature, or asio completion token
      *
      * @param document_id the document id which is used to uniquely identify it.
      * @param duration the new expiration time for the document.
      * @param options custom options to change the default behavior.
-     * @param handler the handler that implements @ref touch_handler
+     * @param token the handler that implements @ref touch_handler, or asio completion token
      *
      * @exception errc::key_value::document_not_found the given document id is not found in the collection.
      * @exception errc::common::ambiguous_timeout
@@ -311,17 +337,24 @@ class collection
      * @since 1.0.0
      * @committed
      */
-    template<typename Handler>
-    void touch(std::string document_id, std::chrono::seconds duration, const touch_options& options, Handler&& handler) const
+    template<typename CompletionToken>
+    auto touch(std::string document_id, std::chrono::seconds duration, const touch_options& options, CompletionToken&& token) const
     {
-        return core::impl::initiate_touch_operation(core_,
-                                                    bucket_name_,
-                                                    scope_name_,
-                                                    name_,
-                                                    std::move(document_id),
-                                                    core::impl::expiry_relative(duration),
-                                                    options.build(),
-                                                    std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(key_value_error_context, result)>(
+          [*this](auto&& handler, std::string id, std::uint32_t expiry, touch_options::built built_options) {
+              core::impl::initiate_touch_operation(core_,
+                                                   bucket_name_,
+                                                   scope_name_,
+                                                   name_,
+                                                   std::move(id),
+                                                   expiry,
+                                                   std::move(built_options),
+                                                   std::forward<decltype(handler)>(handler));
+          },
+          token,
+          std::move(document_id),
+          core::impl::expiry_relative(duration),
+          options.build());
     }
 
     /**
@@ -353,12 +386,12 @@ class collection
     /**
      * Updates the expiration a document given an id, without modifying or returning its value.
      *
-     * @tparam Handler callable type that implements @ref touch_handler signature
+     * @tparam CompletionToken callable that implements @ref touch_handler signature, or asio completion token
      *
      * @param document_id the document id which is used to uniquely identify it.
      * @param time_point the new expiration time point for the document.
      * @param options custom options to change the default behavior.
-     * @param handler the handler that implements @ref touch_handler
+     * @param token the handler that implements @ref touch_handler, or asio completion token
      *
      * @exception errc::key_value::document_not_found the given document id is not found in the collection.
      * @exception errc::common::ambiguous_timeout
@@ -367,20 +400,27 @@ class collection
      * @since 1.0.0
      * @committed
      */
-    template<typename Handler>
-    void touch(std::string document_id,
+    template<typename CompletionToken>
+    auto touch(std::string document_id,
                std::chrono::system_clock::time_point time_point,
                const touch_options& options,
-               Handler&& handler) const
+               CompletionToken&& token) const
     {
-        return core::impl::initiate_touch_operation(core_,
-                                                    bucket_name_,
-                                                    scope_name_,
-                                                    name_,
-                                                    std::move(document_id),
-                                                    core::impl::expiry_absolute(time_point),
-                                                    options.build(),
-                                                    std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(key_value_error_context, result)>(
+          [*this](auto&& handler, std::string id, std::uint32_t expiry, touch_options::built built_options) {
+              core::impl::initiate_touch_operation(core_,
+                                                   bucket_name_,
+                                                   scope_name_,
+                                                   name_,
+                                                   std::move(id),
+                                                   expiry,
+                                                   std::move(built_options),
+                                                   std::forward<decltype(handler)>(handler));
+          },
+          token,
+          std::move(document_id),
+          core::impl::expiry_absolute(time_point),
+          options.build());
     }
 
     /**
@@ -413,11 +453,11 @@ class collection
     /**
      * Reads all available replicas, and returns the first found.
      *
-     * @tparam Handler callable type that implements @ref get_any_replica_handler signature
+     * @tparam CompletionToken callable that implements @ref get_any_replica_handler signature, or asio completion token
      *
      * @param document_id the document id which is used to uniquely identify it.
      * @param options the custom options
-     * @param handler the handler that implements @ref get_any_replica_handler
+     * @param token the handler that implements @ref get_any_replica_handler, or asio completion token
      *
      * @exception errc::key_value::document_irretrievable
      *    the situation where the SDK got all responses (most likely: key not found) but none of them were successful so it
@@ -429,11 +469,22 @@ class collection
      * @since 1.0.0
      * @committed
      */
-    template<typename Handler>
-    void get_any_replica(std::string document_id, const get_any_replica_options& options, Handler&& handler) const
+    template<typename CompletionToken>
+    auto get_any_replica(std::string document_id, const get_any_replica_options& options, CompletionToken&& token) const
     {
-        return core::impl::initiate_get_any_replica_operation(
-          core_, bucket_name_, scope_name_, name_, std::move(document_id), options.build(), std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(key_value_error_context, get_replica_result)>(
+          [*this](auto&& handler, std::string id, get_any_replica_options::built built_options) {
+              core::impl::initiate_get_any_replica_operation(core_,
+                                                             bucket_name_,
+                                                             scope_name_,
+                                                             name_,
+                                                             std::move(id),
+                                                             std::move(built_options),
+                                                             std::forward<decltype(handler)>(handler));
+          },
+          token,
+          std::move(document_id),
+          options.build());
     }
 
     /**
@@ -470,11 +521,11 @@ class collection
      * @note Individual errors are ignored, so you can think of this API as a best effort
      * approach which explicitly emphasises availability over consistency.
      *
-     * @tparam Handler callable type that implements @ref get_all_replicas_handler signature
+     * @tparam CompletionToken callable that implements @ref get_all_replicas_handler signature, or asio completion token
      *
      * @param document_id the document id which is used to uniquely identify it.
      * @param options the custom options
-     * @param handler the handler that implements @ref get_all_replicas_handler
+     * @param token the handler that implements @ref get_all_replicas_handler, or asio completion token
      *
      * @exception errc::common::ambiguous_timeout
      * @exception errc::common::unambiguous_timeout
@@ -482,11 +533,22 @@ class collection
      * @since 1.0.0
      * @committed
      */
-    template<typename Handler>
-    void get_all_replicas(std::string document_id, const get_all_replicas_options& options, Handler&& handler) const
+    template<typename CompletionToken>
+    auto get_all_replicas(std::string document_id, const get_all_replicas_options& options, CompletionToken&& token) const
     {
-        return core::impl::initiate_get_all_replicas_operation(
-          core_, bucket_name_, scope_name_, name_, std::move(document_id), options.build(), std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(key_value_error_context, get_all_replicas_result)>(
+          [*this](auto&& handler, std::string id, get_all_replicas_options::built built_options) {
+              core::impl::initiate_get_all_replicas_operation(core_,
+                                                              bucket_name_,
+                                                              scope_name_,
+                                                              name_,
+                                                              std::move(id),
+                                                              std::move(built_options),
+                                                              std::forward<decltype(handler)>(handler));
+          },
+          token,
+          std::move(document_id),
+          options.build());
     }
 
     /**
@@ -521,12 +583,12 @@ class collection
      *
      * @tparam Transcoder type of the transcoder that will be used to encode the document
      * @tparam Document type of the document
-     * @tparam Handler type of the handler that implements @ref upsert_handler
+     * @tparam CompletionToken callable that implements @ref upsert_handler signature, or asio completion token
      *
      * @param document_id the document id which is used to uniquely identify it.
      * @param document the document content to upsert.
      * @param options custom options to customize the upsert behavior.
-     * @param handler callable that implements @ref upsert_handler
+     * @param token the handler that implements @ref upsert_handler, or asio completion token
      *
      * @exception errc::common::ambiguous_timeout
      * @exception errc::common::unambiguous_timeout
@@ -534,17 +596,24 @@ class collection
      * @since 1.0.0
      * @committed
      */
-    template<typename Transcoder = codec::default_json_transcoder, typename Document, typename Handler>
-    void upsert(std::string document_id, Document document, const upsert_options& options, Handler&& handler) const
+    template<typename Transcoder = codec::default_json_transcoder, typename Document, typename CompletionToken>
+    auto upsert(std::string document_id, Document document, const upsert_options& options, CompletionToken&& token) const
     {
-        return core::impl::initiate_upsert_operation(core_,
-                                                     bucket_name_,
-                                                     scope_name_,
-                                                     name_,
-                                                     std::move(document_id),
-                                                     Transcoder::encode(document),
-                                                     options.build(),
-                                                     std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(key_value_error_context, mutation_result)>(
+          [*this](auto&& handler, std::string id, codec::encoded_value encoded, upsert_options::built built_options) {
+              core::impl::initiate_upsert_operation(core_,
+                                                    bucket_name_,
+                                                    scope_name_,
+                                                    name_,
+                                                    std::move(id),
+                                                    std::move(encoded),
+                                                    std::move(built_options),
+                                                    std::forward<decltype(handler)>(handler));
+          },
+          token,
+          std::move(document_id),
+          Transcoder::encode(document),
+          options.build());
     }
 
     /**
@@ -581,12 +650,12 @@ class collection
      *
      * @tparam Transcoder type of the transcoder that will be used to encode the document
      * @tparam Document type of the document
-     * @tparam Handler type of the handler that implements @ref insert_handler
+     * @tparam CompletionToken callable that implements @ref insert_handler signature, or asio completion token
      *
      * @param document_id the document id which is used to uniquely identify it.
      * @param document the document content to insert.
      * @param options custom options to customize the insert behavior.
-     * @param handler callable that implements @ref insert_handler
+     * @param token the handler that implements @ref insert_handler, or asio completion token
      *
      * @exception errc::key_value::document_exists the given document id is already present in the collection.
      * @exception errc::common::ambiguous_timeout
@@ -595,17 +664,24 @@ class collection
      * @since 1.0.0
      * @committed
      */
-    template<typename Transcoder = codec::default_json_transcoder, typename Document, typename Handler>
-    void insert(std::string document_id, Document document, const insert_options& options, Handler&& handler) const
+    template<typename Transcoder = codec::default_json_transcoder, typename Document, typename CompletionToken>
+    auto insert(std::string document_id, Document document, const insert_options& options, CompletionToken&& token) const
     {
-        return core::impl::initiate_insert_operation(core_,
-                                                     bucket_name_,
-                                                     scope_name_,
-                                                     name_,
-                                                     std::move(document_id),
-                                                     Transcoder::encode(document),
-                                                     options.build(),
-                                                     std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(key_value_error_context, mutation_result)>(
+          [*this](auto&& handler, std::string id, codec::encoded_value encoded, insert_options::built built_options) {
+              core::impl::initiate_insert_operation(core_,
+                                                    bucket_name_,
+                                                    scope_name_,
+                                                    name_,
+                                                    std::move(id),
+                                                    std::move(encoded),
+                                                    std::move(built_options),
+                                                    std::forward<decltype(handler)>(handler));
+          },
+          token,
+          std::move(document_id),
+          Transcoder::encode(document),
+          options.build());
     }
 
     /**
@@ -643,12 +719,12 @@ class collection
      *
      * @tparam Transcoder type of the transcoder that will be used to encode the document
      * @tparam Document type of the document
-     * @tparam Handler type of the handler that implements @ref replace_handler
+     * @tparam CompletionToken callable that implements @ref replace_handler signature, or asio completion token
      *
      * @param document_id the document id which is used to uniquely identify it.
      * @param document the document content to replace.
      * @param options custom options to customize the replace behavior.
-     * @param handler callable that implements @ref replace_handler
+     * @param token the handler that implements @ref replace_handler, or asio completion token
      *
      * @exception errc::key_value::document_not_found the given document id is not found in the collection.
      * @exception errc::common::cas_mismatch if the document has been concurrently modified on the server.
@@ -658,17 +734,24 @@ class collection
      * @since 1.0.0
      * @committed
      */
-    template<typename Transcoder = codec::default_json_transcoder, typename Document, typename Handler>
-    void replace(std::string document_id, Document document, const replace_options& options, Handler&& handler) const
+    template<typename Transcoder = codec::default_json_transcoder, typename Document, typename CompletionToken>
+    auto replace(std::string document_id, Document document, const replace_options& options, CompletionToken&& token) const
     {
-        return core::impl::initiate_replace_operation(core_,
-                                                      bucket_name_,
-                                                      scope_name_,
-                                                      name_,
-                                                      std::move(document_id),
-                                                      Transcoder::encode(document),
-                                                      options.build(),
-                                                      std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(key_value_error_context, mutation_result)>(
+          [*this](auto&& handler, std::string id, codec::encoded_value encoded, replace_options::built built_options) {
+              core::impl::initiate_replace_operation(core_,
+                                                     bucket_name_,
+                                                     scope_name_,
+                                                     name_,
+                                                     std::move(id),
+                                                     std::move(encoded),
+                                                     std::move(built_options),
+                                                     std::forward<decltype(handler)>(handler));
+          },
+          token,
+          std::move(document_id),
+          Transcoder::encode(document),
+          options.build());
     }
 
     /**
@@ -705,11 +788,11 @@ class collection
     /**
      * Removes a Document from a collection.
      *
-     * @tparam Handler type of the handler that implements @ref remove_handler
+     * @tparam CompletionToken callable that implements @ref remove_handler signature, or asio completion token
      *
      * @param document_id the document id which is used to uniquely identify it.
      * @param options custom options to customize the remove behavior.
-     * @param handler callable that implements @ref remove_handler
+     * @param token the handler that implements @ref remove_handler, or asio completion token
      *
      * @exception errc::key_value::document_not_found the given document id is not found in the collection.
      * @exception errc::common::cas_mismatch if the document has been concurrently modified on the server.
@@ -719,11 +802,22 @@ class collection
      * @since 1.0.0
      * @committed
      */
-    template<typename Handler>
-    void remove(std::string document_id, const remove_options& options, Handler&& handler) const
+    template<typename CompletionToken>
+    auto remove(std::string document_id, const remove_options& options, CompletionToken&& token) const
     {
-        return core::impl::initiate_remove_operation(
-          core_, bucket_name_, scope_name_, name_, std::move(document_id), options.build(), std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(key_value_error_context, mutation_result)>(
+          [*this](auto&& handler, std::string id, remove_options::built built_options) {
+              core::impl::initiate_remove_operation(core_,
+                                                    bucket_name_,
+                                                    scope_name_,
+                                                    name_,
+                                                    std::move(id),
+                                                    std::move(built_options),
+                                                    std::forward<decltype(handler)>(handler));
+          },
+          token,
+          std::move(document_id),
+          options.build());
     }
 
     /**
@@ -755,12 +849,12 @@ class collection
     /**
      * Performs mutations to document fragments
      *
-     * @tparam Handler type of the handler that implements @ref mutate_in_handler
+     * @tparam CompletionToken callable that implements @ref mutate_in_handler signature, or asio completion token
      *
      * @param document_id the document id which is used to uniquely identify it.
      * @param specs the spec which specifies the type of mutations to perform.
      * @param options custom options to customize the mutate_in behavior.
-     * @param handler callable that implements @ref mutate_in_handler
+     * @param token the handler that implements @ref mutate_in_handler, or asio completion token
      *
      * @exception errc::key_value::document_not_found the given document id is not found in the collection.
      * @exception errc::key_value::document_exists the given document id is already present in the collection and insert is was selected.
@@ -771,11 +865,25 @@ class collection
      * @since 1.0.0
      * @committed
      */
-    template<typename Handler>
-    void mutate_in(std::string document_id, mutate_in_specs specs, const mutate_in_options& options, Handler&& handler) const
+    template<typename CompletionToken>
+    auto mutate_in(std::string document_id, mutate_in_specs specs, const mutate_in_options& options, CompletionToken&& token) const
     {
-        return core::impl::initiate_mutate_in_operation(
-          core_, bucket_name_, scope_name_, name_, std::move(document_id), specs.specs(), options.build(), std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(subdocument_error_context, mutate_in_result)>(
+          [*this](auto&& handler, std::string id, const std::vector<core::impl::subdoc::command>& commands,
+            mutate_in_options::built built_options) {
+              core::impl::initiate_mutate_in_operation(core_,
+                                                       bucket_name_,
+                                                       scope_name_,
+                                                       name_,
+                                                       std::move(id),
+                                                       commands,
+                                                       std::move(built_options),
+                                                       std::forward<decltype(handler)>(handler));
+          },
+          token,
+          std::move(document_id),
+          specs.specs(),
+          options.build());
     }
 
     /**
@@ -809,12 +917,12 @@ class collection
     /**
      * Performs lookups to document fragments with default options.
      *
-     * @tparam Handler type of the handler that implements @ref lookup_in_handler
+     * @tparam CompletionToken callable that implements @ref lookup_in_handler signature, or asio completion token
      *
      * @param document_id the outer document ID
      * @param specs an object that specifies the types of lookups to perform
      * @param options custom options to modify the lookup options
-     * @param handler callable that implements @ref lookup_in_handler
+     * @param token the handler that implements @ref lookup_in_handler, or asio completion token
      *
      * @exception errc::key_value::document_not_found the given document id is not found in the collection.
      * @exception errc::common::ambiguous_timeout
@@ -823,11 +931,25 @@ class collection
      * @since 1.0.0
      * @committed
      */
-    template<typename Handler>
-    void lookup_in(std::string document_id, lookup_in_specs specs, const lookup_in_options& options, Handler&& handler) const
+    template<typename CompletionToken>
+    auto lookup_in(std::string document_id, lookup_in_specs specs, const lookup_in_options& options, CompletionToken&& token) const
     {
-        return core::impl::initiate_lookup_in_operation(
-          core_, bucket_name_, scope_name_, name_, std::move(document_id), specs.specs(), options.build(), std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(subdocument_error_context, lookup_in_result)>(
+          [*this](auto&& handler, std::string id, const std::vector<core::impl::subdoc::command>& commands,
+            lookup_in_options::built built_options) {
+              core::impl::initiate_lookup_in_operation(core_,
+                                                       bucket_name_,
+                                                       scope_name_,
+                                                       name_,
+                                                       std::move(id),
+                                                       commands,
+                                                       std::move(built_options),
+                                                       std::forward<decltype(handler)>(handler));
+          },
+          token,
+          std::move(document_id),
+          specs.specs(),
+          options.build());
     }
 
     /**
@@ -859,24 +981,37 @@ class collection
     /**
      * Gets a document for a given id and places a pessimistic lock on it for mutations
      *
-     * @tparam Handler type of the handler that implements @ref get_and_lock_handler
+     * @tparam CompletionToken callable that implements @ref get_and_lock_handler signature, or asio completion token
      *
      * @param document_id the id of the document
      * @param lock_duration the length of time the lock will be held on the document
      * @param options the options to customize
-     * @param handler callable that implements @ref get_and_lock_handler
+     * @param token the handler that implements @ref get_and_lock_handler, or asio completion token
      *
      * @since 1.0.0
      * @committed
      */
-    template<typename Handler>
-    void get_and_lock(std::string document_id,
+    template<typename CompletionToken>
+    auto get_and_lock(std::string document_id,
                       std::chrono::seconds lock_duration,
                       const get_and_lock_options& options,
-                      Handler&& handler) const
+                      CompletionToken&& token) const
     {
-        return core::impl::initiate_get_and_lock_operation(
-          core_, bucket_name_, scope_name_, name_, std::move(document_id), lock_duration, options.build(), std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(key_value_error_context, get_result)>(
+          [*this](auto&& handler, std::string id, std::chrono::seconds lock_time, get_and_lock_options::built built_options) {
+              core::impl::initiate_get_and_lock_operation(core_,
+                                                          bucket_name_,
+                                                          scope_name_,
+                                                          name_,
+                                                          std::move(id),
+                                                          lock_time,
+                                                          std::move(built_options),
+                                                          std::forward<decltype(handler)>(handler));
+          },
+          token,
+          std::move(document_id),
+          lock_duration,
+          options.build());
     }
 
     /**
@@ -906,12 +1041,12 @@ class collection
     /**
      * Unlocks a document if it has been locked previously, with default options.
      *
-     * @tparam Handler type of the handler that implements @ref unlock_handler
+     * @tparam CompletionToken callable that implements @ref unlock_handler signature, or asio completion token
      *
      * @param document_id the id of the document
      * @param cas the CAS value which is needed to unlock it
      * @param options the options to customize
-     * @param handler callable that implements @ref unlock_handler
+     * @param token the handler that implements @ref unlock_handler, or asio completion token
      *
      * @exception errc::key_value::document_not_found the given document id is not found in the collection.
      * @exception errc::common::cas_mismatch if the document has been concurrently modified on the server.
@@ -921,11 +1056,24 @@ class collection
      * @since 1.0.0
      * @committed
      */
-    template<typename Handler>
-    void unlock(std::string document_id, couchbase::cas cas, const unlock_options& options, Handler&& handler) const
+    template<typename CompletionToken>
+    auto unlock(std::string document_id, couchbase::cas cas, const unlock_options& options, CompletionToken&& token) const
     {
-        return core::impl::initiate_unlock_operation(
-          core_, bucket_name_, scope_name_, name_, std::move(document_id), cas, options.build(), std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(key_value_error_context)>(
+          [*this](auto&& handler, std::string id, couchbase::cas expected_cas, unlock_options::built built_options) {
+              core::impl::initiate_unlock_operation(core_,
+                                                    bucket_name_,
+                                                    scope_name_,
+                                                    name_,
+                                                    std::move(id),
+                                                    expected_cas,
+                                                    std::move(built_options),
+                                                    std::forward<decltype(handler)>(handler));
+          },
+          token,
+          std::move(document_id),
+          cas,
+          options.build());
     }
 
     /**
@@ -956,11 +1104,11 @@ class collection
     /**
      * Checks if the document exists on the server.
      *
-     * @tparam Handler type of the handler that implements @ref exists_handler
+     * @tparam CompletionToken callable that implements @ref exists_handler signature, or asio completion token
      *
      * @param document_id the id of the document
      * @param options the options to customize
-     * @param handler callable that implements @ref exists_handler
+     * @param token the handler that implements @ref exists_handler, or asio completion token
      *
      * @exception errc::common::ambiguous_timeout
      * @exception errc::common::unambiguous_timeout
@@ -968,11 +1116,22 @@ class collection
      * @since 1.0.0
      * @committed
      */
-    template<typename Handler>
-    void exists(std::string document_id, const exists_options& options, Handler&& handler) const
+    template<typename CompletionToken>
+    auto exists(std::string document_id, const exists_options& options, CompletionToken&& token) const
     {
-        return core::impl::initiate_exists_operation(
-          core_, bucket_name_, scope_name_, name_, std::move(document_id), options.build(), std::forward<Handler>(handler));
+        return core::impl::initiate_with_token<CompletionToken, void(key_value_error_context, exists_result)>(
+          [*this](auto&& handler, std::string id, exists_options::built built_options) {
+              core::impl::initiate_exists_operation(core_,
+                                                    bucket_name_,
+                                                    scope_name_,
+                                                    name_,
+                                                    std::move(id),
+                                                    std::move(built_options),
+                                                    std::forward<decltype(handler)>(handler));
+          },
+          token,
+          std::move(document_id),
+          options.build());
     }
 
     /**
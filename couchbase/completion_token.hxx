@@ -0,0 +1,139 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <asio/associated_allocator.hpp>
+#include <asio/associated_executor.hpp>
+#include <asio/async_result.hpp>
+#include <asio/dispatch.hpp>
+
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#ifndef COUCHBASE_CXX_CLIENT_DOXYGEN
+namespace couchbase::core::impl
+{
+/**
+ * Completion handler together with the arguments, that is submitted to the associated executor of the handler. It exposes the
+ * associated allocator of the handler, so that the executor allocates its bookkeeping with it.
+ */
+template<typename Handler, typename... Args>
+class bound_completion
+{
+  public:
+    using allocator_type = asio::associated_allocator_t<Handler>;
+
+    template<typename... Values>
+    explicit bound_completion(std::shared_ptr<Handler> handler, Values&&... values)
+      : handler_(std::move(handler))
+      , args_(std::forward<Values>(values)...)
+    {
+    }
+
+    [[nodiscard]] auto get_allocator() const noexcept -> allocator_type
+    {
+        return asio::get_associated_allocator(*handler_);
+    }
+
+    void operator()()
+    {
+        std::apply(std::move(*handler_), std::move(args_));
+    }
+
+  private:
+    std::shared_ptr<Handler> handler_;
+    std::tuple<Args...> args_;
+};
+
+/**
+ * The operations keep their handlers in std::function, that requires copyable target. This adapter makes move-only handlers (for
+ * example, the ones created by asio::use_awaitable) copyable by placing them into the shared state, that is allocated with the
+ * associated allocator of the handler. The handler is invoked through its associated executor.
+ */
+template<typename Handler>
+class shared_completion_handler
+{
+  public:
+    explicit shared_completion_handler(Handler handler)
+      : handler_(std::allocate_shared<Handler>(asio::get_associated_allocator(handler), std::move(handler)))
+    {
+    }
+
+    template<typename... Args>
+    void operator()(Args&&... args) const
+    {
+        auto executor = asio::get_associated_executor(*handler_);
+        asio::dispatch(executor, bound_completion<Handler, std::decay_t<Args>...>(handler_, std::forward<Args>(args)...));
+    }
+
+  private:
+    std::shared_ptr<Handler> handler_;
+};
+
+/**
+ * Plain copyable callbacks without associated executor are passed to the operation as is, so that the callback-based API does not
+ * pay for completion tokens support.
+ */
+template<typename Handler>
+auto
+make_completion_handler(Handler&& handler)
+{
+    using handler_type = std::decay_t<Handler>;
+    if constexpr (std::is_copy_constructible_v<handler_type> &&
+                  std::is_same_v<asio::associated_executor_t<handler_type>, asio::system_executor>) {
+        return handler_type(std::forward<Handler>(handler));
+    } else {
+        return shared_completion_handler<handler_type>(std::forward<Handler>(handler));
+    }
+}
+
+template<typename Initiation>
+class completion_token_initiation
+{
+  public:
+    explicit completion_token_initiation(Initiation initiation)
+      : initiation_(std::move(initiation))
+    {
+    }
+
+    template<typename Handler, typename... Args>
+    void operator()(Handler&& handler, Args&&... args)
+    {
+        std::move(initiation_)(make_completion_handler(std::forward<Handler>(handler)), std::forward<Args>(args)...);
+    }
+
+  private:
+    Initiation initiation_;
+};
+
+/**
+ * Starts the operation with asio completion token (callback, asio::use_future, asio::use_awaitable, asio::deferred, etc.). The
+ * initiation receives the completion handler followed by the arguments. With lazy tokens (like asio::deferred) the arguments are
+ * stored until the operation is launched, so the initiation must not capture anything that the caller might release before that.
+ */
+template<typename CompletionToken, typename Signature, typename Initiation, typename... Args>
+auto
+initiate_with_token(Initiation&& initiation, CompletionToken& token, Args&&... args)
+{
+    return asio::async_initiate<CompletionToken, Signature>(
+      completion_token_initiation<std::decay_t<Initiation>>(std::forward<Initiation>(initiation)), token, std::forward<Args>(args)...);
+}
+} // namespace couchbase::core::impl
+#endif
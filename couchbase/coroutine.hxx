@@ -0,0 +1,252 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#if !defined(__cpp_impl_coroutine) || __cpp_impl_coroutine < 201902L
+#error "couchbase/coroutine.hxx requires C++20 coroutines support"
+#endif
+
+#include <couchbase/cluster.hxx>
+#include <couchbase/collection.hxx>
+#include <couchbase/scope.hxx>
+
+#include <coroutine>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Awaitable versions of the most common operations, for applications that use C++20 coroutines.
+ *
+ * Every operation returns an awaitable object, that starts the operation when it is awaited, and resumes the coroutine with
+ * the same pair of error context and result, that is passed to the callback-based API. Unlike the overloads that return std::future,
+ * the awaitable does not allocate shared state and does not block the thread, so a few threads can drive many concurrent operations.
+ *
+ * @code{.cpp}
+ * auto [ctx, result] = co_await couchbase::coro::get(collection, "my-document");
+ * @endcode
+ *
+ * @note the coroutine is resumed on the thread that completes the operation, which is usually the thread running the IO context of
+ * the cluster. Blocking calls after co_await will stall the IO for all operations of the cluster.
+ *
+ * @since 1.0.0
+ * @volatile
+ */
+namespace couchbase::coro
+{
+#ifndef COUCHBASE_CXX_CLIENT_DOXYGEN
+namespace detail
+{
+template<typename Context, typename Result, typename Initiator>
+class operation_awaitable
+{
+  public:
+    explicit operation_awaitable(Initiator initiator)
+      : initiator_(std::move(initiator))
+    {
+    }
+
+    [[nodiscard]] auto await_ready() const noexcept -> bool
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> continuation)
+    {
+        // The handler might resume the coroutine, and destroy this object, before the initiator returns. The initiator is moved to
+        // the stack, so that nothing but the completion slot is touched after the operation has been started.
+        auto initiator = std::move(initiator_);
+        initiator([this, continuation](Context ctx, Result result) {
+            completion_.emplace(std::move(ctx), std::move(result));
+            continuation.resume();
+        });
+    }
+
+    auto await_resume() -> std::pair<Context, Result>
+    {
+        return std::move(completion_.value());
+    }
+
+  private:
+    Initiator initiator_;
+    std::optional<std::pair<Context, Result>> completion_{};
+};
+
+template<typename Context, typename Result, typename Initiator>
+auto
+make_awaitable(Initiator&& initiator) -> operation_awaitable<Context, Result, std::decay_t<Initiator>>
+{
+    return operation_awaitable<Context, Result, std::decay_t<Initiator>>(std::forward<Initiator>(initiator));
+}
+} // namespace detail
+#endif
+
+/**
+ * Fetches the full document from the collection.
+ *
+ * @param collection the collection to read the document from. The handle is copied into the awaitable.
+ * @param document_id the document id which is used to uniquely identify it.
+ * @param options options to customize the get request.
+ * @return awaitable object that yields the error context and the result of the operation
+ *
+ * @since 1.0.0
+ * @volatile
+ */
+[[nodiscard]] inline auto
+get(const collection& collection, std::string document_id, get_options options = {})
+{
+    return detail::make_awaitable<key_value_error_context, get_result>(
+      [collection, document_id = std::move(document_id), options = std::move(options)](auto&& handler) mutable {
+          collection.get(std::move(document_id), options, std::forward<decltype(handler)>(handler));
+      });
+}
+
+/**
+ * Upserts a full document which might or might not exist yet.
+ *
+ * @tparam Transcoder type of the transcoder that will be used to encode the document
+ * @tparam Document type of the document
+ *
+ * @param collection the collection to store the document in. The handle is copied into the awaitable.
+ * @param document_id the document id which is used to uniquely identify it.
+ * @param document the document content to upsert.
+ * @param options custom options to customize the upsert behavior.
+ * @return awaitable object that yields the error context and the result of the operation
+ *
+ * @since 1.0.0
+ * @volatile
+ */
+template<typename Transcoder = codec::default_json_transcoder, typename Document>
+[[nodiscard]] auto
+upsert(const collection& collection, std::string document_id, Document document, upsert_options options = {})
+{
+    return detail::make_awaitable<key_value_error_context, mutation_result>(
+      [collection,
+       document_id = std::move(document_id),
+       document = std::move(document),
+       options = std::move(options)](auto&& handler) mutable {
+          collection.upsert<Transcoder>(
+            std::move(document_id), std::move(document), options, std::forward<decltype(handler)>(handler));
+      });
+}
+
+/**
+ * Removes a document from the collection.
+ *
+ * @param collection the collection to remove the document from. The handle is copied into the awaitable.
+ * @param document_id the document id which is used to uniquely identify it.
+ * @param options custom options to customize the remove behavior.
+ * @return awaitable object that yields the error context and the result of the operation
+ *
+ * @since 1.0.0
+ * @volatile
+ */
+[[nodiscard]] inline auto
+remove(const collection& collection, std::string document_id, remove_options options = {})
+{
+    return detail::make_awaitable<key_value_error_context, mutation_result>(
+      [collection, document_id = std::move(document_id), options = std::move(options)](auto&& handler) mutable {
+          collection.remove(std::move(document_id), options, std::forward<decltype(handler)>(handler));
+      });
+}
+
+/**
+ * Performs lookups to document fragments.
+ *
+ * @param collection the collection that contains the document. The handle is copied into the awaitable.
+ * @param document_id the outer document ID.
+ * @param specs an object that specifies the types of lookups to perform.
+ * @param options custom options to modify the lookup options.
+ * @return awaitable object that yields the error context and the result of the operation
+ *
+ * @since 1.0.0
+ * @volatile
+ */
+[[nodiscard]] inline auto
+lookup_in(const collection& collection, std::string document_id, lookup_in_specs specs, lookup_in_options options = {})
+{
+    return detail::make_awaitable<subdocument_error_context, lookup_in_result>(
+      [collection, document_id = std::move(document_id), specs = std::move(specs), options = std::move(options)](
+        auto&& handler) mutable {
+          collection.lookup_in(std::move(document_id), std::move(specs), options, std::forward<decltype(handler)>(handler));
+      });
+}
+
+/**
+ * Performs mutations to document fragments.
+ *
+ * @param collection the collection that contains the document. The handle is copied into the awaitable.
+ * @param document_id the outer document ID.
+ * @param specs an object that specifies the types of mutations to perform.
+ * @param options custom options to modify the mutation options.
+ * @return awaitable object that yields the error context and the result of the operation
+ *
+ * @since 1.0.0
+ * @volatile
+ */
+[[nodiscard]] inline auto
+mutate_in(const collection& collection, std::string document_id, mutate_in_specs specs, mutate_in_options options = {})
+{
+    return detail::make_awaitable<subdocument_error_context, mutate_in_result>(
+      [collection, document_id = std::move(document_id), specs = std::move(specs), options = std::move(options)](
+        auto&& handler) mutable {
+          collection.mutate_in(std::move(document_id), std::move(specs), options, std::forward<decltype(handler)>(handler));
+      });
+}
+
+/**
+ * Performs a query against the query (N1QL) services.
+ *
+ * @param cluster the cluster to execute the query on. The handle is copied into the awaitable.
+ * @param statement the N1QL query statement.
+ * @param options options to customize the query request.
+ * @return awaitable object that yields the error context and the result of the query
+ *
+ * @since 1.0.0
+ * @volatile
+ */
+[[nodiscard]] inline auto
+query(const cluster& cluster, std::string statement, query_options options = {})
+{
+    return detail::make_awaitable<query_error_context, query_result>(
+      [cluster, statement = std::move(statement), options = std::move(options)](auto&& handler) mutable {
+          cluster.query(std::move(statement), options, std::forward<decltype(handler)>(handler));
+      });
+}
+
+/**
+ * Performs a query against the query (N1QL) services, using the scope as the query context.
+ *
+ * @param scope the scope to execute the query on. The handle is copied into the awaitable.
+ * @param statement the N1QL query statement.
+ * @param options options to customize the query request.
+ * @return awaitable object that yields the error context and the result of the query
+ *
+ * @since 1.0.0
+ * @volatile
+ */
+[[nodiscard]] inline auto
+query(const scope& scope, std::string statement, query_options options = {})
+{
+    return detail::make_awaitable<query_error_context, query_result>(
+      [scope, statement = std::move(statement), options = std::move(options)](auto&& handler) mutable {
+          scope.query(std::move(statement), options, std::forward<decltype(handler)>(handler));
+      });
+}
+} // namespace couchbase::coro
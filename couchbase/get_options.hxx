@@ -44,6 +44,8 @@ struct get_options : public common_options<get_options> {
     struct built : public common_options<get_options>::built {
         const bool with_expiry;
         const std::vector<std::string> projections;
+        const std::optional<std::chrono::milliseconds> hedge_delay;
+        const std::optional<double> hedge_percentile;
     };
 
     static constexpr std::size_t maximum_number_of_projections{ 16U };
@@ -61,9 +63,9 @@ struct get_options : public common_options<get_options> {
     [[nodiscard]] auto build() const -> built
     {
         if (projections_.size() + (with_expiry_ ? 2 : 1) < maximum_number_of_projections) {
-            return { build_common_options(), with_expiry_, projections_ };
+            return { build_common_options(), with_expiry_, projections_, hedge_delay_, hedge_percentile_ };
         }
-        return { build_common_options(), with_expiry_, {} };
+        return { build_common_options(), with_expiry_, {}, hedge_delay_, hedge_percentile_ };
     }
 
     /**
@@ -99,9 +101,53 @@ struct get_options : public common_options<get_options> {
         return self();
     }
 
+    /**
+     * Enables hedged read. If the active node does not respond within the given delay, the document is also requested from the
+     * first replica, and the first successful response is returned. The response of the other node is discarded.
+     *
+     * This caps the tail latency when the active node stalls (for example, during garbage collection pause), without sending every
+     * read to all replicas like collection#get_any_replica() does.
+     *
+     * @note the document returned by the replica might be stale. Hedging is not applied when the expiry or projections are requested,
+     * or when the bucket does not have replicas.
+     *
+     * @param delay time to wait for the active node before sending the request to the replica.
+     * @return this options builder for chaining purposes.
+     *
+     * @since 1.0.0
+     * @volatile
+     */
+    auto hedge_after(std::chrono::milliseconds delay) -> get_options&
+    {
+        hedge_delay_ = delay;
+        hedge_percentile_.reset();
+        return self();
+    }
+
+    /**
+     * Enables hedged read (see hedge_after()) with the delay derived from the latency of the recent hedged reads from the same
+     * bucket. For example, with 95th percentile, the replica is only asked for the slowest 5% of the reads.
+     *
+     * @param percentile percentile of the active node latency, that triggers the replica read.
+     * @param initial_delay delay to use until enough latency samples have been collected.
+     * @return this options builder for chaining purposes.
+     *
+     * @since 1.0.0
+     * @volatile
+     */
+    auto hedge_after_percentile(double percentile = 95.0, std::chrono::milliseconds initial_delay = std::chrono::milliseconds{ 10 })
+      -> get_options&
+    {
+        hedge_delay_ = initial_delay;
+        hedge_percentile_ = percentile;
+        return self();
+    }
+
   private:
     bool with_expiry_{ false };
     std::vector<std::string> projections_{};
+    std::optional<std::chrono::milliseconds> hedge_delay_{};
+    std::optional<double> hedge_percentile_{};
 };
 
 /**
@@ -24,7 +24,17 @@
 #include <couchbase/key_value_status_code.hxx>
 
 #include <cstdint>
+#include <memory>
 #include <optional>
+#include <string>
+
+#ifndef COUCHBASE_CXX_CLIENT_DOXYGEN
+namespace couchbase::core::impl
+{
+struct collection_names;
+struct dispatch_endpoints;
+} // namespace couchbase::core::impl
+#endif
 
 namespace couchbase
 {
@@ -79,12 +89,31 @@ class key_value_error_context : public error_context
                             std::optional<key_value_status_code> status_code,
                             couchbase::cas cas,
                             std::optional<key_value_error_map_info> error_map_info,
+                            std::optional<key_value_extended_error_info> extended_error_info);
+
+#ifndef COUCHBASE_CXX_CLIENT_DOXYGEN
+    /**
+     * Creates error context, that shares the collection names of the document identifier and the addresses of the connection instead
+     * of copying them. Used by the library for every key/value response.
+     *
+     * @since 1.0.0
+     * @internal
+     */
+    key_value_error_context(std::error_code ec,
+                            std::shared_ptr<const core::impl::dispatch_endpoints> endpoints,
+                            std::size_t retry_attempts,
+                            std::set<retry_reason> retry_reasons,
+                            std::string id,
+                            std::shared_ptr<const core::impl::collection_names> names,
+                            std::uint32_t opaque,
+                            std::optional<key_value_status_code> status_code,
+                            couchbase::cas cas,
+                            std::optional<key_value_error_map_info> error_map_info,
                             std::optional<key_value_extended_error_info> extended_error_info)
-      : error_context{ ec, std::move(last_dispatched_to), std::move(last_dispatched_from), retry_attempts, std::move(retry_reasons) }
+      : error_context{ ec, {}, {}, retry_attempts, std::move(retry_reasons) }
       , id_{ std::move(id) }
-      , bucket_{ std::move(bucket) }
-      , scope_{ std::move(scope) }
-      , collection_{ std::move(collection) }
+      , names_{ std::move(names) }
+      , endpoints_{ std::move(endpoints) }
       , opaque_{ opaque }
       , status_code_{ status_code }
       , cas_{ cas }
@@ -92,6 +121,27 @@ class key_value_error_context : public error_context
       , extended_error_info_{ std::move(extended_error_info) }
     {
     }
+#endif
+
+    /**
+     * The hostname/ip where this request got last dispatched to.
+     *
+     * @return address encoded as a string
+     *
+     * @since 1.0.0
+     * @committed
+     */
+    [[nodiscard]] auto last_dispatched_to() const -> const std::optional<std::string>& override;
+
+    /**
+     * The hostname/ip where this request got last dispatched from.
+     *
+     * @return address encoded as a string
+     *
+     * @since 1.0.0
+     * @committed
+     */
+    [[nodiscard]] auto last_dispatched_from() const -> const std::optional<std::string>& override;
 
     /**
      * Returns identifier (key) of the document referenced in the operation.
@@ -114,10 +164,7 @@ class key_value_error_context : public error_context
      * @since 1.0.0
      * @committed
      */
-    [[nodiscard]] auto bucket() const -> const std::string&
-    {
-        return bucket_;
-    }
+    [[nodiscard]] auto bucket() const -> const std::string&;
 
     /**
      * Returns name of the scope of the document.
@@ -127,10 +174,7 @@ class key_value_error_context : public error_context
      * @since 1.0.0
      * @committed
      */
-    [[nodiscard]] auto scope() const -> const std::string&
-    {
-        return scope_;
-    }
+    [[nodiscard]] auto scope() const -> const std::string&;
 
     /**
      * Returns name of the collection of the document.
@@ -140,10 +184,7 @@ class key_value_error_context : public error_context
      * @since 1.0.0
      * @committed
      */
-    [[nodiscard]] auto collection() const -> const std::string&
-    {
-        return collection_;
-    }
+    [[nodiscard]] auto collection() const -> const std::string&;
 
     /**
      * Returns opaque number generated by the SDK and repeated by the server.
@@ -212,9 +253,8 @@ class key_value_error_context : public error_context
 
   private:
     std::string id_{};
-    std::string bucket_{};
-    std::string scope_{};
-    std::string collection_{};
+    std::shared_ptr<const core::impl::collection_names> names_{};
+    std::shared_ptr<const core::impl::dispatch_endpoints> endpoints_{};
     std::uint32_t opaque_{};
     std::optional<key_value_status_code> status_code_{};
     couchbase::cas cas_{};
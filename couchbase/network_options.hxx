@@ -72,6 +72,13 @@ class network_options
         return *this;
     }
 
+    auto io_shards(std::size_t number_of_shards, bool pin_threads = false) -> network_options&
+    {
+        io_shards_ = number_of_shards;
+        pin_io_shards_ = pin_threads;
+        return *this;
+    }
+
     auto force_ip_protocol(ip_protocol protocol) -> network_options&
     {
         ip_protocol_ = protocol;
@@ -86,6 +93,8 @@ class network_options
         std::chrono::milliseconds config_poll_interval;
         std::chrono::milliseconds idle_http_connection_timeout;
         std::optional<std::size_t> max_http_connections;
+        std::size_t io_shards;
+        bool pin_io_shards;
     };
 
     [[nodiscard]] auto build() const -> built
@@ -98,6 +107,8 @@ class network_options
             config_poll_interval_,
             idle_http_connection_timeout_,
             max_http_connections_,
+            io_shards_,
+            pin_io_shards_,
         };
     }
 
@@ -110,5 +121,7 @@ class network_options
     std::chrono::milliseconds config_poll_floor_{ default_config_poll_floor };
     std::chrono::milliseconds idle_http_connection_timeout_{ default_idle_http_connection_timeout };
     std::optional<std::size_t> max_http_connections_{};
+    std::size_t io_shards_{ 0 };
+    bool pin_io_shards_{ false };
 };
 } // namespace couchbase
@@ -22,7 +22,10 @@
 
 #include <chrono>
 #include <cinttypes>
+#include <cstddef>
+#include <memory>
 #include <optional>
+#include <string_view>
 #include <vector>
 
 namespace couchbase
@@ -49,7 +52,33 @@ class query_result
      */
     query_result(query_meta_data meta_data, std::vector<codec::binary> rows)
       : meta_data_{ std::move(meta_data) }
-      , rows_{ std::move(rows) }
+    {
+        std::size_t rows_size{ 0 };
+        for (const auto& row : rows) {
+            rows_size += row.size();
+        }
+        rows_data_.reserve(rows_size);
+        row_offsets_.reserve(rows.size() + 1);
+        row_offsets_.push_back(0);
+        for (const auto& row : rows) {
+            rows_data_.insert(rows_data_.end(), row.begin(), row.end());
+            row_offsets_.push_back(rows_data_.size());
+        }
+    }
+
+    /**
+     * All rows are stored in the single buffer, so that large results do not require allocation per row.
+     *
+     * @param rows_data concatenated rows
+     * @param row_offsets offsets of the rows in the buffer, the first element is zero, and the last element is the size of the buffer
+     *
+     * @since 1.0.0
+     * @internal
+     */
+    query_result(query_meta_data meta_data, std::vector<std::byte> rows_data, std::vector<std::size_t> row_offsets)
+      : meta_data_{ std::move(meta_data) }
+      , rows_data_{ std::move(rows_data) }
+      , row_offsets_{ std::move(row_offsets) }
     {
     }
 
@@ -67,6 +96,52 @@ class query_result
     }
 
     /**
+     * @return number of rows in the result
+     *
+     * @since 1.0.0
+     * @committed
+     */
+    [[nodiscard]] auto rows_count() const -> std::size_t
+    {
+        return row_offsets_.empty() ? 0 : row_offsets_.size() - 1;
+    }
+
+    /**
+     * Returns the row without copying it. The view is valid as long as the result object is alive.
+     *
+     * @param index index of the row, must be less than rows_count()
+     * @return JSON encoded row
+     *
+     * @since 1.0.0
+     * @committed
+     */
+    [[nodiscard]] auto row_view(std::size_t index) const -> std::string_view
+    {
+        return {
+            reinterpret_cast<const char*>(rows_data_.data()) + row_offsets_[index],
+            row_offsets_[index + 1] - row_offsets_[index],
+        };
+    }
+
+    /**
+     * @return list of query results as views into the result object
+     *
+     * @since 1.0.0
+     * @committed
+     */
+    [[nodiscard]] auto rows_as_views() const -> std::vector<std::string_view>
+    {
+        std::vector<std::string_view> rows;
+        rows.reserve(rows_count());
+        for (std::size_t i = 0; i < rows_count(); ++i) {
+            rows.emplace_back(row_view(i));
+        }
+        return rows;
+    }
+
+    /**
+     * The rows are copied into separate buffers on the first call, prefer rows_as_views() or row_view() to avoid allocations.
+     *
      * @return list of query results as binary strings
      *
      * @since 1.0.0
@@ -74,18 +149,46 @@ class query_result
      */
     [[nodiscard]] auto rows_as_binary() const -> const std::vector<codec::binary>&
     {
-        return rows_;
+        if (auto rows = std::atomic_load(&binary_rows_); rows) {
+            return *rows;
+        }
+        auto rows = std::make_shared<std::vector<codec::binary>>();
+        rows->reserve(rows_count());
+        for (std::size_t i = 0; i < rows_count(); ++i) {
+            rows->emplace_back(rows_data_.begin() + static_cast<std::ptrdiff_t>(row_offsets_[i]),
+                               rows_data_.begin() + static_cast<std::ptrdiff_t>(row_offsets_[i + 1]));
+        }
+        std::shared_ptr<const std::vector<codec::binary>> expected{};
+        std::shared_ptr<const std::vector<codec::binary>> desired{ std::move(rows) };
+        // if another thread has been faster, its copy is returned, so the reference stays valid as long as the result
+        if (std::atomic_compare_exchange_strong(&binary_rows_, &expected, desired)) {
+            return *desired;
+        }
+        return *expected;
     }
 
+    /**
+     * Decodes the rows using given serializer. If the serializer accepts std::string_view (see codec::is_view_deserializer), the rows
+     * are decoded directly from the result buffer, otherwise every row is copied into codec::binary first.
+     *
+     * @since 1.0.0
+     * @committed
+     */
     template<typename Serializer,
              typename Document = typename Serializer::document_type,
              std::enable_if_t<codec::is_serializer_v<Serializer>, bool> = true>
     [[nodiscard]] auto rows_as() const -> std::vector<Document>
     {
         std::vector<Document> rows;
-        rows.reserve(rows_.size());
-        for (const auto& row : rows_) {
-            rows.emplace_back(Serializer::template deserialize<Document>(row));
+        rows.reserve(rows_count());
+        for (std::size_t i = 0; i < rows_count(); ++i) {
+            if constexpr (codec::is_view_deserializer_v<Serializer, Document>) {
+                rows.emplace_back(Serializer::template deserialize<Document>(row_view(i)));
+            } else {
+                rows.emplace_back(Serializer::template deserialize<Document>(
+                  codec::binary{ rows_data_.begin() + static_cast<std::ptrdiff_t>(row_offsets_[i]),
+                                 rows_data_.begin() + static_cast<std::ptrdiff_t>(row_offsets_[i + 1]) }));
+            }
         }
         return rows;
     }
@@ -97,6 +200,8 @@ class query_result
 
   private:
     query_meta_data meta_data_{};
-    std::vector<codec::binary> rows_{};
+    std::vector<std::byte> rows_data_{};
+    std::vector<std::size_t> row_offsets_{};
+    mutable std::shared_ptr<const std::vector<codec::binary>> binary_rows_{};
 };
 } // namespace couchbase
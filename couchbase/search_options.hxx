@@ -506,4 +506,15 @@ struct search_options : public common_options<search_options> {
  * @uncommitted
  */
 using search_handler = std::function<void(couchbase::search_error_context, search_result)>;
+
+/**
+ * The signature for the row handler of the streaming @ref cluster#search_query() and @ref scope#search_query() operations.
+ *
+ * The handler receives the hits one by one, as soon as they arrive from the server, and returns false to stop receiving them (the
+ * metadata and the facets are still delivered to @ref search_handler).
+ *
+ * @since 1.0.0
+ * @volatile
+ */
+using search_row_handler = std::function<bool(search_row)>;
 } // namespace couchbase
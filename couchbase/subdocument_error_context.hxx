@@ -99,6 +99,31 @@ class subdocument_error_context : public key_value_error_context
     {
     }
 
+    /**
+     * Creates error context from the context of the key/value response, without copying its fields one by one.
+     *
+     * @param ctx
+     * @param ec
+     * @param first_error_path
+     * @param first_error_index
+     * @param deleted
+     *
+     * @since 1.0.0
+     * @internal
+     */
+    subdocument_error_context(key_value_error_context ctx,
+                              std::error_code ec,
+                              std::optional<std::string> first_error_path,
+                              std::optional<std::uint64_t> first_error_index,
+                              bool deleted)
+      : key_value_error_context{ std::move(ctx) }
+      , first_error_path_{ std::move(first_error_path) }
+      , first_error_index_{ first_error_index }
+      , deleted_{ deleted }
+    {
+        override_ec(ec);
+    }
+
     /**
      * Returns path of the operation that generated first error
      *
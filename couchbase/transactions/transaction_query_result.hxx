@@ -32,6 +32,11 @@ class transaction_query_result : public query_result
     {
     }
 
+    transaction_query_result(query_meta_data meta_data, std::vector<std::byte> rows_data, std::vector<std::size_t> row_offsets)
+      : query_result(std::move(meta_data), std::move(rows_data), std::move(row_offsets))
+    {
+    }
+
     transaction_query_result()
       : query_result()
     {
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 #include <list>
 
 #include <couchbase/transactions/transaction_keyspace.hxx>
@@ -107,6 +108,58 @@ class transactions_cleanup_config
         return *this;
     }
 
+    /**
+     * @brief Get number of ATRs processed concurrently by the lost attempts cleanup
+     *
+     * The lost attempts cleanup walks through the active transaction records (ATRs) of each collection in the
+     * @ref cleanup_window().  By default it examines one ATR at a time, increasing this value allows to clean up
+     * several ATRs in parallel, which shortens recovery after an outage, when many ATRs hold lost attempts.
+     *
+     * @return number of ATRs of the same collection examined at the same time.
+     */
+    [[nodiscard]] std::size_t lost_attempts_cleanup_concurrency() const
+    {
+        return lost_attempts_cleanup_concurrency_;
+    }
+
+    /**
+     * @brief Set number of ATRs processed concurrently by the lost attempts cleanup
+     *
+     * @see lost_attempts_cleanup_concurrency() for more info.
+     * @param value number of ATRs examined at the same time (zero is treated as one).
+     * @return reference to this, so calls can be chained.
+     */
+    transactions_cleanup_config& lost_attempts_cleanup_concurrency(std::size_t value)
+    {
+        lost_attempts_cleanup_concurrency_ = value;
+        return *this;
+    }
+
+    /**
+     * @brief Get upper bound of ATRs examined per second by the lost attempts cleanup
+     *
+     * The limit is applied to each collection separately, and zero means that only @ref cleanup_window() paces the cleanup.
+     *
+     * @return maximum number of ATRs per second.
+     */
+    [[nodiscard]] std::size_t lost_attempts_cleanup_rate_limit() const
+    {
+        return lost_attempts_cleanup_rate_limit_;
+    }
+
+    /**
+     * @brief Set upper bound of ATRs examined per second by the lost attempts cleanup
+     *
+     * @see lost_attempts_cleanup_rate_limit() for more info.
+     * @param atrs_per_second maximum number of ATRs per second, or zero to disable the limit.
+     * @return reference to this, so calls can be chained.
+     */
+    transactions_cleanup_config& lost_attempts_cleanup_rate_limit(std::size_t atrs_per_second)
+    {
+        lost_attempts_cleanup_rate_limit_ = atrs_per_second;
+        return *this;
+    }
+
     /**
      * @brief Add a collection to be cleaned
      *
@@ -125,12 +178,19 @@ class transactions_cleanup_config
         bool cleanup_client_attempts;
         std::chrono::milliseconds cleanup_window;
         std::list<couchbase::transactions::transaction_keyspace> collections;
+        std::size_t lost_attempts_cleanup_concurrency;
+        std::size_t lost_attempts_cleanup_rate_limit;
     };
 
     /** @private */
     [[nodiscard]] auto build() const -> built
     {
-        return { cleanup_lost_attempts_, cleanup_client_attempts_, cleanup_window_, collections_ };
+        return { cleanup_lost_attempts_,
+                 cleanup_client_attempts_,
+                 cleanup_window_,
+                 collections_,
+                 lost_attempts_cleanup_concurrency_,
+                 lost_attempts_cleanup_rate_limit_ };
     }
 
   private:
@@ -138,5 +198,7 @@ class transactions_cleanup_config
     bool cleanup_client_attempts_{ true };
     std::chrono::milliseconds cleanup_window_{ std::chrono::seconds(60) };
     std::list<couchbase::transactions::transaction_keyspace> collections_{};
+    std::size_t lost_attempts_cleanup_concurrency_{ 1 };
+    std::size_t lost_attempts_cleanup_rate_limit_{ 0 };
 };
 } // namespace couchbase::transactions
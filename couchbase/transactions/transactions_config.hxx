@@ -20,6 +20,7 @@
 #include <couchbase/transactions/transactions_query_config.hxx>
 
 #include <chrono>
+#include <cstddef>
 #include <memory>
 #include <optional>
 
@@ -210,6 +211,33 @@ class transactions_config
         return *this;
     }
 
+    /**
+     * @brief Get the number of threads, that run asynchronous transactions
+     *
+     * The logic, commit and rollback of the asynchronous transactions run on a pool of threads, which is created when the first
+     * asynchronous transaction starts. When all threads are busy, the transactions are queued. If not set, the pool has four threads
+     * per CPU core, but at least 16.
+     *
+     * @return number of threads of the pool, if set.
+     */
+    [[nodiscard]] std::optional<std::size_t> async_executor_threads() const
+    {
+        return async_executor_threads_;
+    }
+
+    /**
+     * @brief Set the number of threads, that run asynchronous transactions
+     *
+     * @see async_executor_threads()
+     * @param number_of_threads size of the pool (at least one thread will be used).
+     * @return reference to this, so calls can be chained.
+     */
+    transactions_config& async_executor_threads(std::size_t number_of_threads)
+    {
+        async_executor_threads_ = number_of_threads;
+        return *this;
+    }
+
     /** @private */
     transactions_config& test_factories(std::shared_ptr<core::transactions::attempt_context_testing_hooks> hooks,
                                         std::shared_ptr<core::transactions::cleanup_testing_hooks> cleanup_hooks)
@@ -241,6 +269,7 @@ class transactions_config
         std::optional<couchbase::transactions::transaction_keyspace> metadata_collection;
         transactions_query_config::built query_config;
         transactions_cleanup_config::built cleanup_config;
+        std::optional<std::size_t> async_executor_threads;
     };
 
     /** @internal */
@@ -255,5 +284,6 @@ class transactions_config
     std::optional<couchbase::transactions::transaction_keyspace> metadata_collection_;
     transactions_query_config query_config_{};
     transactions_cleanup_config cleanup_config_{};
+    std::optional<std::size_t> async_executor_threads_{};
 };
 } // namespace couchbase::transactions
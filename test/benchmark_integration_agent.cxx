@@ -0,0 +1,133 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "benchmark_helper_integration.hxx"
+
+#include "utils/allocation_counter.hxx"
+
+#include "core/agent_group.hxx"
+#include "core/operations/document_get.hxx"
+#include "core/operations/document_upsert.hxx"
+#include "core/protocol/datatype.hxx"
+
+#include <fmt/core.h>
+#include <tao/json.hpp>
+
+#include <future>
+
+static auto
+agent_get(couchbase::core::agent& agent, const std::string& key) -> couchbase::core::get_result
+{
+    auto barrier = std::make_shared<std::promise<std::pair<couchbase::core::get_result, std::error_code>>>();
+    auto f = barrier->get_future();
+    couchbase::core::get_options options{};
+    options.key = couchbase::core::utils::to_binary(key);
+    auto op = agent.get(std::move(options), [barrier](auto res, auto error) { barrier->set_value({ std::move(res), error }); });
+    EXPECT_SUCCESS(op);
+    auto [res, ec] = f.get();
+    REQUIRE_SUCCESS(ec);
+    return res;
+}
+
+static auto
+agent_upsert(couchbase::core::agent& agent, const std::string& key, const std::vector<std::byte>& value)
+  -> couchbase::core::upsert_result
+{
+    auto barrier = std::make_shared<std::promise<std::pair<couchbase::core::upsert_result, std::error_code>>>();
+    auto f = barrier->get_future();
+    couchbase::core::upsert_options options{};
+    options.key = couchbase::core::utils::to_binary(key);
+    options.value = value;
+    options.data_type = static_cast<std::uint8_t>(couchbase::core::protocol::datatype::json);
+    auto op = agent.upsert(std::move(options), [barrier](auto res, auto error) { barrier->set_value({ std::move(res), error }); });
+    EXPECT_SUCCESS(op);
+    auto [res, ec] = f.get();
+    REQUIRE_SUCCESS(ec);
+    return res;
+}
+
+TEST_CASE("benchmark: agent KV operations vs cluster::execute", "[benchmark]")
+{
+    test::utils::integration_test_guard integration;
+
+    test::utils::open_bucket(integration.cluster, integration.ctx.bucket);
+
+    auto ag = couchbase::core::agent_group(integration.io, { { integration.cluster } });
+    ag.open_bucket(integration.ctx.bucket);
+    auto agent = ag.get_agent(integration.ctx.bucket);
+    REQUIRE(agent.has_value());
+
+    auto key = test::utils::uniq_id("agent");
+    couchbase::core::document_id id{ integration.ctx.bucket, "_default", "_default", key };
+    const tao::json::value content = {
+        { "a", 1.0 },
+        { "b", 2.0 },
+    };
+    auto value = couchbase::core::utils::json::generate_binary(content);
+
+    {
+        auto res = agent_upsert(agent.value(), key, value);
+        REQUIRE_FALSE(res.cas.empty());
+        REQUIRE(agent_get(agent.value(), key).value == value);
+    }
+
+    BENCHMARK("cluster::execute get")
+    {
+        couchbase::core::operations::get_request req{ id };
+        auto resp = test::utils::execute(integration.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+    };
+
+    BENCHMARK("agent get")
+    {
+        return agent_get(agent.value(), key);
+    };
+
+    BENCHMARK("cluster::execute upsert")
+    {
+        couchbase::core::operations::upsert_request req{ id, value };
+        auto resp = test::utils::execute(integration.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+    };
+
+    BENCHMARK("agent upsert")
+    {
+        return agent_upsert(agent.value(), key, value);
+    };
+
+    static constexpr std::size_t iterations{ 1'000 };
+    auto execute_get = test::utils::allocations_per_operation(iterations, [&]() {
+        couchbase::core::operations::get_request req{ id };
+        auto resp = test::utils::execute(integration.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+    });
+    auto agent_get_allocations = test::utils::allocations_per_operation(iterations, [&]() { agent_get(agent.value(), key); });
+    auto execute_upsert = test::utils::allocations_per_operation(iterations, [&]() {
+        couchbase::core::operations::upsert_request req{ id, value };
+        auto resp = test::utils::execute(integration.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+    });
+    auto agent_upsert_allocations = test::utils::allocations_per_operation(iterations, [&]() { agent_upsert(agent.value(), key, value); });
+
+    // the counter is process-wide, so the allocations made on the IO thread are included as well
+    WARN(fmt::format("allocations per operation: get (cluster::execute={:.1f}, agent={:.1f}), "
+                     "upsert (cluster::execute={:.1f}, agent={:.1f})",
+                     execute_get,
+                     agent_get_allocations,
+                     execute_upsert,
+                     agent_upsert_allocations));
+}
@@ -0,0 +1,94 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "benchmark_helper_integration.hxx"
+
+#include "core/operations/document_get.hxx"
+#include "core/operations/document_upsert.hxx"
+
+#include <fmt/core.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+
+/**
+ * Throughput of concurrent gets, when the sessions are spread over 1..32 IO shards owned by the cluster. The keys are spread over all
+ * vBuckets, so every node of the cluster receives its share, and the number of sessions is the number of KV nodes.
+ */
+TEST_CASE("benchmark: KV throughput with IO shards", "[benchmark]")
+{
+    static constexpr std::size_t number_of_keys{ 1'024 };
+    static constexpr std::size_t operations_in_flight{ 4'096 };
+    static constexpr std::size_t number_of_operations{ 200'000 };
+    static constexpr std::array<std::size_t, 6> shard_counts{ 1, 2, 4, 8, 16, 32 };
+
+    std::string report{};
+    for (auto number_of_shards : shard_counts) {
+        couchbase::core::cluster_options opts{};
+        opts.io_shards = number_of_shards;
+        opts.pin_io_shards = true;
+        test::utils::integration_test_guard integration(opts);
+        test::utils::open_bucket(integration.cluster, integration.ctx.bucket);
+
+        std::vector<couchbase::core::document_id> ids;
+        ids.reserve(number_of_keys);
+        for (std::size_t i = 0; i < number_of_keys; ++i) {
+            auto& id = ids.emplace_back(integration.ctx.bucket, "_default", "_default", fmt::format("io_shards_{}", i));
+            couchbase::core::operations::upsert_request req{ id, couchbase::core::utils::to_binary(R"({"a":1.0,"b":2.0})") };
+            auto resp = test::utils::execute(integration.cluster, req);
+            REQUIRE_SUCCESS(resp.ctx.ec());
+        }
+
+        // keeps operations_in_flight requests outstanding, every completion schedules the next request
+        std::atomic_size_t started{ 0 };
+        std::atomic_size_t completed{ 0 };
+        std::atomic_size_t failed{ 0 };
+        std::promise<void> done;
+        std::function<void()> start_next = [&]() {
+            auto index = started.fetch_add(1);
+            if (index >= number_of_operations) {
+                return;
+            }
+            integration.cluster->execute(couchbase::core::operations::get_request{ ids[index % ids.size()] },
+                                         [&](couchbase::core::operations::get_response&& resp) {
+                                             if (resp.ctx.ec()) {
+                                                 ++failed;
+                                             }
+                                             if (completed.fetch_add(1) + 1 == number_of_operations) {
+                                                 done.set_value();
+                                             } else {
+                                                 start_next();
+                                             }
+                                         });
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < operations_in_flight; ++i) {
+            start_next();
+        }
+        done.get_future().wait();
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+        REQUIRE(failed == 0);
+
+        auto throughput = static_cast<double>(number_of_operations) / elapsed.count();
+        report += fmt::format("\n  shards={:>2}: {:.0f} ops/s", number_of_shards, throughput);
+    }
+    WARN(fmt::format("{} gets with {} in flight:{}", number_of_operations, operations_in_flight, report));
+}
@@ -0,0 +1,93 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "benchmark_helper_integration.hxx"
+
+#include "core/transactions.hxx"
+
+#include <catch2/generators/catch_generators.hpp>
+#include <fmt/core.h>
+#include <tao/json.hpp>
+
+#include <future>
+
+TEST_CASE("benchmark: commit transaction", "[benchmark]")
+{
+    test::utils::integration_test_guard integration;
+
+    test::utils::open_bucket(integration.cluster, integration.ctx.bucket);
+
+    couchbase::transactions::transactions_config cfg{};
+    // large transactions stage their documents one by one, so they need more time than the default
+    cfg.expiration_time(std::chrono::minutes(5));
+    couchbase::core::transactions::transactions txn(integration.cluster, cfg);
+
+    const tao::json::value content = {
+        { "a", 1.0 },
+        { "b", 2.0 },
+    };
+
+    auto number_of_documents = GENERATE(as<std::size_t>{}, 1, 10, 100, 500, 1'000, 10'000);
+
+    BENCHMARK(fmt::format("commit {} inserts", number_of_documents))
+    {
+        txn.run([&](couchbase::core::transactions::attempt_context& ctx) {
+            for (std::size_t i = 0; i < number_of_documents; ++i) {
+                ctx.insert(couchbase::core::document_id{ integration.ctx.bucket, "_default", "_default", test::utils::uniq_id("txn") },
+                           content);
+            }
+        });
+    };
+}
+
+TEST_CASE("benchmark: concurrent asynchronous transactions", "[benchmark]")
+{
+    test::utils::integration_test_guard integration;
+
+    test::utils::open_bucket(integration.cluster, integration.ctx.bucket);
+
+    couchbase::transactions::transactions_config cfg{};
+    cfg.expiration_time(std::chrono::seconds(60));
+    couchbase::core::transactions::transactions txn(integration.cluster, cfg);
+
+    const tao::json::value content = {
+        { "a", 1.0 },
+        { "b", 2.0 },
+    };
+
+    auto number_of_transactions = GENERATE(as<std::size_t>{}, 100, 1'000, 5'000);
+
+    BENCHMARK(fmt::format("run {} transactions", number_of_transactions))
+    {
+        std::vector<std::future<void>> futures;
+        futures.reserve(number_of_transactions);
+        for (std::size_t i = 0; i < number_of_transactions; ++i) {
+            auto barrier = std::make_shared<std::promise<void>>();
+            futures.emplace_back(barrier->get_future());
+            couchbase::core::document_id id{ integration.ctx.bucket, "_default", "_default", test::utils::uniq_id("txn") };
+            txn.run(
+              [id, &content](couchbase::core::transactions::async_attempt_context& ctx) {
+                  ctx.insert(id, content, [](std::exception_ptr, std::optional<couchbase::core::transactions::transaction_get_result>) {});
+              },
+              [barrier](std::optional<couchbase::core::transactions::transaction_exception>,
+                        std::optional<couchbase::transactions::transaction_result>) { barrier->set_value(); });
+        }
+        for (auto& f : futures) {
+            f.get();
+        }
+    };
+}
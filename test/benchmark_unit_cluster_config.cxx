@@ -0,0 +1,80 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "core/protocol/cmd_get_cluster_config.hxx"
+#include "core/topology/configuration.hxx"
+#include "core/utils/json.hxx"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+TEST_CASE("benchmark: parse cluster configuration", "[benchmark]")
+{
+    // three nodes, 1024 vBuckets with one replica, as returned by the server for travel-sample bucket
+    const auto input = test::utils::read_test_data("cluster_config_travel_sample.json");
+    REQUIRE_FALSE(input.empty());
+
+    auto config = couchbase::core::protocol::parse_config(input, "192.168.106.128", 11210);
+    REQUIRE(config.nodes.size() == 3);
+    REQUIRE(config.vbmap.has_value());
+    REQUIRE(config.vbmap->size() == 1024);
+
+    BENCHMARK("utils::json::parse")
+    {
+        return couchbase::core::utils::json::parse(input);
+    };
+
+    BENCHMARK("protocol::parse_config")
+    {
+        return couchbase::core::protocol::parse_config(input, "192.168.106.128", 11210);
+    };
+}
+
+TEST_CASE("benchmark: map key to vBucket", "[benchmark]")
+{
+    const auto input = test::utils::read_test_data("cluster_config_travel_sample.json");
+    REQUIRE_FALSE(input.empty());
+    auto config = couchbase::core::protocol::parse_config(input, "192.168.106.128", 11210);
+
+    std::vector<std::string> keys{};
+    keys.reserve(1'000);
+    for (std::size_t i = 0; i < 1'000; ++i) {
+        keys.emplace_back(fmt::format("airline_{}", i));
+    }
+    auto [vbucket, server] = config.map_key(keys.front(), 0);
+    REQUIRE(vbucket < 1024);
+    REQUIRE(server.has_value());
+
+    BENCHMARK("map 1000 keys to active node")
+    {
+        std::size_t checksum{ 0 };
+        for (const auto& key : keys) {
+            checksum += config.map_key(key, 0).first;
+        }
+        return checksum;
+    };
+
+    BENCHMARK("map 1000 keys to replica node")
+    {
+        std::size_t checksum{ 0 };
+        for (const auto& key : keys) {
+            checksum += config.map_key(key, 1).second.value_or(0);
+        }
+        return checksum;
+    };
+}
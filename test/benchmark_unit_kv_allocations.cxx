@@ -0,0 +1,61 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "utils/allocation_counter.hxx"
+#include "utils/mock_test_guard.hxx"
+
+#include "core/operations/document_get.hxx"
+
+#include <couchbase/cluster.hxx>
+
+#include <fmt/core.h>
+
+/**
+ * Counts heap allocations of the successful get. The counter is process-wide, so the allocations made by the IO thread and by the
+ * mock server are included as well, and the numbers are only meaningful when compared between revisions.
+ */
+TEST_CASE("benchmark: allocations per successful get", "[benchmark]")
+{
+    test::utils::mock_test_guard mock;
+
+    // keys and names longer than the small string buffer, so that every copy of them would be visible in the counter
+    const std::string key{ "allocations-per-successful-get" };
+    couchbase::core::document_id id{ mock.server.bucket_name(), "_default", "_default", key };
+    mock.server.upsert_document(key, R"({"a":1.0,"b":2.0})");
+    auto collection = couchbase::cluster(mock.cluster).bucket(mock.server.bucket_name()).default_collection();
+
+    static constexpr std::size_t iterations{ 1'000 };
+    auto core_get = test::utils::allocations_per_operation(iterations, [&]() {
+        auto resp = test::utils::execute(mock.cluster, couchbase::core::operations::get_request{ id });
+        REQUIRE_SUCCESS(resp.ctx.ec());
+    });
+    auto public_get = test::utils::allocations_per_operation(iterations, [&]() {
+        auto [ctx, result] = collection.get(key, {}).get();
+        REQUIRE_SUCCESS(ctx.ec());
+    });
+    auto document_id = test::utils::allocations_per_operation(iterations, [&]() {
+        couchbase::core::document_id copy{ mock.server.bucket_name(), "_default", "_default", key };
+        return copy.collection_path().size();
+    });
+
+    WARN(fmt::format("allocations per operation: get (cluster::execute={:.1f}, collection::get={:.1f}), document_id={:.1f}",
+                     core_get,
+                     public_get,
+                     document_id));
+}
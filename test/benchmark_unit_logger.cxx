@@ -0,0 +1,63 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "core/logger/configuration.hxx"
+#include "core/logger/logger.hxx"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <fmt/chrono.h>
+#include <spdlog/sinks/null_sink.h>
+
+#include <thread>
+#include <vector>
+
+TEST_CASE("benchmark: log calls from 8 threads", "[benchmark]")
+{
+    constexpr std::size_t number_of_threads{ 8 };
+    constexpr std::size_t calls_per_thread{ 10'000 };
+
+    auto deferred = GENERATE(false, true);
+
+    couchbase::core::logger::configuration configuration{};
+    configuration.sink = std::make_shared<spdlog::sinks::null_sink_mt>();
+    configuration.console = false;
+    configuration.log_level = couchbase::core::logger::level::trace;
+    configuration.deferred_formatting = deferred;
+    REQUIRE_FALSE(couchbase::core::logger::create_file_logger(configuration).has_value());
+
+    BENCHMARK(fmt::format("{} x {} calls, {} formatting", number_of_threads, calls_per_thread, deferred ? "deferred" : "eager"))
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(number_of_threads);
+        for (std::size_t t = 0; t < number_of_threads; ++t) {
+            threads.emplace_back([t]() {
+                for (std::size_t i = 0; i < calls_per_thread; ++i) {
+                    CB_LOG_TRACE("[{}/{}] thread={}, call={}, elapsed={}", "session", "bucket", t, i, std::chrono::microseconds(i));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    };
+
+    couchbase::core::logger::shutdown();
+}
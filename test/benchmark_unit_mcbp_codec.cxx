@@ -0,0 +1,196 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "core/io/mcbp_parser.hxx"
+#include "core/mcbp/codec.hxx"
+#include "core/protocol/client_request.hxx"
+#include "core/protocol/cmd_upsert.hxx"
+#include "core/utils/binary.hxx"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <cstring>
+
+namespace
+{
+couchbase::core::mcbp::packet
+make_upsert_packet()
+{
+    couchbase::core::mcbp::packet packet{};
+    packet.magic_ = couchbase::core::protocol::magic::client_request;
+    packet.command_ = couchbase::core::protocol::client_opcode::upsert;
+    packet.datatype_ = std::byte{ 0x01 };
+    packet.vbucket_ = 115;
+    packet.opaque_ = 0xdeadbeef;
+    packet.collection_id_ = 0x1234;
+    packet.key_ = couchbase::core::utils::to_binary("document-000000000042");
+    packet.extras_.resize(8);
+    packet.value_ = couchbase::core::utils::to_binary(fmt::format(R"({{"payload":"{}"}})", std::string(256, 'x')));
+    packet.durability_level_frame_ = couchbase::core::mcbp::durability_level_frame{ couchbase::core::mcbp::durability_level::majority };
+    return packet;
+}
+
+/**
+ * Response to GET with JSON value and flags in extras, as it comes from the socket.
+ */
+std::vector<std::byte>
+make_get_response_frame(std::uint32_t opaque, std::string_view value)
+{
+    static constexpr std::size_t extras_size{ 4 };
+    std::vector<std::byte> frame(couchbase::core::protocol::header_size + extras_size + value.size());
+    frame[0] = static_cast<std::byte>(couchbase::core::protocol::magic::client_response);
+    frame[1] = static_cast<std::byte>(couchbase::core::protocol::client_opcode::get);
+    frame[4] = static_cast<std::byte>(extras_size);
+    frame[5] = std::byte{ 0x01 };
+    auto body_size = static_cast<std::uint32_t>(extras_size + value.size());
+    frame[8] = static_cast<std::byte>(body_size >> 24U);
+    frame[9] = static_cast<std::byte>(body_size >> 16U);
+    frame[10] = static_cast<std::byte>(body_size >> 8U);
+    frame[11] = static_cast<std::byte>(body_size);
+    std::memcpy(frame.data() + 12, &opaque, sizeof(opaque));
+    frame[16] = std::byte{ 0x16 };
+    frame[23] = std::byte{ 0x42 };
+    std::memcpy(frame.data() + couchbase::core::protocol::header_size + extras_size, value.data(), value.size());
+    return frame;
+}
+} // namespace
+
+TEST_CASE("benchmark: encode MCBP packet", "[benchmark]")
+{
+    couchbase::core::mcbp::codec codec{ {
+      couchbase::core::protocol::hello_feature::collections,
+      couchbase::core::protocol::hello_feature::alt_request_support,
+      couchbase::core::protocol::hello_feature::sync_replication,
+    } };
+    auto packet = make_upsert_packet();
+
+    auto encoded = codec.encode_packet(packet);
+    REQUIRE(encoded.has_value());
+    auto [decoded, size, ec] = codec.decode_packet(encoded.value());
+    REQUIRE_FALSE(ec);
+    REQUIRE(size == encoded->size());
+    REQUIRE(decoded.magic_ == couchbase::core::protocol::magic::alt_client_request);
+    REQUIRE(decoded.collection_id_ == packet.collection_id_);
+    REQUIRE(decoded.key_ == packet.key_);
+    REQUIRE(decoded.extras_ == packet.extras_);
+    REQUIRE(decoded.value_ == packet.value_);
+    REQUIRE(decoded.durability_level_frame_.has_value());
+
+    std::vector<std::byte> buffer{};
+    REQUIRE_FALSE(codec.encode_packet(packet, buffer));
+    REQUIRE(buffer == encoded.value());
+
+    BENCHMARK("encode into new vector")
+    {
+        return codec.encode_packet(packet);
+    };
+
+    BENCHMARK("encode into reused buffer")
+    {
+        buffer.clear();
+        return codec.encode_packet(packet, buffer);
+    };
+}
+
+TEST_CASE("benchmark: parse MCBP responses", "[benchmark]")
+{
+    static constexpr std::uint32_t number_of_frames{ 64 };
+    const auto value = fmt::format(R"({{"payload":"{}"}})", std::string(256, 'x'));
+
+    std::vector<std::byte> stream{};
+    for (std::uint32_t opaque = 0; opaque < number_of_frames; ++opaque) {
+        auto frame = make_get_response_frame(opaque, value);
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+
+    couchbase::core::io::mcbp_parser parser;
+    couchbase::core::io::mcbp_message msg{};
+    parser.feed(stream.begin(), stream.end());
+    for (std::uint32_t opaque = 0; opaque < number_of_frames; ++opaque) {
+        REQUIRE(parser.next(msg) == couchbase::core::io::mcbp_parser::result::ok);
+        REQUIRE(msg.header.opaque == opaque);
+        REQUIRE(msg.body.size() == 4 + value.size());
+    }
+    REQUIRE(parser.next(msg) == couchbase::core::io::mcbp_parser::result::need_data);
+
+    BENCHMARK("parse 64 GET responses from single read")
+    {
+        parser.feed(stream.begin(), stream.end());
+        std::size_t parsed{ 0 };
+        while (parser.next(msg) == couchbase::core::io::mcbp_parser::result::ok) {
+            ++parsed;
+        }
+        return parsed;
+    };
+
+    const auto half = static_cast<std::ptrdiff_t>(stream.size() / 2 + 7);
+    BENCHMARK("parse 64 GET responses split across two reads")
+    {
+        std::size_t parsed{ 0 };
+        parser.feed(stream.begin(), stream.begin() + half);
+        while (parser.next(msg) == couchbase::core::io::mcbp_parser::result::ok) {
+            ++parsed;
+        }
+        parser.feed(stream.begin() + half, stream.end());
+        while (parser.next(msg) == couchbase::core::io::mcbp_parser::result::ok) {
+            ++parsed;
+        }
+        return parsed;
+    };
+}
+
+TEST_CASE("benchmark: encode MCBP upsert request", "[benchmark]")
+{
+    couchbase::core::document_id id{ "default", "_default", "_default", "document-000000000042" };
+    const auto small_value = couchbase::core::utils::to_binary(R"({"a":1.0,"b":2.0})");
+    const auto large_value = couchbase::core::utils::to_binary(fmt::format(R"({{"payload":"{}"}})", std::string(16 * 1024, 'x')));
+
+    auto make_request = [&id](const std::vector<std::byte>& value) {
+        couchbase::core::protocol::client_request<couchbase::core::protocol::upsert_request_body> req;
+        req.opaque(0xdeadbeef);
+        req.partition(115);
+        req.body().id(id);
+        req.body().content(value);
+        req.body().flags(0x02000006);
+        return req;
+    };
+
+    couchbase::core::protocol::compression_config compression{};
+    compression.enabled = true;
+
+    auto small = make_request(small_value);
+    REQUIRE(small.data().size() == couchbase::core::protocol::header_size + small.body().size());
+    auto large = make_request(large_value);
+    REQUIRE(large.data(compression).size() < couchbase::core::protocol::header_size + large_value.size());
+
+    BENCHMARK("small document")
+    {
+        return small.data();
+    };
+
+    BENCHMARK("16KiB document")
+    {
+        return large.data();
+    };
+
+    BENCHMARK("16KiB document with compression")
+    {
+        return large.data(compression);
+    };
+}
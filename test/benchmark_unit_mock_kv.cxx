@@ -0,0 +1,134 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "utils/mock_test_guard.hxx"
+
+#include "core/operations/document_get.hxx"
+#include "core/operations/document_query.hxx"
+#include "core/operations/document_upsert.hxx"
+
+#include "core/protocol/client_opcode.hxx"
+
+#include <couchbase/cluster.hxx>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <future>
+
+/**
+ * Measures client-side overhead of the operations. The server runs in the same process without latency, so the numbers do not
+ * depend on the network or on the cluster load.
+ */
+TEST_CASE("benchmark: KV operations against mock server", "[benchmark]")
+{
+    test::utils::mock_test_guard mock;
+
+    couchbase::core::document_id id{ mock.server.bucket_name(), "_default", "_default", "benchmark" };
+    const auto value = couchbase::core::utils::to_binary(R"({"a":1.0,"b":2.0})");
+    {
+        auto resp = test::utils::execute(mock.cluster, couchbase::core::operations::upsert_request{ id, value });
+        REQUIRE_SUCCESS(resp.ctx.ec());
+    }
+
+    BENCHMARK("get")
+    {
+        return test::utils::execute(mock.cluster, couchbase::core::operations::get_request{ id });
+    };
+
+    BENCHMARK("upsert")
+    {
+        return test::utils::execute(mock.cluster, couchbase::core::operations::upsert_request{ id, value });
+    };
+
+    BENCHMARK("query")
+    {
+        return test::utils::execute(mock.cluster, couchbase::core::operations::query_request{ "SELECT 1" });
+    };
+
+    static constexpr std::size_t batch_size{ 1'000 };
+    BENCHMARK("1000 concurrent gets")
+    {
+        std::vector<std::future<couchbase::core::operations::get_response>> futures;
+        futures.reserve(batch_size);
+        for (std::size_t i = 0; i < batch_size; ++i) {
+            auto barrier = std::make_shared<std::promise<couchbase::core::operations::get_response>>();
+            futures.emplace_back(barrier->get_future());
+            mock.cluster->execute(couchbase::core::operations::get_request{ id },
+                                  [barrier](couchbase::core::operations::get_response&& resp) { barrier->set_value(std::move(resp)); });
+        }
+        for (auto& future : futures) {
+            future.get();
+        }
+    };
+}
+
+/**
+ * Legacy durability (persist_to/replicate_to) polls the vBucket state with observe_seqno. The mock reports the mutation as
+ * replicated after 2ms, so the latency shows how quickly the poller notices it.
+ */
+TEST_CASE("benchmark: legacy durability against mock server", "[benchmark]")
+{
+    test::utils::mock_server_options options{};
+    options.number_of_vbuckets = 1; // all keys share the vBucket, so the concurrent probes could be coalesced
+    options.number_of_replicas = 1;
+    options.replication_delay = std::chrono::milliseconds{ 2 };
+    test::utils::mock_test_guard mock(options);
+
+    auto collection = couchbase::cluster(mock.cluster).bucket(mock.server.bucket_name()).default_collection();
+    auto upsert_options = couchbase::upsert_options{}.durability(couchbase::persist_to::active, couchbase::replicate_to::one);
+    const tao::json::value value{ { "a", 1.0 }, { "b", 2.0 } };
+    const auto observe_seqno = static_cast<std::uint8_t>(couchbase::core::protocol::client_opcode::observe_seqno);
+
+    {
+        auto [ctx, result] = collection.upsert("durable", value, upsert_options).get();
+        REQUIRE_SUCCESS(ctx.ec());
+    }
+
+    BENCHMARK("upsert with persist_to::active and replicate_to::one")
+    {
+        auto [ctx, result] = collection.upsert("durable", value, upsert_options).get();
+        return ctx.ec();
+    };
+
+    static constexpr std::size_t batch_size{ 100 };
+    auto concurrent_upserts = [&]() {
+        std::vector<std::future<std::pair<couchbase::key_value_error_context, couchbase::mutation_result>>> futures;
+        futures.reserve(batch_size);
+        for (std::size_t i = 0; i < batch_size; ++i) {
+            futures.emplace_back(collection.upsert(fmt::format("durable_{}", i), value, upsert_options));
+        }
+        for (auto& future : futures) {
+            auto [ctx, result] = future.get();
+            REQUIRE_SUCCESS(ctx.ec());
+        }
+    };
+
+    auto probes_before = mock.server.number_of_requests(observe_seqno);
+    concurrent_upserts();
+    auto probes = mock.server.number_of_requests(observe_seqno) - probes_before;
+    WARN(fmt::format("{} concurrent durable upserts sent {} observe_seqno requests ({:.2f} per mutation)",
+                     batch_size,
+                     probes,
+                     static_cast<double>(probes) / static_cast<double>(batch_size)));
+
+    BENCHMARK("100 concurrent upserts with persist_to::active and replicate_to::one")
+    {
+        concurrent_upserts();
+    };
+}
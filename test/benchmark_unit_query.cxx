@@ -0,0 +1,206 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "utils/mock_test_guard.hxx"
+
+#include "core/cluster_options.hxx"
+#include "core/io/http_context.hxx"
+#include "core/io/http_message.hxx"
+#include "core/io/query_cache.hxx"
+#include "core/operations/document_query.hxx"
+#include "core/topology/configuration.hxx"
+#include "core/utils/json_streaming_lexer.hxx"
+
+#include <couchbase/cluster.hxx>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+std::string
+make_query_response_body(std::size_t number_of_rows)
+{
+    std::string body =
+      R"({"requestID": "9739203f-9cd5-45cd-8e3a-31c27407d66a", "clientContextID": "2067c2c25c32545c", "signature": {"*":"*"}, "results": [)";
+    for (std::size_t i = 0; i < number_of_rows; ++i) {
+        if (i > 0) {
+            body += ",";
+        }
+        body += fmt::format(
+          R"({{"travel-sample":{{"id":{},"type":"airline","name":"Airline {}","iata":"A{}","icao":"AIR{}","callsign":"CALL{}","country":"United States","geo":{{"lat":37.7825,"lon":-122.393}}}}}})",
+          i,
+          i,
+          i,
+          i,
+          i);
+    }
+    body += fmt::format(
+      R"(], "status": "success", "metrics": {{"elapsedTime": "1.284307ms","executionTime": "1.231972ms","resultCount": {},"resultSize": {},"serviceLoad": 3}} }})",
+      number_of_rows,
+      body.size());
+    return body;
+}
+
+/**
+ * @return peak resident set size of the process in kilobytes, or zero if it is not supported on the platform
+ */
+std::size_t
+peak_rss_kb()
+{
+#ifdef _WIN32
+    return 0;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<std::size_t>(usage.ru_maxrss) / 1024;
+#else
+    return static_cast<std::size_t>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+std::size_t
+lex_rows(const std::vector<std::string_view>& chunks)
+{
+    std::size_t rows{ 0 };
+    couchbase::core::utils::json::streaming_lexer lexer("/results/^", 4);
+    lexer.on_row([&rows](std::string&& /* row */) {
+        ++rows;
+        return couchbase::core::utils::json::stream_control::next_row;
+    });
+    lexer.on_complete([](std::error_code /* ec */, std::size_t /* number_of_rows */, std::string&& /* meta */) {});
+    for (const auto& chunk : chunks) {
+        lexer.feed(chunk);
+    }
+    return rows;
+}
+} // namespace
+
+TEST_CASE("benchmark: encode query request", "[benchmark]")
+{
+    couchbase::core::topology::configuration config{};
+    couchbase::core::query_cache query_cache{};
+    couchbase::core::cluster_options cluster_options{};
+    couchbase::core::http_context ctx{ config, cluster_options, query_cache, "192.168.106.128", 8093 };
+
+    couchbase::core::io::http_request encoded{};
+    encoded.client_context_id = "2067c2c25c32545c";
+    encoded.timeout = std::chrono::milliseconds{ 75'000 };
+
+    {
+        couchbase::core::operations::query_request req{ R"(SELECT * FROM `travel-sample` WHERE type = "airline")" };
+        REQUIRE_SUCCESS(req.encode_to(encoded, ctx));
+        REQUIRE(encoded.method == "POST");
+        REQUIRE(encoded.path == "/query/service");
+    }
+
+    BENCHMARK("ad-hoc statement")
+    {
+        couchbase::core::operations::query_request req{ R"(SELECT * FROM `travel-sample` WHERE type = "airline")" };
+        auto ec = req.encode_to(encoded, ctx);
+        return std::make_pair(ec, encoded.body.size());
+    };
+
+    BENCHMARK("statement with parameters and consistency")
+    {
+        couchbase::core::operations::query_request req{ "SELECT * FROM `travel-sample` WHERE type = $type AND country = $country" };
+        req.named_parameters["type"] = couchbase::core::json_string{ R"("airline")" };
+        req.named_parameters["country"] = couchbase::core::json_string{ R"("United States")" };
+        req.scan_consistency = couchbase::query_scan_consistency::request_plus;
+        req.query_context = "default:`travel-sample`.`inventory`";
+        req.readonly = true;
+        auto ec = req.encode_to(encoded, ctx);
+        return std::make_pair(ec, encoded.body.size());
+    };
+}
+
+TEST_CASE("benchmark: stream query rows", "[benchmark]")
+{
+    static constexpr std::size_t number_of_rows{ 100 };
+    const auto body = make_query_response_body(number_of_rows);
+
+    std::vector<std::string_view> single_chunk{ body };
+    std::vector<std::string_view> small_chunks{};
+    static constexpr std::size_t chunk_size{ 1'024 };
+    for (std::size_t offset = 0; offset < body.size(); offset += chunk_size) {
+        small_chunks.emplace_back(std::string_view{ body }.substr(offset, chunk_size));
+    }
+
+    REQUIRE(lex_rows(single_chunk) == number_of_rows);
+    REQUIRE(lex_rows(small_chunks) == number_of_rows);
+
+    BENCHMARK("100 rows in single chunk")
+    {
+        return lex_rows(single_chunk);
+    };
+
+    BENCHMARK("100 rows in 1KiB chunks")
+    {
+        return lex_rows(small_chunks);
+    };
+}
+
+TEST_CASE("benchmark: large query result", "[benchmark]")
+{
+    static constexpr std::size_t number_of_rows{ 100'000 };
+
+    test::utils::mock_server_options options{};
+    options.query_rows.clear();
+    options.query_rows.reserve(number_of_rows);
+    for (std::size_t i = 0; i < number_of_rows; ++i) {
+        options.query_rows.emplace_back(fmt::format(R"({{"id":{},"type":"airline","name":"Airline {}","country":"United States"}})", i, i));
+    }
+    test::utils::mock_test_guard mock(options);
+    auto cluster = couchbase::cluster(mock.cluster);
+
+    {
+        // warm up connections, so that only the result itself contributes to the peak RSS
+        auto [ctx, result] = cluster.query("SELECT 1", {}).get();
+        REQUIRE_SUCCESS(ctx.ec());
+    }
+
+    auto rss_before = peak_rss_kb();
+    {
+        auto [ctx, result] = cluster.query("SELECT * FROM `travel-sample` WHERE type = 'airline'", {}).get();
+        REQUIRE_SUCCESS(ctx.ec());
+        REQUIRE(result.rows_count() == number_of_rows);
+        REQUIRE(result.row_view(number_of_rows - 1) == options.query_rows.back());
+    }
+    auto rss_after = peak_rss_kb();
+
+    // the mock server lives in the same process, so the growth includes its response buffer as well
+    WARN(fmt::format("peak RSS growth for {} rows: {} KiB (before={} KiB, after={} KiB)",
+                     number_of_rows,
+                     rss_after - rss_before,
+                     rss_before,
+                     rss_after));
+
+    BENCHMARK("query 100000 rows")
+    {
+        auto [ctx, result] = cluster.query("SELECT * FROM `travel-sample` WHERE type = 'airline'", {}).get();
+        return result.rows_count();
+    };
+}
@@ -0,0 +1,120 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "core/crud_component.hxx"
+#include "core/protocol/datatype.hxx"
+#include "core/utils/unsigned_leb128.hxx"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <snappy.h>
+
+#include <vector>
+
+namespace
+{
+void
+append_uint(std::vector<std::byte>& payload, std::uint64_t value, std::size_t size)
+{
+    for (std::size_t i = size; i > 0; --i) {
+        payload.push_back(static_cast<std::byte>(value >> (8 * (i - 1))));
+    }
+}
+
+void
+append_leb128_prefixed(std::vector<std::byte>& payload, const std::string& data)
+{
+    couchbase::core::utils::unsigned_leb128<std::size_t> length(data.size());
+    payload.insert(payload.end(), length.begin(), length.end());
+    for (auto ch : data) {
+        payload.push_back(static_cast<std::byte>(ch));
+    }
+}
+
+/**
+ * Builds the payload of range_scan_continue response, that carries documents
+ */
+std::vector<std::byte>
+make_documents_payload(std::size_t number_of_documents, std::size_t value_size, bool compressed)
+{
+    std::vector<std::byte> payload;
+    for (std::size_t i = 0; i < number_of_documents; ++i) {
+        std::string value = fmt::format(R"({{"id":{},"payload":"{}"}})", i, std::string(value_size, 'x'));
+        auto datatype = static_cast<std::uint8_t>(couchbase::core::protocol::datatype::json);
+        if (compressed) {
+            std::string output;
+            snappy::Compress(value.data(), value.size(), &output);
+            value = std::move(output);
+            datatype |= static_cast<std::uint8_t>(couchbase::core::protocol::datatype::snappy);
+        }
+        append_uint(payload, 0, 4);          // flags
+        append_uint(payload, 0, 4);          // expiry
+        append_uint(payload, i + 1, 8);      // sequence number
+        append_uint(payload, 0xcafe + i, 8); // cas
+        append_uint(payload, datatype, 1);   // datatype
+        append_leb128_prefixed(payload, fmt::format("document-{:012}", i));
+        append_leb128_prefixed(payload, value);
+    }
+    return payload;
+}
+} // namespace
+
+TEST_CASE("benchmark: decode range scan documents", "[benchmark]")
+{
+    constexpr std::size_t number_of_documents{ 1'000 };
+    constexpr std::size_t value_size{ 256 };
+
+    auto compressed = GENERATE(false, true);
+    auto payload = make_documents_payload(number_of_documents, value_size, compressed);
+
+    std::size_t decoded{ 0 };
+    REQUIRE_FALSE(couchbase::core::parse_range_scan_data(
+      payload,
+      [&decoded](const couchbase::core::range_scan_item_view& item) {
+          REQUIRE(item.body.has_value());
+          REQUIRE(item.body->datatype == static_cast<std::byte>(couchbase::core::protocol::datatype::json));
+          REQUIRE(item.body->sequence_number == decoded + 1);
+          REQUIRE(item.body->value.size() > value_size);
+          ++decoded;
+      },
+      false));
+    REQUIRE(decoded == number_of_documents);
+
+    const auto* encoding = compressed ? "snappy" : "plain";
+
+    BENCHMARK(fmt::format("{} {} documents, views", number_of_documents, encoding))
+    {
+        std::size_t bytes{ 0 };
+        auto ec = couchbase::core::parse_range_scan_data(
+          payload,
+          [&bytes](const couchbase::core::range_scan_item_view& item) { bytes += item.key.size() + item.body->value.size(); },
+          false);
+        return ec ? 0 : bytes;
+    };
+
+    BENCHMARK(fmt::format("{} {} documents, owned items", number_of_documents, encoding))
+    {
+        std::vector<couchbase::core::range_scan_item> items;
+        items.reserve(number_of_documents);
+        auto ec = couchbase::core::parse_range_scan_data(
+          payload, [&items](const couchbase::core::range_scan_item_view& item) { items.emplace_back(item.to_item()); }, false);
+        return ec ? 0 : items.size();
+    };
+}
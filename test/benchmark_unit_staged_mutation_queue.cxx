@@ -0,0 +1,100 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "core/operations/document_mutate_in.hxx"
+#include "core/transactions/staged_mutation.hxx"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <fmt/core.h>
+
+using couchbase::core::transactions::staged_mutation;
+using couchbase::core::transactions::staged_mutation_queue;
+using couchbase::core::transactions::staged_mutation_type;
+using couchbase::core::transactions::transaction_get_result;
+
+namespace
+{
+auto
+make_documents(std::size_t number_of_documents) -> std::vector<transaction_get_result>
+{
+    std::vector<transaction_get_result> documents{};
+    documents.reserve(number_of_documents);
+    for (std::size_t i = 0; i < number_of_documents; ++i) {
+        documents.emplace_back(couchbase::core::document_id{ "default", "_default", "_default", fmt::format("txn-document-{:06}", i) },
+                               tao::json::empty_object);
+    }
+    return documents;
+}
+
+/**
+ * Stages the documents the way attempt_context does: look for the mutation of the same document first, then (re)stage it.
+ */
+void
+stage(staged_mutation_queue& queue, std::vector<transaction_get_result>& documents, staged_mutation_type type)
+{
+    for (auto& document : documents) {
+        [[maybe_unused]] auto* existing = queue.find_any(document.id());
+        queue.add(staged_mutation(document, std::vector<std::byte>{}, type));
+    }
+}
+} // namespace
+
+TEST_CASE("benchmark: stage mutations of large transaction", "[benchmark]")
+{
+    auto number_of_documents = GENERATE(as<std::size_t>{}, 1'000, 10'000);
+    auto documents = make_documents(number_of_documents);
+
+    {
+        staged_mutation_queue queue;
+        stage(queue, documents, staged_mutation_type::INSERT);
+        stage(queue, documents, staged_mutation_type::REPLACE);
+        REQUIRE(queue.find_insert(documents.front().id()) == nullptr);
+        REQUIRE(queue.find_replace(documents.back().id()) != nullptr);
+        std::size_t number_of_mutations{ 0 };
+        queue.iterate([&number_of_mutations](staged_mutation&) { ++number_of_mutations; });
+        REQUIRE(number_of_mutations == number_of_documents);
+        queue.remove_any(documents.front().id());
+        REQUIRE(queue.find_any(documents.front().id()) == nullptr);
+    }
+
+    BENCHMARK(fmt::format("stage {} inserts", number_of_documents))
+    {
+        staged_mutation_queue queue;
+        stage(queue, documents, staged_mutation_type::INSERT);
+        return queue.empty();
+    };
+
+    BENCHMARK(fmt::format("stage {} inserts, then replace each of them", number_of_documents))
+    {
+        staged_mutation_queue queue;
+        stage(queue, documents, staged_mutation_type::INSERT);
+        stage(queue, documents, staged_mutation_type::REPLACE);
+        return queue.empty();
+    };
+
+    staged_mutation_queue queue;
+    stage(queue, documents, staged_mutation_type::INSERT);
+    BENCHMARK(fmt::format("extract {} mutations to ATR", number_of_documents))
+    {
+        couchbase::core::operations::mutate_in_request req{};
+        queue.extract_to("attempts.benchmark.", req);
+        return req.specs.size();
+    };
+}
@@ -0,0 +1,119 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include <couchbase/codec/default_json_transcoder.hxx>
+#include <couchbase/codec/raw_binary_transcoder.hxx>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <tao/json.hpp>
+
+namespace
+{
+struct airline {
+    std::uint32_t id{};
+    std::string name{};
+    std::string iata{};
+    std::string icao{};
+    std::string callsign{};
+    std::string country{};
+};
+} // namespace
+
+template<>
+struct tao::json::traits<airline> {
+    template<template<typename...> class Traits>
+    static void assign(tao::json::basic_value<Traits>& v, const airline& a)
+    {
+        v = {
+            { "id", a.id },
+            { "type", "airline" },
+            { "name", a.name },
+            { "iata", a.iata },
+            { "icao", a.icao },
+            { "callsign", a.callsign },
+            { "country", a.country },
+        };
+    }
+
+    template<template<typename...> class Traits>
+    static airline as(const tao::json::basic_value<Traits>& v)
+    {
+        airline result;
+        const auto& object = v.get_object();
+        result.id = object.at("id").template as<std::uint32_t>();
+        result.name = object.at("name").template as<std::string>();
+        result.iata = object.at("iata").template as<std::string>();
+        result.icao = object.at("icao").template as<std::string>();
+        result.callsign = object.at("callsign").template as<std::string>();
+        result.country = object.at("country").template as<std::string>();
+        return result;
+    }
+};
+
+TEST_CASE("benchmark: JSON transcoder", "[benchmark]")
+{
+    airline document{ 10, "40-Mile Air", "Q5", "MLA", "MILE-AIR", "United States" };
+
+    auto encoded = couchbase::codec::default_json_transcoder::encode(document);
+    REQUIRE(encoded.flags == couchbase::codec::codec_flags::json_common_flags);
+    auto decoded = couchbase::codec::default_json_transcoder::decode<airline>(encoded);
+    REQUIRE(decoded.name == document.name);
+
+    tao::json::value generic = tao::json::from_string(test::utils::to_string(encoded.data));
+
+    BENCHMARK("encode user type")
+    {
+        return couchbase::codec::default_json_transcoder::encode(document);
+    };
+
+    BENCHMARK("decode user type")
+    {
+        return couchbase::codec::default_json_transcoder::decode<airline>(encoded);
+    };
+
+    BENCHMARK("encode tao::json::value")
+    {
+        return couchbase::codec::default_json_transcoder::encode(generic);
+    };
+
+    BENCHMARK("decode tao::json::value")
+    {
+        return couchbase::codec::default_json_transcoder::decode<tao::json::value>(encoded);
+    };
+}
+
+TEST_CASE("benchmark: raw binary transcoder", "[benchmark]")
+{
+    std::vector<std::byte> document(16 * 1024, std::byte{ 0x42 });
+
+    auto encoded = couchbase::codec::raw_binary_transcoder::encode(document);
+    REQUIRE(encoded.flags == couchbase::codec::codec_flags::binary_common_flags);
+    REQUIRE(couchbase::codec::raw_binary_transcoder::decode(encoded) == document);
+
+    BENCHMARK("encode 16KiB")
+    {
+        return couchbase::codec::raw_binary_transcoder::encode(document);
+    };
+
+    BENCHMARK("decode 16KiB")
+    {
+        return couchbase::codec::raw_binary_transcoder::decode(encoded);
+    };
+}
@@ -86,7 +86,7 @@ do_range_scan(couchbase::core::agent agent,
           scan_uuid,
           vbucket_id,
           options,
-          [&data](auto item) { data.emplace_back(std::move(item)); },
+          [&data](const auto& item) { data.emplace_back(item.to_item()); },
           [barrier](auto res, auto error) {
               barrier->set_value({ std::move(res), error });
           });
@@ -485,7 +485,7 @@ TEST_CASE("integration: range scan cancellation before continue", "[integration]
           scan_uuid,
           vbucket_id,
           options,
-          [&items_callback_invoked](auto) { items_callback_invoked = true; },
+          [&items_callback_invoked](const auto& /* item */) { items_callback_invoked = true; },
           [barrier](auto res, auto ec) {
               barrier->set_value({ std::move(res), ec });
           });
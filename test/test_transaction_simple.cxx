@@ -20,6 +20,7 @@
 
 #include "core/transactions.hxx"
 #include "core/transactions/atr_ids.hxx"
+#include "core/transactions/internal/transactions_cleanup.hxx"
 
 #include <spdlog/spdlog.h>
 #include <tao/json.hpp>
@@ -293,6 +294,35 @@ TEST_CASE("transactions: non existent collection in custom metadata collections"
     }
 }
 
+TEST_CASE("transactions: lost attempts cleanup examines ATRs concurrently", "[transactions]")
+{
+    test::utils::integration_test_guard integration;
+    auto cluster = integration.cluster;
+    test::utils::open_bucket(cluster, integration.ctx.bucket);
+
+    auto cfg = get_conf()
+                 .metadata_collection(couchbase::transactions::transaction_keyspace{ integration.ctx.bucket })
+                 .cleanup_config(couchbase::transactions::transactions_cleanup_config()
+                                   .cleanup_lost_attempts(true)
+                                   .cleanup_window(std::chrono::seconds(2))
+                                   .lost_attempts_cleanup_concurrency(8)
+                                   .lost_attempts_cleanup_rate_limit(2'000));
+    transactions txn(cluster, cfg);
+
+    REQUIRE(test::utils::wait_until(
+      [&txn]() {
+          auto stats = txn.cleanup().lost_attempts_stats();
+          return !stats.empty() && stats.front().passes_completed > 0;
+      },
+      std::chrono::seconds(30)));
+    auto stats = txn.cleanup().lost_attempts_stats();
+    REQUIRE(stats.size() == 1);
+    REQUIRE(stats.front().keyspace.bucket == integration.ctx.bucket);
+    REQUIRE(stats.front().atrs_in_pass > 0);
+    REQUIRE(stats.front().atrs_checked >= stats.front().atrs_in_pass);
+    REQUIRE(stats.front().atrs_per_second > 0);
+}
+
 TEST_CASE("transactions: raw std::strings become json strings", "[transactions]")
 {
     test::utils::integration_test_guard integration;
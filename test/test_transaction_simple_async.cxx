@@ -23,6 +23,7 @@
 #include <future>
 #include <list>
 #include <stdexcept>
+#include <vector>
 
 using namespace couchbase::core::transactions;
 
@@ -968,3 +969,39 @@ TEST_CASE("transactions: rollback async KV remove", "[transactions]")
         REQUIRE(resp.value == async_content_json);
     }
 }
+
+TEST_CASE("transactions: async transactions are queued on bounded executor", "[transactions]")
+{
+    test::utils::integration_test_guard integration;
+
+    auto cfg = get_conf();
+    cfg.async_executor_threads(1);
+    couchbase::core::transactions::transactions txn(integration.cluster, cfg);
+
+    test::utils::open_bucket(integration.cluster, integration.ctx.bucket);
+    static constexpr std::size_t number_of_transactions{ 8 };
+    std::vector<couchbase::core::document_id> ids{};
+    std::vector<std::future<void>> results{};
+    for (std::size_t i = 0; i < number_of_transactions; ++i) {
+        couchbase::core::document_id id{ integration.ctx.bucket, "_default", "_default", test::utils::uniq_id("txn") };
+        ids.push_back(id);
+        auto barrier = std::make_shared<std::promise<void>>();
+        results.emplace_back(barrier->get_future());
+        txn.run(
+          [id](async_attempt_context& ctx) {
+              ctx.insert(id, async_content, [](std::exception_ptr, std::optional<transaction_get_result>) {});
+          },
+          [barrier](std::optional<transaction_exception> err, std::optional<couchbase::transactions::transaction_result> res) {
+              txn_completed(std::move(err), std::move(res), barrier);
+          });
+    }
+    for (auto& f : results) {
+        REQUIRE_NOTHROW(f.get());
+    }
+    for (const auto& id : ids) {
+        couchbase::core::operations::get_request req{ id };
+        auto resp = test::utils::execute(integration.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+        REQUIRE(resp.value == async_content_json);
+    }
+}
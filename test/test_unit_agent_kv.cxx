@@ -0,0 +1,500 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "utils/binary.hxx"
+#include "utils/mock_test_guard.hxx"
+
+#include "core/agent_group.hxx"
+#include "core/protocol/client_opcode.hxx"
+#include "core/protocol/datatype.hxx"
+#include "core/utils/binary.hxx"
+
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <mutex>
+
+namespace
+{
+using couchbase::core::protocol::client_opcode;
+
+/**
+ * Keeps the requests seen by the mock server, so that their encoding could be checked.
+ */
+class request_recorder
+{
+  public:
+    void record(const test::utils::mock_kv_request& request)
+    {
+        std::scoped_lock lock(mutex_);
+        requests_.emplace_back(request);
+    }
+
+    [[nodiscard]] auto last(client_opcode opcode) -> test::utils::mock_kv_request
+    {
+        std::scoped_lock lock(mutex_);
+        auto request = std::find_if(requests_.rbegin(), requests_.rend(), [opcode](const auto& entry) {
+            return entry.opcode == static_cast<std::uint8_t>(opcode);
+        });
+        REQUIRE(request != requests_.rend());
+        return *request;
+    }
+
+  private:
+    std::mutex mutex_{};
+    std::vector<test::utils::mock_kv_request> requests_{};
+};
+
+struct agent_fixture {
+    explicit agent_fixture(test::utils::mock_server_options options = {})
+      : recorder{ std::make_shared<request_recorder>() }
+      , mock{ with_recorder(std::move(options), recorder) }
+      , group{ mock.io, { { mock.cluster } } }
+    {
+        group.open_bucket(mock.server.bucket_name());
+        auto bucket_agent = group.get_agent(mock.server.bucket_name());
+        REQUIRE(bucket_agent.has_value());
+        agent = std::make_unique<couchbase::core::agent>(std::move(bucket_agent.value()));
+    }
+
+    static auto with_recorder(test::utils::mock_server_options options, std::shared_ptr<request_recorder> recorder)
+      -> test::utils::mock_server_options
+    {
+        options.request_observer = [recorder = std::move(recorder)](const auto& request) { recorder->record(request); };
+        return options;
+    }
+
+    std::shared_ptr<request_recorder> recorder;
+    test::utils::mock_test_guard mock;
+    couchbase::core::agent_group group;
+    std::unique_ptr<couchbase::core::agent> agent{};
+};
+
+/**
+ * Runs the operation of the agent and waits for its callback.
+ */
+template<typename Result, typename Operation>
+auto
+run(Operation&& operation) -> std::pair<Result, std::error_code>
+{
+    auto barrier = std::make_shared<std::promise<std::pair<Result, std::error_code>>>();
+    auto f = barrier->get_future();
+    auto op = operation([barrier](Result res, std::error_code ec) { barrier->set_value({ std::move(res), ec }); });
+    EXPECT_SUCCESS(op);
+    REQUIRE(op.has_value());
+    return f.get();
+}
+
+auto
+big_endian(std::uint64_t value, std::size_t size) -> std::vector<std::byte>
+{
+    std::vector<std::byte> out;
+    for (std::size_t i = size; i > 0; --i) {
+        out.push_back(static_cast<std::byte>(value >> (8 * (i - 1))));
+    }
+    return out;
+}
+
+template<typename... Fields>
+auto
+concat(Fields&&... fields) -> std::vector<std::byte>
+{
+    std::vector<std::byte> out;
+    (out.insert(out.end(), fields.begin(), fields.end()), ...);
+    return out;
+}
+} // namespace
+
+TEST_CASE("unit: agent encodes storage operations", "[unit]")
+{
+    agent_fixture fixture;
+    auto& agent = *fixture.agent;
+    auto key = test::utils::uniq_id("agent");
+    const auto value = couchbase::core::utils::to_binary(R"({"a":1})");
+
+    couchbase::cas stored_cas{};
+    {
+        couchbase::core::upsert_options options{};
+        options.key = couchbase::core::utils::to_binary(key);
+        options.value = value;
+        options.flags = 0xdeadbeef;
+        options.expiry = 42;
+        options.data_type = static_cast<std::uint8_t>(couchbase::core::protocol::datatype::json);
+        auto [res, ec] = run<couchbase::core::upsert_result>([&](auto&& cb) { return agent.upsert(options, std::move(cb)); });
+        REQUIRE_SUCCESS(ec);
+        REQUIRE_FALSE(res.cas.empty());
+        stored_cas = res.cas;
+
+        auto request = fixture.recorder->last(client_opcode::upsert);
+        REQUIRE(request.key == key);
+        REQUIRE(request.extras == concat(big_endian(0xdeadbeef, 4), big_endian(42, 4)));
+        REQUIRE(request.datatype == static_cast<std::uint8_t>(couchbase::core::protocol::datatype::json));
+        REQUIRE(request.value == test::utils::to_string(value));
+    }
+    {
+        couchbase::core::get_options options{};
+        options.key = couchbase::core::utils::to_binary(key);
+        auto [res, ec] = run<couchbase::core::get_result>([&](auto&& cb) { return agent.get(options, std::move(cb)); });
+        REQUIRE_SUCCESS(ec);
+        REQUIRE(res.value == value);
+        REQUIRE(res.flags == 0xdeadbeef);
+        REQUIRE(res.data_type == static_cast<std::uint8_t>(couchbase::core::protocol::datatype::json));
+        REQUIRE(res.cas == stored_cas);
+        REQUIRE(fixture.recorder->last(client_opcode::get).extras.empty());
+    }
+    {
+        couchbase::core::insert_options options{};
+        options.key = couchbase::core::utils::to_binary(key);
+        options.value = value;
+        auto [res, ec] = run<couchbase::core::insert_result>([&](auto&& cb) { return agent.insert(options, std::move(cb)); });
+        REQUIRE(ec == couchbase::errc::key_value::document_exists);
+        REQUIRE(fixture.recorder->last(client_opcode::insert).extras == concat(big_endian(0, 4), big_endian(0, 4)));
+    }
+    {
+        couchbase::core::replace_options options{};
+        options.key = couchbase::core::utils::to_binary(key);
+        options.value = value;
+        options.flags = 7;
+        options.cas = couchbase::cas{ stored_cas.value() + 1 };
+        auto [res, ec] = run<couchbase::core::replace_result>([&](auto&& cb) { return agent.replace(options, std::move(cb)); });
+        REQUIRE(ec == couchbase::errc::common::cas_mismatch);
+        auto request = fixture.recorder->last(client_opcode::replace);
+        REQUIRE(request.cas == stored_cas.value() + 1);
+        REQUIRE(request.extras == concat(big_endian(7, 4), big_endian(0, 4)));
+    }
+    {
+        couchbase::core::get_one_replica_options options{};
+        options.key = couchbase::core::utils::to_binary(key);
+        auto op = agent.get_one_replica(options, [](auto /* res */, auto /* ec */) {});
+        REQUIRE_FALSE(op.has_value());
+        REQUIRE(op.error() == couchbase::errc::common::invalid_argument);
+    }
+    {
+        couchbase::core::remove_options options{};
+        options.key = couchbase::core::utils::to_binary(key);
+        options.cas = stored_cas;
+        auto [res, ec] = run<couchbase::core::remove_result>([&](auto&& cb) { return agent.remove(options, std::move(cb)); });
+        REQUIRE_SUCCESS(ec);
+        REQUIRE(res.cas != stored_cas);
+        REQUIRE(fixture.recorder->last(client_opcode::remove).cas == stored_cas.value());
+        REQUIRE(fixture.mock.server.number_of_documents() == 0);
+    }
+}
+
+TEST_CASE("unit: agent reads from replica", "[unit]")
+{
+    test::utils::mock_server_options server_options{};
+    server_options.number_of_replicas = 1;
+    agent_fixture fixture{ server_options };
+    auto key = test::utils::uniq_id("agent");
+    fixture.mock.server.upsert_document(key, R"({"replica":true})", 0x11);
+
+    couchbase::core::get_one_replica_options options{};
+    options.key = couchbase::core::utils::to_binary(key);
+    options.replica_index = 1;
+    auto [res, ec] =
+      run<couchbase::core::get_one_replica_result>([&](auto&& cb) { return fixture.agent->get_one_replica(options, std::move(cb)); });
+    REQUIRE_SUCCESS(ec);
+    REQUIRE(test::utils::to_string(res.value) == R"({"replica":true})");
+    REQUIRE(res.flags == 0x11);
+    REQUIRE(fixture.recorder->last(client_opcode::get_replica).key == key);
+}
+
+TEST_CASE("unit: agent encodes expiry and lock operations", "[unit]")
+{
+    agent_fixture fixture;
+    auto& agent = *fixture.agent;
+    auto key = test::utils::uniq_id("agent");
+    fixture.mock.server.upsert_document(key, "locked value", 0x22);
+
+    {
+        couchbase::core::touch_options options{};
+        options.key = couchbase::core::utils::to_binary(key);
+        options.expiry = 10;
+        auto [res, ec] = run<couchbase::core::touch_result>([&](auto&& cb) { return agent.touch(options, std::move(cb)); });
+        REQUIRE_SUCCESS(ec);
+        REQUIRE_FALSE(res.cas.empty());
+        REQUIRE(fixture.recorder->last(client_opcode::touch).extras == big_endian(10, 4));
+    }
+    {
+        couchbase::core::get_and_touch_options options{};
+        options.key = couchbase::core::utils::to_binary(key);
+        options.expiry = 20;
+        auto [res, ec] =
+          run<couchbase::core::get_and_touch_result>([&](auto&& cb) { return agent.get_and_touch(options, std::move(cb)); });
+        REQUIRE_SUCCESS(ec);
+        REQUIRE(test::utils::to_string(res.value) == "locked value");
+        REQUIRE(res.flags == 0x22);
+        REQUIRE(fixture.recorder->last(client_opcode::get_and_touch).extras == big_endian(20, 4));
+    }
+    couchbase::cas lock_cas{};
+    {
+        couchbase::core::get_and_lock_options options{};
+        options.key = couchbase::core::utils::to_binary(key);
+        options.lock_time = 15;
+        auto [res, ec] = run<couchbase::core::get_and_lock_result>([&](auto&& cb) { return agent.get_and_lock(options, std::move(cb)); });
+        REQUIRE_SUCCESS(ec);
+        REQUIRE(test::utils::to_string(res.value) == "locked value");
+        REQUIRE_FALSE(res.cas.empty());
+        lock_cas = res.cas;
+        REQUIRE(fixture.recorder->last(client_opcode::get_and_lock).extras == big_endian(15, 4));
+    }
+    {
+        couchbase::core::unlock_options options{};
+        options.key = couchbase::core::utils::to_binary(key);
+        options.cas = lock_cas;
+        auto [res, ec] = run<couchbase::core::unlock_result>([&](auto&& cb) { return agent.unlock(options, std::move(cb)); });
+        REQUIRE_SUCCESS(ec);
+        auto request = fixture.recorder->last(client_opcode::unlock);
+        REQUIRE(request.cas == lock_cas.value());
+        REQUIRE(request.extras.empty());
+    }
+}
+
+TEST_CASE("unit: agent encodes append, prepend and counters", "[unit]")
+{
+    agent_fixture fixture;
+    auto& agent = *fixture.agent;
+    auto key = test::utils::uniq_id("agent");
+    fixture.mock.server.upsert_document(key, "middle");
+
+    {
+        couchbase::core::adjoin_options options{};
+        options.key = couchbase::core::utils::to_binary(key);
+        options.value = couchbase::core::utils::to_binary("<");
+        auto [res, ec] = run<couchbase::core::adjoin_result>([&](auto&& cb) { return agent.prepend(options, std::move(cb)); });
+        REQUIRE_SUCCESS(ec);
+        REQUIRE(fixture.recorder->last(client_opcode::prepend).value == "<");
+    }
+    {
+        couchbase::core::adjoin_options options{};
+        options.key = couchbase::core::utils::to_binary(key);
+        options.value = couchbase::core::utils::to_binary(">");
+        auto [res, ec] = run<couchbase::core::adjoin_result>([&](auto&& cb) { return agent.append(options, std::move(cb)); });
+        REQUIRE_SUCCESS(ec);
+        REQUIRE(fixture.recorder->last(client_opcode::append).extras.empty());
+    }
+    {
+        couchbase::core::get_options options{};
+        options.key = couchbase::core::utils::to_binary(key);
+        auto [res, ec] = run<couchbase::core::get_result>([&](auto&& cb) { return agent.get(options, std::move(cb)); });
+        REQUIRE_SUCCESS(ec);
+        REQUIRE(test::utils::to_string(res.value) == "<middle>");
+    }
+
+    auto counter_key = test::utils::uniq_id("counter");
+    {
+        couchbase::core::counter_options options{};
+        options.key = couchbase::core::utils::to_binary(counter_key);
+        options.delta = 5;
+        options.initial_value = 10;
+        options.expiry = 30;
+        auto [res, ec] = run<couchbase::core::counter_result>([&](auto&& cb) { return agent.increment(options, std::move(cb)); });
+        REQUIRE_SUCCESS(ec);
+        REQUIRE(res.value == 10);
+        REQUIRE(fixture.recorder->last(client_opcode::increment).extras ==
+                concat(big_endian(5, 8), big_endian(10, 8), big_endian(30, 4)));
+    }
+    {
+        couchbase::core::counter_options options{};
+        options.key = couchbase::core::utils::to_binary(counter_key);
+        options.delta = 5;
+        auto [res, ec] = run<couchbase::core::counter_result>([&](auto&& cb) { return agent.increment(options, std::move(cb)); });
+        REQUIRE_SUCCESS(ec);
+        REQUIRE(res.value == 15);
+        REQUIRE_FALSE(res.cas.empty());
+    }
+    {
+        couchbase::core::counter_options options{};
+        options.key = couchbase::core::utils::to_binary(counter_key);
+        options.delta = 20;
+        auto [res, ec] = run<couchbase::core::counter_result>([&](auto&& cb) { return agent.decrement(options, std::move(cb)); });
+        REQUIRE_SUCCESS(ec);
+        REQUIRE(res.value == 0);
+    }
+    {
+        // the maximal initial value means, that the counter must not be created
+        couchbase::core::counter_options options{};
+        options.key = couchbase::core::utils::to_binary(test::utils::uniq_id("missing"));
+        options.delta = 1;
+        options.initial_value = std::numeric_limits<std::uint64_t>::max();
+        auto [res, ec] = run<couchbase::core::counter_result>([&](auto&& cb) { return agent.increment(options, std::move(cb)); });
+        REQUIRE(ec == couchbase::errc::key_value::document_not_found);
+        REQUIRE(fixture.recorder->last(client_opcode::increment).extras ==
+                concat(big_endian(1, 8), big_endian(0, 8), big_endian(std::numeric_limits<std::uint32_t>::max(), 4)));
+    }
+    {
+        couchbase::core::counter_options options{};
+        options.key = couchbase::core::utils::to_binary(key);
+        options.delta = 1;
+        auto [res, ec] = run<couchbase::core::counter_result>([&](auto&& cb) { return agent.increment(options, std::move(cb)); });
+        REQUIRE(ec == couchbase::errc::key_value::delta_invalid);
+    }
+}
+
+TEST_CASE("unit: agent encodes operations with metadata", "[unit]")
+{
+    agent_fixture fixture;
+    auto& agent = *fixture.agent;
+    auto key = test::utils::uniq_id("agent");
+    const auto value = couchbase::core::utils::to_binary(R"({"meta":1})");
+    const std::vector<std::byte> extra{ std::byte{ 0x01 }, std::byte{ 0x02 } };
+
+    {
+        couchbase::core::upsert_with_meta_options options{};
+        options.key = couchbase::core::utils::to_binary(key);
+        options.value = value;
+        options.extra = extra;
+        options.flags = 0x33;
+        options.expiry = 40;
+        options.revision_number = 3;
+        options.cas = couchbase::cas{ 0x1234 };
+        options.options = 0x04;
+        options.data_type = static_cast<std::uint8_t>(couchbase::core::protocol::datatype::json);
+        auto [res, ec] =
+          run<couchbase::core::upsert_with_meta_result>([&](auto&& cb) { return agent.upsert_with_meta(options, std::move(cb)); });
+        REQUIRE_SUCCESS(ec);
+        REQUIRE(res.cas.value() == 0x1234);
+
+        auto request = fixture.recorder->last(client_opcode::upsert_with_meta);
+        // flags, expiry, revision number, CAS, options, size of the extended metadata
+        REQUIRE(request.extras == concat(big_endian(0x33, 4),
+                                         big_endian(40, 4),
+                                         big_endian(3, 8),
+                                         big_endian(0x1234, 8),
+                                         big_endian(0x04, 4),
+                                         big_endian(extra.size(), 2)));
+        REQUIRE(request.value == test::utils::to_string(concat(value, extra)));
+    }
+    {
+        couchbase::core::get_with_meta_options options{};
+        options.key = couchbase::core::utils::to_binary(key);
+        auto [res, ec] = run<couchbase::core::get_with_meta_result>([&](auto&& cb) { return agent.get_with_meta(options, std::move(cb)); });
+        REQUIRE_SUCCESS(ec);
+        REQUIRE(res.deleted == 0);
+        REQUIRE(res.flags == 0x33);
+        REQUIRE(res.expiry == 40);
+        REQUIRE(res.sequence_number > 0);
+        REQUIRE(res.data_type == static_cast<std::uint8_t>(couchbase::core::protocol::datatype::json));
+        REQUIRE(res.cas.value() == 0x1234);
+        REQUIRE(fixture.recorder->last(client_opcode::get_meta).extras == std::vector<std::byte>{ std::byte{ 0x02 } });
+    }
+    {
+        couchbase::core::remove_with_meta_options options{};
+        options.key = couchbase::core::utils::to_binary(key);
+        options.cas = couchbase::cas{ 0x1235 };
+        options.revision_number = 4;
+        auto [res, ec] =
+          run<couchbase::core::remove_with_meta_result>([&](auto&& cb) { return agent.remove_with_meta(options, std::move(cb)); });
+        REQUIRE_SUCCESS(ec);
+        REQUIRE(fixture.recorder->last(client_opcode::remove_with_meta).extras ==
+                concat(big_endian(0, 4), big_endian(0, 4), big_endian(4, 8), big_endian(0x1235, 8), big_endian(0, 4), big_endian(0, 2)));
+        REQUIRE(fixture.mock.server.number_of_documents() == 0);
+    }
+}
+
+TEST_CASE("unit: agent encodes subdocument operations", "[unit]")
+{
+    agent_fixture fixture;
+    auto& agent = *fixture.agent;
+    auto key = test::utils::uniq_id("agent");
+    fixture.mock.server.upsert_document(key, R"({"a":1})");
+
+    {
+        couchbase::core::lookup_in_options options{};
+        options.key = couchbase::core::utils::to_binary(key);
+        options.operations = {
+            { couchbase::core::protocol::subdoc_opcode::get, 0, "a", {} },
+            { couchbase::core::protocol::subdoc_opcode::exists, 0, "missing", {} },
+        };
+        auto [res, ec] = run<couchbase::core::lookup_in_result>([&](auto&& cb) { return agent.lookup_in(options, std::move(cb)); });
+        REQUIRE_SUCCESS(ec);
+        REQUIRE(res.results.size() == 2);
+        REQUIRE_SUCCESS(res.results[0].error);
+        REQUIRE(test::utils::to_string(res.results[0].value) == "1");
+        REQUIRE(res.results[1].error == couchbase::errc::key_value::path_not_found);
+        REQUIRE_FALSE(res.internal.is_deleted);
+
+        auto request = fixture.recorder->last(client_opcode::subdoc_multi_lookup);
+        REQUIRE(request.extras.empty());
+        // opcode, flags, path length, path
+        REQUIRE(request.value.substr(0, 5) == std::string{ '\xc5', '\x00', '\x00', '\x01', 'a' });
+    }
+    {
+        couchbase::core::mutate_in_options options{};
+        options.key = couchbase::core::utils::to_binary(key);
+        options.expiry = 50;
+        options.operations = {
+            { couchbase::core::protocol::subdoc_opcode::dict_upsert, 0, "b", couchbase::core::utils::to_binary("2") },
+        };
+        auto [res, ec] = run<couchbase::core::mutate_in_result>([&](auto&& cb) { return agent.mutate_in(options, std::move(cb)); });
+        REQUIRE_SUCCESS(ec);
+        REQUIRE(res.results.size() == 1);
+        REQUIRE_FALSE(res.cas.empty());
+
+        auto request = fixture.recorder->last(client_opcode::subdoc_multi_mutation);
+        REQUIRE(request.extras == big_endian(50, 4));
+        // opcode, flags, path length, value length, path, value
+        REQUIRE(request.value == std::string{ '\xc8', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x01', 'b', '2' });
+    }
+    {
+        couchbase::core::get_options options{};
+        options.key = couchbase::core::utils::to_binary(key);
+        auto [res, ec] = run<couchbase::core::get_result>([&](auto&& cb) { return agent.get(options, std::move(cb)); });
+        REQUIRE_SUCCESS(ec);
+        REQUIRE(test::utils::to_string(res.value) == R"({"a":1,"b":2})");
+    }
+}
+
+TEST_CASE("unit: agent decodes observe_seqno and get_random responses", "[unit]")
+{
+    agent_fixture fixture;
+    auto& agent = *fixture.agent;
+    auto key = test::utils::uniq_id("agent");
+
+    couchbase::core::upsert_options upsert{};
+    upsert.key = couchbase::core::utils::to_binary(key);
+    upsert.value = couchbase::core::utils::to_binary(R"({"random":true})");
+    auto [stored, stored_ec] = run<couchbase::core::upsert_result>([&](auto&& cb) { return agent.upsert(upsert, std::move(cb)); });
+    REQUIRE_SUCCESS(stored_ec);
+    REQUIRE(stored.token.sequence_number() > 0);
+
+    {
+        couchbase::core::observe_seqno_options options{};
+        options.vbucket_id = stored.token.partition_id();
+        options.vbucket_uuid = stored.token.partition_uuid();
+        auto [res, ec] = run<couchbase::core::observe_seqno_result>([&](auto&& cb) { return agent.observe_seqno(options, std::move(cb)); });
+        REQUIRE_SUCCESS(ec);
+        REQUIRE_FALSE(res.did_failover);
+        REQUIRE(res.vbucket_id == stored.token.partition_id());
+        REQUIRE(res.vbucket_uuid == stored.token.partition_uuid());
+        REQUIRE(res.current_sequence_number >= stored.token.sequence_number());
+
+        auto request = fixture.recorder->last(client_opcode::observe_seqno);
+        REQUIRE(request.vbucket == stored.token.partition_id());
+        REQUIRE(request.value == test::utils::to_string(big_endian(stored.token.partition_uuid(), 8)));
+    }
+    {
+        couchbase::core::get_random_options options{};
+        auto [res, ec] = run<couchbase::core::get_random_result>([&](auto&& cb) { return agent.get_random(options, std::move(cb)); });
+        REQUIRE_SUCCESS(ec);
+        REQUIRE(test::utils::to_string(res.value) == R"({"random":true})");
+        REQUIRE(fixture.recorder->last(client_opcode::get_random_key).key.empty());
+    }
+}
@@ -0,0 +1,215 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "utils/mock_test_guard.hxx"
+
+#include <couchbase/cluster.hxx>
+
+#include <asio/bind_executor.hpp>
+#include <asio/deferred.hpp>
+#include <asio/executor_work_guard.hpp>
+#include <asio/use_future.hpp>
+
+#if defined(ASIO_HAS_CO_AWAIT)
+#include <asio/co_spawn.hpp>
+#include <asio/use_awaitable.hpp>
+#endif
+
+#include <tao/json.hpp>
+
+#include <atomic>
+#include <future>
+
+namespace
+{
+std::atomic_size_t number_of_handler_allocations{ 0 };
+
+template<typename T>
+struct counting_allocator {
+    using value_type = T;
+
+    counting_allocator() = default;
+
+    template<typename U>
+    explicit counting_allocator(const counting_allocator<U>& /* other */)
+    {
+    }
+
+    auto allocate(std::size_t n) -> T*
+    {
+        number_of_handler_allocations.fetch_add(1);
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* ptr, std::size_t n)
+    {
+        std::allocator<T>{}.deallocate(ptr, n);
+    }
+
+    template<typename U>
+    auto operator==(const counting_allocator<U>& /* other */) const -> bool
+    {
+        return true;
+    }
+
+    template<typename U>
+    auto operator!=(const counting_allocator<U>& /* other */) const -> bool
+    {
+        return false;
+    }
+};
+
+/**
+ * Move-only handler with associated allocator, which cannot be stored in std::function directly.
+ */
+struct allocator_aware_handler {
+    using allocator_type = counting_allocator<void>;
+
+    std::unique_ptr<std::promise<std::error_code>> barrier;
+
+    [[nodiscard]] auto get_allocator() const noexcept -> allocator_type
+    {
+        return {};
+    }
+
+    void operator()(couchbase::key_value_error_context ctx, couchbase::get_result /* result */)
+    {
+        barrier->set_value(ctx.ec());
+    }
+};
+} // namespace
+
+TEST_CASE("unit: public API accepts asio completion tokens", "[unit]")
+{
+    test::utils::mock_test_guard mock;
+    auto collection = couchbase::cluster(mock.cluster).bucket(mock.server.bucket_name()).default_collection();
+    const auto key = test::utils::uniq_id("token");
+    const tao::json::value content{ { "a", 1 } };
+
+    {
+        auto [ctx, result] = collection.upsert(key, content, {}, asio::use_future).get();
+        REQUIRE_SUCCESS(ctx.ec());
+        REQUIRE_FALSE(result.cas().empty());
+    }
+
+    {
+        auto [ctx, result] = collection.get(key, {}, asio::use_future).get();
+        REQUIRE_SUCCESS(ctx.ec());
+        REQUIRE(result.content_as<tao::json::value>() == content);
+    }
+
+    {
+        // the handler is invoked through its associated executor, rather than on the IO thread of the cluster
+        asio::io_context application_io;
+        auto work = asio::make_work_guard(application_io);
+        std::thread application_thread([&application_io]() { application_io.run(); });
+
+        auto barrier = std::make_shared<std::promise<bool>>();
+        auto f = barrier->get_future();
+        collection.exists(key, {}, asio::bind_executor(application_io, [&application_io, barrier](auto ctx, auto result) {
+                              barrier->set_value(!ctx.ec() && result.exists() && application_io.get_executor().running_in_this_thread());
+                          }));
+        REQUIRE(f.get());
+
+        work.reset();
+        application_thread.join();
+    }
+
+    {
+        // the shared state of move-only handler is allocated with its associated allocator
+        auto barrier = std::make_unique<std::promise<std::error_code>>();
+        auto f = barrier->get_future();
+        auto before = number_of_handler_allocations.load();
+        collection.get(key, {}, allocator_aware_handler{ std::move(barrier) });
+        REQUIRE_SUCCESS(f.get());
+        REQUIRE(number_of_handler_allocations.load() > before);
+    }
+
+    {
+        // plain callbacks are still accepted
+        auto barrier = std::make_shared<std::promise<std::error_code>>();
+        auto f = barrier->get_future();
+        collection.remove(key, {}, [barrier](auto ctx, auto /* result */) { barrier->set_value(ctx.ec()); });
+        REQUIRE_SUCCESS(f.get());
+        REQUIRE(mock.server.number_of_documents() == 0);
+    }
+}
+
+TEST_CASE("unit: deferred operation outlives the collection object it was created from", "[unit]")
+{
+    test::utils::mock_test_guard mock;
+    const auto key = test::utils::uniq_id("deferred");
+    const tao::json::value content{ { "a", 1 } };
+
+    // the collection handles are temporaries, and destroyed before the operations are launched
+    auto upsert =
+      couchbase::cluster(mock.cluster).bucket(mock.server.bucket_name()).default_collection().upsert(key, content, {}, asio::deferred);
+    auto get = couchbase::cluster(mock.cluster).bucket(mock.server.bucket_name()).default_collection().get(key, {}, asio::deferred);
+
+    {
+        auto barrier = std::make_shared<std::promise<std::error_code>>();
+        auto f = barrier->get_future();
+        std::move(upsert)([barrier](auto ctx, auto /* result */) { barrier->set_value(ctx.ec()); });
+        REQUIRE_SUCCESS(f.get());
+    }
+
+    {
+        auto barrier = std::make_shared<std::promise<std::pair<std::error_code, tao::json::value>>>();
+        auto f = barrier->get_future();
+        std::move(get)([barrier](auto ctx, auto result) {
+            if (ctx.ec()) {
+                return barrier->set_value({ ctx.ec(), {} });
+            }
+            barrier->set_value({ {}, result.template content_as<tao::json::value>() });
+        });
+        auto [ec, value] = f.get();
+        REQUIRE_SUCCESS(ec);
+        REQUIRE(value == content);
+    }
+}
+
+#if defined(ASIO_HAS_CO_AWAIT)
+TEST_CASE("unit: asio awaitable outlives the collection object it was created from", "[unit]")
+{
+    test::utils::mock_test_guard mock;
+    const auto key = test::utils::uniq_id("awaitable");
+    const tao::json::value content{ { "a", 1 } };
+
+    auto round_trip = [&mock, &key, &content]() -> asio::awaitable<bool> {
+        // the collection handles are temporaries, and destroyed before the operations are awaited
+        auto upsert = couchbase::cluster(mock.cluster)
+                        .bucket(mock.server.bucket_name())
+                        .default_collection()
+                        .upsert(key, content, {}, asio::use_awaitable);
+        auto get =
+          couchbase::cluster(mock.cluster).bucket(mock.server.bucket_name()).default_collection().get(key, {}, asio::use_awaitable);
+
+        if (auto [ctx, result] = co_await std::move(upsert); ctx.ec()) {
+            co_return false;
+        }
+        auto [ctx, result] = co_await std::move(get);
+        co_return !ctx.ec() && result.content_as<tao::json::value>() == content;
+    };
+
+    asio::io_context application_io;
+    auto done = asio::co_spawn(application_io, round_trip(), asio::use_future);
+    application_io.run();
+    REQUIRE(done.get());
+}
+#endif
@@ -0,0 +1,100 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "core/document_id.hxx"
+#include "core/protocol/client_request.hxx"
+#include "core/protocol/cmd_upsert.hxx"
+#include "core/protocol/compression.hxx"
+#include "core/utils/binary.hxx"
+
+#include <algorithm>
+#include <cstring>
+
+TEST_CASE("unit: compression respects configured thresholds", "[unit]")
+{
+    auto value = couchbase::core::utils::to_binary(std::string(1024, 'a'));
+    std::vector<std::byte> output(4, std::byte{ 0xff });
+
+    SECTION("disabled")
+    {
+        auto result = couchbase::core::protocol::write_value(value, {}, output, 4);
+        REQUIRE_FALSE(result.compressed);
+        REQUIRE(result.duration.count() == 0);
+        REQUIRE(output.size() == 4 + value.size());
+        REQUIRE(std::equal(value.begin(), value.end(), output.begin() + 4));
+    }
+
+    SECTION("value is too small")
+    {
+        auto result = couchbase::core::protocol::write_value(value, { true, value.size(), 0.83 }, output, 4);
+        REQUIRE_FALSE(result.compressed);
+        REQUIRE(output.size() == 4 + value.size());
+    }
+
+    SECTION("ratio is not good enough")
+    {
+        auto result = couchbase::core::protocol::write_value(value, { true, 32, 0.0 }, output, 4);
+        REQUIRE_FALSE(result.compressed);
+        REQUIRE(result.duration.count() > 0);
+        REQUIRE(output.size() == 4 + value.size());
+        REQUIRE(std::equal(value.begin(), value.end(), output.begin() + 4));
+    }
+
+    SECTION("compressed in place")
+    {
+        auto before = couchbase::core::protocol::compression_statistics();
+        auto result = couchbase::core::protocol::write_value(value, { true, 32, 0.83 }, output, 4);
+        REQUIRE(result.compressed);
+        REQUIRE(result.original_size == value.size());
+        REQUIRE(result.compressed_size < value.size());
+        REQUIRE(output.size() == 4 + result.compressed_size);
+        REQUIRE(output[0] == std::byte{ 0xff });
+
+        auto after = couchbase::core::protocol::compression_statistics();
+        REQUIRE(after.values_compressed > before.values_compressed);
+        REQUIRE(after.bytes_saved - before.bytes_saved >= value.size() - result.compressed_size);
+
+        std::vector<std::byte> decompressed{};
+        REQUIRE(couchbase::core::protocol::decompress_value(gsl::make_span(output.data() + 4, result.compressed_size), decompressed));
+        REQUIRE(decompressed == value);
+    }
+}
+
+TEST_CASE("unit: upsert request compresses value into the payload", "[unit]")
+{
+    auto value = couchbase::core::utils::to_binary(std::string(1024, 'a'));
+
+    couchbase::core::protocol::client_request<couchbase::core::protocol::upsert_request_body> req;
+    req.opaque(42);
+    req.body().id(couchbase::core::document_id{ "default", "_default", "_default", "foo" });
+    req.body().content(value);
+
+    auto plain = req.data();
+    REQUIRE((plain[5] & static_cast<std::byte>(couchbase::core::protocol::datatype::snappy)) == std::byte{ 0 });
+
+    couchbase::core::protocol::compression_result result{};
+    auto compressed = req.data({ true, 32, 0.83 }, &result);
+    REQUIRE(result.compressed);
+    REQUIRE((compressed[5] & static_cast<std::byte>(couchbase::core::protocol::datatype::snappy)) != std::byte{ 0 });
+    REQUIRE(compressed.size() == plain.size() - value.size() + result.compressed_size);
+
+    std::uint32_t body_size{ 0 };
+    std::memcpy(&body_size, compressed.data() + 8, sizeof(body_size));
+    REQUIRE(couchbase::core::utils::byte_swap(body_size) == compressed.size() - couchbase::core::protocol::header_size);
+}
@@ -0,0 +1,223 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "core/io/connect_race.hxx"
+#include "core/io/resolve_cache.hxx"
+
+#include <asio.hpp>
+
+#include <chrono>
+#include <future>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+using couchbase::core::io::connect_race;
+using couchbase::core::io::ip_protocol;
+using couchbase::core::io::resolve_cache;
+
+namespace
+{
+auto
+closed_port_endpoint(asio::io_context& io) -> asio::ip::tcp::endpoint
+{
+    asio::ip::tcp::acceptor acceptor(io, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+    auto endpoint = acceptor.local_endpoint();
+    acceptor.close();
+    return endpoint;
+}
+
+struct race_result {
+    std::error_code ec{};
+    asio::ip::tcp::endpoint endpoint{};
+    bool socket_is_open{ false };
+    std::chrono::steady_clock::duration elapsed{};
+};
+
+auto
+run_race(asio::io_context& io, std::vector<asio::ip::tcp::endpoint> endpoints, std::chrono::milliseconds attempt_delay) -> race_result
+{
+    std::optional<race_result> result{};
+    auto start = std::chrono::steady_clock::now();
+    connect_race::start(asio::make_strand(io),
+                        std::move(endpoints),
+                        attempt_delay,
+                        [&result, start](std::error_code ec, asio::ip::tcp::socket socket, asio::ip::tcp::endpoint endpoint) {
+                            result = { ec, endpoint, socket.is_open(), std::chrono::steady_clock::now() - start };
+                        });
+    io.run_for(std::chrono::seconds(5));
+    io.restart();
+    REQUIRE(result.has_value());
+    return result.value();
+}
+
+auto
+resolve(resolve_cache& cache, const std::string& service, std::chrono::milliseconds ttl)
+  -> std::pair<std::error_code, std::vector<asio::ip::tcp::endpoint>>
+{
+    std::promise<std::pair<std::error_code, std::vector<asio::ip::tcp::endpoint>>> barrier;
+    auto f = barrier.get_future();
+    cache.resolve(ip_protocol::any,
+                  "127.0.0.1",
+                  service,
+                  ttl,
+                  std::chrono::seconds(60),
+                  std::chrono::seconds(10),
+                  [&barrier](std::error_code ec, std::vector<asio::ip::tcp::endpoint> endpoints) {
+                      barrier.set_value({ ec, std::move(endpoints) });
+                  });
+    return f.get();
+}
+} // namespace
+
+TEST_CASE("unit: connect race interleaves address families", "[unit]")
+{
+    auto v6_1 = asio::ip::tcp::endpoint(asio::ip::make_address("::1"), 11210);
+    auto v6_2 = asio::ip::tcp::endpoint(asio::ip::make_address("fe80::1"), 11210);
+    auto v4_1 = asio::ip::tcp::endpoint(asio::ip::make_address("127.0.0.1"), 11210);
+    auto v4_2 = asio::ip::tcp::endpoint(asio::ip::make_address("127.0.0.2"), 11210);
+    auto v4_3 = asio::ip::tcp::endpoint(asio::ip::make_address("127.0.0.3"), 11210);
+
+    REQUIRE(connect_race::interleave({ v6_1, v6_2, v4_1, v4_2, v4_3 }) ==
+            std::vector<asio::ip::tcp::endpoint>{ v6_1, v4_1, v6_2, v4_2, v4_3 });
+    REQUIRE(connect_race::interleave({ v4_1, v4_2, v6_1 }) == std::vector<asio::ip::tcp::endpoint>{ v4_1, v6_1, v4_2 });
+    REQUIRE(connect_race::interleave({ v4_1 }) == std::vector<asio::ip::tcp::endpoint>{ v4_1 });
+}
+
+TEST_CASE("unit: connect race moves to the next address as soon as the attempt fails", "[unit]")
+{
+    asio::io_context io;
+    asio::ip::tcp::acceptor acceptor(io, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+    auto refused = closed_port_endpoint(io);
+
+    // the delay is much longer than the test, so the second attempt can only be started by the failure of the first one
+    auto result = run_race(io, { refused, acceptor.local_endpoint() }, std::chrono::seconds(60));
+    REQUIRE_SUCCESS(result.ec);
+    REQUIRE(result.socket_is_open);
+    REQUIRE(result.endpoint == acceptor.local_endpoint());
+    REQUIRE(result.elapsed < std::chrono::seconds(5));
+}
+
+TEST_CASE("unit: connect race reports the error when no address accepts the connection", "[unit]")
+{
+    asio::io_context io;
+    auto refused = closed_port_endpoint(io);
+
+    auto result = run_race(io, { refused, refused }, std::chrono::milliseconds(10));
+    REQUIRE(result.ec == asio::error::connection_refused);
+    REQUIRE_FALSE(result.socket_is_open);
+
+    result = run_race(io, {}, std::chrono::milliseconds(10));
+    REQUIRE(result.ec == asio::error::host_not_found);
+}
+
+TEST_CASE("unit: cancelled connect race does not invoke the handler", "[unit]")
+{
+    asio::io_context io;
+    asio::ip::tcp::acceptor acceptor(io, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+
+    bool invoked{ false };
+    auto race = connect_race::start(asio::make_strand(io),
+                                    { acceptor.local_endpoint() },
+                                    std::chrono::milliseconds(10),
+                                    [&invoked](std::error_code, asio::ip::tcp::socket, asio::ip::tcp::endpoint) { invoked = true; });
+    race->cancel();
+    io.run_for(std::chrono::seconds(1));
+    REQUIRE_FALSE(invoked);
+}
+
+TEST_CASE("unit: resolve cache coalesces concurrent lookups and reuses the result", "[unit]")
+{
+    auto& cache = resolve_cache::instance();
+    cache.clear();
+
+    REQUIRE(resolve(cache, "11211", std::chrono::seconds(60)).first == std::error_code{});
+
+    // the handlers are invoked on the thread of the cache, so the lookup cannot complete while this handler is blocked
+    std::promise<void> blocked;
+    std::promise<void> release;
+    cache.resolve(ip_protocol::any,
+                  "127.0.0.1",
+                  "11211",
+                  std::chrono::seconds(60),
+                  std::chrono::seconds(1),
+                  std::chrono::seconds(10),
+                  [&blocked, wait = release.get_future().share()](auto, auto) {
+                      blocked.set_value();
+                      wait.wait();
+                  });
+    blocked.get_future().wait();
+
+    static constexpr std::size_t number_of_sessions{ 10 };
+    std::vector<std::future<std::vector<asio::ip::tcp::endpoint>>> results{};
+    for (std::size_t i = 0; i < number_of_sessions; ++i) {
+        auto barrier = std::make_shared<std::promise<std::vector<asio::ip::tcp::endpoint>>>();
+        results.emplace_back(barrier->get_future());
+        cache.resolve(ip_protocol::any,
+                      "127.0.0.1",
+                      "11210",
+                      std::chrono::seconds(60),
+                      std::chrono::seconds(1),
+                      std::chrono::seconds(10),
+                      [barrier](std::error_code ec, std::vector<asio::ip::tcp::endpoint> endpoints) {
+                          if (ec) {
+                              return barrier->set_value({});
+                          }
+                          barrier->set_value(std::move(endpoints));
+                      });
+    }
+    release.set_value();
+
+    for (auto& f : results) {
+        REQUIRE(f.get() == std::vector<asio::ip::tcp::endpoint>{ { asio::ip::make_address("127.0.0.1"), 11210 } });
+    }
+    auto stats = cache.stats();
+    REQUIRE(stats.misses == 2);
+    REQUIRE(stats.coalesced == number_of_sessions - 1);
+    REQUIRE(stats.hits == 1);
+
+    auto [ec, endpoints] = resolve(cache, "11210", std::chrono::seconds(60));
+    REQUIRE_SUCCESS(ec);
+    REQUIRE(endpoints.size() == 1);
+    REQUIRE(cache.stats().hits == 2);
+
+    cache.invalidate("127.0.0.1", "11210");
+    resolve(cache, "11210", std::chrono::seconds(60));
+    REQUIRE(cache.stats().misses == 3);
+}
+
+TEST_CASE("unit: resolve cache respects TTL and caches failures", "[unit]")
+{
+    auto& cache = resolve_cache::instance();
+    cache.clear();
+
+    // zero TTL disables caching
+    REQUIRE_SUCCESS(resolve(cache, "11210", std::chrono::milliseconds::zero()).first);
+    REQUIRE_SUCCESS(resolve(cache, "11210", std::chrono::milliseconds::zero()).first);
+    REQUIRE(cache.stats().misses == 2);
+    REQUIRE(cache.stats().hits == 0);
+
+    // unknown service name fails without asking DNS
+    auto ec = resolve(cache, "no-such-couchbase-service", std::chrono::seconds(60)).first;
+    REQUIRE(ec);
+    REQUIRE(resolve(cache, "no-such-couchbase-service", std::chrono::seconds(60)).first == ec);
+    REQUIRE(cache.stats().misses == 3);
+    REQUIRE(cache.stats().hits == 1);
+}
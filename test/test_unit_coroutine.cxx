@@ -0,0 +1,156 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "utils/mock_test_guard.hxx"
+
+#include <couchbase/coroutine.hxx>
+
+#include <tao/json.hpp>
+
+#include <atomic>
+#include <future>
+
+namespace
+{
+/**
+ * Coroutine that starts eagerly and is not awaited by anybody. Assertions are not thread-safe in Catch2, so the coroutines only
+ * count failures, and the test checks the counters once all of them finished.
+ */
+struct detached_task {
+    struct promise_type {
+        auto get_return_object() -> detached_task
+        {
+            return {};
+        }
+
+        auto initial_suspend() noexcept -> std::suspend_never
+        {
+            return {};
+        }
+
+        auto final_suspend() noexcept -> std::suspend_never
+        {
+            return {};
+        }
+
+        void return_void()
+        {
+        }
+
+        void unhandled_exception()
+        {
+            std::terminate();
+        }
+    };
+};
+
+struct completion_tracker {
+    explicit completion_tracker(std::size_t expected)
+      : pending{ expected }
+    {
+    }
+
+    void complete()
+    {
+        if (pending.fetch_sub(1) == 1) {
+            barrier.set_value();
+        }
+    }
+
+    std::atomic_size_t pending;
+    std::atomic_size_t failures{ 0 };
+    std::promise<void> barrier{};
+};
+
+auto
+kv_round_trip(couchbase::collection collection, std::string key, completion_tracker& tracker) -> detached_task
+{
+    const tao::json::value content{ { "key", key }, { "tags", tao::json::value::array({ "a", "b" }) } };
+
+    if (auto [ctx, result] = co_await couchbase::coro::upsert(collection, key, content); ctx.ec() || result.cas().empty()) {
+        ++tracker.failures;
+    }
+    if (auto [ctx, result] = co_await couchbase::coro::get(collection, key); ctx.ec() || result.content_as<tao::json::value>() != content) {
+        ++tracker.failures;
+    }
+    if (auto [ctx, result] = co_await couchbase::coro::mutate_in(
+          collection, key, couchbase::mutate_in_specs{ couchbase::mutate_in_specs::array_append("tags", "c") });
+        ctx.ec()) {
+        ++tracker.failures;
+    }
+    if (auto [ctx, result] =
+          co_await couchbase::coro::lookup_in(collection, key, couchbase::lookup_in_specs{ couchbase::lookup_in_specs::get("tags[-1]") });
+        ctx.ec() || result.content_as<std::string>(0) != "c") {
+        ++tracker.failures;
+    }
+    if (auto [ctx, result] = co_await couchbase::coro::remove(collection, key); ctx.ec()) {
+        ++tracker.failures;
+    }
+    if (auto [ctx, result] = co_await couchbase::coro::get(collection, key); ctx.ec() != couchbase::errc::key_value::document_not_found) {
+        ++tracker.failures;
+    }
+    tracker.complete();
+}
+
+auto
+query_rows(couchbase::cluster cluster, completion_tracker& tracker, std::vector<std::string>& rows) -> detached_task
+{
+    auto [ctx, result] = co_await couchbase::coro::query(cluster, "SELECT greeting FROM greetings");
+    if (ctx.ec()) {
+        ++tracker.failures;
+    } else {
+        for (const auto& row : result.rows_as_views()) {
+            rows.emplace_back(row);
+        }
+    }
+    tracker.complete();
+}
+} // namespace
+
+TEST_CASE("unit: awaitable KV operations", "[unit]")
+{
+    test::utils::mock_test_guard mock;
+    auto collection = couchbase::cluster(mock.cluster).bucket(mock.server.bucket_name()).default_collection();
+
+    // many more operations in flight, than there are threads
+    static constexpr std::size_t number_of_coroutines{ 1'000 };
+    completion_tracker tracker{ number_of_coroutines };
+    auto done = tracker.barrier.get_future();
+    for (std::size_t i = 0; i < number_of_coroutines; ++i) {
+        kv_round_trip(collection, test::utils::uniq_id("coro"), tracker);
+    }
+    REQUIRE(done.wait_for(std::chrono::seconds{ 30 }) == std::future_status::ready);
+    REQUIRE(tracker.failures == 0);
+    REQUIRE(mock.server.number_of_documents() == 0);
+}
+
+TEST_CASE("unit: awaitable query", "[unit]")
+{
+    test::utils::mock_server_options options{};
+    options.query_rows = { R"({"greeting":"hello"})", R"({"greeting":"world"})" };
+    test::utils::mock_test_guard mock(options);
+
+    completion_tracker tracker{ 1 };
+    auto done = tracker.barrier.get_future();
+    std::vector<std::string> rows{};
+    query_rows(couchbase::cluster(mock.cluster), tracker, rows);
+    REQUIRE(done.wait_for(std::chrono::seconds{ 10 }) == std::future_status::ready);
+    REQUIRE(tracker.failures == 0);
+    REQUIRE(rows == options.query_rows);
+}
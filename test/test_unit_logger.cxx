@@ -0,0 +1,122 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "core/logger/configuration.hxx"
+#include "core/logger/logger.hxx"
+
+#include <fmt/ranges.h>
+#include <spdlog/sinks/ostream_sink.h>
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+std::shared_ptr<spdlog::sinks::ostream_sink_mt>
+create_deferred_logger(std::ostringstream& output, couchbase::core::logger::overflow_policy policy, std::size_t buffer_size = 1024)
+{
+    auto sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(output);
+    couchbase::core::logger::configuration configuration{};
+    configuration.sink = sink;
+    configuration.console = false;
+    configuration.log_level = couchbase::core::logger::level::trace;
+    configuration.deferred_formatting = true;
+    configuration.per_thread_buffer_size = buffer_size;
+    configuration.overflow_policy = policy;
+    REQUIRE_FALSE(couchbase::core::logger::create_file_logger(configuration).has_value());
+    return sink;
+}
+} // namespace
+
+TEST_CASE("unit: deferred logger formats messages on background thread", "[unit]")
+{
+    std::ostringstream output;
+    auto sink = create_deferred_logger(output, couchbase::core::logger::overflow_policy::block);
+
+    {
+        std::string transient_string = "transient string";
+        std::string_view transient_view = transient_string;
+        CB_LOG_DEBUG("number={}, string=\"{}\", view=\"{}\"", 42, transient_string, transient_view);
+        // the arguments must be copied, so the caller is free to release them
+        transient_string.assign(transient_string.size(), 'X');
+    }
+    {
+        std::vector<int> numbers{ 1, 2, 3 };
+        // fmt::join() refers to the caller's container, so the message must be formatted before the call returns
+        STATIC_REQUIRE_FALSE(couchbase::core::logger::detail::are_deferrable_arguments_v<decltype(fmt::join(numbers, ","))>);
+        CB_LOG_INFO("non-deferrable argument: {}", fmt::join(numbers, ","));
+        numbers.assign(numbers.size(), 0);
+    }
+    CB_LOG_WARNING_RAW("raw message");
+    couchbase::core::logger::flush();
+
+    auto text = output.str();
+    REQUIRE(text.find(R"(number=42, string="transient string", view="transient string")") != std::string::npos);
+    REQUIRE(text.find("non-deferrable argument: 1,2,3") != std::string::npos);
+    REQUIRE(text.find("raw message") != std::string::npos);
+
+    couchbase::core::logger::shutdown();
+}
+
+TEST_CASE("unit: deferred logger preserves all messages with block overflow policy", "[unit]")
+{
+    std::ostringstream output;
+    auto sink = create_deferred_logger(output, couchbase::core::logger::overflow_policy::block, 16);
+
+    constexpr std::size_t number_of_threads{ 8 };
+    constexpr std::size_t messages_per_thread{ 1'000 };
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < number_of_threads; ++t) {
+        threads.emplace_back([t]() {
+            for (std::size_t i = 0; i < messages_per_thread; ++i) {
+                CB_LOG_TRACE("thread={}, message={}", t, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    couchbase::core::logger::flush();
+
+    auto text = output.str();
+    REQUIRE(static_cast<std::size_t>(std::count(text.begin(), text.end(), '\n')) == number_of_threads * messages_per_thread);
+    REQUIRE(couchbase::core::logger::dropped_messages() == 0);
+
+    couchbase::core::logger::shutdown();
+}
+
+TEST_CASE("unit: deferred logger counts dropped messages with drop overflow policy", "[unit]")
+{
+    std::ostringstream output;
+    auto sink = create_deferred_logger(output, couchbase::core::logger::overflow_policy::drop, 2);
+
+    constexpr std::size_t number_of_messages{ 10'000 };
+    for (std::size_t i = 0; i < number_of_messages; ++i) {
+        CB_LOG_TRACE("message={}", i);
+    }
+    couchbase::core::logger::flush();
+
+    auto text = output.str();
+    auto written = static_cast<std::size_t>(std::count(text.begin(), text.end(), '\n'));
+    REQUIRE(written + couchbase::core::logger::dropped_messages() == number_of_messages);
+
+    couchbase::core::logger::shutdown();
+}
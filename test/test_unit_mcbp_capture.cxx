@@ -0,0 +1,176 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "core/io/mcbp_capture.hxx"
+#include "core/io/mcbp_parser.hxx"
+#include "core/platform/dirutils.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+namespace
+{
+std::vector<std::byte>
+make_frame(std::uint8_t magic, std::uint8_t opcode, std::uint32_t opaque, std::string_view value)
+{
+    std::vector<std::byte> frame(couchbase::core::protocol::header_size + value.size());
+    frame[0] = static_cast<std::byte>(magic);
+    frame[1] = static_cast<std::byte>(opcode);
+    auto body_size = static_cast<std::uint32_t>(value.size());
+    frame[8] = static_cast<std::byte>(body_size >> 24U);
+    frame[9] = static_cast<std::byte>(body_size >> 16U);
+    frame[10] = static_cast<std::byte>(body_size >> 8U);
+    frame[11] = static_cast<std::byte>(body_size);
+    std::memcpy(frame.data() + 12, &opaque, sizeof(opaque));
+    std::memcpy(frame.data() + couchbase::core::protocol::header_size, value.data(), value.size());
+    return frame;
+}
+
+std::string
+capture_base_name()
+{
+    return (std::filesystem::temp_directory_path() / test::utils::uniq_id("mcbp_capture")).string();
+}
+
+void
+remove_capture_files(const std::string& base_name)
+{
+    for (const auto& file : couchbase::core::platform::find_files_with_prefix(base_name)) {
+        std::filesystem::remove(file);
+    }
+}
+} // namespace
+
+TEST_CASE("unit: MCBP capture could be replayed through the parser", "[unit]")
+{
+    couchbase::core::io::mcbp_capture_options options{};
+    options.path = capture_base_name();
+
+    auto session_id = couchbase::core::uuid::random();
+    auto request = make_frame(0x80, 0x00, 42, "");
+    auto response = make_frame(0x81, 0x00, 42, "hello");
+    std::string file_name;
+    {
+        auto writer = couchbase::core::io::mcbp_capture_writer::open(options);
+        REQUIRE(writer);
+        REQUIRE(writer == couchbase::core::io::mcbp_capture_writer::open(options));
+        file_name = writer->current_file();
+
+        writer->record(session_id, couchbase::core::io::capture_direction::send, request.data(), request.size());
+        // the response arrives in two chunks
+        writer->record(session_id, couchbase::core::io::capture_direction::receive, response.data(), 10);
+        writer->record(session_id, couchbase::core::io::capture_direction::receive, response.data() + 10, response.size() - 10);
+        writer->flush();
+        REQUIRE(writer->dropped_records() == 0);
+    }
+
+    std::vector<couchbase::core::io::mcbp_capture_record> records;
+    {
+        couchbase::core::io::mcbp_capture_reader reader(file_name);
+        couchbase::core::io::mcbp_capture_record record{};
+        while (reader.next(record)) {
+            records.emplace_back(std::move(record));
+        }
+    }
+    remove_capture_files(options.path);
+
+    REQUIRE(records.size() == 3);
+    REQUIRE(records[0].session_id == session_id);
+    REQUIRE(records[0].direction == couchbase::core::io::capture_direction::send);
+    REQUIRE(records[0].data == request);
+    REQUIRE(records[0].timestamp <= records[1].timestamp);
+
+    couchbase::core::io::mcbp_parser parser;
+    couchbase::core::io::mcbp_message msg{};
+    parser.feed(records[1].data.begin(), records[1].data.end());
+    REQUIRE(parser.next(msg) == couchbase::core::io::mcbp_parser::result::need_data);
+    parser.feed(records[2].data.begin(), records[2].data.end());
+    REQUIRE(parser.next(msg) == couchbase::core::io::mcbp_parser::result::ok);
+    REQUIRE(msg.header.opaque == 42);
+    REQUIRE(std::string(reinterpret_cast<const char*>(msg.body.data()), msg.body.size()) == "hello");
+}
+
+TEST_CASE("unit: MCBP capture rotates files", "[unit]")
+{
+    couchbase::core::io::mcbp_capture_options options{};
+    options.path = capture_base_name();
+    options.max_file_size = 1;
+    options.max_files = 2;
+
+    auto session_id = couchbase::core::uuid::random();
+    auto frame = make_frame(0x80, 0x00, 1, "value");
+    {
+        auto writer = couchbase::core::io::mcbp_capture_writer::open(options);
+        REQUIRE(writer);
+        auto first_file = writer->current_file();
+        for (int i = 0; i < 5; ++i) {
+            writer->record(session_id, couchbase::core::io::capture_direction::send, frame.data(), frame.size());
+            writer->flush();
+        }
+        REQUIRE(writer->current_file() != first_file);
+        REQUIRE_FALSE(std::filesystem::exists(first_file));
+    }
+    auto files = couchbase::core::platform::find_files_with_prefix(options.path);
+    remove_capture_files(options.path);
+    REQUIRE(files.size() == 2);
+}
+
+TEST_CASE("unit: MCBP capture does not store SASL credentials", "[unit]")
+{
+    couchbase::core::io::mcbp_capture_options options{};
+    options.path = capture_base_name();
+
+    auto session_id = couchbase::core::uuid::random();
+    using namespace std::literals::string_view_literals;
+    auto mechanism = "PLAIN"sv;
+    auto sasl_auth = make_frame(0x80, 0x21, 7, "PLAIN\0Administrator\0password"sv);
+    sasl_auth[3] = static_cast<std::byte>(mechanism.size());
+    std::string file_name;
+    {
+        auto writer = couchbase::core::io::mcbp_capture_writer::open(options);
+        REQUIRE(writer);
+        file_name = writer->current_file();
+#ifndef _MSC_VER
+        auto permissions = std::filesystem::status(file_name).permissions();
+        REQUIRE((permissions & (std::filesystem::perms::group_all | std::filesystem::perms::others_all)) == std::filesystem::perms::none);
+#endif
+        writer->record(session_id, couchbase::core::io::capture_direction::send, sasl_auth.data(), sasl_auth.size());
+        writer->flush();
+    }
+
+    couchbase::core::io::mcbp_capture_record record{};
+    {
+        couchbase::core::io::mcbp_capture_reader reader(file_name);
+        REQUIRE(reader.next(record));
+    }
+    remove_capture_files(options.path);
+
+    auto value_offset = couchbase::core::protocol::header_size + mechanism.size();
+    REQUIRE(record.data.size() == sasl_auth.size());
+    REQUIRE(std::equal(record.data.begin(), record.data.begin() + static_cast<std::ptrdiff_t>(value_offset), sasl_auth.begin()));
+    REQUIRE(std::all_of(record.data.begin() + static_cast<std::ptrdiff_t>(value_offset), record.data.end(), [](auto b) {
+        return b == std::byte{ 0 };
+    }));
+}
+
+TEST_CASE("unit: MCBP capture is disabled without path", "[unit]")
+{
+    REQUIRE_FALSE(couchbase::core::io::mcbp_capture_writer::open({}));
+}
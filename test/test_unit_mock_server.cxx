@@ -0,0 +1,288 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "utils/mock_test_guard.hxx"
+
+#include "core/operations/document_get.hxx"
+#include "core/operations/document_insert.hxx"
+#include "core/operations/document_lookup_in.hxx"
+#include "core/operations/document_mutate_in.hxx"
+#include "core/operations/document_query.hxx"
+#include "core/operations/document_remove.hxx"
+#include "core/operations/document_upsert.hxx"
+#include "core/protocol/client_opcode.hxx"
+#include "core/utils/json.hxx"
+
+#include <couchbase/cluster.hxx>
+#include <couchbase/codec/binary_noop_serializer.hxx>
+#include <couchbase/lookup_in_specs.hxx>
+#include <couchbase/mutate_in_specs.hxx>
+
+#include <future>
+#include <thread>
+
+TEST_CASE("unit: mock server serves basic KV operations", "[unit]")
+{
+    test::utils::mock_test_guard mock;
+
+    couchbase::core::document_id id{ mock.server.bucket_name(), "_default", "_default", test::utils::uniq_id("mock") };
+    const auto value = couchbase::core::utils::to_binary(R"({"name":"mock","tags":["a","b"]})");
+
+    {
+        auto resp = test::utils::execute(mock.cluster, couchbase::core::operations::get_request{ id });
+        REQUIRE(resp.ctx.ec() == couchbase::errc::key_value::document_not_found);
+    }
+    {
+        couchbase::core::operations::upsert_request req{ id, value };
+        req.flags = 0xcafe;
+        auto resp = test::utils::execute(mock.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+        REQUIRE_FALSE(resp.cas.empty());
+    }
+    {
+        auto resp = test::utils::execute(mock.cluster, couchbase::core::operations::get_request{ id });
+        REQUIRE_SUCCESS(resp.ctx.ec());
+        REQUIRE(resp.value == value);
+        REQUIRE(resp.flags == 0xcafe);
+    }
+    {
+        auto resp = test::utils::execute(mock.cluster, couchbase::core::operations::insert_request{ id, value });
+        REQUIRE(resp.ctx.ec() == couchbase::errc::key_value::document_exists);
+    }
+    {
+        auto resp = test::utils::execute(mock.cluster, couchbase::core::operations::remove_request{ id });
+        REQUIRE_SUCCESS(resp.ctx.ec());
+        REQUIRE(mock.server.number_of_documents() == 0);
+    }
+}
+
+TEST_CASE("unit: mock server serves subdocument operations", "[unit]")
+{
+    test::utils::mock_test_guard mock;
+
+    couchbase::core::document_id id{ mock.server.bucket_name(), "_default", "_default", test::utils::uniq_id("mock") };
+    mock.server.upsert_document(id.key(), R"({"name":"mock","tags":["a","b"]})");
+
+    {
+        couchbase::core::operations::mutate_in_request req{ id };
+        req.specs = couchbase::mutate_in_specs{
+            couchbase::mutate_in_specs::upsert("nested.field", 42).create_path(),
+            couchbase::mutate_in_specs::increment("counter", 3),
+            couchbase::mutate_in_specs::array_append("tags", "c"),
+        }.specs();
+        auto resp = test::utils::execute(mock.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+        REQUIRE(resp.fields.size() == 3);
+        REQUIRE(test::utils::to_string(resp.fields[1].value) == "3");
+    }
+    {
+        couchbase::core::operations::lookup_in_request req{ id };
+        req.specs = couchbase::lookup_in_specs{
+            couchbase::lookup_in_specs::get("nested.field"),
+            couchbase::lookup_in_specs::get("tags[-1]"),
+            couchbase::lookup_in_specs::exists("missing"),
+        }.specs();
+        auto resp = test::utils::execute(mock.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+        REQUIRE(resp.fields.size() == 3);
+        REQUIRE(test::utils::to_string(resp.fields[0].value) == "42");
+        REQUIRE(test::utils::to_string(resp.fields[1].value) == R"("c")");
+        REQUIRE_FALSE(resp.fields[2].exists);
+    }
+}
+
+TEST_CASE("unit: mock server serves queries", "[unit]")
+{
+    test::utils::mock_server_options options{};
+    options.query_rows = { R"({"greeting":"hello"})", R"({"greeting":"world"})" };
+    test::utils::mock_test_guard mock(options);
+
+    auto resp = test::utils::execute(mock.cluster, couchbase::core::operations::query_request{ "SELECT greeting FROM greetings" });
+    REQUIRE_SUCCESS(resp.ctx.ec);
+    REQUIRE(resp.rows.size() == 2);
+    REQUIRE(couchbase::core::utils::json::parse(resp.rows[1]) == couchbase::core::utils::json::parse(options.query_rows[1]));
+
+    {
+        auto cluster = couchbase::cluster(mock.cluster);
+        auto [ctx, result] = cluster.query("SELECT greeting FROM greetings", {}).get();
+        REQUIRE_SUCCESS(ctx.ec());
+        REQUIRE(result.rows_count() == 2);
+        REQUIRE(result.row_view(0) == options.query_rows[0]);
+        REQUIRE(result.rows_as_views() == std::vector<std::string_view>{ options.query_rows[0], options.query_rows[1] });
+        REQUIRE(result.rows_as_json()[1]["greeting"] == "world");
+        auto binary_rows = result.rows_as<couchbase::codec::binary_noop_serializer>();
+        REQUIRE(binary_rows.size() == 2);
+        REQUIRE(binary_rows[1] == couchbase::core::utils::to_binary(options.query_rows[1]));
+    }
+}
+
+TEST_CASE("unit: mock server injects faults", "[unit]")
+{
+    test::utils::mock_server_options options{};
+    options.fault_injector = [](std::uint8_t opcode, std::string_view key) -> std::optional<couchbase::key_value_status_code> {
+        if (opcode == static_cast<std::uint8_t>(couchbase::core::protocol::client_opcode::upsert) && key == "too-big") {
+            return couchbase::key_value_status_code::too_big;
+        }
+        return {};
+    };
+    test::utils::mock_test_guard mock(options);
+
+    const auto value = couchbase::core::utils::to_binary("{}");
+    {
+        couchbase::core::document_id id{ mock.server.bucket_name(), "_default", "_default", "too-big" };
+        auto resp = test::utils::execute(mock.cluster, couchbase::core::operations::upsert_request{ id, value });
+        REQUIRE(resp.ctx.ec() == couchbase::errc::key_value::value_too_large);
+    }
+    {
+        couchbase::core::document_id id{ mock.server.bucket_name(), "_default", "_default", "just-right" };
+        auto resp = test::utils::execute(mock.cluster, couchbase::core::operations::upsert_request{ id, value });
+        REQUIRE_SUCCESS(resp.ctx.ec());
+    }
+}
+
+TEST_CASE("unit: legacy durability does not wait for fixed poll interval", "[unit]")
+{
+    test::utils::mock_server_options options{};
+    options.number_of_replicas = 1;
+    options.replication_delay = std::chrono::milliseconds{ 2 };
+    test::utils::mock_test_guard mock(options);
+
+    auto collection = couchbase::cluster(mock.cluster).bucket(mock.server.bucket_name()).default_collection();
+    auto upsert_options = couchbase::upsert_options{}.durability(couchbase::persist_to::active, couchbase::replicate_to::one);
+
+    auto start = std::chrono::steady_clock::now();
+    auto [ctx, result] = collection.upsert(test::utils::uniq_id("legacy"), tao::json::value{ { "a", 1 } }, upsert_options).get();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    REQUIRE_SUCCESS(ctx.ec());
+    REQUIRE(result.mutation_token().has_value());
+    REQUIRE(mock.server.number_of_requests(static_cast<std::uint8_t>(couchbase::core::protocol::client_opcode::observe_seqno)) >= 2);
+    // the mutation is replicated after 2ms, the polling must not round it up to the old fixed interval of 500ms
+    REQUIRE(elapsed < std::chrono::milliseconds{ 250 });
+}
+
+TEST_CASE("unit: hedged get falls back to replica when active node stalls", "[unit]")
+{
+    test::utils::mock_server_options options{};
+    options.number_of_replicas = 1;
+    options.latency_injector = [](std::uint8_t opcode) {
+        if (opcode == static_cast<std::uint8_t>(couchbase::core::protocol::client_opcode::get)) {
+            return std::chrono::microseconds{ std::chrono::seconds{ 1 } };
+        }
+        return std::chrono::microseconds::zero();
+    };
+    test::utils::mock_test_guard mock(options);
+
+    const auto key = test::utils::uniq_id("hedged");
+    mock.server.upsert_document(key, R"({"a":1})");
+    auto collection = couchbase::cluster(mock.cluster).bucket(mock.server.bucket_name()).default_collection();
+    const auto get_replica = static_cast<std::uint8_t>(couchbase::core::protocol::client_opcode::get_replica);
+
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto [ctx, result] = collection.get(key, couchbase::get_options{}.hedge_after(std::chrono::milliseconds{ 10 })).get();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        REQUIRE_SUCCESS(ctx.ec());
+        REQUIRE(result.content_as<tao::json::value>() == tao::json::value{ { "a", 1 } });
+        REQUIRE(mock.server.number_of_requests(get_replica) == 1);
+        REQUIRE(elapsed < std::chrono::milliseconds{ 500 });
+    }
+
+    {
+        // the active node responds before the delay expires, the replica is not asked
+        auto [ctx, result] = collection.get(key, couchbase::get_options{}.hedge_after(std::chrono::seconds{ 5 })).get();
+        REQUIRE_SUCCESS(ctx.ec());
+        REQUIRE(mock.server.number_of_requests(get_replica) == 1);
+    }
+
+    {
+        auto [ctx, result] = collection.get("missing", couchbase::get_options{}.hedge_after(std::chrono::milliseconds{ 10 })).get();
+        REQUIRE(ctx.ec() == couchbase::errc::key_value::document_not_found);
+    }
+}
+
+TEST_CASE("unit: hedged get does not return replica copy after definitive response of active node", "[unit]")
+{
+    const auto get = static_cast<std::uint8_t>(couchbase::core::protocol::client_opcode::get);
+    const auto get_replica = static_cast<std::uint8_t>(couchbase::core::protocol::client_opcode::get_replica);
+
+    test::utils::mock_server_options options{};
+    options.number_of_replicas = 1;
+    // the active node reports the document as removed, while the slower replica still has the stale copy
+    options.fault_injector = [get](std::uint8_t opcode, std::string_view /* key */) -> std::optional<couchbase::key_value_status_code> {
+        if (opcode == get) {
+            return couchbase::key_value_status_code::not_found;
+        }
+        return {};
+    };
+    options.latency_injector = [get, get_replica](std::uint8_t opcode) {
+        if (opcode == get) {
+            return std::chrono::microseconds{ std::chrono::milliseconds{ 100 } };
+        }
+        if (opcode == get_replica) {
+            return std::chrono::microseconds{ std::chrono::milliseconds{ 300 } };
+        }
+        return std::chrono::microseconds::zero();
+    };
+    test::utils::mock_test_guard mock(options);
+
+    const auto key = test::utils::uniq_id("hedged");
+    mock.server.upsert_document(key, R"({"a":1})");
+    auto collection = couchbase::cluster(mock.cluster).bucket(mock.server.bucket_name()).default_collection();
+
+    auto [ctx, result] = collection.get(key, couchbase::get_options{}.hedge_after(std::chrono::milliseconds{ 10 })).get();
+    REQUIRE(ctx.ec() == couchbase::errc::key_value::document_not_found);
+    REQUIRE(mock.server.number_of_requests(get_replica) == 1);
+}
+
+TEST_CASE("unit: sessions are spread over IO shards owned by the cluster", "[unit]")
+{
+    test::utils::mock_test_guard mock({}, 1, 2);
+    const auto io_thread = mock.io_threads.front().get_id();
+
+    couchbase::core::document_id id{ mock.server.bucket_name(), "_default", "_default", test::utils::uniq_id("shard") };
+    {
+        couchbase::core::operations::upsert_request req{ id, couchbase::core::utils::to_binary("{}") };
+        auto resp = test::utils::execute(mock.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+    }
+
+    // the completions are invoked on the thread of the shard that owns the socket
+    {
+        auto barrier = std::make_shared<std::promise<std::pair<std::error_code, std::thread::id>>>();
+        auto f = barrier->get_future();
+        mock.cluster->execute(couchbase::core::operations::get_request{ id }, [barrier](couchbase::core::operations::get_response&& resp) {
+            barrier->set_value({ resp.ctx.ec(), std::this_thread::get_id() });
+        });
+        auto [ec, completion_thread] = f.get();
+        REQUIRE_SUCCESS(ec);
+        REQUIRE(completion_thread != io_thread);
+        REQUIRE(completion_thread != std::this_thread::get_id());
+    }
+    {
+        auto barrier = std::make_shared<std::promise<std::pair<std::error_code, std::thread::id>>>();
+        auto f = barrier->get_future();
+        mock.cluster->execute(couchbase::core::operations::query_request{ "SELECT 1" },
+                              [barrier](couchbase::core::operations::query_response&& resp) {
+                                  barrier->set_value({ resp.ctx.ec, std::this_thread::get_id() });
+                              });
+        auto [ec, completion_thread] = f.get();
+        REQUIRE_SUCCESS(ec);
+        REQUIRE(completion_thread != io_thread);
+    }
+}
@@ -17,7 +17,12 @@
 
 #include "test_helper.hxx"
 
+#include "core/cluster_options.hxx"
 #include "core/impl/encoded_search_query.hxx"
+#include "core/io/query_cache.hxx"
+#include "core/operations/document_search.hxx"
+#include "core/topology/configuration.hxx"
+#include "core/utils/json.hxx"
 
 #include <couchbase/boolean_field_query.hxx>
 #include <couchbase/boolean_query.hxx>
@@ -425,3 +430,189 @@ auto query = couchbase::geo_polygon_query({
 }
 )"_json);
 }
+
+TEST_CASE("unit: search request splices encoded query, sort and facets into the body", "[unit]")
+{
+    couchbase::core::topology::configuration config{};
+    couchbase::core::query_cache query_cache{};
+    couchbase::core::cluster_options cluster_options{};
+    couchbase::core::http_context ctx{ config, cluster_options, query_cache, "192.168.106.128", 8094 };
+
+    couchbase::core::io::http_request encoded{};
+    encoded.timeout = std::chrono::milliseconds{ 75'000 };
+
+    couchbase::core::operations::search_request req{};
+    req.index_name = "travel-sample-index";
+    req.query = couchbase::core::utils::json::generate_binary(R"({"match":"pool","field":"description"})"_json);
+    req.limit = 10;
+    req.sort_specs = { R"("-_score")", R"({"by":"id","desc":true})" };
+    req.facets = { { "types", R"({"field":"type","size":3})" } };
+    req.raw = { { "size", std::string{ "5" } } };
+    REQUIRE_SUCCESS(req.encode_to(encoded, ctx));
+
+    // the strict parser rejects duplicate keys
+    auto body = tao::json::from_string(encoded.body);
+    REQUIRE(body["query"] == R"({"match":"pool","field":"description"})"_json);
+    REQUIRE(body["sort"] == R"(["-_score",{"by":"id","desc":true}])"_json);
+    REQUIRE(body["facets"] == R"({"types":{"field":"type","size":3}})"_json);
+    REQUIRE(body["ctl"]["timeout"] == 75'000);
+    // raw options override the options of the request
+    REQUIRE(body["size"] == 5);
+}
+
+TEST_CASE("unit: raw search options replace spliced query and sort specs", "[unit]")
+{
+    couchbase::core::topology::configuration config{};
+    couchbase::core::query_cache query_cache{};
+    couchbase::core::cluster_options cluster_options{};
+    couchbase::core::http_context ctx{ config, cluster_options, query_cache, "192.168.106.128", 8094 };
+
+    couchbase::core::io::http_request encoded{};
+    encoded.timeout = std::chrono::milliseconds{ 75'000 };
+
+    couchbase::core::operations::search_request req{};
+    req.index_name = "travel-sample-index";
+    req.query = std::string{ R"({"match":"pool"})" };
+    req.sort_specs = { R"("-_score")" };
+    req.raw = {
+        { "query", std::string{ R"({"match_all":{}})" } },
+        { "sort", std::string{ R"(["_id"])" } },
+        { "ctl", std::string{ R"({"timeout":1000})" } },
+    };
+    REQUIRE_SUCCESS(req.encode_to(encoded, ctx));
+
+    auto body = tao::json::from_string(encoded.body);
+    REQUIRE(body.get_object().size() == 3);
+    REQUIRE(body["query"] == R"({"match_all":{}})"_json);
+    REQUIRE(body["sort"] == R"(["_id"])"_json);
+    REQUIRE(body["ctl"] == R"({"timeout":1000})"_json);
+}
+
+TEST_CASE("unit: decode search hit", "[unit]")
+{
+    auto row = couchbase::core::operations::decode_search_hit(R"(
+{
+  "index": "travel-sample-index_33af8fca1d2c8e4a_4c1c5584",
+  "id": "hotel_26223",
+  "score": 0.5,
+  "sort": ["_score"],
+  "locations": {
+    "description": {
+      "pool": [
+        {"pos": 8, "start": 38, "end": 42, "array_positions": null},
+        {"pos": 12, "start": 60, "end": 64, "array_positions": [1, 2]}
+      ]
+    },
+    "name": {
+      "pool": [{"pos": 1, "start": 0, "end": 4}]
+    }
+  },
+  "fragments": {
+    "description": ["the <mark>pool</mark> is open", "second"],
+    "name": ["<mark>pool</mark> house"]
+  },
+  "fields": {"city": "San Francisco", "reviews": [{"ratings": {"Overall": 4}}], "free_parking": true, "distance": null},
+  "explanation": {"value": 0.5, "message": "sum of:", "children": []}
+}
+)");
+
+    REQUIRE(row.index == "travel-sample-index_33af8fca1d2c8e4a_4c1c5584");
+    REQUIRE(row.id == "hotel_26223");
+    REQUIRE(row.score == 0.5);
+
+    REQUIRE(row.locations.size() == 3);
+    REQUIRE(row.locations[0].field == "description");
+    REQUIRE(row.locations[0].term == "pool");
+    REQUIRE(row.locations[0].position == 8);
+    REQUIRE(row.locations[0].start_offset == 38);
+    REQUIRE(row.locations[0].end_offset == 42);
+    REQUIRE_FALSE(row.locations[0].array_positions.has_value());
+    REQUIRE(row.locations[1].array_positions == std::vector<std::uint64_t>{ 1, 2 });
+    REQUIRE(row.locations[2].field == "name");
+    REQUIRE(row.locations[2].position == 1);
+
+    REQUIRE(row.fragments.size() == 2);
+    REQUIRE(row.fragments["description"] == std::vector<std::string>{ "the <mark>pool</mark> is open", "second" });
+    REQUIRE(row.fragments["name"] == std::vector<std::string>{ "<mark>pool</mark> house" });
+
+    REQUIRE(couchbase::core::utils::json::parse(row.fields) ==
+            R"({"city": "San Francisco", "reviews": [{"ratings": {"Overall": 4}}], "free_parking": true, "distance": null})"_json);
+    REQUIRE(couchbase::core::utils::json::parse(row.explanation) == R"({"value": 0.5, "message": "sum of:", "children": []})"_json);
+}
+
+TEST_CASE("unit: search hits are passed to the callback as soon as they are received", "[unit]")
+{
+    couchbase::core::topology::configuration config{};
+    couchbase::core::query_cache query_cache{};
+    couchbase::core::cluster_options cluster_options{};
+    couchbase::core::http_context ctx{ config, cluster_options, query_cache, "192.168.106.128", 8094 };
+
+    couchbase::core::io::http_request encoded{};
+    encoded.timeout = std::chrono::milliseconds{ 75'000 };
+
+    std::vector<std::string> ids{};
+    couchbase::core::operations::search_request req{};
+    req.index_name = "travel-sample-index";
+    req.query = std::string{ R"({"match":"pool"})" };
+    req.hit_callback = [&ids](couchbase::core::operations::search_response::search_row&& row) {
+        ids.emplace_back(std::move(row.id));
+        return ids.size() < 2 ? couchbase::core::utils::json::stream_control::next_row : couchbase::core::utils::json::stream_control::stop;
+    };
+    REQUIRE_SUCCESS(req.encode_to(encoded, ctx));
+    REQUIRE(encoded.streaming.has_value());
+
+    couchbase::core::io::http_response response{};
+    response.status_code = 200;
+    response.body.use_json_streaming(std::move(encoded.streaming.value()));
+    const std::string payload = R"({"status":{"total":1,"failed":0,"successful":1},"hits":[)"
+                                R"({"index":"i","id":"hotel_1","score":3.5},)"
+                                R"({"index":"i","id":"hotel_2","score":2.5},)"
+                                R"({"index":"i","id":"hotel_3","score":1.5}],)"
+                                R"("total_hits":3,"max_score":3.5,"took":1000,"facets":null})";
+    response.body.append(payload.substr(0, 70));
+    REQUIRE(ids.empty());
+    response.body.append(payload.substr(70));
+    // the handler has asked to stop after the second hit
+    REQUIRE(ids == std::vector<std::string>{ "hotel_1", "hotel_2" });
+
+    auto resp = req.make_response({}, response);
+    REQUIRE_SUCCESS(resp.ctx.ec);
+    REQUIRE(resp.rows.empty());
+    REQUIRE(resp.meta.metrics.total_rows == 3);
+    REQUIRE(resp.meta.metrics.success_partition_count == 1);
+}
+
+TEST_CASE("unit: search hit that cannot be decoded fails the request", "[unit]")
+{
+    couchbase::core::topology::configuration config{};
+    couchbase::core::query_cache query_cache{};
+    couchbase::core::cluster_options cluster_options{};
+    couchbase::core::http_context ctx{ config, cluster_options, query_cache, "192.168.106.128", 8094 };
+
+    couchbase::core::io::http_request encoded{};
+    encoded.timeout = std::chrono::milliseconds{ 75'000 };
+
+    std::vector<std::string> ids{};
+    couchbase::core::operations::search_request req{};
+    req.index_name = "travel-sample-index";
+    req.query = std::string{ R"({"match":"pool"})" };
+    req.hit_callback = [&ids](couchbase::core::operations::search_response::search_row&& row) {
+        ids.emplace_back(std::move(row.id));
+        return couchbase::core::utils::json::stream_control::next_row;
+    };
+    REQUIRE_SUCCESS(req.encode_to(encoded, ctx));
+
+    couchbase::core::io::http_response response{};
+    response.status_code = 200;
+    response.body.use_json_streaming(std::move(encoded.streaming.value()));
+    // the lexer does not validate UTF-8, but the decoder of the hit does
+    response.body.append(R"({"status":{"total":1,"failed":0,"successful":1},"hits":[)"
+                         R"({"index":"i","id":"hotel_1","score":3.5},)"
+                         "{\"index\":\"i\",\"id\":\"hotel_\xff\",\"score\":2.5},"
+                         R"({"index":"i","id":"hotel_3","score":1.5}],)"
+                         R"("total_hits":3,"max_score":3.5,"took":1000,"facets":null})");
+    REQUIRE(ids == std::vector<std::string>{ "hotel_1" });
+
+    auto resp = req.make_response({}, response);
+    REQUIRE(resp.ctx.ec == couchbase::errc::common::parsing_failure);
+}
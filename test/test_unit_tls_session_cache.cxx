@@ -0,0 +1,224 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "core/diagnostics_json.hxx"
+#include "core/io/streams.hxx"
+#include "core/io/tls_session_cache.hxx"
+#include "core/platform/uuid.h"
+
+#include <asio.hpp>
+#include <asio/ssl.hpp>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+#include <tao/json.hpp>
+
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace
+{
+void
+use_self_signed_certificate(asio::ssl::context& tls)
+{
+    EVP_PKEY* key = nullptr;
+    EVP_PKEY_CTX* key_ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+    REQUIRE(EVP_PKEY_keygen_init(key_ctx) == 1);
+    REQUIRE(EVP_PKEY_CTX_set_ec_paramgen_curve_nid(key_ctx, NID_X9_62_prime256v1) == 1);
+    REQUIRE(EVP_PKEY_keygen(key_ctx, &key) == 1);
+    EVP_PKEY_CTX_free(key_ctx);
+
+    X509* certificate = X509_new();
+    X509_set_version(certificate, 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(certificate), 1);
+    X509_gmtime_adj(X509_getm_notBefore(certificate), 0);
+    X509_gmtime_adj(X509_getm_notAfter(certificate), 3600);
+    X509_set_pubkey(certificate, key);
+    X509_NAME_add_entry_by_txt(
+      X509_get_subject_name(certificate), "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+    X509_set_issuer_name(certificate, X509_get_subject_name(certificate));
+    REQUIRE(X509_sign(certificate, key, EVP_sha256()) > 0);
+
+    REQUIRE(SSL_CTX_use_certificate(tls.native_handle(), certificate) == 1);
+    REQUIRE(SSL_CTX_use_PrivateKey(tls.native_handle(), key) == 1);
+    X509_free(certificate);
+    EVP_PKEY_free(key);
+}
+
+/**
+ * OpenSSL server, that completes the handshake, sends one byte, and keeps the connection open until the client closes it.
+ */
+class tls_server
+{
+  public:
+    tls_server(asio::io_context& io, int max_protocol_version)
+      : acceptor_(io, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0))
+    {
+        use_self_signed_certificate(tls_);
+        SSL_CTX_set_max_proto_version(tls_.native_handle(), max_protocol_version);
+        do_accept();
+    }
+
+    [[nodiscard]] auto endpoint() const -> asio::ip::tcp::endpoint
+    {
+        return acceptor_.local_endpoint();
+    }
+
+  private:
+    using tls_socket = asio::ssl::stream<asio::ip::tcp::socket>;
+
+    void do_accept()
+    {
+        acceptor_.async_accept([this](std::error_code ec, asio::ip::tcp::socket socket) {
+            if (ec) {
+                return;
+            }
+            auto connection = std::make_shared<tls_socket>(std::move(socket), tls_);
+            connections_.push_back(connection);
+            connection->async_handshake(asio::ssl::stream_base::server, [connection](std::error_code ec_handshake) {
+                if (ec_handshake) {
+                    return;
+                }
+                static const char greeting = 'x';
+                asio::async_write(*connection, asio::buffer(&greeting, 1), [connection](std::error_code, std::size_t) {
+                    auto buffer = std::make_shared<char>();
+                    connection->async_read_some(asio::buffer(buffer.get(), 1), [connection, buffer](std::error_code, std::size_t) {});
+                });
+            });
+            do_accept();
+        });
+    }
+
+    asio::ssl::context tls_{ asio::ssl::context::tls_server };
+    asio::ip::tcp::acceptor acceptor_;
+    std::vector<std::shared_ptr<tls_socket>> connections_{};
+};
+
+class io_thread
+{
+  public:
+    explicit io_thread(asio::io_context& io)
+      : io_(io)
+      , thread_([&io]() { io.run(); })
+    {
+    }
+    io_thread(const io_thread&) = delete;
+    io_thread(io_thread&&) = delete;
+    auto operator=(const io_thread&) -> io_thread& = delete;
+    auto operator=(io_thread&&) -> io_thread& = delete;
+
+    ~io_thread()
+    {
+        io_.stop();
+        thread_.join();
+    }
+
+  private:
+    asio::io_context& io_;
+    std::thread thread_;
+};
+
+void
+connect_and_close(asio::io_context& io, asio::ssl::context& tls, const asio::ip::tcp::endpoint& endpoint)
+{
+    couchbase::core::io::tls_stream_impl stream(io, tls);
+    stream.set_server_name("localhost", std::to_string(endpoint.port()));
+
+    std::promise<std::error_code> connected;
+    stream.async_connect(endpoint, [&connected](std::error_code ec) { connected.set_value(ec); });
+    REQUIRE_SUCCESS(connected.get_future().get());
+
+    // with TLS 1.3 the session tickets are sent after the handshake, and the client processes them while reading the data
+    char greeting{};
+    std::promise<std::error_code> received;
+    stream.async_read_some(asio::buffer(&greeting, 1), [&received](std::error_code ec, std::size_t) { received.set_value(ec); });
+    REQUIRE_SUCCESS(received.get_future().get());
+    REQUIRE(greeting == 'x');
+
+    std::promise<void> closed;
+    stream.close([&closed](std::error_code) { closed.set_value(); });
+    closed.get_future().get();
+}
+} // namespace
+
+TEST_CASE("unit: TLS sessions are resumed on reconnect", "[unit]")
+{
+    auto [protocol, max_protocol_version] = GENERATE(table<std::string, int>({
+      { "TLS 1.2", TLS1_2_VERSION },
+      { "TLS 1.3", TLS1_3_VERSION },
+    }));
+    INFO(protocol);
+
+    asio::io_context io;
+    tls_server server(io, max_protocol_version);
+    io_thread runner(io);
+
+    asio::ssl::context tls(asio::ssl::context::tls_client);
+    tls.set_verify_mode(asio::ssl::verify_none);
+    auto sessions = std::make_shared<couchbase::core::io::tls_session_cache>();
+    couchbase::core::io::tls_session_cache::attach(sessions, tls);
+    REQUIRE(couchbase::core::io::tls_session_cache::from(tls) == sessions);
+
+    static constexpr std::uint64_t number_of_connections{ 3 };
+    for (std::uint64_t i = 0; i < number_of_connections; ++i) {
+        connect_and_close(io, tls, server.endpoint());
+    }
+
+    auto stats = sessions->stats();
+    REQUIRE(stats.size() == 1);
+    REQUIRE(stats[0].remote == fmt::format("localhost:{}", server.endpoint().port()));
+    REQUIRE(stats[0].handshakes == number_of_connections);
+    // only the first connection does full handshake
+    REQUIRE(stats[0].resumed_handshakes == number_of_connections - 1);
+
+    couchbase::core::diag::diagnostics_result report{ "report", "sdk" };
+    report.tls_sessions = stats;
+    auto json = tao::json::value(report);
+    REQUIRE(json["tls_sessions"][0]["handshakes"].as<std::uint64_t>() == number_of_connections);
+    REQUIRE(json["tls_sessions"][0]["resumed_handshakes"].as<std::uint64_t>() == number_of_connections - 1);
+}
+
+TEST_CASE("unit: TLS stream keeps session cache alive after it has been released by the owner", "[unit]")
+{
+    asio::io_context io;
+    tls_server server(io, TLS1_3_VERSION);
+    io_thread runner(io);
+
+    asio::ssl::context tls(asio::ssl::context::tls_client);
+    tls.set_verify_mode(asio::ssl::verify_none);
+    auto sessions = std::make_shared<couchbase::core::io::tls_session_cache>();
+    couchbase::core::io::tls_session_cache::attach(sessions, tls);
+    std::weak_ptr<couchbase::core::io::tls_session_cache> weak_sessions = sessions;
+
+    couchbase::core::io::tls_stream_impl stream(io, tls);
+    stream.set_server_name("localhost", std::to_string(server.endpoint().port()));
+    std::promise<std::error_code> connected;
+    stream.async_connect(server.endpoint(), [&connected](std::error_code ec) { connected.set_value(ec); });
+    REQUIRE_SUCCESS(connected.get_future().get());
+
+    // the owner (the cluster) is gone, but the stream still has to store its session when it is closed
+    sessions.reset();
+    REQUIRE_FALSE(weak_sessions.expired());
+    REQUIRE(couchbase::core::io::tls_session_cache::from(tls) != nullptr);
+
+    std::promise<void> closed;
+    stream.close([&closed](std::error_code) { closed.set_value(); });
+    closed.get_future().get();
+}
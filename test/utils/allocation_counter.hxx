@@ -0,0 +1,46 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace test::utils
+{
+/**
+ * @return number of calls to the global operator new since the start of the process
+ *
+ * The counter is only available for the targets, that link test_allocation_counter, as it replaces global allocation functions.
+ */
+auto
+number_of_allocations() -> std::size_t;
+
+/**
+ * Runs the operation given number of times and returns average number of heap allocations per iteration. The counter is process-wide,
+ * so the allocations made by the other threads are included as well.
+ */
+template<typename Operation>
+auto
+allocations_per_operation(std::size_t iterations, Operation&& operation) -> double
+{
+    auto before = number_of_allocations();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        operation();
+    }
+    return static_cast<double>(number_of_allocations() - before) / static_cast<double>(iterations);
+}
+} // namespace test::utils
@@ -101,6 +101,8 @@ integration_test_guard::integration_test_guard(const couchbase::core::cluster_op
     connstr.options.meter = opts.meter;
     connstr.options.tracer = opts.tracer;
     connstr.options.enable_mutation_tokens = opts.enable_mutation_tokens;
+    connstr.options.io_shards = opts.io_shards;
+    connstr.options.pin_io_shards = opts.pin_io_shards;
     origin = build_origin(ctx, auth, connstr);
     io_threads = spawn_io_threads(io, ctx.number_of_io_threads);
     open_cluster(cluster, origin);
@@ -0,0 +1,1824 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "mock_server.hxx"
+
+#include "core/platform/base64.h"
+#include "core/protocol/client_opcode.hxx"
+#include "core/protocol/hello_feature.hxx"
+#include "core/protocol/magic.hxx"
+#include "core/utils/connection_string.hxx"
+#include "core/utils/crc32.hxx"
+#include "core/utils/json.hxx"
+
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/post.hpp>
+#include <asio/steady_timer.hpp>
+#include <asio/write.hpp>
+#include <fmt/core.h>
+#include <tao/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <variant>
+
+namespace test::utils
+{
+namespace
+{
+using couchbase::key_value_status_code;
+namespace protocol = couchbase::core::protocol;
+
+constexpr std::size_t header_size{ 24 };
+
+constexpr std::uint8_t path_flag_create_parents{ 0x01 };
+constexpr std::uint8_t path_flag_xattr{ 0x04 };
+constexpr std::uint8_t doc_flag_mkdoc{ 0x01 };
+constexpr std::uint8_t doc_flag_add{ 0x02 };
+constexpr std::uint8_t datatype_json{ 0x01 };
+
+constexpr std::array supported_features{
+    protocol::hello_feature::tcp_nodelay, protocol::hello_feature::xattr,
+    protocol::hello_feature::select_bucket, protocol::hello_feature::json,
+    protocol::hello_feature::unordered_execution, protocol::hello_feature::collections,
+    protocol::hello_feature::mutation_seqno,
+};
+
+auto
+read_uint(const std::byte* data, std::size_t size) -> std::uint64_t
+{
+    std::uint64_t value{ 0 };
+    for (std::size_t i = 0; i < size; ++i) {
+        value = (value << 8U) | std::to_integer<std::uint64_t>(data[i]);
+    }
+    return value;
+}
+
+void
+append_uint(std::vector<std::byte>& out, std::uint64_t value, std::size_t size)
+{
+    for (std::size_t i = size; i > 0; --i) {
+        out.push_back(static_cast<std::byte>(value >> (8 * (i - 1))));
+    }
+}
+
+void
+append_uint(std::string& out, std::uint64_t value, std::size_t size)
+{
+    for (std::size_t i = size; i > 0; --i) {
+        out.push_back(static_cast<char>(value >> (8 * (i - 1))));
+    }
+}
+
+void
+append_leb128(std::string& out, std::uint64_t value)
+{
+    do {
+        auto byte = static_cast<std::uint8_t>(value & 0x7fU);
+        value >>= 7U;
+        if (value != 0) {
+            byte |= 0x80U;
+        }
+        out.push_back(static_cast<char>(byte));
+    } while (value != 0);
+}
+
+struct mock_request {
+    std::uint8_t magic{ 0 };
+    std::uint8_t opcode{ 0 };
+    std::uint8_t datatype{ 0 };
+    std::uint16_t vbucket{ 0 };
+    std::array<std::byte, 4> opaque{};
+    std::uint64_t cas{ 0 };
+    std::vector<std::byte> extras{};
+    std::string key{};
+    std::string value{};
+};
+
+struct mock_response {
+    key_value_status_code status{ key_value_status_code::success };
+    std::uint64_t cas{ 0 };
+    std::uint8_t datatype{ 0 };
+    std::vector<std::byte> extras{};
+    std::string value{};
+};
+
+/**
+ * Extracts the next complete request from the input buffer.
+ */
+auto
+parse_request(std::vector<std::byte>& input, mock_request& req) -> bool
+{
+    if (input.size() < header_size) {
+        return false;
+    }
+    auto body_size = static_cast<std::size_t>(read_uint(input.data() + 8, 4));
+    if (input.size() < header_size + body_size) {
+        return false;
+    }
+    req.magic = std::to_integer<std::uint8_t>(input[0]);
+    req.opcode = std::to_integer<std::uint8_t>(input[1]);
+    std::size_t framing_extras_size{ 0 };
+    auto key_size = static_cast<std::size_t>(read_uint(input.data() + 2, 2));
+    if (req.magic == static_cast<std::uint8_t>(protocol::magic::alt_client_request)) {
+        framing_extras_size = std::to_integer<std::size_t>(input[2]);
+        key_size = std::to_integer<std::size_t>(input[3]);
+    }
+    auto extras_size = std::to_integer<std::size_t>(input[4]);
+    req.datatype = std::to_integer<std::uint8_t>(input[5]);
+    req.vbucket = static_cast<std::uint16_t>(read_uint(input.data() + 6, 2));
+    std::copy_n(input.data() + 12, req.opaque.size(), req.opaque.begin());
+    req.cas = read_uint(input.data() + 16, 8);
+
+    const auto* body = input.data() + header_size + framing_extras_size;
+    req.extras.assign(body, body + extras_size);
+    body += extras_size;
+    req.key.assign(reinterpret_cast<const char*>(body), key_size);
+    body += key_size;
+    req.value.assign(reinterpret_cast<const char*>(body),
+                     body_size - std::min(body_size, framing_extras_size + extras_size + key_size));
+
+    input.erase(input.begin(), input.begin() + static_cast<std::ptrdiff_t>(header_size + body_size));
+    return true;
+}
+
+auto
+encode_response(const mock_request& req, const mock_response& resp) -> std::vector<std::byte>
+{
+    std::vector<std::byte> frame;
+    frame.reserve(header_size + resp.extras.size() + resp.value.size());
+    append_uint(frame, static_cast<std::uint8_t>(protocol::magic::client_response), 1);
+    append_uint(frame, req.opcode, 1);
+    append_uint(frame, 0, 2); // key length
+    append_uint(frame, resp.extras.size(), 1);
+    append_uint(frame, resp.datatype, 1);
+    append_uint(frame, static_cast<std::uint16_t>(resp.status), 2);
+    append_uint(frame, resp.extras.size() + resp.value.size(), 4);
+    frame.insert(frame.end(), req.opaque.begin(), req.opaque.end());
+    append_uint(frame, resp.cas, 8);
+    frame.insert(frame.end(), resp.extras.begin(), resp.extras.end());
+    std::transform(resp.value.begin(), resp.value.end(), std::back_inserter(frame), [](auto ch) { return static_cast<std::byte>(ch); });
+    return frame;
+}
+
+auto
+split_collection_id(std::string_view key) -> std::pair<std::uint32_t, std::string>
+{
+    std::uint32_t collection_id{ 0 };
+    std::size_t shift{ 0 };
+    std::size_t offset{ 0 };
+    while (offset < key.size()) {
+        auto byte = static_cast<std::uint8_t>(key[offset++]);
+        collection_id |= static_cast<std::uint32_t>(byte & 0x7fU) << shift;
+        shift += 7;
+        if ((byte & 0x80U) == 0) {
+            break;
+        }
+    }
+    return { collection_id, std::string(key.substr(offset)) };
+}
+
+auto
+encode_http_response(int status, std::string_view reason, std::string_view body) -> std::vector<std::byte>
+{
+    auto response = fmt::format("HTTP/1.1 {} {}\r\n"
+                                "Content-Type: application/json\r\n"
+                                "Content-Length: {}\r\n"
+                                "Connection: keep-alive\r\n"
+                                "\r\n"
+                                "{}",
+                                status,
+                                reason,
+                                body.size(),
+                                body);
+    std::vector<std::byte> payload(response.size());
+    std::memcpy(payload.data(), response.data(), response.size());
+    return payload;
+}
+
+using path_element = std::variant<std::string, std::int64_t>;
+
+/**
+ * Parses subdocument paths like "a.b[2].c". Escaping with backticks is not supported.
+ */
+auto
+parse_path(std::string_view path) -> std::optional<std::vector<path_element>>
+{
+    std::vector<path_element> elements;
+    std::string current;
+    std::size_t i = 0;
+    while (i < path.size()) {
+        if (path[i] == '.') {
+            if (!current.empty()) {
+                elements.emplace_back(std::move(current));
+                current.clear();
+            }
+            ++i;
+        } else if (path[i] == '[') {
+            if (!current.empty()) {
+                elements.emplace_back(std::move(current));
+                current.clear();
+            }
+            auto end = path.find(']', i);
+            if (end == std::string_view::npos) {
+                return {};
+            }
+            try {
+                elements.emplace_back(std::stoll(std::string(path.substr(i + 1, end - i - 1))));
+            } catch (const std::logic_error&) {
+                return {};
+            }
+            i = end + 1;
+        } else {
+            current.push_back(path[i]);
+            ++i;
+        }
+    }
+    if (!current.empty()) {
+        elements.emplace_back(std::move(current));
+    }
+    return elements;
+}
+
+auto
+array_position(const tao::json::value::array_t& array, std::int64_t index) -> std::optional<std::size_t>
+{
+    auto position = index < 0 ? static_cast<std::int64_t>(array.size()) + index : index;
+    if (position < 0 || static_cast<std::size_t>(position) >= array.size()) {
+        return {};
+    }
+    return static_cast<std::size_t>(position);
+}
+
+auto
+find_path(tao::json::value& root, const std::vector<path_element>& path, std::size_t depth, bool create_parents) -> tao::json::value*
+{
+    auto* current = &root;
+    for (std::size_t i = 0; i < depth; ++i) {
+        if (const auto* key = std::get_if<std::string>(&path[i]); key != nullptr) {
+            if (!current->is_object()) {
+                return nullptr;
+            }
+            auto* next = current->find(*key);
+            if (next == nullptr) {
+                if (!create_parents) {
+                    return nullptr;
+                }
+                next = &current->get_object()[*key];
+                *next = tao::json::empty_object;
+            }
+            current = next;
+        } else {
+            if (!current->is_array()) {
+                return nullptr;
+            }
+            auto position = array_position(current->get_array(), std::get<std::int64_t>(path[i]));
+            if (!position) {
+                return nullptr;
+            }
+            current = &current->get_array()[position.value()];
+        }
+    }
+    return current;
+}
+
+auto
+parse_fragment(const std::string& fragment) -> std::optional<tao::json::value>
+{
+    try {
+        return couchbase::core::utils::json::parse(fragment);
+    } catch (const std::exception&) {
+        return {};
+    }
+}
+
+struct subdoc_spec {
+    protocol::subdoc_opcode opcode{};
+    std::uint8_t flags{ 0 };
+    std::string path{};
+    std::string value{};
+};
+
+auto
+lookup_path(tao::json::value& body, const subdoc_spec& spec, std::string& result) -> key_value_status_code
+{
+    if ((spec.flags & path_flag_xattr) != 0) {
+        return key_value_status_code::subdoc_path_not_found;
+    }
+    auto path = parse_path(spec.path);
+    if (!path) {
+        return key_value_status_code::subdoc_path_invalid;
+    }
+    auto* target = find_path(body, path.value(), path->size(), false);
+    switch (spec.opcode) {
+        case protocol::subdoc_opcode::get:
+            if (target == nullptr) {
+                return key_value_status_code::subdoc_path_not_found;
+            }
+            result = couchbase::core::utils::json::generate(*target);
+            return key_value_status_code::success;
+        case protocol::subdoc_opcode::exists:
+            return target == nullptr ? key_value_status_code::subdoc_path_not_found : key_value_status_code::success;
+        case protocol::subdoc_opcode::get_count:
+            if (target == nullptr) {
+                return key_value_status_code::subdoc_path_not_found;
+            }
+            if (target->is_array()) {
+                result = std::to_string(target->get_array().size());
+            } else if (target->is_object()) {
+                result = std::to_string(target->get_object().size());
+            } else {
+                return key_value_status_code::subdoc_path_mismatch;
+            }
+            return key_value_status_code::success;
+        default:
+            break;
+    }
+    return key_value_status_code::subdoc_invalid_combo;
+}
+
+auto
+mutate_array(tao::json::value& target, const subdoc_spec& spec) -> key_value_status_code
+{
+    if (!target.is_array()) {
+        return key_value_status_code::subdoc_path_mismatch;
+    }
+    // multiple values might be passed as comma-separated list
+    auto values = parse_fragment("[" + spec.value + "]");
+    if (!values) {
+        return key_value_status_code::subdoc_value_cannot_insert;
+    }
+    auto& array = target.get_array();
+    auto& new_values = values->get_array();
+    switch (spec.opcode) {
+        case protocol::subdoc_opcode::array_push_last:
+            array.insert(array.end(), new_values.begin(), new_values.end());
+            break;
+        case protocol::subdoc_opcode::array_push_first:
+            array.insert(array.begin(), new_values.begin(), new_values.end());
+            break;
+        case protocol::subdoc_opcode::array_add_unique:
+            if (new_values.size() != 1) {
+                return key_value_status_code::subdoc_value_cannot_insert;
+            }
+            if (std::find(array.begin(), array.end(), new_values.front()) != array.end()) {
+                return key_value_status_code::subdoc_path_exists;
+            }
+            array.emplace_back(new_values.front());
+            break;
+        default:
+            return key_value_status_code::subdoc_invalid_combo;
+    }
+    return key_value_status_code::success;
+}
+
+auto
+mutate_counter(tao::json::value* target, tao::json::value& parent, const path_element& last, const subdoc_spec& spec, std::string& result)
+  -> key_value_status_code
+{
+    std::int64_t delta{ 0 };
+    try {
+        delta = std::stoll(spec.value);
+    } catch (const std::logic_error&) {
+        return key_value_status_code::subdoc_delta_invalid;
+    }
+    std::int64_t current{ 0 };
+    if (target != nullptr) {
+        if (!target->is_integer()) {
+            return key_value_status_code::subdoc_path_mismatch;
+        }
+        current = target->as<std::int64_t>();
+    } else if (const auto* key = std::get_if<std::string>(&last); key != nullptr && parent.is_object()) {
+        target = &parent.get_object()[*key];
+    } else {
+        return key_value_status_code::subdoc_path_not_found;
+    }
+    *target = current + delta;
+    result = std::to_string(current + delta);
+    return key_value_status_code::success;
+}
+
+/**
+ * Applies single mutation to the parsed document body.
+ */
+auto
+mutate_path(tao::json::value& body, const subdoc_spec& spec, bool create_parents, std::string& result) -> key_value_status_code
+{
+    if ((spec.flags & path_flag_xattr) != 0) {
+        return key_value_status_code::subdoc_path_invalid;
+    }
+    auto path = parse_path(spec.path);
+    if (!path) {
+        return key_value_status_code::subdoc_path_invalid;
+    }
+    create_parents = create_parents || (spec.flags & path_flag_create_parents) != 0;
+
+    if (path->empty()) {
+        switch (spec.opcode) {
+            case protocol::subdoc_opcode::array_push_last:
+            case protocol::subdoc_opcode::array_push_first:
+            case protocol::subdoc_opcode::array_add_unique:
+                return mutate_array(body, spec);
+            default:
+                return key_value_status_code::subdoc_path_invalid;
+        }
+    }
+
+    auto* parent = find_path(body, path.value(), path->size() - 1, create_parents);
+    if (parent == nullptr) {
+        return key_value_status_code::subdoc_path_not_found;
+    }
+    const auto& last = path->back();
+    tao::json::value* target{ nullptr };
+    if (const auto* key = std::get_if<std::string>(&last); key != nullptr) {
+        if (!parent->is_object()) {
+            return key_value_status_code::subdoc_path_mismatch;
+        }
+        target = parent->find(*key);
+    } else if (parent->is_array()) {
+        if (auto position = array_position(parent->get_array(), std::get<std::int64_t>(last)); position) {
+            target = &parent->get_array()[position.value()];
+        }
+    } else {
+        return key_value_status_code::subdoc_path_mismatch;
+    }
+
+    switch (spec.opcode) {
+        case protocol::subdoc_opcode::dict_add:
+        case protocol::subdoc_opcode::dict_upsert: {
+            const auto* key = std::get_if<std::string>(&last);
+            if (key == nullptr) {
+                return key_value_status_code::subdoc_path_mismatch;
+            }
+            if (target != nullptr && spec.opcode == protocol::subdoc_opcode::dict_add) {
+                return key_value_status_code::subdoc_path_exists;
+            }
+            auto value = parse_fragment(spec.value);
+            if (!value) {
+                return key_value_status_code::subdoc_value_cannot_insert;
+            }
+            parent->get_object()[*key] = std::move(value.value());
+            return key_value_status_code::success;
+        }
+
+        case protocol::subdoc_opcode::replace: {
+            if (target == nullptr) {
+                return key_value_status_code::subdoc_path_not_found;
+            }
+            auto value = parse_fragment(spec.value);
+            if (!value) {
+                return key_value_status_code::subdoc_value_cannot_insert;
+            }
+            *target = std::move(value.value());
+            return key_value_status_code::success;
+        }
+
+        case protocol::subdoc_opcode::remove:
+            if (target == nullptr) {
+                return key_value_status_code::subdoc_path_not_found;
+            }
+            if (const auto* key = std::get_if<std::string>(&last); key != nullptr) {
+                parent->get_object().erase(*key);
+            } else {
+                auto& array = parent->get_array();
+                array.erase(array.begin() + (target - array.data()));
+            }
+            return key_value_status_code::success;
+
+        case protocol::subdoc_opcode::array_insert: {
+            if (!parent->is_array() || std::holds_alternative<std::string>(last)) {
+                return key_value_status_code::subdoc_path_mismatch;
+            }
+            auto& array = parent->get_array();
+            auto index = std::get<std::int64_t>(last);
+            if (index < 0 || static_cast<std::size_t>(index) > array.size()) {
+                return key_value_status_code::subdoc_path_not_found;
+            }
+            auto value = parse_fragment(spec.value);
+            if (!value) {
+                return key_value_status_code::subdoc_value_cannot_insert;
+            }
+            array.insert(array.begin() + index, std::move(value.value()));
+            return key_value_status_code::success;
+        }
+
+        case protocol::subdoc_opcode::array_push_last:
+        case protocol::subdoc_opcode::array_push_first:
+        case protocol::subdoc_opcode::array_add_unique:
+            if (target == nullptr) {
+                const auto* key = std::get_if<std::string>(&last);
+                if (!create_parents || key == nullptr) {
+                    return key_value_status_code::subdoc_path_not_found;
+                }
+                target = &parent->get_object()[*key];
+                *target = tao::json::empty_array;
+            }
+            return mutate_array(*target, spec);
+
+        case protocol::subdoc_opcode::counter:
+            return mutate_counter(target, *parent, last, spec, result);
+
+        default:
+            break;
+    }
+    return key_value_status_code::subdoc_invalid_combo;
+}
+
+auto
+parse_subdoc_specs(std::string_view payload, bool with_values) -> std::optional<std::vector<subdoc_spec>>
+{
+    std::vector<subdoc_spec> specs;
+    const auto* data = reinterpret_cast<const std::byte*>(payload.data());
+    std::size_t offset{ 0 };
+    const std::size_t spec_header_size = with_values ? 8 : 4;
+    while (offset < payload.size()) {
+        if (payload.size() - offset < spec_header_size) {
+            return {};
+        }
+        subdoc_spec spec{};
+        spec.opcode = static_cast<protocol::subdoc_opcode>(data[offset]);
+        spec.flags = std::to_integer<std::uint8_t>(data[offset + 1]);
+        auto path_size = static_cast<std::size_t>(read_uint(data + offset + 2, 2));
+        std::size_t value_size = with_values ? static_cast<std::size_t>(read_uint(data + offset + 4, 4)) : 0;
+        offset += spec_header_size;
+        if (payload.size() - offset < path_size + value_size) {
+            return {};
+        }
+        spec.path = payload.substr(offset, path_size);
+        offset += path_size;
+        spec.value = payload.substr(offset, value_size);
+        offset += value_size;
+        specs.emplace_back(std::move(spec));
+    }
+    return specs;
+}
+
+struct mock_document {
+    std::string value{};
+    std::uint32_t flags{ 0 };
+    std::uint32_t expiry{ 0 };
+    std::uint8_t datatype{ 0 };
+    std::uint64_t cas{ 0 };
+    std::uint64_t sequence_number{ 0 };
+    std::uint16_t vbucket{ 0 };
+    bool locked{ false };
+};
+
+/**
+ * Documents are ordered by collection and key, so the range scans could walk them in order.
+ */
+using document_key = std::pair<std::uint32_t, std::string>;
+
+/**
+ * Mutations become visible for observe_seqno after mock_server_options::replication_delay.
+ */
+struct mock_vbucket {
+    std::uint64_t uuid{ 0 };
+    std::uint64_t visible_sequence_number{ 0 };
+    std::vector<std::pair<std::uint64_t, std::chrono::steady_clock::time_point>> pending{};
+};
+
+struct mock_range_scan {
+    std::vector<std::pair<std::string, mock_document>> items{};
+    std::size_t position{ 0 };
+    bool keys_only{ false };
+};
+} // namespace
+
+class kv_session;
+class http_session;
+
+class mock_server_impl
+{
+  public:
+    explicit mock_server_impl(mock_server_options options)
+      : options_(std::move(options))
+      , kv_acceptor_(io_, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0))
+      , query_acceptor_(io_, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0))
+      , cas_(static_cast<std::uint64_t>(std::chrono::system_clock::now().time_since_epoch().count()))
+    {
+        vbuckets_.resize(options_.number_of_vbuckets);
+        for (auto& vbucket : vbuckets_) {
+            vbucket.uuid = random_();
+        }
+        do_accept_kv();
+        do_accept_query();
+        thread_ = std::thread([this]() { io_.run(); });
+    }
+
+    mock_server_impl(const mock_server_impl&) = delete;
+    mock_server_impl(mock_server_impl&&) = delete;
+    auto operator=(const mock_server_impl&) -> mock_server_impl& = delete;
+    auto operator=(mock_server_impl&&) -> mock_server_impl& = delete;
+
+    ~mock_server_impl()
+    {
+        asio::post(io_, [this]() { close_all(); });
+        thread_.join();
+    }
+
+    [[nodiscard]] auto kv_port() const -> std::uint16_t
+    {
+        return kv_acceptor_.local_endpoint().port();
+    }
+
+    [[nodiscard]] auto query_port() const -> std::uint16_t
+    {
+        return query_acceptor_.local_endpoint().port();
+    }
+
+    [[nodiscard]] auto options() const -> const mock_server_options&
+    {
+        return options_;
+    }
+
+    void upsert_document(std::uint32_t collection_id, const std::string& key, std::string value, std::uint32_t flags)
+    {
+        const std::scoped_lock lock(documents_mutex_);
+        auto vbucket =
+          static_cast<std::uint16_t>(couchbase::core::utils::hash_crc32(key.data(), key.size()) % options_.number_of_vbuckets);
+        auto datatype = parse_fragment(value).has_value() ? datatype_json : std::uint8_t{ 0 };
+        documents_[{ collection_id, key }] = { std::move(value), flags, 0, datatype, ++cas_, ++sequence_number_, vbucket };
+        record_mutation(vbucket, sequence_number_);
+    }
+
+    [[nodiscard]] auto number_of_documents() const -> std::size_t
+    {
+        const std::scoped_lock lock(documents_mutex_);
+        return documents_.size();
+    }
+
+    [[nodiscard]] auto number_of_requests(std::uint8_t opcode) const -> std::size_t
+    {
+        return requests_[opcode].load();
+    }
+
+    void handle_kv(const std::shared_ptr<kv_session>& session, mock_request&& req);
+    void handle_query(const std::shared_ptr<http_session>& session, const std::string& path, const std::string& body);
+
+  private:
+    void do_accept_kv();
+    void do_accept_query();
+    void close_all();
+
+    [[nodiscard]] auto response_delay() -> std::chrono::microseconds
+    {
+        auto delay = options_.latency;
+        if (options_.jitter.count() > 0) {
+            delay += std::chrono::microseconds{ std::uniform_int_distribution<std::chrono::microseconds::rep>(0, options_.jitter.count())(random_) };
+        }
+        return delay;
+    }
+
+    template<typename Session>
+    void send_delayed(const std::shared_ptr<Session>& session,
+                      std::vector<std::byte> payload,
+                      std::chrono::microseconds extra_delay = std::chrono::microseconds::zero())
+    {
+        auto delay = response_delay() + extra_delay;
+        if (delay.count() == 0) {
+            return session->write(std::move(payload));
+        }
+        auto timer = std::make_shared<asio::steady_timer>(io_, delay);
+        timer->async_wait([timer, session, payload = std::move(payload)](std::error_code ec) mutable {
+            if (ec == asio::error::operation_aborted) {
+                return;
+            }
+            session->write(std::move(payload));
+        });
+    }
+
+    auto injected_fault(const mock_request& req, const std::string& key) -> std::optional<key_value_status_code>
+    {
+        if (options_.fault_injector) {
+            if (auto status = options_.fault_injector(req.opcode, key); status) {
+                return status;
+            }
+        }
+        if (options_.fault_probability > 0 && std::uniform_real_distribution<double>(0, 1)(random_) < options_.fault_probability) {
+            return options_.fault_status;
+        }
+        return {};
+    }
+
+    /**
+     * Must be called with documents_mutex_ held.
+     */
+    void record_mutation(std::uint16_t vbucket, std::uint64_t sequence_number)
+    {
+        if (vbucket < vbuckets_.size()) {
+            vbuckets_[vbucket].pending.emplace_back(sequence_number, std::chrono::steady_clock::now());
+        }
+    }
+
+    /**
+     * Must be called with documents_mutex_ held.
+     *
+     * @return extras of the mutation response with vbucket UUID and sequence number, if the session negotiated mutation_seqno
+     */
+    auto mutation_extras(const kv_session& session, std::uint16_t vbucket, std::uint64_t sequence_number) -> std::vector<std::byte>;
+
+    auto build_configuration(bool with_bucket) const -> std::string;
+
+    auto handle_hello(kv_session& session, const mock_request& req) -> mock_response;
+    auto handle_sasl_auth(kv_session& session, const mock_request& req) const -> mock_response;
+    auto handle_get_collection_id(const mock_request& req) const -> mock_response;
+    auto execute(kv_session& session, const mock_request& req) -> mock_response;
+    auto execute_get(const document_key& key) -> mock_response;
+    auto execute_store(kv_session& session, const mock_request& req, document_key key) -> mock_response;
+    auto execute_remove(kv_session& session, const mock_request& req, const document_key& key) -> mock_response;
+    auto execute_touch(const mock_request& req, const document_key& key) -> mock_response;
+    auto execute_get_and_lock(const document_key& key) -> mock_response;
+    auto execute_unlock(const mock_request& req, const document_key& key) -> mock_response;
+    auto execute_adjoin(kv_session& session, const mock_request& req, const document_key& key) -> mock_response;
+    auto execute_counter(kv_session& session, const mock_request& req, document_key key) -> mock_response;
+    auto execute_get_random(const document_key& key) -> mock_response;
+    auto execute_get_meta(const mock_request& req, const document_key& key) -> mock_response;
+    auto execute_upsert_with_meta(kv_session& session, const mock_request& req, document_key key) -> mock_response;
+    auto execute_lookup_in(const mock_request& req, const document_key& key) -> mock_response;
+    auto execute_mutate_in(kv_session& session, const mock_request& req, document_key key) -> mock_response;
+    auto execute_range_scan_create(const mock_request& req) -> mock_response;
+    auto execute_range_scan_continue(const mock_request& req) -> mock_response;
+    auto execute_observe_seqno(const mock_request& req) -> mock_response;
+
+    mock_server_options options_;
+    asio::io_context io_{};
+    asio::ip::tcp::acceptor kv_acceptor_;
+    asio::ip::tcp::acceptor query_acceptor_;
+    std::thread thread_{};
+    std::mt19937_64 random_{ std::random_device{}() };
+
+    std::vector<std::weak_ptr<kv_session>> kv_sessions_{};
+    std::vector<std::weak_ptr<http_session>> http_sessions_{};
+
+    mutable std::mutex documents_mutex_{};
+    std::map<document_key, mock_document> documents_{};
+    std::uint64_t cas_;
+    std::uint64_t sequence_number_{ 0 };
+    std::vector<mock_vbucket> vbuckets_{};
+    std::map<std::string, mock_range_scan> range_scans_{};
+    std::array<std::atomic_size_t, 256> requests_{};
+};
+
+/**
+ * Serializes writes of the responses to the socket. All methods are called on the server thread.
+ */
+template<typename Derived>
+class mock_session : public std::enable_shared_from_this<Derived>
+{
+  public:
+    mock_session(mock_server_impl& server, asio::ip::tcp::socket socket)
+      : server_(server)
+      , socket_(std::move(socket))
+    {
+    }
+
+    void close()
+    {
+        std::error_code ignored;
+        socket_.close(ignored);
+    }
+
+    void write(std::vector<std::byte> payload)
+    {
+        output_.insert(output_.end(), payload.begin(), payload.end());
+        do_write();
+    }
+
+  protected:
+    void do_write()
+    {
+        if (writing_ || output_.empty()) {
+            return;
+        }
+        writing_ = true;
+        std::swap(output_, writing_buffer_);
+        asio::async_write(
+          socket_, asio::buffer(writing_buffer_), [self = this->shared_from_this()](std::error_code ec, std::size_t /* bytes */) {
+              self->writing_ = false;
+              self->writing_buffer_.clear();
+              if (ec) {
+                  return;
+              }
+              self->do_write();
+          });
+    }
+
+    mock_server_impl& server_;
+    asio::ip::tcp::socket socket_;
+    std::array<char, 16384> read_buffer_{};
+
+  private:
+    std::vector<std::byte> output_{};
+    std::vector<std::byte> writing_buffer_{};
+    bool writing_{ false };
+};
+
+class kv_session : public mock_session<kv_session>
+{
+  public:
+    using mock_session::mock_session;
+
+    void start()
+    {
+        socket_.async_read_some(asio::buffer(read_buffer_), [self = shared_from_this()](std::error_code ec, std::size_t bytes) {
+            if (ec) {
+                return;
+            }
+            const auto* data = reinterpret_cast<const std::byte*>(self->read_buffer_.data());
+            self->input_.insert(self->input_.end(), data, data + bytes);
+            mock_request req{};
+            while (parse_request(self->input_, req)) {
+                self->server_.handle_kv(self, std::move(req));
+                req = {};
+            }
+            self->start();
+        });
+    }
+
+    bool collections{ false };
+    bool json{ false };
+    bool mutation_seqno{ false };
+    bool authenticated{ false };
+    std::optional<std::string> bucket{};
+
+  private:
+    std::vector<std::byte> input_{};
+};
+
+/**
+ * HTTP/1.1 with keep-alive. Only requests with Content-Length are supported.
+ */
+class http_session : public mock_session<http_session>
+{
+  public:
+    using mock_session::mock_session;
+
+    void start()
+    {
+        socket_.async_read_some(asio::buffer(read_buffer_), [self = shared_from_this()](std::error_code ec, std::size_t bytes) {
+            if (ec) {
+                return;
+            }
+            self->input_.append(self->read_buffer_.data(), bytes);
+            while (self->handle_next_request()) {
+            }
+            self->start();
+        });
+    }
+
+  private:
+    auto handle_next_request() -> bool
+    {
+        auto headers_end = input_.find("\r\n\r\n");
+        if (headers_end == std::string::npos) {
+            return false;
+        }
+        std::string headers = input_.substr(0, headers_end);
+        std::transform(headers.begin(), headers.end(), headers.begin(), [](unsigned char c) { return std::tolower(c); });
+        std::size_t content_length{ 0 };
+        if (auto pos = headers.find("content-length:"); pos != std::string::npos) {
+            content_length = std::stoul(headers.substr(pos + std::strlen("content-length:")));
+        }
+        auto body_offset = headers_end + 4;
+        if (input_.size() < body_offset + content_length) {
+            return false;
+        }
+        auto request_line = input_.substr(0, input_.find("\r\n"));
+        auto path_start = request_line.find(' ') + 1;
+        auto path = request_line.substr(path_start, request_line.find(' ', path_start) - path_start);
+        auto body = input_.substr(body_offset, content_length);
+        input_.erase(0, body_offset + content_length);
+        server_.handle_query(shared_from_this(), path, body);
+        return true;
+    }
+
+    std::string input_{};
+};
+
+void
+mock_server_impl::do_accept_kv()
+{
+    kv_acceptor_.async_accept([this](std::error_code ec, asio::ip::tcp::socket socket) {
+        if (ec) {
+            return;
+        }
+        socket.set_option(asio::ip::tcp::no_delay{ true });
+        auto session = std::make_shared<kv_session>(*this, std::move(socket));
+        kv_sessions_.emplace_back(session);
+        session->start();
+        do_accept_kv();
+    });
+}
+
+void
+mock_server_impl::do_accept_query()
+{
+    query_acceptor_.async_accept([this](std::error_code ec, asio::ip::tcp::socket socket) {
+        if (ec) {
+            return;
+        }
+        socket.set_option(asio::ip::tcp::no_delay{ true });
+        auto session = std::make_shared<http_session>(*this, std::move(socket));
+        http_sessions_.emplace_back(session);
+        session->start();
+        do_accept_query();
+    });
+}
+
+void
+mock_server_impl::close_all()
+{
+    std::error_code ignored;
+    kv_acceptor_.close(ignored);
+    query_acceptor_.close(ignored);
+    for (const auto& weak : kv_sessions_) {
+        if (auto session = weak.lock(); session) {
+            session->close();
+        }
+    }
+    for (const auto& weak : http_sessions_) {
+        if (auto session = weak.lock(); session) {
+            session->close();
+        }
+    }
+    io_.stop();
+}
+
+auto
+mock_server_impl::build_configuration(bool with_bucket) const -> std::string
+{
+    const tao::json::value node{
+        { "thisNode", true },
+        { "hostname", "127.0.0.1" },
+        { "services",
+          {
+            { "kv", kv_port() },
+            { "n1ql", query_port() },
+          } },
+    };
+    tao::json::value config{
+        { "rev", 1 },
+        { "revEpoch", 1 },
+        { "nodesExt", tao::json::value::array({ node }) },
+        { "clusterCapabilitiesVer", tao::json::value::array({ 1, 0 }) },
+        { "clusterCapabilities",
+          {
+            { "n1ql", tao::json::value::array({ "enhancedPreparedStatements" }) },
+          } },
+    };
+    if (with_bucket) {
+        tao::json::value vbucket_map = tao::json::empty_array;
+        for (std::uint16_t i = 0; i < options_.number_of_vbuckets; ++i) {
+            // the single node holds both active and replica copies
+            tao::json::value servers = tao::json::empty_array;
+            for (std::uint32_t copy = 0; copy <= options_.number_of_replicas; ++copy) {
+                servers.get_array().emplace_back(0);
+            }
+            vbucket_map.get_array().emplace_back(std::move(servers));
+        }
+        config["name"] = options_.bucket_name;
+        config["uuid"] = "b2a49ceb1b1d3a49d8d7f4e15ec49efb";
+        config["nodeLocator"] = "vbucket";
+        config["collectionsManifestUid"] = "0";
+        config["bucketCapabilitiesVer"] = "";
+        config["bucketCapabilities"] =
+          tao::json::value::array({ "collections", "durableWrite", "tombstonedUserXAttrs", "couchapi", "dcp", "cbhello", "touch", "cccp",
+                                    "xdcrCheckpointing", "nodesExt", "xattr", "rangeScan" });
+        config["vBucketServerMap"] = {
+            { "hashAlgorithm", "CRC" },
+            { "numReplicas", options_.number_of_replicas },
+            { "serverList", tao::json::value::array({ fmt::format("127.0.0.1:{}", kv_port()) }) },
+            { "vBucketMap", std::move(vbucket_map) },
+        };
+    }
+    return couchbase::core::utils::json::generate(config);
+}
+
+auto
+mock_server_impl::handle_hello(kv_session& session, const mock_request& req) -> mock_response
+{
+    mock_response resp{};
+    const auto* data = reinterpret_cast<const std::byte*>(req.value.data());
+    for (std::size_t offset = 0; offset + 2 <= req.value.size(); offset += 2) {
+        auto feature = static_cast<protocol::hello_feature>(read_uint(data + offset, 2));
+        if (std::find(supported_features.begin(), supported_features.end(), feature) == supported_features.end()) {
+            continue;
+        }
+        session.collections = session.collections || feature == protocol::hello_feature::collections;
+        session.json = session.json || feature == protocol::hello_feature::json;
+        session.mutation_seqno = session.mutation_seqno || feature == protocol::hello_feature::mutation_seqno;
+        append_uint(resp.value, static_cast<std::uint16_t>(feature), 2);
+    }
+    return resp;
+}
+
+auto
+mock_server_impl::handle_sasl_auth(kv_session& session, const mock_request& req) const -> mock_response
+{
+    if (req.key != "PLAIN") {
+        return { key_value_status_code::auth_error };
+    }
+    // authzid \0 authcid \0 password
+    auto first = req.value.find('\0');
+    auto second = first == std::string::npos ? std::string::npos : req.value.find('\0', first + 1);
+    if (second == std::string::npos || req.value.substr(first + 1, second - first - 1) != options_.username ||
+        req.value.substr(second + 1) != options_.password) {
+        return { key_value_status_code::auth_error };
+    }
+    session.authenticated = true;
+    return {};
+}
+
+auto
+mock_server_impl::handle_get_collection_id(const mock_request& req) const -> mock_response
+{
+    auto path = req.value.empty() ? req.key : req.value;
+    if (path != "_default._default" && path != "._default" && path != "_default.") {
+        return { key_value_status_code::unknown_collection };
+    }
+    mock_response resp{};
+    append_uint(resp.extras, 0, 8); // manifest uid
+    append_uint(resp.extras, 0, 4); // collection id
+    return resp;
+}
+
+void
+mock_server_impl::handle_kv(const std::shared_ptr<kv_session>& session, mock_request&& req)
+{
+    requests_[req.opcode].fetch_add(1);
+    mock_response resp{};
+    switch (static_cast<protocol::client_opcode>(req.opcode)) {
+        case protocol::client_opcode::hello:
+            resp = handle_hello(*session, req);
+            break;
+
+        case protocol::client_opcode::sasl_list_mechs:
+            resp.value = "PLAIN";
+            break;
+
+        case protocol::client_opcode::sasl_auth:
+            resp = handle_sasl_auth(*session, req);
+            break;
+
+        case protocol::client_opcode::select_bucket:
+            if (!session->authenticated || req.key != options_.bucket_name) {
+                resp.status = key_value_status_code::no_access;
+            } else {
+                session->bucket = req.key;
+            }
+            break;
+
+        case protocol::client_opcode::get_cluster_config:
+            resp.value = build_configuration(session->bucket.has_value());
+            resp.datatype = session->json ? datatype_json : 0;
+            break;
+
+        case protocol::client_opcode::get_collection_id:
+            resp = handle_get_collection_id(req);
+            break;
+
+        case protocol::client_opcode::noop:
+            break;
+
+        default: {
+            // KV data operations
+            if (!session->bucket) {
+                resp.status = key_value_status_code::no_bucket;
+            } else {
+                resp = execute(*session, req);
+            }
+            auto extra_delay = options_.latency_injector ? options_.latency_injector(req.opcode) : std::chrono::microseconds::zero();
+            return send_delayed(session, encode_response(req, resp), extra_delay);
+        }
+    }
+    session->write(encode_response(req, resp));
+}
+
+auto
+mock_server_impl::execute(kv_session& session, const mock_request& req) -> mock_response
+{
+    auto opcode = static_cast<protocol::client_opcode>(req.opcode);
+    if (options_.request_observer) {
+        options_.request_observer({ req.opcode,
+                                    req.datatype,
+                                    req.vbucket,
+                                    req.cas,
+                                    req.extras,
+                                    session.collections ? split_collection_id(req.key).second : req.key,
+                                    req.value });
+    }
+    switch (opcode) {
+        case protocol::client_opcode::range_scan_create:
+        case protocol::client_opcode::range_scan_continue:
+        case protocol::client_opcode::range_scan_cancel:
+            if (auto status = injected_fault(req, {}); status) {
+                return { status.value() };
+            }
+            break;
+        default:
+            break;
+    }
+
+    if (opcode == protocol::client_opcode::range_scan_create) {
+        return execute_range_scan_create(req);
+    }
+    if (opcode == protocol::client_opcode::range_scan_continue) {
+        return execute_range_scan_continue(req);
+    }
+    if (opcode == protocol::client_opcode::observe_seqno) {
+        return execute_observe_seqno(req);
+    }
+    if (opcode == protocol::client_opcode::range_scan_cancel) {
+        const std::scoped_lock lock(documents_mutex_);
+        auto erased = range_scans_.erase(std::string(reinterpret_cast<const char*>(req.extras.data()), req.extras.size()));
+        return { erased > 0 ? key_value_status_code::success : key_value_status_code::not_found };
+    }
+
+    document_key key = session.collections ? split_collection_id(req.key) : document_key{ 0, req.key };
+    if (key.first != 0) {
+        return { key_value_status_code::unknown_collection };
+    }
+    if (auto status = injected_fault(req, key.second); status) {
+        return { status.value() };
+    }
+
+    switch (opcode) {
+        case protocol::client_opcode::get:
+        case protocol::client_opcode::get_replica:
+            return execute_get(key);
+        case protocol::client_opcode::upsert:
+        case protocol::client_opcode::insert:
+        case protocol::client_opcode::replace:
+            return execute_store(session, req, std::move(key));
+        case protocol::client_opcode::remove:
+        case protocol::client_opcode::remove_with_meta:
+            return execute_remove(session, req, key);
+        case protocol::client_opcode::touch:
+        case protocol::client_opcode::get_and_touch:
+            return execute_touch(req, key);
+        case protocol::client_opcode::get_and_lock:
+            return execute_get_and_lock(key);
+        case protocol::client_opcode::unlock:
+            return execute_unlock(req, key);
+        case protocol::client_opcode::append:
+        case protocol::client_opcode::prepend:
+            return execute_adjoin(session, req, key);
+        case protocol::client_opcode::increment:
+        case protocol::client_opcode::decrement:
+            return execute_counter(session, req, std::move(key));
+        case protocol::client_opcode::get_random_key:
+            return execute_get_random(key);
+        case protocol::client_opcode::get_meta:
+            return execute_get_meta(req, key);
+        case protocol::client_opcode::upsert_with_meta:
+            return execute_upsert_with_meta(session, req, std::move(key));
+        case protocol::client_opcode::subdoc_multi_lookup:
+            return execute_lookup_in(req, key);
+        case protocol::client_opcode::subdoc_multi_mutation:
+            return execute_mutate_in(session, req, std::move(key));
+        default:
+            break;
+    }
+    return { key_value_status_code::not_supported };
+}
+
+auto
+mock_server_impl::execute_get(const document_key& key) -> mock_response
+{
+    const std::scoped_lock lock(documents_mutex_);
+    auto document = documents_.find(key);
+    if (document == documents_.end()) {
+        return { key_value_status_code::not_found };
+    }
+    mock_response resp{ key_value_status_code::success, document->second.cas, document->second.datatype };
+    append_uint(resp.extras, document->second.flags, 4);
+    resp.value = document->second.value;
+    return resp;
+}
+
+auto
+mock_server_impl::execute_store(kv_session& session, const mock_request& req, document_key key) -> mock_response
+{
+    auto opcode = static_cast<protocol::client_opcode>(req.opcode);
+    const std::scoped_lock lock(documents_mutex_);
+    auto document = documents_.find(key);
+    if (opcode == protocol::client_opcode::insert && document != documents_.end()) {
+        return { key_value_status_code::exists };
+    }
+    if (document == documents_.end() && (opcode == protocol::client_opcode::replace || req.cas != 0)) {
+        return { key_value_status_code::not_found };
+    }
+    if (document != documents_.end() && req.cas != 0 && req.cas != document->second.cas) {
+        return { key_value_status_code::exists };
+    }
+    mock_document stored{ req.value, 0, 0, req.datatype, ++cas_, ++sequence_number_, req.vbucket };
+    if (req.extras.size() >= 8) {
+        stored.flags = static_cast<std::uint32_t>(read_uint(req.extras.data(), 4));
+        stored.expiry = static_cast<std::uint32_t>(read_uint(req.extras.data() + 4, 4));
+    }
+    mock_response resp{ key_value_status_code::success, stored.cas };
+    record_mutation(stored.vbucket, stored.sequence_number);
+    resp.extras = mutation_extras(session, stored.vbucket, stored.sequence_number);
+    documents_[std::move(key)] = std::move(stored);
+    return resp;
+}
+
+auto
+mock_server_impl::execute_remove(kv_session& session, const mock_request& req, const document_key& key) -> mock_response
+{
+    const std::scoped_lock lock(documents_mutex_);
+    auto document = documents_.find(key);
+    if (document == documents_.end()) {
+        return { key_value_status_code::not_found };
+    }
+    if (req.cas != 0 && req.cas != document->second.cas) {
+        return { key_value_status_code::exists };
+    }
+    documents_.erase(document);
+    mock_response resp{ key_value_status_code::success, ++cas_ };
+    record_mutation(req.vbucket, ++sequence_number_);
+    resp.extras = mutation_extras(session, req.vbucket, sequence_number_);
+    return resp;
+}
+
+auto
+mock_server_impl::execute_touch(const mock_request& req, const document_key& key) -> mock_response
+{
+    if (req.extras.size() != 4) {
+        return { key_value_status_code::invalid };
+    }
+    const std::scoped_lock lock(documents_mutex_);
+    auto document = documents_.find(key);
+    if (document == documents_.end()) {
+        return { key_value_status_code::not_found };
+    }
+    document->second.expiry = static_cast<std::uint32_t>(read_uint(req.extras.data(), 4));
+    document->second.cas = ++cas_;
+    if (static_cast<protocol::client_opcode>(req.opcode) == protocol::client_opcode::touch) {
+        return { key_value_status_code::success, document->second.cas };
+    }
+    mock_response resp{ key_value_status_code::success, document->second.cas, document->second.datatype };
+    append_uint(resp.extras, document->second.flags, 4);
+    resp.value = document->second.value;
+    return resp;
+}
+
+auto
+mock_server_impl::execute_get_and_lock(const document_key& key) -> mock_response
+{
+    const std::scoped_lock lock(documents_mutex_);
+    auto document = documents_.find(key);
+    if (document == documents_.end()) {
+        return { key_value_status_code::not_found };
+    }
+    if (document->second.locked) {
+        return { key_value_status_code::locked };
+    }
+    document->second.locked = true;
+    document->second.cas = ++cas_;
+    mock_response resp{ key_value_status_code::success, document->second.cas, document->second.datatype };
+    append_uint(resp.extras, document->second.flags, 4);
+    resp.value = document->second.value;
+    return resp;
+}
+
+auto
+mock_server_impl::execute_unlock(const mock_request& req, const document_key& key) -> mock_response
+{
+    const std::scoped_lock lock(documents_mutex_);
+    auto document = documents_.find(key);
+    if (document == documents_.end()) {
+        return { key_value_status_code::not_found };
+    }
+    if (!document->second.locked) {
+        return { key_value_status_code::temporary_failure };
+    }
+    if (req.cas != document->second.cas) {
+        return { key_value_status_code::locked };
+    }
+    document->second.locked = false;
+    return { key_value_status_code::success, document->second.cas };
+}
+
+auto
+mock_server_impl::execute_adjoin(kv_session& session, const mock_request& req, const document_key& key) -> mock_response
+{
+    const std::scoped_lock lock(documents_mutex_);
+    auto document = documents_.find(key);
+    if (document == documents_.end()) {
+        return { key_value_status_code::not_stored };
+    }
+    if (req.cas != 0 && req.cas != document->second.cas) {
+        return { key_value_status_code::exists };
+    }
+    auto& stored = document->second;
+    if (static_cast<protocol::client_opcode>(req.opcode) == protocol::client_opcode::append) {
+        stored.value.append(req.value);
+    } else {
+        stored.value.insert(0, req.value);
+    }
+    stored.cas = ++cas_;
+    stored.sequence_number = ++sequence_number_;
+    mock_response resp{ key_value_status_code::success, stored.cas };
+    record_mutation(stored.vbucket, stored.sequence_number);
+    resp.extras = mutation_extras(session, stored.vbucket, stored.sequence_number);
+    return resp;
+}
+
+auto
+mock_server_impl::execute_counter(kv_session& session, const mock_request& req, document_key key) -> mock_response
+{
+    // delta, initial value, expiry (0xffffffff does not allow to create the document)
+    if (req.extras.size() != 20) {
+        return { key_value_status_code::invalid };
+    }
+    auto delta = read_uint(req.extras.data(), 8);
+    auto initial_value = read_uint(req.extras.data() + 8, 8);
+    auto expiry = static_cast<std::uint32_t>(read_uint(req.extras.data() + 16, 4));
+
+    const std::scoped_lock lock(documents_mutex_);
+    auto document = documents_.find(key);
+    std::uint64_t value{ initial_value };
+    if (document == documents_.end()) {
+        if (expiry == std::numeric_limits<std::uint32_t>::max()) {
+            return { key_value_status_code::not_found };
+        }
+    } else {
+        if (req.cas != 0 && req.cas != document->second.cas) {
+            return { key_value_status_code::exists };
+        }
+        const auto& current = document->second.value;
+        if (current.empty() || current.size() > 20 ||
+            !std::all_of(current.begin(), current.end(), [](auto ch) { return std::isdigit(static_cast<unsigned char>(ch)) != 0; })) {
+            return { key_value_status_code::delta_bad_value };
+        }
+        value = std::stoull(current);
+        if (static_cast<protocol::client_opcode>(req.opcode) == protocol::client_opcode::increment) {
+            value += delta;
+        } else {
+            value = value > delta ? value - delta : 0;
+        }
+        expiry = document->second.expiry;
+    }
+    mock_document stored{ std::to_string(value), 0, expiry, 0, ++cas_, ++sequence_number_, req.vbucket };
+    if (document != documents_.end()) {
+        stored.flags = document->second.flags;
+        stored.vbucket = document->second.vbucket;
+    }
+    mock_response resp{ key_value_status_code::success, stored.cas };
+    append_uint(resp.value, value, 8);
+    record_mutation(stored.vbucket, stored.sequence_number);
+    resp.extras = mutation_extras(session, stored.vbucket, stored.sequence_number);
+    documents_[std::move(key)] = std::move(stored);
+    return resp;
+}
+
+auto
+mock_server_impl::execute_get_random(const document_key& key) -> mock_response
+{
+    // the key is empty, so it only carries the collection
+    const std::scoped_lock lock(documents_mutex_);
+    auto document = documents_.lower_bound(key);
+    if (document == documents_.end() || document->first.first != key.first) {
+        return { key_value_status_code::not_found };
+    }
+    mock_response resp{ key_value_status_code::success, document->second.cas, document->second.datatype };
+    append_uint(resp.extras, document->second.flags, 4);
+    resp.value = document->second.value;
+    return resp;
+}
+
+auto
+mock_server_impl::execute_get_meta(const mock_request& req, const document_key& key) -> mock_response
+{
+    const std::scoped_lock lock(documents_mutex_);
+    auto document = documents_.find(key);
+    if (document == documents_.end()) {
+        return { key_value_status_code::not_found };
+    }
+    // deleted, flags, expiry, sequence number, and datatype for the version 2 of the request
+    mock_response resp{ key_value_status_code::success, document->second.cas };
+    append_uint(resp.extras, 0, 4);
+    append_uint(resp.extras, document->second.flags, 4);
+    append_uint(resp.extras, document->second.expiry, 4);
+    append_uint(resp.extras, document->second.sequence_number, 8);
+    if (req.extras.size() == 1 && std::to_integer<std::uint8_t>(req.extras[0]) == 2) {
+        append_uint(resp.extras, document->second.datatype, 1);
+    }
+    return resp;
+}
+
+auto
+mock_server_impl::execute_upsert_with_meta(kv_session& session, const mock_request& req, document_key key) -> mock_response
+{
+    // flags, expiry, revision number, CAS, options and the size of the extended metadata, that follows the value
+    if (req.extras.size() != 30) {
+        return { key_value_status_code::invalid };
+    }
+    auto extra_size = static_cast<std::size_t>(read_uint(req.extras.data() + 28, 2));
+    if (extra_size > req.value.size()) {
+        return { key_value_status_code::invalid };
+    }
+
+    const std::scoped_lock lock(documents_mutex_);
+    mock_document stored{ req.value.substr(0, req.value.size() - extra_size),
+                          static_cast<std::uint32_t>(read_uint(req.extras.data(), 4)),
+                          static_cast<std::uint32_t>(read_uint(req.extras.data() + 4, 4)),
+                          req.datatype,
+                          read_uint(req.extras.data() + 16, 8),
+                          ++sequence_number_,
+                          req.vbucket };
+    mock_response resp{ key_value_status_code::success, stored.cas };
+    record_mutation(stored.vbucket, stored.sequence_number);
+    resp.extras = mutation_extras(session, stored.vbucket, stored.sequence_number);
+    documents_[std::move(key)] = std::move(stored);
+    return resp;
+}
+
+auto
+mock_server_impl::execute_lookup_in(const mock_request& req, const document_key& key) -> mock_response
+{
+    auto specs = parse_subdoc_specs(req.value, false);
+    if (!specs || specs->empty()) {
+        return { key_value_status_code::invalid };
+    }
+
+    const std::scoped_lock lock(documents_mutex_);
+    auto document = documents_.find(key);
+    if (document == documents_.end()) {
+        return { key_value_status_code::not_found };
+    }
+    auto body = parse_fragment(document->second.value);
+
+    mock_response resp{ key_value_status_code::success, document->second.cas };
+    for (const auto& spec : specs.value()) {
+        std::string result{};
+        auto status = key_value_status_code::success;
+        if (spec.opcode == protocol::subdoc_opcode::get_doc) {
+            result = document->second.value;
+        } else if (!body) {
+            status = key_value_status_code::subdoc_doc_not_json;
+        } else {
+            status = lookup_path(body.value(), spec, result);
+        }
+        if (status != key_value_status_code::success) {
+            resp.status = key_value_status_code::subdoc_multi_path_failure;
+        }
+        append_uint(resp.value, static_cast<std::uint16_t>(status), 2);
+        append_uint(resp.value, result.size(), 4);
+        resp.value += result;
+    }
+    return resp;
+}
+
+auto
+mock_server_impl::execute_mutate_in(kv_session& session, const mock_request& req, document_key key) -> mock_response
+{
+    auto specs = parse_subdoc_specs(req.value, true);
+    if (!specs || specs->empty()) {
+        return { key_value_status_code::invalid };
+    }
+    std::uint8_t doc_flags{ 0 };
+    std::uint32_t expiry{ 0 };
+    if (req.extras.size() == 1 || req.extras.size() == 5) {
+        doc_flags = std::to_integer<std::uint8_t>(req.extras.back());
+    }
+    if (req.extras.size() >= 4) {
+        expiry = static_cast<std::uint32_t>(read_uint(req.extras.data(), 4));
+    }
+    bool create_document = (doc_flags & (doc_flag_mkdoc | doc_flag_add)) != 0;
+
+    const std::scoped_lock lock(documents_mutex_);
+    auto document = documents_.find(key);
+    if (document != documents_.end() && (doc_flags & doc_flag_add) != 0) {
+        return { key_value_status_code::exists };
+    }
+    if (document == documents_.end() && !create_document) {
+        return { key_value_status_code::not_found };
+    }
+    if (document != documents_.end() && req.cas != 0 && req.cas != document->second.cas) {
+        return { key_value_status_code::exists };
+    }
+
+    std::optional<tao::json::value> body{ tao::json::empty_object };
+    if (document != documents_.end()) {
+        body = parse_fragment(document->second.value);
+    }
+
+    mock_response resp{};
+    bool remove_document{ false };
+    for (std::size_t index = 0; index < specs->size(); ++index) {
+        const auto& spec = specs->at(index);
+        std::string result{};
+        auto status = key_value_status_code::success;
+        if (spec.opcode == protocol::subdoc_opcode::set_doc) {
+            body = parse_fragment(spec.value);
+            status = body ? key_value_status_code::success : key_value_status_code::subdoc_value_cannot_insert;
+        } else if (spec.opcode == protocol::subdoc_opcode::remove_doc) {
+            remove_document = true;
+        } else if (!body) {
+            status = key_value_status_code::subdoc_doc_not_json;
+        } else {
+            status = mutate_path(body.value(), spec, create_document, result);
+        }
+        if (status != key_value_status_code::success) {
+            // nothing is applied, when any of the mutations fails
+            mock_response failure{ key_value_status_code::subdoc_multi_path_failure };
+            append_uint(failure.value, index, 1);
+            append_uint(failure.value, static_cast<std::uint16_t>(status), 2);
+            return failure;
+        }
+        if (!result.empty()) {
+            append_uint(resp.value, index, 1);
+            append_uint(resp.value, static_cast<std::uint16_t>(status), 2);
+            append_uint(resp.value, result.size(), 4);
+            resp.value += result;
+        }
+    }
+
+    resp.cas = ++cas_;
+    record_mutation(req.vbucket, ++sequence_number_);
+    resp.extras = mutation_extras(session, req.vbucket, sequence_number_);
+    if (remove_document) {
+        if (document != documents_.end()) {
+            documents_.erase(document);
+        }
+        return resp;
+    }
+    mock_document stored{ couchbase::core::utils::json::generate(body.value()),
+                          0,
+                          expiry,
+                          session.json ? datatype_json : std::uint8_t{ 0 },
+                          resp.cas,
+                          sequence_number_,
+                          req.vbucket };
+    if (document != documents_.end()) {
+        stored.flags = document->second.flags;
+    }
+    documents_[std::move(key)] = std::move(stored);
+    return resp;
+}
+
+auto
+mock_server_impl::execute_range_scan_create(const mock_request& req) -> mock_response
+{
+    auto options = parse_fragment(req.value);
+    if (!options || !options->is_object()) {
+        return { key_value_status_code::invalid };
+    }
+    std::uint32_t collection_id{ 0 };
+    if (const auto* collection = options->find("collection"); collection != nullptr) {
+        collection_id = static_cast<std::uint32_t>(std::stoul(collection->get_string(), nullptr, 16));
+    }
+    mock_range_scan scan{};
+    if (const auto* key_only = options->find("key_only"); key_only != nullptr) {
+        scan.keys_only = key_only->get_boolean();
+    }
+
+    std::string start{};
+    bool start_exclusive{ false };
+    std::optional<std::string> end{};
+    bool end_exclusive{ false };
+    std::optional<std::size_t> samples{};
+    if (const auto* range = options->find("range"); range != nullptr) {
+        if (const auto* value = range->find("start"); value != nullptr) {
+            start = couchbase::core::base64::decode_to_string(value->get_string());
+        } else if (const auto* excl_value = range->find("excl_start"); excl_value != nullptr) {
+            start = couchbase::core::base64::decode_to_string(excl_value->get_string());
+            start_exclusive = true;
+        }
+        if (const auto* value = range->find("end"); value != nullptr) {
+            end = couchbase::core::base64::decode_to_string(value->get_string());
+        } else if (const auto* excl_value = range->find("excl_end"); excl_value != nullptr) {
+            end = couchbase::core::base64::decode_to_string(excl_value->get_string());
+            end_exclusive = true;
+        }
+    } else if (const auto* sampling = options->find("sampling"); sampling != nullptr) {
+        samples = sampling->at("samples").as<std::size_t>();
+    } else {
+        return { key_value_status_code::invalid };
+    }
+
+    const std::scoped_lock lock(documents_mutex_);
+    for (auto it = documents_.lower_bound({ collection_id, start }); it != documents_.end() && it->first.first == collection_id; ++it) {
+        const auto& [id, document] = *it;
+        if (start_exclusive && id.second == start) {
+            continue;
+        }
+        if (end && (id.second > end.value() || (end_exclusive && id.second == end.value()))) {
+            break;
+        }
+        if (document.vbucket != req.vbucket) {
+            continue;
+        }
+        scan.items.emplace_back(id.second, document);
+        if (samples && scan.items.size() >= samples.value()) {
+            break;
+        }
+    }
+    if (scan.items.empty()) {
+        return { key_value_status_code::not_found };
+    }
+
+    std::string uuid(16, '\0');
+    std::generate(uuid.begin(), uuid.end(), [this]() { return static_cast<char>(random_()); });
+    range_scans_[uuid] = std::move(scan);
+    return { key_value_status_code::success, 0, 0, {}, uuid };
+}
+
+auto
+mock_server_impl::execute_range_scan_continue(const mock_request& req) -> mock_response
+{
+    if (req.extras.size() < 20) {
+        return { key_value_status_code::invalid };
+    }
+    std::string uuid(reinterpret_cast<const char*>(req.extras.data()), 16);
+    auto item_limit = static_cast<std::size_t>(read_uint(req.extras.data() + 16, 4));
+
+    const std::scoped_lock lock(documents_mutex_);
+    auto scan = range_scans_.find(uuid);
+    if (scan == range_scans_.end()) {
+        return { key_value_status_code::not_found };
+    }
+    auto& state = scan->second;
+    mock_response resp{};
+    append_uint(resp.extras, state.keys_only ? 0 : 1, 4);
+    std::size_t sent{ 0 };
+    while (state.position < state.items.size() && (item_limit == 0 || sent < item_limit)) {
+        const auto& [key, document] = state.items[state.position++];
+        ++sent;
+        if (!state.keys_only) {
+            append_uint(resp.value, document.flags, 4);
+            append_uint(resp.value, document.expiry, 4);
+            append_uint(resp.value, document.sequence_number, 8);
+            append_uint(resp.value, document.cas, 8);
+            append_uint(resp.value, document.datatype, 1);
+        }
+        append_leb128(resp.value, key.size());
+        resp.value += key;
+        if (!state.keys_only) {
+            append_leb128(resp.value, document.value.size());
+            resp.value += document.value;
+        }
+    }
+    if (state.position < state.items.size()) {
+        resp.status = key_value_status_code::range_scan_more;
+    } else {
+        resp.status = key_value_status_code::range_scan_complete;
+        range_scans_.erase(scan);
+    }
+    return resp;
+}
+
+auto
+mock_server_impl::mutation_extras(const kv_session& session, std::uint16_t vbucket, std::uint64_t sequence_number)
+  -> std::vector<std::byte>
+{
+    std::vector<std::byte> extras{};
+    if (session.mutation_seqno && vbucket < vbuckets_.size()) {
+        append_uint(extras, vbuckets_[vbucket].uuid, 8);
+        append_uint(extras, sequence_number, 8);
+    }
+    return extras;
+}
+
+auto
+mock_server_impl::execute_observe_seqno(const mock_request& req) -> mock_response
+{
+    const std::scoped_lock lock(documents_mutex_);
+    if (req.vbucket >= vbuckets_.size()) {
+        return { key_value_status_code::not_my_vbucket };
+    }
+    auto& vbucket = vbuckets_[req.vbucket];
+    auto visible_before = std::chrono::steady_clock::now() - options_.replication_delay;
+    auto pending = vbucket.pending.begin();
+    while (pending != vbucket.pending.end() && pending->second <= visible_before) {
+        vbucket.visible_sequence_number = std::max(vbucket.visible_sequence_number, pending->first);
+        ++pending;
+    }
+    vbucket.pending.erase(vbucket.pending.begin(), pending);
+
+    // format, vbucket, vbucket UUID, last persisted sequence number, current sequence number
+    mock_response resp{};
+    append_uint(resp.value, 0, 1);
+    append_uint(resp.value, req.vbucket, 2);
+    append_uint(resp.value, vbucket.uuid, 8);
+    append_uint(resp.value, vbucket.visible_sequence_number, 8);
+    append_uint(resp.value, vbucket.visible_sequence_number, 8);
+    return resp;
+}
+
+void
+mock_server_impl::handle_query(const std::shared_ptr<http_session>& session, const std::string& path, const std::string& body)
+{
+    if (path != "/query/service") {
+        return session->write(encode_http_response(404, "Not Found", R"({"errors":[{"code":404,"msg":"not found"}]})"));
+    }
+    std::string client_context_id{};
+    if (auto request = parse_fragment(body); request && request->is_object()) {
+        if (const auto* id = request->find("client_context_id"); id != nullptr && id->is_string()) {
+            client_context_id = id->get_string();
+        }
+    }
+    std::string rows{};
+    std::size_t rows_size{ 0 };
+    for (const auto& row : options_.query_rows) {
+        if (!rows.empty()) {
+            rows += ',';
+        }
+        rows += row;
+        rows_size += row.size();
+    }
+    auto response = fmt::format(R"({{"requestID":"{}","clientContextID":"{}","signature":{{"*":"*"}},"results":[{}],"status":"success",)"
+                                R"("metrics":{{"elapsedTime":"1ms","executionTime":"1ms","resultCount":{},"resultSize":{}}}}})",
+                                fmt::format("{:016x}", random_()),
+                                client_context_id,
+                                rows,
+                                options_.query_rows.size(),
+                                rows_size);
+    send_delayed(session, encode_http_response(200, "OK", response));
+}
+
+mock_server::mock_server(mock_server_options options)
+  : impl_(std::make_unique<mock_server_impl>(std::move(options)))
+{
+}
+
+mock_server::~mock_server() = default;
+
+auto
+mock_server::bucket_name() const -> const std::string&
+{
+    return impl_->options().bucket_name;
+}
+
+auto
+mock_server::kv_port() const -> std::uint16_t
+{
+    return impl_->kv_port();
+}
+
+auto
+mock_server::query_port() const -> std::uint16_t
+{
+    return impl_->query_port();
+}
+
+auto
+mock_server::connection_string() const -> std::string
+{
+    return fmt::format("couchbase://127.0.0.1:{}=mcd", impl_->kv_port());
+}
+
+auto
+mock_server::origin() const -> couchbase::core::origin
+{
+    couchbase::core::cluster_credentials auth{};
+    auth.username = impl_->options().username;
+    auth.password = impl_->options().password;
+    auth.allowed_sasl_mechanisms = std::vector<std::string>{ "PLAIN" };
+    return couchbase::core::origin(auth, couchbase::core::utils::parse_connection_string(connection_string()));
+}
+
+void
+mock_server::upsert_document(const std::string& key, std::string value, std::uint32_t flags)
+{
+    impl_->upsert_document(0, key, std::move(value), flags);
+}
+
+auto
+mock_server::number_of_documents() const -> std::size_t
+{
+    return impl_->number_of_documents();
+}
+
+auto
+mock_server::number_of_requests(std::uint8_t opcode) const -> std::size_t
+{
+    return impl_->number_of_requests(opcode);
+}
+} // namespace test::utils
@@ -0,0 +1,154 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include "core/origin.hxx"
+
+#include <couchbase/key_value_status_code.hxx>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace test::utils
+{
+/**
+ * KV data request as it has been received by the server. The key does not include the collection prefix.
+ */
+struct mock_kv_request {
+    std::uint8_t opcode{ 0 };
+    std::uint8_t datatype{ 0 };
+    std::uint16_t vbucket{ 0 };
+    std::uint64_t cas{ 0 };
+    std::vector<std::byte> extras{};
+    std::string key{};
+    std::string value{};
+};
+
+struct mock_server_options {
+    std::string bucket_name{ "default" };
+    std::string username{ "Administrator" };
+    std::string password{ "password" };
+    std::uint16_t number_of_vbuckets{ 64 };
+
+    /**
+     * Number of replicas advertised in the configuration. Replicas are served by the same node, so the replica reads and observe
+     * requests are handled by the server like the requests to the active copy.
+     */
+    std::uint32_t number_of_replicas{ 0 };
+
+    /**
+     * Delay after which mutation is reported as replicated and persisted by observe_seqno.
+     */
+    std::chrono::microseconds replication_delay{ 0 };
+
+    /**
+     * Delay applied to every KV data operation and query response.
+     */
+    std::chrono::microseconds latency{ 0 };
+
+    /**
+     * Upper bound of the random delay added on top of the latency. With non-zero jitter the responses might be reordered.
+     */
+    std::chrono::microseconds jitter{ 0 };
+
+    /**
+     * Additional delay for KV data operations with given opcode, for example to emulate the stall of the active node by slowing down
+     * only GET, but not GET_REPLICA.
+     */
+    std::function<std::chrono::microseconds(std::uint8_t opcode)> latency_injector{};
+
+    /**
+     * Probability that KV data operation fails with fault_status instead of being executed.
+     */
+    double fault_probability{ 0.0 };
+    couchbase::key_value_status_code fault_status{ couchbase::key_value_status_code::temporary_failure };
+
+    /**
+     * Targeted fault injection. Receives opcode and key (without collection prefix) of the KV data operation, and returns the status
+     * to respond with, or std::nullopt to execute the operation normally.
+     */
+    std::function<std::optional<couchbase::key_value_status_code>(std::uint8_t opcode, std::string_view key)> fault_injector{};
+
+    /**
+     * Called on the server thread with every KV data operation before it is executed, so that the tests could check the encoding of
+     * the requests.
+     */
+    std::function<void(const mock_kv_request& request)> request_observer{};
+
+    /**
+     * Rows (JSON encoded) returned by the query service for any statement.
+     */
+    std::vector<std::string> query_rows{ R"({"$1":1})" };
+};
+
+class mock_server_impl;
+
+/**
+ * In-process server, that speaks enough of MCBP and HTTP query protocols to bootstrap the SDK and serve basic operations without
+ * network access.
+ *
+ * KV: HELLO, SASL PLAIN, select bucket, get_cluster_config, get_collection_id (default collection only), get, get_replica, upsert,
+ * insert, replace, remove, touch, get_and_touch, get_and_lock, unlock, append, prepend, increment, decrement, get_random_key, get_meta,
+ * upsert_with_meta, remove_with_meta, subdocument lookup/mutation of document body (dictionary paths and array indexes), range scans,
+ * observe_seqno. The locks are only checked by get_and_lock and unlock, and the expiry is stored, but never applied. Query: POST to
+ * /query/service returns mock_server_options::query_rows.
+ *
+ * All connections are served by the single background thread owned by the server.
+ */
+class mock_server
+{
+  public:
+    explicit mock_server(mock_server_options options = {});
+    mock_server(const mock_server&) = delete;
+    mock_server(mock_server&&) = delete;
+    auto operator=(const mock_server&) -> mock_server& = delete;
+    auto operator=(mock_server&&) -> mock_server& = delete;
+    ~mock_server();
+
+    [[nodiscard]] auto bucket_name() const -> const std::string&;
+    [[nodiscard]] auto kv_port() const -> std::uint16_t;
+    [[nodiscard]] auto query_port() const -> std::uint16_t;
+    [[nodiscard]] auto connection_string() const -> std::string;
+
+    /**
+     * @return origin with credentials and SASL mechanism accepted by the server
+     */
+    [[nodiscard]] auto origin() const -> couchbase::core::origin;
+
+    /**
+     * Stores the document in the default collection, bypassing the protocol.
+     */
+    void upsert_document(const std::string& key, std::string value, std::uint32_t flags = 0);
+
+    [[nodiscard]] auto number_of_documents() const -> std::size_t;
+
+    /**
+     * @return number of KV requests with given opcode received by the server
+     */
+    [[nodiscard]] auto number_of_requests(std::uint8_t opcode) const -> std::size_t;
+
+  private:
+    std::unique_ptr<mock_server_impl> impl_;
+};
+} // namespace test::utils
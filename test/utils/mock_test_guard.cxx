@@ -0,0 +1,48 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "mock_test_guard.hxx"
+
+#include "logger.hxx"
+
+namespace test::utils
+{
+mock_test_guard::mock_test_guard(mock_server_options options, std::size_t number_of_io_threads, std::size_t number_of_io_shards)
+  : server(std::move(options))
+  , io(static_cast<int>(number_of_io_threads))
+  , cluster(couchbase::core::cluster::create(io))
+{
+    init_logger();
+    io_threads.reserve(number_of_io_threads);
+    for (std::size_t i = 0; i < number_of_io_threads; ++i) {
+        io_threads.emplace_back([this]() { io.run(); });
+    }
+    auto origin = server.origin();
+    origin.options().io_shards = number_of_io_shards;
+    open_cluster(cluster, origin);
+    open_bucket(cluster, server.bucket_name());
+}
+
+mock_test_guard::~mock_test_guard()
+{
+    close_cluster(cluster);
+    io.stop();
+    for (auto& thread : io_threads) {
+        thread.join();
+    }
+}
+} // namespace test::utils
@@ -0,0 +1,49 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include "integration_shortcuts.hxx"
+#include "mock_server.hxx"
+
+#include <thread>
+#include <vector>
+
+namespace test::utils
+{
+/**
+ * Counterpart of integration_test_guard, that connects the cluster to the in-process mock_server and opens its bucket.
+ */
+class mock_test_guard
+{
+  public:
+    /**
+     * @param number_of_io_shards when non-zero, the cluster spreads its sessions over its own IO contexts (cluster_options::io_shards)
+     */
+    explicit mock_test_guard(mock_server_options options = {}, std::size_t number_of_io_threads = 1, std::size_t number_of_io_shards = 0);
+    mock_test_guard(const mock_test_guard&) = delete;
+    mock_test_guard(mock_test_guard&&) = delete;
+    auto operator=(const mock_test_guard&) -> mock_test_guard& = delete;
+    auto operator=(mock_test_guard&&) -> mock_test_guard& = delete;
+    ~mock_test_guard();
+
+    mock_server server;
+    asio::io_context io;
+    std::vector<std::thread> io_threads{};
+    std::shared_ptr<couchbase::core::cluster> cluster;
+};
+} // namespace test::utils
@@ -33,6 +33,7 @@ Available commands:
   query        Perform N1QL query.
   analytics    Perform Analytics query.
   pillowfight  Run workload generator.
+  replay       Analyze captured MCBP traffic.
 
 Options:
   -h --help  Show this screen.
@@ -21,6 +21,7 @@
 #include "get.hxx"
 #include "pillowfight.hxx"
 #include "query.hxx"
+#include "replay.hxx"
 #include "version.hxx"
 
 namespace cbc
@@ -32,6 +33,7 @@ command_registry::command_registry()
       { "query", std::make_shared<cbc::query>() },
       { "analytics", std::make_shared<cbc::analytics>() },
       { "pillowfight", std::make_shared<cbc::pillowfight>() },
+      { "replay", std::make_shared<cbc::replay>() },
   }
 {
 }
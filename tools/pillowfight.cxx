@@ -18,6 +18,7 @@
 #include "pillowfight.hxx"
 
 #include "core/operations/document_upsert.hxx"
+#include "core/utils/json.hxx"
 #include "couchbase/codec/binary_noop_serializer.hxx"
 #include "utils.hxx"
 
@@ -29,8 +30,14 @@
 #include <asio/io_context.hpp>
 #include <asio/steady_timer.hpp>
 #include <fmt/chrono.h>
+#include <hdr_histogram.h>
+#include <tao/json/value.hpp>
 
+#include <algorithm>
+#include <array>
+#include <condition_variable>
 #include <csignal>
+#include <mutex>
 #include <numeric>
 #include <random>
 
@@ -51,6 +58,9 @@ usage() -> std::string
     static const std::string default_query_statement{ "SELECT COUNT(*) FROM `{bucket_name}` WHERE type = \"fake_profile\"" };
     static const std::size_t default_document_body_size{ 0 };
     static const std::size_t default_operation_limit{ 0 };
+    static const std::size_t default_max_in_flight{ 1 };
+    static const std::size_t default_target_rate{ 0 };
+    static const std::size_t default_stats_interval{ 1 };
 
     static const std::string usage_string = fmt::format(
       R"(Run workload generator.
@@ -74,6 +84,10 @@ Options:
   --incompressible-body               Use random characters to fill generated document value (by default uses 'x' to fill the body).
   --document-body-size=INTEGER        Size of the body (if zero, it will use predefined document). [default: {document_body_size}]
   --operations-limit=INTEGER          Stop and exit after the number of the operations reaches this limit. (zero for running indefinitely) [default: {operation_limit}]
+  --max-in-flight=INTEGER             Number of operations each worker keeps in flight. [default: {max_in_flight}]
+  --target-rate=INTEGER               Total number of operations per second scheduled across all workers (zero for closed loop, where the next operation is sent as soon as a slot becomes free). Latencies are measured from the scheduled start, so stalls of the cluster are not hidden. [default: {target_rate}]
+  --stats-interval=INTEGER            Interval in seconds between the statistics reports. [default: {stats_interval}]
+  --json                              Print statistics reports and summary as JSON objects (one per line).
 
 {logger_options}{cluster_options}
 )",
@@ -89,6 +103,9 @@ Options:
       fmt::arg("query_statement", default_query_statement),
       fmt::arg("document_body_size", default_document_body_size),
       fmt::arg("operation_limit", default_operation_limit),
+      fmt::arg("max_in_flight", default_max_in_flight),
+      fmt::arg("target_rate", default_target_rate),
+      fmt::arg("stats_interval", default_stats_interval),
       fmt::arg("logger_options", usage_block_for_logger()),
       fmt::arg("cluster_options", usage_block_for_cluster_options()));
 
@@ -149,15 +166,181 @@ struct command_options {
     std::string query_statement;
     bool incompressible_body;
     std::size_t document_body_size;
+    std::size_t max_in_flight;
+    std::size_t target_rate;
+    std::chrono::seconds stats_interval;
+    bool json;
 };
 
 enum class operation {
     get,
     upsert,
+    query,
 };
 
+constexpr std::array all_operations{ operation::get, operation::upsert, operation::query };
+
+auto
+operation_name(operation opcode) -> std::string
+{
+    switch (opcode) {
+        case operation::get:
+            return "get";
+        case operation::upsert:
+            return "upsert";
+        case operation::query:
+            return "query";
+    }
+    return "unknown";
+}
+
 using raw_json_transcoder = couchbase::codec::json_transcoder<couchbase::codec::binary_noop_serializer>;
 
+struct latency_summary {
+    std::int64_t count{ 0 };
+    std::int64_t mean{ 0 };
+    std::int64_t p50{ 0 };
+    std::int64_t p90{ 0 };
+    std::int64_t p99{ 0 };
+    std::int64_t p999{ 0 };
+    std::int64_t max{ 0 };
+
+    [[nodiscard]] auto to_json(std::chrono::nanoseconds period) const -> tao::json::value
+    {
+        auto seconds = std::chrono::duration<double>(period).count();
+        return {
+            { "count", count },
+            { "rate", seconds > 0 ? static_cast<double>(count) / seconds : 0.0 },
+            { "latency_us",
+              {
+                { "mean", mean },
+                { "p50", p50 },
+                { "p90", p90 },
+                { "p99", p99 },
+                { "p99.9", p999 },
+                { "max", max },
+              } },
+        };
+    }
+};
+
+/**
+ * Latencies (in nanoseconds) of the single operation type. The interval histogram is folded into the cumulative one on every
+ * report, so the summary covers the whole run.
+ */
+class latency_histogram
+{
+  public:
+    latency_histogram()
+    {
+        hdr_init(1, 30'000'000'000LL, 3, &interval_);
+        hdr_init(1, 30'000'000'000LL, 3, &cumulative_);
+    }
+
+    latency_histogram(const latency_histogram&) = delete;
+    latency_histogram(latency_histogram&&) = delete;
+    auto operator=(const latency_histogram&) -> latency_histogram& = delete;
+    auto operator=(latency_histogram&&) -> latency_histogram& = delete;
+
+    ~latency_histogram()
+    {
+        hdr_close(interval_);
+        hdr_close(cumulative_);
+    }
+
+    void record(std::chrono::nanoseconds latency)
+    {
+        const std::scoped_lock lock(mutex_);
+        hdr_record_value(interval_, std::clamp<std::int64_t>(latency.count(), 1, interval_->highest_trackable_value));
+    }
+
+    auto take_interval() -> latency_summary
+    {
+        const std::scoped_lock lock(mutex_);
+        auto summary = summarize(interval_);
+        hdr_add(cumulative_, interval_);
+        hdr_reset(interval_);
+        return summary;
+    }
+
+    auto cumulative() -> latency_summary
+    {
+        const std::scoped_lock lock(mutex_);
+        return summarize(cumulative_);
+    }
+
+  private:
+    static auto summarize(const hdr_histogram* histogram) -> latency_summary
+    {
+        if (histogram->total_count == 0) {
+            return {};
+        }
+        static constexpr auto to_us = [](auto value) { return static_cast<std::int64_t>(value) / 1'000; };
+        return {
+            histogram->total_count,
+            to_us(hdr_mean(histogram)),
+            to_us(hdr_value_at_percentile(histogram, 50.0)),
+            to_us(hdr_value_at_percentile(histogram, 90.0)),
+            to_us(hdr_value_at_percentile(histogram, 99.0)),
+            to_us(hdr_value_at_percentile(histogram, 99.9)),
+            to_us(hdr_max(histogram)),
+        };
+    }
+
+    std::mutex mutex_{};
+    hdr_histogram* interval_{ nullptr };
+    hdr_histogram* cumulative_{ nullptr };
+};
+
+/**
+ * Bounds the number of the outstanding operations of the single worker.
+ */
+class in_flight_window
+{
+  public:
+    explicit in_flight_window(std::size_t capacity)
+      : capacity_{ std::max<std::size_t>(capacity, 1) }
+    {
+    }
+
+    void acquire()
+    {
+        std::unique_lock lock(mutex_);
+        cv_.wait(lock, [this]() { return in_flight_ < capacity_; });
+        ++in_flight_;
+    }
+
+    void release()
+    {
+        {
+            const std::scoped_lock lock(mutex_);
+            --in_flight_;
+        }
+        cv_.notify_all();
+    }
+
+    void drain()
+    {
+        std::unique_lock lock(mutex_);
+        cv_.wait(lock, [this]() { return in_flight_ == 0; });
+    }
+
+  private:
+    const std::size_t capacity_;
+    std::size_t in_flight_{ 0 };
+    std::mutex mutex_{};
+    std::condition_variable cv_{};
+};
+
+/**
+ * Keys written by the worker. New keys are published only after the upsert completes, so that the gets, that are already in flight,
+ * do not race with them.
+ */
+struct key_pool {
+    std::mutex mutex{};
+    std::vector<std::string> keys{};
+};
+
 std::atomic_flag running{ true };
 std::size_t operations_limit{ 0 };
 std::atomic_uint64_t total{ 0 };
@@ -165,24 +348,91 @@ std::atomic_uint64_t total{ 0 };
 std::map<std::error_code, std::size_t> errors{};
 std::mutex errors_mutex{};
 
+std::array<latency_histogram, all_operations.size()> histograms{};
+
+auto
+histogram_for(operation opcode) -> latency_histogram&
+{
+    return histograms[static_cast<std::size_t>(opcode)];
+}
+
 void
 sigint_handler(int /* signal */)
 {
     running.clear();
 }
 
+/**
+ * The latency is measured from the time when the operation was supposed to start according to the schedule, rather than when it has
+ * been sent. Otherwise the operations, delayed by the slow responses in front of them, would not be accounted (coordinated omission).
+ */
+void
+record_completion(operation opcode, std::chrono::steady_clock::time_point intended_start, std::error_code ec)
+{
+    histogram_for(opcode).record(std::chrono::steady_clock::now() - intended_start);
+    ++total;
+    if (ec) {
+        const std::scoped_lock lock(errors_mutex);
+        ++errors[ec];
+    }
+    if (operations_limit > 0 && total >= operations_limit) {
+        running.clear();
+    }
+}
+
+void
+report_interval(const command_options& options, std::chrono::nanoseconds elapsed, std::chrono::nanoseconds period)
+{
+    const std::uint64_t ops = total;
+    if (options.json) {
+        tao::json::value report{
+            { "type", "interval" },
+            { "elapsed_ms", std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() },
+            { "interval_ms", std::chrono::duration_cast<std::chrono::milliseconds>(period).count() },
+            { "total", ops },
+            { "operations", tao::json::empty_object },
+        };
+        for (auto opcode : all_operations) {
+            report["operations"][operation_name(opcode)] = histogram_for(opcode).take_interval().to_json(period);
+        }
+        fmt::print(stdout, "{}\n", couchbase::core::utils::json::generate(report));
+        std::fflush(stdout);
+        return;
+    }
+
+    std::string line = fmt::format("[{:>6}s] total: {}", std::chrono::duration_cast<std::chrono::seconds>(elapsed).count(), ops);
+    auto seconds = std::chrono::duration<double>(period).count();
+    for (auto opcode : all_operations) {
+        auto summary = histogram_for(opcode).take_interval();
+        if (summary.count == 0) {
+            continue;
+        }
+        line += fmt::format(" | {}: {:.0f} ops/s, p50={}us, p90={}us, p99={}us, p99.9={}us, max={}us",
+                            operation_name(opcode),
+                            seconds > 0 ? static_cast<double>(summary.count) / seconds : 0.0,
+                            summary.p50,
+                            summary.p90,
+                            summary.p99,
+                            summary.p999,
+                            summary.max);
+    }
+    fmt::print(stderr, "{}\n", line);
+}
+
 void
-dump_stats(asio::steady_timer& timer, std::chrono::system_clock::time_point start_time)
+dump_stats(asio::steady_timer& timer,
+           const command_options& options,
+           std::chrono::steady_clock::time_point start_time,
+           std::chrono::steady_clock::time_point last_report_time)
 {
-    timer.expires_after(std::chrono::seconds{ 1 });
-    timer.async_wait([&timer, start_time](std::error_code ec) {
+    timer.expires_after(options.stats_interval);
+    timer.async_wait([&timer, &options, start_time, last_report_time](std::error_code ec) {
         if (ec == asio::error::operation_aborted) {
             return;
         }
-        auto diff = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now() - start_time).count();
-        const std::uint64_t ops = total;
-        fmt::print(stderr, "\rrate: {} ops/s, total: {}", diff == 0 ? ops : ops / static_cast<std::uint64_t>(diff), ops);
-        return dump_stats(timer, start_time);
+        auto now = std::chrono::steady_clock::now();
+        report_interval(options, now - start_time, now - last_report_time);
+        return dump_stats(timer, options, start_time, now);
     });
 }
 
@@ -205,8 +455,12 @@ random_text(std::size_t length)
     return text;
 }
 
+/**
+ * Sends operations asynchronously, keeping at most options.max_in_flight of them outstanding. When the target rate is set, the
+ * operations are started according to the fixed schedule (open loop), and the worker does not slow down when the cluster does.
+ */
 void
-worker(couchbase::cluster connected_cluster, command_options cmd_options, std::vector<std::string>& known_keys)
+worker(couchbase::cluster connected_cluster, command_options cmd_options, key_pool& known_keys)
 {
     auto options = std::move(cmd_options);
     auto cluster = std::move(connected_cluster);
@@ -226,59 +480,142 @@ worker(couchbase::cluster connected_cluster, command_options cmd_options, std::v
         json_doc = couchbase::core::utils::to_binary(default_json_doc);
     }
 
+    std::chrono::nanoseconds schedule_interval{ 0 };
+    if (options.target_rate > 0) {
+        schedule_interval = std::chrono::nanoseconds{ std::chrono::seconds{ 1 } } * options.number_of_worker_threads / options.target_rate;
+    }
+    auto next_start = std::chrono::steady_clock::now();
+
+    in_flight_window window{ options.max_in_flight };
+
     while (running.test_and_set()) {
-        auto opcode = (dist(gen) <= options.chance_of_get) ? operation::get : operation::upsert;
-        if (opcode == operation::get && known_keys.empty()) {
-            opcode = operation::upsert;
+        auto intended_start = std::chrono::steady_clock::now();
+        if (schedule_interval.count() > 0) {
+            std::this_thread::sleep_until(next_start);
+            intended_start = next_start;
+            next_start += schedule_interval;
         }
-        bool should_check_known_keys{ false };
-        switch (opcode) {
-            case operation::get:
-                should_check_known_keys = options.hit_chance_for_get > dist(gen);
-                break;
-            case operation::upsert:
-                should_check_known_keys = options.hit_chance_for_upsert > dist(gen);
-                break;
+
+        std::string document_id{};
+        bool known_key{ false };
+        auto opcode = (dist(gen) <= options.chance_of_get) ? operation::get : operation::upsert;
+        {
+            const std::scoped_lock lock(known_keys.mutex);
+            if (opcode == operation::get && known_keys.keys.empty()) {
+                opcode = operation::upsert;
+            }
+            auto hit_chance = opcode == operation::get ? options.hit_chance_for_get : options.hit_chance_for_upsert;
+            if (hit_chance > dist(gen) && !known_keys.keys.empty()) {
+                auto key_index = std::uniform_int_distribution<std::size_t>(0, known_keys.keys.size() - 1)(gen);
+                document_id = known_keys.keys[key_index];
+                known_key = true;
+            }
         }
-        std::string document_id = uniq_id("id");
-        if (should_check_known_keys && !known_keys.empty()) {
-            auto key_index = std::uniform_int_distribution<std::size_t>(0, known_keys.size() - 1)(gen);
-            document_id = known_keys[key_index];
-        } else {
-            known_keys.emplace_back(document_id);
+        if (!known_key) {
+            document_id = uniq_id("id");
         }
 
+        window.acquire();
         switch (opcode) {
             case operation::upsert: {
                 const couchbase::upsert_options operation_options{};
-                auto [ctx, resp] = collection.upsert<raw_json_transcoder>(document_id, json_doc, operation_options).get();
-                ++total;
-                if (ctx.ec()) {
-                    const std::scoped_lock lock(errors_mutex);
-                    ++errors[ctx.ec()];
-                }
+                collection.upsert<raw_json_transcoder>(
+                  document_id,
+                  json_doc,
+                  operation_options,
+                  [&window, &known_keys, intended_start, known_key, document_id](auto ctx, auto /* resp */) {
+                      record_completion(operation::upsert, intended_start, ctx.ec());
+                      if (!ctx.ec() && !known_key) {
+                          const std::scoped_lock lock(known_keys.mutex);
+                          known_keys.keys.emplace_back(document_id);
+                      }
+                      window.release();
+                  });
             } break;
             case operation::get: {
                 const couchbase::get_options operation_options{};
-                auto [ctx, resp] = collection.get(document_id, operation_options).get();
-                ++total;
-                if (ctx.ec()) {
-                    const std::scoped_lock lock(errors_mutex);
-                    ++errors[ctx.ec()];
-                }
+                collection.get(document_id, operation_options, [&window, intended_start](auto ctx, auto /* resp */) {
+                    record_completion(operation::get, intended_start, ctx.ec());
+                    window.release();
+                });
             } break;
+            case operation::query:
+                break;
         }
         if (options.chance_of_query > 0 && dist(gen) <= options.chance_of_query) {
+            window.acquire();
             const couchbase::query_options operation_options{};
-            auto [ctx, resp] = cluster.query(options.query_statement, operation_options).get();
-            ++total;
-            if (ctx.ec()) {
-                const std::scoped_lock lock(errors_mutex);
-                ++errors[ctx.ec()];
+            cluster.query(options.query_statement, operation_options, [&window, intended_start](auto ctx, auto /* resp */) {
+                record_completion(operation::query, intended_start, ctx.ec());
+                window.release();
+            });
+        }
+    }
+
+    // the callbacks refer to the window and the key pool
+    window.drain();
+}
+
+void
+print_summary(const command_options& options, std::chrono::nanoseconds total_time, std::size_t number_of_keys)
+{
+    const std::uint64_t ops = total;
+    auto seconds = std::chrono::duration<double>(total_time).count();
+
+    if (options.json) {
+        tao::json::value summary{
+            { "type", "summary" },
+            { "total", ops },
+            { "keys", number_of_keys },
+            { "time_ms", std::chrono::duration_cast<std::chrono::milliseconds>(total_time).count() },
+            { "rate", seconds > 0 ? static_cast<double>(ops) / seconds : 0.0 },
+            { "operations", tao::json::empty_object },
+            { "errors", tao::json::empty_object },
+        };
+        for (auto opcode : all_operations) {
+            summary["operations"][operation_name(opcode)] = histogram_for(opcode).cumulative().to_json(total_time);
+        }
+        {
+            const std::scoped_lock lock(errors_mutex);
+            for (auto [e, count] : errors) {
+                summary["errors"][e.message()] = count;
             }
         }
-        if (operations_limit > 0 && total >= operations_limit) {
-            running.clear();
+        fmt::print(stdout, "{}\n", couchbase::core::utils::json::generate(summary));
+        return;
+    }
+
+    fmt::print("\ntotal operations: {}\n", ops);
+    fmt::print("total keys used: {}\n", number_of_keys);
+    fmt::print("total time: {}s ({}ms)\n",
+               std::chrono::duration_cast<std::chrono::seconds>(total_time).count(),
+               std::chrono::duration_cast<std::chrono::milliseconds>(total_time).count());
+    if (seconds > 0) {
+        fmt::print("total rate: {:.0f} ops/s\n", static_cast<double>(ops) / seconds);
+    }
+    fmt::print("latency (us):\n");
+    for (auto opcode : all_operations) {
+        auto latency = histogram_for(opcode).cumulative();
+        if (latency.count == 0) {
+            continue;
+        }
+        fmt::print("    {}: count={}, mean={}, p50={}, p90={}, p99={}, p99.9={}, max={}\n",
+                   operation_name(opcode),
+                   latency.count,
+                   latency.mean,
+                   latency.p50,
+                   latency.p90,
+                   latency.p99,
+                   latency.p999,
+                   latency.max);
+    }
+    {
+        const std::scoped_lock lock(errors_mutex);
+        if (!errors.empty()) {
+            fmt::print("error stats:\n");
+            for (auto [e, count] : errors) {
+                fmt::print("    {}: {}\n", e.message(), count);
+            }
         }
     }
 }
@@ -309,12 +646,12 @@ do_work(const std::string& connection_string, const couchbase::cluster_options&
         throw std::system_error(ec, "unable to connect to the cluster in time");
     }
 
-    const auto start_time = std::chrono::system_clock::now();
+    const auto start_time = std::chrono::steady_clock::now();
 
     asio::steady_timer stats_timer(io);
-    dump_stats(stats_timer, start_time);
+    dump_stats(stats_timer, cmd_options, start_time, start_time);
 
-    std::vector<std::vector<std::string>> known_keys(cmd_options.number_of_worker_threads);
+    std::vector<key_pool> known_keys(cmd_options.number_of_worker_threads);
 
     std::vector<std::thread> worker_pool{};
     worker_pool.reserve(cmd_options.number_of_worker_threads);
@@ -325,28 +662,18 @@ do_work(const std::string& connection_string, const couchbase::cluster_options&
         thread.join();
     }
 
-    const auto finish_time = std::chrono::system_clock::now();
+    const auto finish_time = std::chrono::steady_clock::now();
     stats_timer.cancel();
 
-    fmt::print("\n\ntotal operations: {}\n", total);
-    fmt::print("total keys used: {}\n",
-               std::accumulate(known_keys.begin(), known_keys.end(), 0, [](auto count, const auto& keys) { return count + keys.size(); }));
-    const auto total_time = finish_time - start_time;
-    fmt::print("total time: {}s ({}ms)\n",
-               std::chrono::duration_cast<std::chrono::seconds>(total_time).count(),
-               std::chrono::duration_cast<std::chrono::milliseconds>(total_time).count());
-    if (auto diff = std::chrono::duration_cast<std::chrono::seconds>(total_time).count(); diff > 0) {
-        fmt::print("total rate: {} ops/s\n", total / static_cast<std::uint64_t>(diff));
-    }
-    {
-        std::scoped_lock lock(errors_mutex);
-        if (!errors.empty()) {
-            fmt::print("error stats:\n");
-            for (auto [e, count] : errors) {
-                fmt::print("    {}: {}\n", ec.message(), count);
-            }
-        }
+    // fold the last partial interval into the cumulative histograms
+    for (auto opcode : all_operations) {
+        histogram_for(opcode).take_interval();
     }
+    print_summary(cmd_options,
+                  finish_time - start_time,
+                  std::accumulate(known_keys.begin(), known_keys.end(), std::size_t{ 0 }, [](auto count, const auto& pool) {
+                      return count + pool.keys.size();
+                  }));
 
     cluster.close();
     guard.reset();
@@ -389,6 +716,10 @@ cbc::pillowfight::execute(const std::vector<std::string>& argv)
                                               fmt::arg("collection_name", cmd_options.collection_name));
     cmd_options.incompressible_body = get_bool_option(options, "--incompressible-body");
     cmd_options.document_body_size = options["--document-body-size"].asLong();
+    cmd_options.max_in_flight = options["--max-in-flight"].asLong();
+    cmd_options.target_rate = options["--target-rate"].asLong();
+    cmd_options.stats_interval = std::chrono::seconds{ std::max(options["--stats-interval"].asLong(), 1L) };
+    cmd_options.json = get_bool_option(options, "--json");
     operations_limit = options["--operations-limit"].asLong();
 
     do_work(connection_string, cluster_options, cmd_options);
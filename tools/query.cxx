@@ -190,11 +190,11 @@ print_result_json_line(const std::optional<scope_with_bucket>& scope_id,
             meta["warnings"] = warnings;
         }
         tao::json::value rows = tao::json::empty_array;
-        for (const auto& row : resp.rows_as_binary()) {
+        for (const auto& row : resp.rows_as_views()) {
             try {
-                rows.emplace_back(couchbase::core::utils::json::parse_binary(row));
+                rows.emplace_back(couchbase::core::utils::json::parse(row));
             } catch (const tao::pegtl::parse_error&) {
-                rows.emplace_back(row);
+                rows.emplace_back(std::string{ row });
             }
         }
         line["rows"] = rows;
@@ -283,11 +283,11 @@ print_result(const std::optional<scope_with_bucket>& scope_id,
                 fmt::print("{:a}\n", spdlog::to_hex(profile.value()));
             }
         }
-        for (const auto& row : resp.rows_as_binary()) {
+        for (const auto& row : resp.rows_as_views()) {
             try {
-                fmt::print("{}\n", tao::json::to_string(couchbase::core::utils::json::parse_binary(row)));
+                fmt::print("{}\n", tao::json::to_string(couchbase::core::utils::json::parse(row)));
             } catch (const tao::pegtl::parse_error&) {
-                fmt::print("{:a}\n", spdlog::to_hex(row));
+                fmt::print("{:a}\n", spdlog::to_hex(row.begin(), row.end()));
             }
         }
     }
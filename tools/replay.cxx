@@ -0,0 +1,277 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "replay.hxx"
+
+#include "utils.hxx"
+
+#include <core/io/mcbp_capture.hxx>
+#include <core/io/mcbp_parser.hxx>
+#include <core/protocol/client_opcode_fmt.hxx>
+
+#include <tao/json.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+namespace cbc
+{
+namespace
+{
+static constexpr auto* USAGE =
+  R"(Replay MCBP traffic, captured by the library.
+
+The capture could be enabled with "mcbp_capture_path" connection string parameter, for example:
+
+  cbc pillowfight --connection-string="couchbase://127.0.0.1?mcbp_capture_path=/tmp/cbc"
+
+Received data is fed into the MCBP parser in the same chunks as it has been read from the socket, so the decoding costs could be
+profiled offline. Requests are matched with responses by opaque to report server round-trip time for every opcode.
+
+Usage:
+  cbc replay [options] <file>...
+  cbc replay (-h|--help)
+
+Options:
+  -h --help           Show this screen.
+  --iterations=INT    Number of times to feed the capture into the parser. [default: 1]
+  --json              Print report in JSON format.
+)";
+
+using couchbase::core::io::capture_direction;
+using couchbase::core::io::mcbp_capture_reader;
+using couchbase::core::io::mcbp_capture_record;
+using couchbase::core::io::mcbp_message;
+using couchbase::core::io::mcbp_parser;
+
+struct opcode_stats {
+    std::uint64_t requests{ 0 };
+    std::uint64_t responses{ 0 };
+    std::uint64_t request_bytes{ 0 };
+    std::uint64_t response_bytes{ 0 };
+    std::vector<std::chrono::nanoseconds> round_trips{};
+};
+
+struct pending_request {
+    std::uint8_t opcode;
+    std::chrono::system_clock::time_point timestamp;
+};
+
+auto
+opcode_name(std::uint8_t opcode) -> std::string
+{
+    if (couchbase::core::protocol::is_valid_client_opcode(opcode)) {
+        return fmt::format("{}", static_cast<couchbase::core::protocol::client_opcode>(opcode));
+    }
+    return fmt::format("0x{:02x}", opcode);
+}
+
+auto
+percentile(const std::vector<std::chrono::nanoseconds>& sorted, double p) -> std::chrono::nanoseconds
+{
+    if (sorted.empty()) {
+        return {};
+    }
+    auto index = static_cast<std::size_t>(p / 100.0 * static_cast<double>(sorted.size() - 1));
+    return sorted[index];
+}
+
+auto
+load_records(const std::vector<std::string>& files) -> std::vector<mcbp_capture_record>
+{
+    std::vector<mcbp_capture_record> records;
+    for (const auto& file : files) {
+        mcbp_capture_reader reader(file);
+        mcbp_capture_record record{};
+        while (reader.next(record)) {
+            records.emplace_back(std::move(record));
+        }
+    }
+    std::stable_sort(records.begin(), records.end(), [](const auto& lhs, const auto& rhs) { return lhs.timestamp < rhs.timestamp; });
+    return records;
+}
+
+auto
+analyze(const std::vector<mcbp_capture_record>& records, std::uint64_t& parse_failures) -> std::map<std::uint8_t, opcode_stats>
+{
+    std::map<std::uint8_t, opcode_stats> stats;
+    std::map<couchbase::core::uuid::uuid_t, mcbp_parser> parsers;
+    std::map<std::pair<couchbase::core::uuid::uuid_t, std::uint32_t>, pending_request> pending;
+
+    for (const auto& record : records) {
+        if (record.direction == capture_direction::send) {
+            if (record.data.size() < couchbase::core::protocol::header_size) {
+                continue;
+            }
+            auto opcode = std::to_integer<std::uint8_t>(record.data[1]);
+            std::uint32_t opaque{ 0 };
+            std::memcpy(&opaque, record.data.data() + 12, sizeof(opaque));
+            auto& entry = stats[opcode];
+            ++entry.requests;
+            entry.request_bytes += record.data.size();
+            pending[{ record.session_id, opaque }] = { opcode, record.timestamp };
+            continue;
+        }
+
+        auto& parser = parsers[record.session_id];
+        parser.feed(record.data.begin(), record.data.end());
+        for (;;) {
+            mcbp_message msg{};
+            auto res = parser.next(msg);
+            if (res == mcbp_parser::result::need_data) {
+                break;
+            }
+            if (res == mcbp_parser::result::failure) {
+                ++parse_failures;
+                parser.reset();
+                break;
+            }
+            auto& entry = stats[msg.header.opcode];
+            ++entry.responses;
+            entry.response_bytes += couchbase::core::protocol::header_size + msg.body.size();
+            if (auto request = pending.find({ record.session_id, msg.header.opaque }); request != pending.end()) {
+                entry.round_trips.emplace_back(record.timestamp - request->second.timestamp);
+                pending.erase(request);
+            }
+        }
+    }
+    for (auto& [opcode, entry] : stats) {
+        std::sort(entry.round_trips.begin(), entry.round_trips.end());
+    }
+    return stats;
+}
+
+auto
+measure_parser(const std::vector<mcbp_capture_record>& records, std::size_t iterations, std::uint64_t& messages, std::uint64_t& bytes)
+  -> std::chrono::nanoseconds
+{
+    messages = 0;
+    bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        std::map<couchbase::core::uuid::uuid_t, mcbp_parser> parsers;
+        for (const auto& record : records) {
+            if (record.direction != capture_direction::receive) {
+                continue;
+            }
+            bytes += record.data.size();
+            auto& parser = parsers[record.session_id];
+            parser.feed(record.data.begin(), record.data.end());
+            mcbp_message msg{};
+            while (parser.next(msg) == mcbp_parser::result::ok) {
+                ++messages;
+            }
+        }
+    }
+    return std::chrono::steady_clock::now() - start;
+}
+} // namespace
+
+void
+cbc::replay::execute(const std::vector<std::string>& argv)
+{
+    try {
+        auto options = cbc::parse_options(USAGE, argv);
+        if (options["--help"].asBool()) {
+            fmt::print(stdout, USAGE);
+            return;
+        }
+
+        auto records = load_records(options["<file>"].asStringList());
+        auto iterations = static_cast<std::size_t>(std::max(1L, options["--iterations"].asLong()));
+
+        std::uint64_t parse_failures{ 0 };
+        auto stats = analyze(records, parse_failures);
+        std::uint64_t messages{ 0 };
+        std::uint64_t bytes{ 0 };
+        auto parse_time = measure_parser(records, iterations, messages, bytes);
+        auto parse_seconds = std::chrono::duration<double>(parse_time).count();
+        auto messages_per_second = parse_seconds > 0 ? static_cast<double>(messages) / parse_seconds : 0.0;
+        auto megabytes_per_second = parse_seconds > 0 ? static_cast<double>(bytes) / parse_seconds / (1024.0 * 1024.0) : 0.0;
+
+        if (options["--json"].asBool()) {
+            tao::json::value report = {
+                { "records", records.size() },
+                { "parse_failures", parse_failures },
+                { "parser",
+                  {
+                    { "iterations", iterations },
+                    { "messages", messages },
+                    { "bytes", bytes },
+                    { "duration_ns", parse_time.count() },
+                    { "messages_per_second", messages_per_second },
+                    { "megabytes_per_second", megabytes_per_second },
+                  } },
+            };
+            tao::json::value opcodes = tao::json::empty_object;
+            for (const auto& [opcode, entry] : stats) {
+                opcodes[opcode_name(opcode)] = {
+                    { "requests", entry.requests },
+                    { "responses", entry.responses },
+                    { "request_bytes", entry.request_bytes },
+                    { "response_bytes", entry.response_bytes },
+                    { "round_trip_ns",
+                      {
+                        { "min", percentile(entry.round_trips, 0).count() },
+                        { "p50", percentile(entry.round_trips, 50).count() },
+                        { "p99", percentile(entry.round_trips, 99).count() },
+                        { "max", percentile(entry.round_trips, 100).count() },
+                      } },
+                };
+            }
+            report["opcodes"] = opcodes;
+            fmt::print(stdout, "{}\n", tao::json::to_string(report, 2));
+            return;
+        }
+
+        fmt::print(stdout, "Records: {}, parse failures: {}\n", records.size(), parse_failures);
+        fmt::print(stdout,
+                   "Parser: {} messages, {} bytes in {} ({} iterations), {:.1f} msg/s, {:.2f} MiB/s\n",
+                   messages,
+                   bytes,
+                   std::chrono::duration_cast<std::chrono::microseconds>(parse_time),
+                   iterations,
+                   messages_per_second,
+                   megabytes_per_second);
+        fmt::print(stdout,
+                   "{:<28} {:>10} {:>10} {:>14} {:>14} {:>12} {:>12} {:>12}\n",
+                   "opcode",
+                   "requests",
+                   "responses",
+                   "req bytes",
+                   "resp bytes",
+                   "rtt p50",
+                   "rtt p99",
+                   "rtt max");
+        for (const auto& [opcode, entry] : stats) {
+            fmt::print(stdout,
+                       "{:<28} {:>10} {:>10} {:>14} {:>14} {:>12} {:>12} {:>12}\n",
+                       opcode_name(opcode),
+                       entry.requests,
+                       entry.responses,
+                       entry.request_bytes,
+                       entry.response_bytes,
+                       std::chrono::duration_cast<std::chrono::microseconds>(percentile(entry.round_trips, 50)),
+                       std::chrono::duration_cast<std::chrono::microseconds>(percentile(entry.round_trips, 99)),
+                       std::chrono::duration_cast<std::chrono::microseconds>(percentile(entry.round_trips, 100)));
+        }
+    } catch (const docopt::DocoptArgumentError& e) {
+        fmt::print(stderr, "Error: {}\n", e.what());
+    }
+}
+} // namespace cbc